@@ -543,6 +543,12 @@ private:
 			status_t			_Dereference();
 
 			status_t			_ValidateMessage();
+			status_t			_AdoptFlattened(void* buffer, size_t size);
+
+			bool				_IsInline() const;
+			void				_UpdateInlineLayout();
+			status_t			_Reserve(size_t size);
+			status_t			_MoveOutOfLine();
 
 			void				_UpdateOffsets(uint32 offset, int32 change);
 			status_t			_ResizeData(uint32 offset, int32 change);
@@ -597,7 +603,11 @@ private:
 
 			void*				fArchivingPointer;
 
-			uint32				fReserved[8];
+			uint32				fBufferSize;
+				// the size of the buffer fHeader points to when the fields
+				// and data follow the header in it, 0 otherwise
+
+			uint32				fReserved[7];
 
 			enum				{ sNumReplyPorts = 3 };
 	static	port_id				sReplyPorts[sNumReplyPorts];
@@ -11,6 +11,11 @@
 	// For convenience
 
 
+namespace BPrivate {
+	class BDirectMessageTarget;
+}
+
+
 class BMessageQueue {
 public:
 								BMessageQueue();
@@ -33,6 +38,8 @@ public:
 			bool				IsNextMessage(const BMessage* message) const;
 
 private:
+	friend class BPrivate::BDirectMessageTarget;
+
 			// Reserved space in the vtable for future changes to BMessageQueue
 	virtual	void				_ReservedMessageQueue1();
 	virtual	void				_ReservedMessageQueue2();
@@ -45,13 +52,24 @@ private:
 				// this needs to be exported for R5 compatibility and should
 				// be dropped as soon as possible
 
+			bool				_AddMessage(BMessage* message);
+			void				_TakePendingMessages();
+
 private:
 			BMessage*			fHead;
 			BMessage*			fTail;
 			int32				fMessageCount;
 	mutable	BLocker				fLock;
 
-			uint32				_reserved[3];
+			BMessage*			fPending;
+				// messages that have been added, but not yet been moved to
+				// the queue, newest first
+
+#ifdef B_HAIKU_64_BIT
+			uint32				_reserved[1];
+#else
+			uint32				_reserved[2];
+#endif
 };
 
 
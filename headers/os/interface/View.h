@@ -585,6 +585,9 @@ public:
 			void				Flush() const;
 			void				Sync() const;
 
+			status_t			BeginDrawingBatch();
+			status_t			EndDrawingBatch();
+
 	virtual	void				GetPreferredSize(float* _width, float* _height);
 	virtual	void				ResizeToPreferred();
 
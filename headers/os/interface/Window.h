@@ -367,6 +367,11 @@ private:
 			void				_SendShowOrHideMessage();
 			void				_PropagateMessageToChildViews(BMessage*);
 
+			status_t			_BeginDrawingBatch();
+			status_t			_EndDrawingBatch();
+			status_t			_CreateCommandBuffer();
+			void				_DeleteCommandBuffer();
+
 private:
 			char*				fTitle;
 			int32				_unused0;
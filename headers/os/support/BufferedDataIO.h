@@ -33,6 +33,16 @@ private:
 								BBufferedDataIO(const BBufferedDataIO& other);
 									// not implemented
 
+			struct Private;
+
+			ssize_t				_FillBuffer();
+			void				_SequentialAccess();
+			void				_ResizeBuffer();
+			void				_Prefetch();
+			void				_WaitForPrefetch();
+			void				_StopPrefetching();
+	static	status_t			_PrefetchThread(void* data);
+
 	virtual	status_t			_Reserved0(void*);
 	virtual	status_t			_Reserved1(void*);
 	virtual	status_t			_Reserved2(void*);
@@ -46,7 +56,9 @@ private:
 			size_t				fPosition;
 			size_t				fSize;
 
-			uint32				_reserved_ints[4];
+			Private*			fPrivate;
+			uint32				_reserved_ints[4
+									- sizeof(void*) / sizeof(uint32)];
 
 			bool				fDirty;
 			bool				fOwnsStream;
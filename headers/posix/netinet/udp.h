@@ -14,4 +14,7 @@ struct udphdr {
 	uint16_t uh_sum;
 };
 
+/* UDP socket options */
+#define UDP_SEGMENT	103	/* send as datagrams of this size (int) */
+
 #endif /* _NETINET_UDP_H */
@@ -113,6 +113,11 @@ struct msghdr {
 	int			msg_flags;		/* flags */
 };
 
+struct mmsghdr {
+	struct msghdr	msg_hdr;	/* message header */
+	unsigned int	msg_len;	/* number of bytes transferred */
+};
+
 /* Flags for the msghdr.msg_flags field */
 #define MSG_OOB			0x0001	/* process out-of-band data */
 #define MSG_PEEK		0x0002	/* peek at incoming message */
@@ -128,6 +133,7 @@ struct msghdr {
 #define MSG_NOSIGNAL	0x0800	/* don't raise SIGPIPE if socket is closed */
 #define MSG_CMSG_CLOEXEC	0x1000	/* set FD_CLOEXEC flag on FDs created via SCM_RIGHTS */
 #define MSG_CMSG_CLOFORK	0x2000	/* set FD_CLOFORK flag on FDs created via SCM_RIGHTS */
+#define MSG_WAITFORONE	0x4000	/* recvmmsg(): only block for the first message */
 
 struct cmsghdr {
 	socklen_t	cmsg_len;
@@ -164,6 +170,9 @@ struct ucred {
 };
 
 
+struct timespec;
+
+
 #if __cplusplus
 extern "C" {
 #endif
@@ -185,8 +194,12 @@ ssize_t recv(int socket, void *buffer, size_t length, int flags);
 ssize_t recvfrom(int socket, void *buffer, size_t bufferLength, int flags,
 			struct sockaddr *address, socklen_t *_addressLength);
 ssize_t recvmsg(int socket, struct msghdr *message, int flags);
+int		recvmmsg(int socket, struct mmsghdr *messages, unsigned int count,
+			int flags, struct timespec *timeout);
 ssize_t send(int socket, const void *buffer, size_t length, int flags);
 ssize_t	sendmsg(int socket, const struct msghdr *message, int flags);
+int		sendmmsg(int socket, struct mmsghdr *messages, unsigned int count,
+			int flags);
 ssize_t sendto(int socket, const void *message, size_t length, int flags,
 			const struct sockaddr *address, socklen_t addressLength);
 int     setsockopt(int socket, int level, int option, const void *value,
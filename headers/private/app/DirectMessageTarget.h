@@ -18,7 +18,7 @@ class BDirectMessageTarget {
 	public:
 		BDirectMessageTarget();
 
-		bool AddMessage(BMessage* message);
+		bool AddMessage(BMessage* message, bool* _wasEmpty = NULL);
 
 		void Close();
 		void Acquire();
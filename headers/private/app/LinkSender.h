@@ -54,12 +54,24 @@ class LinkSender {
 			return Attach(&data, sizeof(Type));
 		}
 
+		status_t SetCommandBuffer(area_id area, void* buffer, size_t size,
+			sem_id consumedSemaphore);
+		area_id CommandBufferArea() const { return fCommandBufferArea; }
+		sem_id CommandBufferSemaphore() const
+			{ return fCommandBufferSemaphore; }
+
+		status_t StartRecording();
+		status_t StopRecording();
+		bool IsRecording() const { return fRecordingNesting > 0; }
+
 	protected:
 		size_t SpaceLeft() const { return fBufferSize - fCurrentEnd; }
 		size_t CurrentMessageSize() const { return fCurrentEnd - fCurrentStart; }
 
 		status_t AdjustBuffer(size_t newBufferSize, char **_oldBuffer = NULL);
 		status_t FlushCompleted(size_t newBufferSize);
+		status_t FlushRecorded(bool rewind,
+			bigtime_t timeout = B_INFINITE_TIMEOUT, bool needsReply = false);
 
 		port_id	fPort;
 		team_id fTargetTeam;
@@ -71,6 +83,18 @@ class LinkSender {
 		uint32	fCurrentStart;		// start of current message
 
 		status_t fCurrentStatus;
+
+		// recording into a buffer shared with the server
+		char	*fSavedBuffer;
+		size_t	fSavedBufferSize;
+
+		area_id	fCommandBufferArea;
+		char	*fCommandBuffer;
+		size_t	fCommandBufferSize;
+		sem_id	fCommandBufferSemaphore;
+		uint32	fCommandBufferPosition;	// where the next recording starts
+		uint32	fSegmentStart;		// start of the commands not yet sent
+		int32	fRecordingNesting;
 };
 
 
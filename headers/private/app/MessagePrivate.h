@@ -18,6 +18,8 @@
 #define MESSAGE_BODY_HASH_TABLE_SIZE	5
 #define MAX_DATA_PREALLOCATION			B_PAGE_SIZE * 10
 #define MAX_FIELD_PREALLOCATION			50
+#define INLINE_BUFFER_SIZE				256
+#define MAX_INLINE_BUFFER_SIZE			B_PAGE_SIZE
 
 
 static const int32 kPortMessageCode = 'pjpp';
@@ -170,6 +172,12 @@ class BMessage::Private {
 			return fMessage->fData;
 		}
 
+		status_t
+		AdoptFlattened(void* buffer, size_t size)
+		{
+			return fMessage->_AdoptFlattened(buffer, size);
+		}
+
 		status_t
 		FlattenToArea(message_header **header) const
 		{
@@ -374,6 +374,10 @@ enum {
 	AS_VIEW_CLIP_TO_RECT,
 	AS_VIEW_CLIP_TO_SHAPE,
 
+	// Drawing commands recorded in memory shared with the server
+	AS_CREATE_COMMAND_BUFFER,
+	AS_EXECUTE_COMMAND_BUFFER,
+
 	AS_LAST_CODE
 };
 
@@ -0,0 +1,107 @@
+/*
+ * Copyright 2026, Haiku, Inc. All Rights Reserved.
+ * Distributed under the terms of the MIT License.
+ */
+#ifndef SHARED_FONT_METRICS_H
+#define SHARED_FONT_METRICS_H
+
+
+#include <SupportDefs.h>
+
+
+/*!	The app_server publishes the advances of the first characters of the
+	fonts that clients measure text with in an area that all clients map
+	read-only, so that BFont can measure text in these fonts without asking
+	the server.
+
+	The metrics of a font are never changed once they are published. When
+	the table is full, or the font settings change, it is emptied; the
+	generation is odd while that happens. Clients have to check that the
+	generation is even, and did not change while they used the metrics.
+*/
+
+
+static const uint32 kSharedFontMetricsVersion = 1;
+
+static const uint32 kSharedFontMetricsCharCount = 256;
+	// the characters U+0000 - U+00FF
+static const uint32 kSharedFontMetricsSlotCount = 256;
+static const uint32 kSharedFontMetricsMaxFonts = 96;
+
+
+struct shared_glyph_metrics {
+	float	advance;
+		// used for B_BITMAP_SPACING and B_FIXED_SPACING
+	float	precise_advance;
+		// used for B_CHAR_SPACING, in units of the font size
+};
+
+struct shared_font_metrics {
+	uint16	family_id;
+	uint16	style_id;
+	float	size;
+	uint16	flags;
+		// the font flags the metrics were taken with
+	uint16	reserved;
+	uint32	missing[kSharedFontMetricsCharCount / 32];
+		// characters without a glyph, they don't advance at all
+	shared_glyph_metrics glyphs[kSharedFontMetricsCharCount];
+};
+
+struct shared_font_metrics_area {
+	uint32	version;
+	int32	generation;
+	int32	count;
+	int32	slots[kSharedFontMetricsSlotCount];
+		// index + 1 of the font in "fonts", or 0
+	shared_font_metrics fonts[kSharedFontMetricsMaxFonts];
+};
+
+
+static inline uint32
+shared_font_metrics_hash(uint16 familyID, uint16 styleID, float size)
+{
+	union {
+		float	size;
+		uint32	bits;
+	} sizeBits;
+	sizeBits.size = size;
+
+	uint32 hash = ((uint32)familyID << 16 | styleID) * 2654435761U;
+	return (hash ^ sizeBits.bits * 40503U) % kSharedFontMetricsSlotCount;
+}
+
+
+static inline bool
+shared_font_metrics_missing(const shared_font_metrics* metrics,
+	uint32 charCode)
+{
+	return (metrics->missing[charCode / 32] & (1UL << (charCode % 32))) != 0;
+}
+
+
+/*!	Returns the published metrics of the given font, if any. */
+static inline const shared_font_metrics*
+find_shared_font_metrics(const shared_font_metrics_area* area,
+	uint16 familyID, uint16 styleID, float size)
+{
+	uint32 slot = shared_font_metrics_hash(familyID, styleID, size);
+	for (uint32 i = 0; i < kSharedFontMetricsSlotCount; i++) {
+		int32 index = atomic_get((int32*)&area->slots[slot]);
+		if (index <= 0 || index > (int32)kSharedFontMetricsMaxFonts)
+			return NULL;
+
+		const shared_font_metrics* metrics = &area->fonts[index - 1];
+		if (metrics->family_id == familyID && metrics->style_id == styleID
+			&& metrics->size == size) {
+			return metrics;
+		}
+
+		slot = (slot + 1) % kSharedFontMetricsSlotCount;
+	}
+
+	return NULL;
+}
+
+
+#endif	// SHARED_FONT_METRICS_H
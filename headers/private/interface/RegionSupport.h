@@ -77,6 +77,11 @@ class BRegion::Support {
 	static	int					XRectInRegion(const BRegion* region,
 									const clipping_rect& rect);
 
+	// A per-thread cache for the rectangle array of a result region, so
+	// that the operations don't need to allocate memory in the common case.
+	static	void				AcquireBuffer(BRegion* region);
+	static	void				RecycleBuffer(BRegion* region);
+
  private:
 	static	BRegion*			CreateRegion();
 	static	void				DestroyRegion(BRegion* r);
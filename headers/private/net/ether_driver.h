@@ -28,6 +28,12 @@ enum {
 
 	ETHER_SEND_NET_BUFFER,					/* send a net_buffer */
 	ETHER_RECEIVE_NET_BUFFER,				/* receive a net_buffer */
+
+	ETHER_GET_RX_QUEUE_COUNT,
+		/* get the number of receive queues (uint32 *) */
+	ETHER_RECEIVE_NET_BUFFER_QUEUE,
+		/* receive a net_buffer from a specific queue
+		   (ether_rx_queue_buffer_t *) */
 };
 
 
@@ -43,4 +49,10 @@ typedef struct ether_link_state {
 	uint64	speed;		/* in bit/s */
 } ether_link_state_t;
 
+/* ETHER_RECEIVE_NET_BUFFER_QUEUE */
+typedef struct ether_rx_queue_buffer {
+	uint32				queue;
+	struct net_buffer*	buffer;
+} ether_rx_queue_buffer_t;
+
 #endif	/* _ETHER_DRIVER_H */
@@ -1,5 +1,5 @@
 /*
- * Copyright 2006-2010, Haiku, Inc. All Rights Reserved.
+ * Copyright 2006-2026, Haiku, Inc. All Rights Reserved.
  * Distributed under the terms of the MIT License.
  */
 #ifndef NET_BUFFER_H
@@ -45,6 +45,7 @@ typedef struct net_buffer {
 } net_buffer;
 
 struct ancillary_data_container;
+struct net_buffer_pool;
 
 struct net_buffer_module_info {
 	module_info info;
@@ -108,6 +109,11 @@ struct net_buffer_module_info {
 	void			(*swap_addresses)(net_buffer* buffer);
 
 	void			(*dump)(net_buffer* buffer);
+
+	struct net_buffer_pool* (*create_pool)(const char* name,
+						size_t headerSpace, size_t dataSize, uint32 count);
+	void			(*delete_pool)(struct net_buffer_pool* pool);
+	net_buffer*		(*create_from_pool)(struct net_buffer_pool* pool);
 };
 
 
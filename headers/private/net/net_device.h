@@ -61,6 +61,11 @@ struct net_device_module_info {
 					const struct sockaddr* address);
 	status_t	(*remove_multicast)(net_device* device,
 					const struct sockaddr* address);
+
+	// optional multi-queue receive support; only valid after up()
+	uint32		(*receive_queue_count)(net_device* device);
+	status_t	(*receive_queue_data)(net_device* device, uint32 queue,
+					net_buffer** _buffer);
 };
 
 
@@ -0,0 +1,300 @@
+/*
+ * Copyright 2026, Haiku, Inc. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+#ifndef FLAT_HASH_MAP_H
+#define FLAT_HASH_MAP_H
+
+
+#include <FlatHashTable.h>
+#include <HashMap.h>
+
+
+namespace BPrivate {
+
+
+// FlatHashMapElement
+template<typename Key, typename Value>
+class FlatHashMapElement {
+public:
+	FlatHashMapElement(const Key& key, const Value& value)
+		:
+		fKey(key),
+		fValue(value)
+	{
+	}
+
+	Key				fKey;
+	Value			fValue;
+};
+
+
+// FlatHashMapTableDefinition
+template<typename Key, typename Value>
+struct FlatHashMapTableDefinition {
+	typedef Key								KeyType;
+	typedef	FlatHashMapElement<Key, Value>	SlotType;
+
+	size_t HashKey(const KeyType& key) const
+		{ return key.GetHashCode(); }
+	const KeyType& GetKey(const SlotType& slot) const
+		{ return slot.fKey; }
+	bool Compare(const KeyType& key, const SlotType& slot) const
+		{ return slot.fKey == key; }
+};
+
+
+/*!	Has the same interface as HashMap, and takes the same keys, but keeps
+	its elements in a FlatHashTable instead of allocating each of them.
+
+	Unlike with HashMap, the value pointers returned by Get() are only valid
+	until the next Put(), or Reserve(). Removing elements, also while
+	iterating, does not move the others.
+*/
+template<typename Key, typename Value>
+class FlatHashMap {
+public:
+	typedef typename HashMap<Key, Value>::Entry Entry;
+
+	class Iterator {
+	public:
+		Iterator(const Iterator& other)
+			:
+			fMap(other.fMap),
+			fIndex(other.fIndex),
+			fNextIndex(other.fNextIndex)
+		{
+		}
+
+		bool HasNext() const
+		{
+			return fNextIndex < fMap->fTable.Capacity();
+		}
+
+		Entry Next()
+		{
+			if (!HasNext()) {
+				fIndex = ElementTable::kInvalidIndex;
+				return Entry();
+			}
+
+			fIndex = fNextIndex;
+			fNextIndex = fMap->fTable.NextIndex(fIndex + 1);
+
+			const Element& element = fMap->fTable.SlotAt(fIndex);
+			return Entry(element.fKey, element.fValue);
+		}
+
+		Iterator& operator=(const Iterator& other)
+		{
+			fMap = other.fMap;
+			fIndex = other.fIndex;
+			fNextIndex = other.fNextIndex;
+			return *this;
+		}
+
+	private:
+		Iterator(const FlatHashMap<Key, Value>* map)
+			:
+			fMap(map),
+			fIndex(ElementTable::kInvalidIndex),
+			fNextIndex(map->fTable.NextIndex(0))
+		{
+		}
+
+	private:
+		friend class FlatHashMap<Key, Value>;
+
+		const FlatHashMap<Key, Value>*	fMap;
+		size_t							fIndex;
+		size_t							fNextIndex;
+	};
+
+	FlatHashMap();
+	~FlatHashMap();
+
+	status_t InitCheck() const;
+
+	status_t Reserve(int32 count);
+
+	status_t Put(const Key& key, const Value& value);
+	Value Remove(const Key& key);
+	Value Remove(Iterator& it);
+	void Clear();
+	Value Get(const Key& key) const;
+	bool Get(const Key& key, Value*& _value) const;
+
+	bool ContainsKey(const Key& key) const;
+
+	int32 Size() const;
+
+	Iterator GetIterator() const;
+
+protected:
+	typedef FlatHashTable<FlatHashMapTableDefinition<Key, Value> >
+		ElementTable;
+	typedef FlatHashMapElement<Key, Value>	Element;
+	friend class Iterator;
+
+protected:
+	ElementTable	fTable;
+};
+
+
+// FlatHashMap
+
+// constructor
+template<typename Key, typename Value>
+FlatHashMap<Key, Value>::FlatHashMap()
+	:
+	fTable()
+{
+}
+
+
+// destructor
+template<typename Key, typename Value>
+FlatHashMap<Key, Value>::~FlatHashMap()
+{
+}
+
+
+// InitCheck
+template<typename Key, typename Value>
+status_t
+FlatHashMap<Key, Value>::InitCheck() const
+{
+	// the table is only allocated with the first element
+	return B_OK;
+}
+
+
+// Reserve
+template<typename Key, typename Value>
+status_t
+FlatHashMap<Key, Value>::Reserve(int32 count)
+{
+	if (count < 0)
+		return B_BAD_VALUE;
+
+	return fTable.Reserve(count);
+}
+
+
+// Put
+template<typename Key, typename Value>
+status_t
+FlatHashMap<Key, Value>::Put(const Key& key, const Value& value)
+{
+	bool inserted;
+	Element* element = fTable.FindOrInsert(key, inserted);
+	if (element == NULL)
+		return B_NO_MEMORY;
+
+	if (inserted)
+		new(element) Element(key, value);
+	else
+		element->fValue = value;
+
+	return B_OK;
+}
+
+
+// Remove
+template<typename Key, typename Value>
+Value
+FlatHashMap<Key, Value>::Remove(const Key& key)
+{
+	size_t index = fTable.Find(key);
+	if (index == ElementTable::kInvalidIndex)
+		return Value();
+
+	Value value = fTable.SlotAt(index).fValue;
+	fTable.RemoveAt(index);
+
+	return value;
+}
+
+
+// Remove
+template<typename Key, typename Value>
+Value
+FlatHashMap<Key, Value>::Remove(Iterator& it)
+{
+	if (it.fIndex == ElementTable::kInvalidIndex)
+		return Value();
+
+	Value value = fTable.SlotAt(it.fIndex).fValue;
+	fTable.RemoveAt(it.fIndex);
+	it.fIndex = ElementTable::kInvalidIndex;
+
+	return value;
+}
+
+
+// Clear
+template<typename Key, typename Value>
+void
+FlatHashMap<Key, Value>::Clear()
+{
+	fTable.Clear();
+}
+
+
+// Get
+template<typename Key, typename Value>
+Value
+FlatHashMap<Key, Value>::Get(const Key& key) const
+{
+	size_t index = fTable.Find(key);
+	if (index != ElementTable::kInvalidIndex)
+		return fTable.SlotAt(index).fValue;
+	return Value();
+}
+
+
+// Get
+template<typename Key, typename Value>
+bool
+FlatHashMap<Key, Value>::Get(const Key& key, Value*& _value) const
+{
+	size_t index = fTable.Find(key);
+	if (index != ElementTable::kInvalidIndex) {
+		_value = &fTable.SlotAt(index).fValue;
+		return true;
+	}
+	return false;
+}
+
+
+// ContainsKey
+template<typename Key, typename Value>
+bool
+FlatHashMap<Key, Value>::ContainsKey(const Key& key) const
+{
+	return fTable.Find(key) != ElementTable::kInvalidIndex;
+}
+
+
+// Size
+template<typename Key, typename Value>
+int32
+FlatHashMap<Key, Value>::Size() const
+{
+	return fTable.Count();
+}
+
+
+// GetIterator
+template<typename Key, typename Value>
+typename FlatHashMap<Key, Value>::Iterator
+FlatHashMap<Key, Value>::GetIterator() const
+{
+	return Iterator(this);
+}
+
+} // namespace BPrivate
+
+using BPrivate::FlatHashMap;
+
+#endif	// FLAT_HASH_MAP_H
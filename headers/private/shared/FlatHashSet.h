@@ -0,0 +1,241 @@
+/*
+ * Copyright 2026, Haiku, Inc. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+#ifndef FLAT_HASH_SET_H
+#define FLAT_HASH_SET_H
+
+
+#include <FlatHashTable.h>
+
+
+namespace BPrivate {
+
+
+// FlatHashSetTableDefinition
+template<typename Key>
+struct FlatHashSetTableDefinition {
+	typedef Key		KeyType;
+	typedef	Key		SlotType;
+
+	size_t HashKey(const KeyType& key) const
+		{ return key.GetHashCode(); }
+	const KeyType& GetKey(const SlotType& slot) const
+		{ return slot; }
+	bool Compare(const KeyType& key, const SlotType& slot) const
+		{ return slot == key; }
+};
+
+
+/*!	Has the same interface as HashSet, but keeps its keys in a FlatHashTable
+	instead of allocating an element for each of them.
+	Removing keys, also while iterating, does not move the others.
+*/
+template<typename Key>
+class FlatHashSet {
+public:
+	class Iterator {
+	public:
+		Iterator(const Iterator& other)
+			:
+			fSet(other.fSet),
+			fIndex(other.fIndex),
+			fNextIndex(other.fNextIndex)
+		{
+		}
+
+		bool HasNext() const
+		{
+			return fNextIndex < fSet->fTable.Capacity();
+		}
+
+		Key Next()
+		{
+			if (!HasNext()) {
+				fIndex = ElementTable::kInvalidIndex;
+				return Key();
+			}
+
+			fIndex = fNextIndex;
+			fNextIndex = fSet->fTable.NextIndex(fIndex + 1);
+
+			return fSet->fTable.SlotAt(fIndex);
+		}
+
+		Iterator& operator=(const Iterator& other)
+		{
+			fSet = other.fSet;
+			fIndex = other.fIndex;
+			fNextIndex = other.fNextIndex;
+			return *this;
+		}
+
+	private:
+		Iterator(const FlatHashSet<Key>* set)
+			:
+			fSet(set),
+			fIndex(ElementTable::kInvalidIndex),
+			fNextIndex(set->fTable.NextIndex(0))
+		{
+		}
+
+	private:
+		friend class FlatHashSet<Key>;
+
+		const FlatHashSet<Key>*	fSet;
+		size_t					fIndex;
+		size_t					fNextIndex;
+	};
+
+	FlatHashSet();
+	~FlatHashSet();
+
+	status_t InitCheck() const;
+
+	status_t Reserve(int32 count);
+
+	status_t Add(const Key& key);
+	bool Remove(const Key& key);
+	bool Remove(Iterator& it);
+	void Clear();
+	bool Contains(const Key& key) const;
+
+	int32 Size() const;
+
+	Iterator GetIterator() const;
+
+protected:
+	typedef FlatHashTable<FlatHashSetTableDefinition<Key> > ElementTable;
+	friend class Iterator;
+
+protected:
+	ElementTable	fTable;
+};
+
+
+// FlatHashSet
+
+// constructor
+template<typename Key>
+FlatHashSet<Key>::FlatHashSet()
+	:
+	fTable()
+{
+}
+
+
+// destructor
+template<typename Key>
+FlatHashSet<Key>::~FlatHashSet()
+{
+}
+
+
+// InitCheck
+template<typename Key>
+status_t
+FlatHashSet<Key>::InitCheck() const
+{
+	// the table is only allocated with the first key
+	return B_OK;
+}
+
+
+// Reserve
+template<typename Key>
+status_t
+FlatHashSet<Key>::Reserve(int32 count)
+{
+	if (count < 0)
+		return B_BAD_VALUE;
+
+	return fTable.Reserve(count);
+}
+
+
+// Add
+template<typename Key>
+status_t
+FlatHashSet<Key>::Add(const Key& key)
+{
+	bool inserted;
+	Key* slot = fTable.FindOrInsert(key, inserted);
+	if (slot == NULL)
+		return B_NO_MEMORY;
+
+	if (inserted)
+		new(slot) Key(key);
+
+	return B_OK;
+}
+
+
+// Remove
+template<typename Key>
+bool
+FlatHashSet<Key>::Remove(const Key& key)
+{
+	size_t index = fTable.Find(key);
+	if (index == ElementTable::kInvalidIndex)
+		return false;
+
+	fTable.RemoveAt(index);
+	return true;
+}
+
+
+// Remove
+template<typename Key>
+bool
+FlatHashSet<Key>::Remove(Iterator& it)
+{
+	if (it.fIndex == ElementTable::kInvalidIndex)
+		return false;
+
+	fTable.RemoveAt(it.fIndex);
+	it.fIndex = ElementTable::kInvalidIndex;
+
+	return true;
+}
+
+
+// Clear
+template<typename Key>
+void
+FlatHashSet<Key>::Clear()
+{
+	fTable.Clear();
+}
+
+
+// Contains
+template<typename Key>
+bool
+FlatHashSet<Key>::Contains(const Key& key) const
+{
+	return fTable.Find(key) != ElementTable::kInvalidIndex;
+}
+
+
+// Size
+template<typename Key>
+int32
+FlatHashSet<Key>::Size() const
+{
+	return fTable.Count();
+}
+
+
+// GetIterator
+template<typename Key>
+typename FlatHashSet<Key>::Iterator
+FlatHashSet<Key>::GetIterator() const
+{
+	return Iterator(this);
+}
+
+} // namespace BPrivate
+
+using BPrivate::FlatHashSet;
+
+#endif	// FLAT_HASH_SET_H
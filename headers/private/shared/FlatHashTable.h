@@ -0,0 +1,426 @@
+/*
+ * Copyright 2026, Haiku, Inc. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+#ifndef FLAT_HASH_TABLE_H
+#define FLAT_HASH_TABLE_H
+
+
+#include <new>
+#include <stdlib.h>
+#include <string.h>
+
+#include <ByteOrder.h>
+#include <SupportDefs.h>
+
+#ifdef __SSE2__
+#	include <emmintrin.h>
+#endif
+
+
+namespace BPrivate {
+
+
+/*!	The control bytes of a group of slots of a FlatHashTable. A control byte
+	is either kEmpty, kDeleted, or, for a used slot, the lower 7 bits of the
+	hash of its key.
+
+	With SSE2, a group is matched with one compare; otherwise, the group is
+	treated as two 64 bit words, in which case Match() may report slots that
+	don't match, but never misses one.
+*/
+class FlatHashGroup {
+public:
+	enum {
+		kSize		= 16,
+		kEmpty		= 0x80,
+		kDeleted	= 0xfe
+	};
+
+	FlatHashGroup(const uint8* control)
+	{
+#ifdef __SSE2__
+		fControl = _mm_loadu_si128((const __m128i*)control);
+#else
+		memcpy(fControl, control, sizeof(fControl));
+		fControl[0] = B_LENDIAN_TO_HOST_INT64(fControl[0]);
+		fControl[1] = B_LENDIAN_TO_HOST_INT64(fControl[1]);
+#endif
+	}
+
+	uint32 Match(uint8 hash) const
+	{
+#ifdef __SSE2__
+		return _mm_movemask_epi8(_mm_cmpeq_epi8(fControl,
+			_mm_set1_epi8((char)hash)));
+#else
+		uint64 pattern = kLowBits * hash;
+		return _ToMask(_MatchZero(fControl[0] ^ pattern),
+			_MatchZero(fControl[1] ^ pattern));
+#endif
+	}
+
+	uint32 MatchEmpty() const
+	{
+#ifdef __SSE2__
+		return _mm_movemask_epi8(_mm_cmpeq_epi8(fControl,
+			_mm_set1_epi8((char)kEmpty)));
+#else
+		// only kEmpty has the highest bit set, and the second lowest cleared
+		return _ToMask(fControl[0] & ~(fControl[0] << 6) & kHighBits,
+			fControl[1] & ~(fControl[1] << 6) & kHighBits);
+#endif
+	}
+
+	uint32 MatchEmptyOrDeleted() const
+	{
+#ifdef __SSE2__
+		return _mm_movemask_epi8(fControl);
+#else
+		return _ToMask(fControl[0] & kHighBits, fControl[1] & kHighBits);
+#endif
+	}
+
+	static int32 LowestBit(uint32 mask)
+	{
+#if __GNUC__ > 2
+		return __builtin_ctz(mask);
+#else
+		int32 bit = 0;
+		while ((mask & 1) == 0) {
+			mask >>= 1;
+			bit++;
+		}
+		return bit;
+#endif
+	}
+
+private:
+#ifndef __SSE2__
+	static const uint64 kLowBits = 0x0101010101010101ULL;
+	static const uint64 kHighBits = 0x8080808080808080ULL;
+
+	static uint64 _MatchZero(uint64 word)
+	{
+		// sets the highest bit of the bytes that are zero, and possibly of
+		// some above them, but only of those that are below 0x80
+		return (word - kLowBits) & ~word & kHighBits;
+	}
+
+	static uint32 _ToMask(uint64 low, uint64 high)
+	{
+		// gathers the highest bit of each byte into one byte
+		return (uint32)(((low >> 7) * 0x0102040810204080ULL) >> 56)
+			| (uint32)(((high >> 7) * 0x0102040810204080ULL) >> 56) << 8;
+	}
+#endif
+
+private:
+#ifdef __SSE2__
+	__m128i		fControl;
+#else
+	uint64		fControl[2];
+#endif
+};
+
+
+/*!	An open addressing hash table that stores its slots inline, in one
+	allocation, in the style of Abseil's SwissTable. Besides the slots, there
+	is a control byte per slot, and lookups compare a group of 16 of them at
+	once against the lower 7 bits of the hash, so that the keys only have to
+	be compared on a likely match, and an empty slot ends the search.
+
+	Removed slots are marked deleted rather than empty, unless their group
+	was never full, so that the search for other keys isn't cut short. The
+	table grows, or is cleaned of deleted slots, when it is 7/8 full.
+
+	The definition is like that of BOpenHashTable, but hashes and compares
+	slots instead of linked values:
+
+	struct Definition {
+		typedef int		KeyType;
+		typedef	Foo		SlotType;
+
+		size_t HashKey(const KeyType& key) const;
+		const KeyType& GetKey(const SlotType& slot) const;
+		bool Compare(const KeyType& key, const SlotType& slot) const;
+	};
+
+	The slots are moved, that is, copied and destroyed, when the table is
+	resized, so pointers to them are only valid until the next insertion.
+*/
+template<typename Definition>
+class FlatHashTable {
+public:
+	typedef typename Definition::KeyType	KeyType;
+	typedef typename Definition::SlotType	SlotType;
+
+	static const size_t kInvalidIndex = ~(size_t)0;
+
+	FlatHashTable()
+		:
+		fControl(NULL),
+		fSlots(NULL),
+		fCapacity(0),
+		fCount(0),
+		fGrowthLeft(0)
+	{
+	}
+
+	FlatHashTable(const Definition& definition)
+		:
+		fDefinition(definition),
+		fControl(NULL),
+		fSlots(NULL),
+		fCapacity(0),
+		fCount(0),
+		fGrowthLeft(0)
+	{
+	}
+
+	~FlatHashTable()
+	{
+		Clear();
+	}
+
+	/*!	Makes room for \a count slots, so that they can be inserted without
+		resizing the table.
+	*/
+	status_t Reserve(size_t count)
+	{
+		size_t capacity = FlatHashGroup::kSize;
+		while (_MaxCount(capacity) < count) {
+			if (capacity > ~(size_t)0 / 2)
+				return B_NO_MEMORY;
+			capacity *= 2;
+		}
+
+		if (capacity <= fCapacity)
+			return B_OK;
+
+		return _Resize(capacity);
+	}
+
+	//!	Destroys all slots, and frees the memory of the table.
+	void Clear()
+	{
+		for (size_t i = 0; i < fCapacity; i++) {
+			if (_IsUsed(i))
+				fSlots[i].~SlotType();
+		}
+
+		free(fControl);
+		fControl = NULL;
+		fSlots = NULL;
+		fCapacity = 0;
+		fCount = 0;
+		fGrowthLeft = 0;
+	}
+
+	size_t Find(const KeyType& key) const
+	{
+		if (fCapacity == 0)
+			return kInvalidIndex;
+
+		return _Find(key, _Hash(key));
+	}
+
+	/*!	Returns the slot of \a key. If there was none, \a _inserted is set to
+		\c true, and the returned slot is not constructed yet; the caller has
+		to construct it with \a key right away.
+		Returns \c NULL if the table could not be resized.
+	*/
+	SlotType* FindOrInsert(const KeyType& key, bool& _inserted)
+	{
+		uint32 hash = _Hash(key);
+
+		if (fCapacity != 0) {
+			size_t index = _Find(key, hash);
+			if (index != kInvalidIndex) {
+				_inserted = false;
+				return &fSlots[index];
+			}
+		}
+
+		size_t index = fCapacity != 0 ? _FindFree(hash) : 0;
+		if (fCapacity == 0
+			|| (fControl[index] == FlatHashGroup::kEmpty && fGrowthLeft == 0)) {
+			// only grow if most of the used slots are not deleted ones
+			size_t capacity = FlatHashGroup::kSize;
+			if (fCapacity != 0) {
+				capacity = fCount < _MaxCount(fCapacity) / 2
+					? fCapacity : fCapacity * 2;
+			}
+			if (_Resize(capacity) != B_OK)
+				return NULL;
+
+			index = _FindFree(hash);
+		}
+
+		if (fControl[index] == FlatHashGroup::kEmpty)
+			fGrowthLeft--;
+		fControl[index] = hash & 0x7f;
+		fCount++;
+
+		_inserted = true;
+		return &fSlots[index];
+	}
+
+	void RemoveAt(size_t index)
+	{
+		fSlots[index].~SlotType();
+		fCount--;
+
+		size_t group = index & ~(size_t)(FlatHashGroup::kSize - 1);
+		if (FlatHashGroup(fControl + group).MatchEmpty() != 0) {
+			// no search went past this group yet
+			fControl[index] = FlatHashGroup::kEmpty;
+			fGrowthLeft++;
+		} else
+			fControl[index] = FlatHashGroup::kDeleted;
+	}
+
+	//!	Returns the index of the first used slot at or after \a index.
+	size_t NextIndex(size_t index) const
+	{
+		while (index < fCapacity && !_IsUsed(index))
+			index++;
+		return index;
+	}
+
+	SlotType& SlotAt(size_t index) const
+	{
+		return fSlots[index];
+	}
+
+	size_t Count() const
+	{
+		return fCount;
+	}
+
+	size_t Capacity() const
+	{
+		return fCapacity;
+	}
+
+private:
+	FlatHashTable(const FlatHashTable& other);
+	FlatHashTable& operator=(const FlatHashTable& other);
+
+	static size_t _MaxCount(size_t capacity)
+	{
+		return capacity - capacity / 8;
+	}
+
+	bool _IsUsed(size_t index) const
+	{
+		return (fControl[index] & 0x80) == 0;
+	}
+
+	uint32 _Hash(const KeyType& key) const
+	{
+		// The hash codes of the keys are often just their value, so they
+		// are mixed, as the table uses the lower bits of the hash for the
+		// control bytes, and the others for the position
+		uint64 hash = (uint64)fDefinition.HashKey(key)
+			* 0x9e3779b97f4a7c15ULL;
+		return (uint32)(hash ^ (hash >> 32));
+	}
+
+	size_t _Find(const KeyType& key, uint32 hash) const
+	{
+		size_t groupMask = fCapacity / FlatHashGroup::kSize - 1;
+		size_t group = (hash >> 7) & groupMask;
+
+		for (size_t step = 1; step <= groupMask + 1; step++) {
+			size_t base = group * FlatHashGroup::kSize;
+			FlatHashGroup controlGroup(fControl + base);
+
+			uint32 match = controlGroup.Match(hash & 0x7f);
+			while (match != 0) {
+				size_t index = base + FlatHashGroup::LowestBit(match);
+				if (fDefinition.Compare(key, fSlots[index]))
+					return index;
+				match &= match - 1;
+			}
+
+			if (controlGroup.MatchEmpty() != 0)
+				break;
+
+			group = (group + step) & groupMask;
+		}
+
+		return kInvalidIndex;
+	}
+
+	size_t _FindFree(uint32 hash) const
+	{
+		// There is always a free slot, as the table is never full
+		size_t groupMask = fCapacity / FlatHashGroup::kSize - 1;
+		size_t group = (hash >> 7) & groupMask;
+
+		for (size_t step = 1; ; step++) {
+			size_t base = group * FlatHashGroup::kSize;
+			uint32 free = FlatHashGroup(fControl + base).MatchEmptyOrDeleted();
+			if (free != 0)
+				return base + FlatHashGroup::LowestBit(free);
+
+			group = (group + step) & groupMask;
+		}
+	}
+
+	status_t _Resize(size_t capacity)
+	{
+		if (capacity > ~(size_t)0 / (sizeof(SlotType) + 1))
+			return B_NO_MEMORY;
+
+		// The slots follow the control bytes; since the capacity is a
+		// multiple of the group size, they are aligned like malloc()'s
+		uint8* control = (uint8*)malloc(capacity * (sizeof(SlotType) + 1));
+		if (control == NULL)
+			return B_NO_MEMORY;
+
+		memset(control, FlatHashGroup::kEmpty, capacity);
+
+		uint8* oldControl = fControl;
+		SlotType* oldSlots = fSlots;
+		size_t oldCapacity = fCapacity;
+
+		fControl = control;
+		fSlots = (SlotType*)(control + capacity);
+		fCapacity = capacity;
+
+		for (size_t i = 0; i < oldCapacity; i++) {
+			if ((oldControl[i] & 0x80) != 0)
+				continue;
+
+			uint32 hash = _Hash(fDefinition.GetKey(oldSlots[i]));
+			size_t index = _FindFree(hash);
+			new(&fSlots[index]) SlotType(oldSlots[i]);
+			fControl[index] = hash & 0x7f;
+			oldSlots[i].~SlotType();
+		}
+
+		free(oldControl);
+
+		fGrowthLeft = _MaxCount(capacity) - fCount;
+		return B_OK;
+	}
+
+private:
+	Definition		fDefinition;
+	uint8*			fControl;
+	SlotType*		fSlots;
+	size_t			fCapacity;
+	size_t			fCount;
+	size_t			fGrowthLeft;
+};
+
+
+}	// namespace BPrivate
+
+
+using BPrivate::FlatHashTable;
+
+
+#endif	// FLAT_HASH_TABLE_H
@@ -47,11 +47,16 @@ private:
 
 			status_t			StreamChar(char c);
 
+			status_t			FlushBuffer();
+
 			BDataIO*			fDataIO;
 			BJsonTextWriterStackedEventListener*
 								fStackedListener;
 
-			char				fUnicodeAssemblyBuffer[7];
+			char				fUnicodeAssemblyBuffer[12];
+
+			char				fBuffer[4096];
+			size_t				fBufferLength;
 
 };
 
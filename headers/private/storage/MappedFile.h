@@ -0,0 +1,96 @@
+/*
+ * Copyright 2026, Haiku, Inc.
+ * Distributed under the terms of the MIT License.
+ */
+#ifndef _MAPPED_FILE_H
+#define _MAPPED_FILE_H
+
+
+#include <DataIO.h>
+
+
+struct entry_ref;
+
+
+enum mapped_file_access {
+	B_MAPPED_FILE_ACCESS_NORMAL		= 0,
+	B_MAPPED_FILE_ACCESS_SEQUENTIAL,
+	B_MAPPED_FILE_ACCESS_RANDOM,
+	B_MAPPED_FILE_ACCESS_WILL_NEED
+};
+
+
+class BMappedFile : public BPositionIO {
+public:
+								BMappedFile();
+								BMappedFile(const char* path,
+									mapped_file_access access
+										= B_MAPPED_FILE_ACCESS_NORMAL);
+								BMappedFile(const entry_ref* ref,
+									mapped_file_access access
+										= B_MAPPED_FILE_ACCESS_NORMAL);
+								BMappedFile(int fd, bool keepFd,
+									mapped_file_access access
+										= B_MAPPED_FILE_ACCESS_NORMAL);
+	virtual						~BMappedFile();
+
+			status_t			SetTo(const char* path,
+									mapped_file_access access
+										= B_MAPPED_FILE_ACCESS_NORMAL);
+			status_t			SetTo(const entry_ref* ref,
+									mapped_file_access access
+										= B_MAPPED_FILE_ACCESS_NORMAL);
+			status_t			SetTo(int fd, bool keepFd,
+									mapped_file_access access
+										= B_MAPPED_FILE_ACCESS_NORMAL);
+			void				Unset();
+
+			status_t			InitCheck() const;
+
+			mapped_file_access	Access() const;
+			void				SetAccess(mapped_file_access access);
+
+			size_t				WindowSize() const;
+			void				SetWindowSize(size_t size);
+
+			const void*			DataAt(off_t position, size_t size);
+									// valid until the next call
+
+	virtual	ssize_t				Read(void* buffer, size_t size);
+	virtual	ssize_t				Write(const void* buffer, size_t size);
+
+	virtual	ssize_t				ReadAt(off_t position, void* buffer,
+									size_t size);
+	virtual	ssize_t				WriteAt(off_t position, const void* buffer,
+									size_t size);
+
+	virtual	off_t				Seek(off_t position, uint32 seekMode);
+	virtual	off_t				Position() const;
+
+	virtual	status_t			SetSize(off_t size);
+	virtual	status_t			GetSize(off_t* size) const;
+
+private:
+								BMappedFile(const BMappedFile& other);
+			BMappedFile&		operator=(const BMappedFile& other);
+
+			status_t			_MapWindow(off_t position, size_t size);
+			void				_Unmap();
+			void				_Advise();
+
+private:
+			int					fFD;
+			bool				fOwnsFD;
+			status_t			fInitStatus;
+			off_t				fSize;
+			off_t				fPosition;
+			mapped_file_access	fAccess;
+
+			size_t				fWindowSize;
+			uint8*				fWindow;
+			off_t				fWindowOffset;
+			size_t				fWindowLength;
+};
+
+
+#endif	// _MAPPED_FILE_H
@@ -0,0 +1,249 @@
+/*
+ * Copyright 2026, Haiku, Inc. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+#ifndef _SUPPORT_SMALL_STRING_H
+#define _SUPPORT_SMALL_STRING_H
+
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+#include <String.h>
+
+
+/*!	A string that keeps up to \a InlineSize - 1 bytes in the object itself,
+	and only allocates memory for longer ones. Meant for the many short
+	strings, like MIME types, attribute, or field names, that are built,
+	compared, and thrown away again, and for which a BString would have to
+	allocate memory every time.
+
+	Unlike BString, the contents are never shared between copies.
+*/
+template<int32 InlineSize = 32>
+class BSmallString {
+public:
+	BSmallString()
+		:
+		fData(fBuffer),
+		fLength(0),
+		fCapacity(InlineSize)
+	{
+		fBuffer[0] = '\0';
+	}
+
+	BSmallString(const char* string, int32 maxLength = INT32_MAX)
+		:
+		fData(fBuffer),
+		fLength(0),
+		fCapacity(InlineSize)
+	{
+		fBuffer[0] = '\0';
+		SetTo(string, maxLength);
+	}
+
+	BSmallString(const BString& string)
+		:
+		fData(fBuffer),
+		fLength(0),
+		fCapacity(InlineSize)
+	{
+		fBuffer[0] = '\0';
+		SetTo(string.String(), string.Length());
+	}
+
+	BSmallString(const BSmallString& other)
+		:
+		fData(fBuffer),
+		fLength(0),
+		fCapacity(InlineSize)
+	{
+		fBuffer[0] = '\0';
+		SetTo(other.fData, other.fLength);
+	}
+
+	~BSmallString()
+	{
+		if (fData != fBuffer)
+			free(fData);
+	}
+
+	BSmallString& operator=(const BSmallString& other)
+	{
+		if (this != &other)
+			SetTo(other.fData, other.fLength);
+		return *this;
+	}
+
+	BSmallString& operator=(const char* string)
+	{
+		SetTo(string);
+		return *this;
+	}
+
+	BSmallString& operator+=(const char* string)
+	{
+		Append(string);
+		return *this;
+	}
+
+	BSmallString& operator+=(char c)
+	{
+		Append(&c, 1);
+		return *this;
+	}
+
+	//!	Sets the string to at most \a maxLength bytes of \a string.
+	status_t SetTo(const char* string, int32 maxLength = INT32_MAX)
+	{
+		if (string == NULL)
+			maxLength = 0;
+		int32 length = maxLength > 0 ? strnlen(string, maxLength) : 0;
+		if (!_Reserve(length))
+			return B_NO_MEMORY;
+
+		memmove(fData, string, length);
+		fLength = length;
+		fData[fLength] = '\0';
+		return B_OK;
+	}
+
+	status_t Append(const char* string, int32 maxLength = INT32_MAX)
+	{
+		if (string == NULL)
+			return B_OK;
+		int32 length = maxLength > 0 ? strnlen(string, maxLength) : 0;
+
+		// the string might be part of ourselves, and move with the data
+		bool isOwnData = string >= fData && string <= fData + fLength;
+		int32 offset = string - fData;
+		if (!_Reserve(fLength + length))
+			return B_NO_MEMORY;
+		if (isOwnData)
+			string = fData + offset;
+
+		memcpy(fData + fLength, string, length);
+		fLength += length;
+		fData[fLength] = '\0';
+		return B_OK;
+	}
+
+	void Truncate(int32 newLength)
+	{
+		if (newLength >= 0 && newLength < fLength) {
+			fLength = newLength;
+			fData[fLength] = '\0';
+		}
+	}
+
+	void MakeEmpty()
+	{
+		Truncate(0);
+	}
+
+	const char* String() const
+	{
+		return fData;
+	}
+
+	int32 Length() const
+	{
+		return fLength;
+	}
+
+	bool IsEmpty() const
+	{
+		return fLength == 0;
+	}
+
+	//!	Returns whether the string is kept in the object itself.
+	bool IsInline() const
+	{
+		return fData == fBuffer;
+	}
+
+	char operator[](int32 index) const
+	{
+		return fData[index];
+	}
+
+	int Compare(const char* string) const
+	{
+		return strcmp(fData, string != NULL ? string : "");
+	}
+
+	int ICompare(const char* string) const
+	{
+		return strcasecmp(fData, string != NULL ? string : "");
+	}
+
+	bool operator==(const char* string) const
+	{
+		return Compare(string) == 0;
+	}
+
+	bool operator!=(const char* string) const
+	{
+		return Compare(string) != 0;
+	}
+
+	bool operator<(const char* string) const
+	{
+		return Compare(string) < 0;
+	}
+
+	bool operator==(const BSmallString& other) const
+	{
+		return fLength == other.fLength
+			&& memcmp(fData, other.fData, fLength) == 0;
+	}
+
+	bool operator!=(const BSmallString& other) const
+	{
+		return !(*this == other);
+	}
+
+	bool operator<(const BSmallString& other) const
+	{
+		return Compare(other.fData) < 0;
+	}
+
+	BString ToString() const
+	{
+		return BString(fData, fLength);
+	}
+
+private:
+	bool _Reserve(int32 length)
+	{
+		if (length < fCapacity)
+			return true;
+
+		int32 capacity = fCapacity * 2;
+		if (capacity <= length)
+			capacity = length + 1;
+
+		char* data = (char*)malloc(capacity);
+		if (data == NULL)
+			return false;
+
+		memcpy(data, fData, fLength + 1);
+		if (fData != fBuffer)
+			free(fData);
+
+		fData = data;
+		fCapacity = capacity;
+		return true;
+	}
+
+private:
+	char*	fData;
+	int32	fLength;
+	int32	fCapacity;
+	char	fBuffer[InlineSize];
+};
+
+
+#endif	// _SUPPORT_SMALL_STRING_H
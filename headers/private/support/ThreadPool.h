@@ -0,0 +1,197 @@
+/*
+ * Copyright 2026, Haiku, Inc.
+ * Distributed under the terms of the MIT License.
+ */
+#ifndef _SUPPORT_PRIVATE_THREAD_POOL_H_
+#define _SUPPORT_PRIVATE_THREAD_POOL_H_
+
+
+#include <new>
+
+#include <Locker.h>
+#include <OS.h>
+#include <SupportDefs.h>
+
+
+namespace BSupportKit {
+
+
+class BJob;
+
+
+namespace BPrivate {
+
+
+class JobQueue;
+class TaskGroup;
+class ThreadPool;
+
+
+enum task_priority {
+	TASK_PRIORITY_LOW		= 0,
+	TASK_PRIORITY_NORMAL,
+	TASK_PRIORITY_HIGH
+};
+
+
+class Task {
+public:
+								Task();
+	virtual						~Task();
+
+	virtual	void				Run() = 0;
+
+			bool				IsCanceled() const;
+									// whether the group of the task was
+									// canceled, for tasks that are running
+
+private:
+			friend class TaskGroup;
+			friend class ThreadPool;
+
+			TaskGroup*			fGroup;
+			Task*				fNext;
+};
+
+
+template<typename Function>
+class FunctionTask : public Task {
+public:
+	FunctionTask(const Function& function)
+		:
+		fFunction(function)
+	{
+	}
+
+	virtual void Run()
+	{
+		fFunction();
+	}
+
+private:
+	Function	fFunction;
+};
+
+
+class TaskGroup {
+public:
+								TaskGroup(ThreadPool& pool);
+								~TaskGroup();
+									// waits for the tasks of the group
+
+			status_t			Spawn(Task* task,
+									task_priority priority
+										= TASK_PRIORITY_NORMAL);
+									// takes ownership
+			template<typename Function>
+			status_t			SpawnFunction(const Function& function,
+									task_priority priority
+										= TASK_PRIORITY_NORMAL);
+			status_t			Spawn(BJob* job,
+									task_priority priority
+										= TASK_PRIORITY_NORMAL);
+									// doesn't take ownership
+
+			void				Wait();
+
+			void				Cancel();
+			bool				IsCanceled() const;
+
+private:
+			friend class ThreadPool;
+
+			void				_TaskDone();
+
+private:
+			ThreadPool&			fPool;
+			int32				fPendingCount;
+			int32				fNotifyingCount;
+			int32				fCanceled;
+			sem_id				fDoneSemaphore;
+};
+
+
+class ThreadPool {
+public:
+								ThreadPool(const char* name = "thread pool",
+									int32 workerCount = -1,
+									int32 threadPriority = B_NORMAL_PRIORITY);
+									// -1 workers means one per CPU
+								~ThreadPool();
+
+			status_t			InitCheck() const;
+
+			int32				CountWorkers() const;
+			bool				IsWorkerThread() const;
+
+			status_t			Submit(Task* task,
+									task_priority priority
+										= TASK_PRIORITY_NORMAL);
+									// takes ownership
+
+			status_t			RunJobs(JobQueue& queue);
+									// runs all jobs of the queue, and
+									// deletes them
+
+private:
+			friend class TaskGroup;
+
+			struct Worker;
+			class JobTask;
+			class JobQueueTask;
+
+			enum {
+				kPriorityCount = TASK_PRIORITY_HIGH + 1
+			};
+
+private:
+			status_t			_Init(const char* name, int32 workerCount,
+									int32 threadPriority);
+
+			status_t			_Enqueue(Task* task, task_priority priority);
+			Task*				_NextTask(Worker* worker);
+			Task*				_DequeueQueued(task_priority minPriority);
+			Task*				_Steal(Worker* thief);
+			void				_RunTask(Task* task);
+			void				_DiscardTask(Task* task);
+			void				_WakeUpWorker();
+			Worker*				_CurrentWorker() const;
+
+	static	status_t			_WorkerLoop(void* data);
+
+private:
+			BLocker				fLock;
+			Task*				fQueueHeads[kPriorityCount];
+			Task*				fQueueTails[kPriorityCount];
+			int32				fQueuedCounts[kPriorityCount];
+
+			Worker*				fWorkers;
+			int32				fWorkerCount;
+			sem_id				fWakeUpSemaphore;
+			int32				fIdleCount;
+			int32				fStealIndex;
+			int32				fQuit;
+
+			status_t			fInitStatus;
+};
+
+
+template<typename Function>
+status_t
+TaskGroup::SpawnFunction(const Function& function,
+	task_priority priority)
+{
+	Task* task = new(std::nothrow) FunctionTask<Function>(function);
+	if (task == NULL)
+		return B_NO_MEMORY;
+
+	return Spawn(task, priority);
+}
+
+
+}	// namespace BPrivate
+
+}	// namespace BSupportKit
+
+
+#endif // _SUPPORT_PRIVATE_THREAD_POOL_H_
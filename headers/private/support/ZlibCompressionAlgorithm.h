@@ -35,10 +35,14 @@ public:
 			bool				IsGzipFormat() const;
 			void				SetGzipFormat(bool gzipFormat);
 
+			int32				WorkerCount() const;
+			void				SetWorkerCount(int32 count);
+
 private:
 			int32				fCompressionLevel;
 			size_t				fBufferSize;
 			bool				fGzipFormat;
+			int32				fWorkerCount;
 };
 
 
@@ -88,6 +92,9 @@ private:
 			template<typename BaseClass, typename Strategy>
 				friend struct Stream;
 
+			class ParallelCompressingStream;
+			friend class ParallelCompressingStream;
+
 private:
 	static	status_t			_TranslateZlibError(int error);
 };
@@ -32,9 +32,28 @@ public:
 			size_t				BufferSize() const;
 			void				SetBufferSize(size_t size);
 
+			int32				WorkerCount() const;
+			void				SetWorkerCount(int32 count);
+
+			bool				LongDistanceMatching() const;
+			void				SetLongDistanceMatching(bool enabled);
+
+			int32				WindowLog() const;
+			void				SetWindowLog(int32 windowLog);
+
+			const void*			Dictionary() const;
+			size_t				DictionarySize() const;
+			void				SetDictionary(const void* dictionary,
+									size_t size);
+
 private:
 			int32				fCompressionLevel;
 			size_t				fBufferSize;
+			int32				fWorkerCount;
+			int32				fWindowLog;
+			bool				fLongDistanceMatching;
+			const void*			fDictionary;
+			size_t				fDictionarySize;
 };
 
 
@@ -46,8 +65,19 @@ public:
 			size_t				BufferSize() const;
 			void				SetBufferSize(size_t size);
 
+			int32				MaxWindowLog() const;
+			void				SetMaxWindowLog(int32 windowLog);
+
+			const void*			Dictionary() const;
+			size_t				DictionarySize() const;
+			void				SetDictionary(const void* dictionary,
+									size_t size);
+
 private:
 			size_t				fBufferSize;
+			int32				fMaxWindowLog;
+			const void*			fDictionary;
+			size_t				fDictionarySize;
 };
 
 
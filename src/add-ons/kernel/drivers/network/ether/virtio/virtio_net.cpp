@@ -30,6 +30,8 @@
 
 #define BUFFER_SIZE	2048
 #define MAX_FRAME_SIZE 1536
+#define MAX_RX_QUEUES	16
+#define RX_DATA_SIZE	(BUFFER_SIZE - sizeof(virtio_net_rx_hdr))
 
 
 struct virtio_net_rx_hdr {
@@ -52,13 +54,31 @@ struct BufInfo : DoublyLinkedListLinkImpl<BufInfo> {
 	physical_entry			entry;
 	physical_entry			hdrEntry;
 	uint32					rxUsedLength;
+	net_buffer*				netBuffer;
+		// pooled buffer the device receives into, if any
 };
 
 
 typedef DoublyLinkedList<BufInfo> BufInfoList;
 
 
-typedef struct {
+struct virtio_net_driver_info;
+
+
+struct RxQueue {
+	virtio_net_driver_info*	info;
+	uint32					index;
+	::virtio_queue			queue;
+	uint16					size;
+
+	BufInfo**				bufInfos;
+	sem_id					done;
+	BufInfoList				fullList;
+	mutex					lock;
+};
+
+
+typedef struct virtio_net_driver_info {
 	device_node*			node;
 	::virtio_device			virtio_device;
 	virtio_device_interface*	virtio;
@@ -66,15 +86,12 @@ typedef struct {
 	uint64 					features;
 
 	uint32					pairsCount;
+	uint32					rxQueueCount;
+		// the receive queues the device actually steers packets to
 
-	::virtio_queue*			rxQueues;
-	uint16*					rxSizes;
-
-	BufInfo**				rxBufInfos;
-	sem_id					rxDone;
+	RxQueue*				rxQueues;
 	area_id					rxArea;
-	BufInfoList				rxFullList;
-	mutex					rxLock;
+	net_buffer_pool*		rxPool;
 
 	::virtio_queue*			txQueues;
 	uint16*					txSizes;
@@ -189,31 +206,60 @@ virtio_net_drain_queues(virtio_net_driver_info* info)
 	while (info->virtio->queue_dequeue(info->txQueues[0], (void**)&buf, NULL))
 		info->txFreeList.Add(buf);
 
-	while (info->virtio->queue_dequeue(info->rxQueues[0], NULL, NULL))
-		;
-
-	while (info->rxFullList.RemoveHead() != NULL)
-		;
+	for (uint32 i = 0; i < info->pairsCount; i++) {
+		RxQueue& rxQueue = info->rxQueues[i];
+		while (info->virtio->queue_dequeue(rxQueue.queue, NULL, NULL))
+			;
+
+		while (rxQueue.fullList.RemoveHead() != NULL)
+			;
+
+		for (int j = 0; j < rxQueue.size; j++) {
+			BufInfo* buf = rxQueue.bufInfos[j];
+			if (buf->netBuffer != NULL) {
+				sBufferModule->free(buf->netBuffer);
+				buf->netBuffer = NULL;
+			}
+		}
+	}
 
 	return B_OK;
 }
 
 
 static status_t
-virtio_net_rx_enqueue_buf(virtio_net_driver_info* info, BufInfo* buf)
+virtio_net_rx_enqueue_buf(RxQueue* rxQueue, BufInfo* buf)
 {
 	CALLED();
 	physical_entry entries[2];
 	entries[0] = buf->hdrEntry;
 	entries[1] = buf->entry;
 
+	if (rxQueue->info->rxPool != NULL && buf->netBuffer == NULL) {
+		// Let the device write the frame directly into a pooled net_buffer;
+		// if the pool is exhausted, we use our own buffer and copy instead.
+		net_buffer* buffer = sBufferModule->create_from_pool(
+			rxQueue->info->rxPool);
+		void* data = NULL;
+		if (buffer != NULL
+			&& sBufferModule->append_size(buffer, RX_DATA_SIZE, &data) == B_OK
+			&& data != NULL
+			&& get_memory_map(data, RX_DATA_SIZE, &entries[1], 1) == B_OK) {
+			buf->netBuffer = buffer;
+		} else if (buffer != NULL) {
+			sBufferModule->free(buffer);
+			entries[1] = buf->entry;
+		}
+	}
+
 	memset(buf->hdr, 0, sizeof(struct virtio_net_hdr));
 
 	// queue the rx buffer
-	status_t status = info->virtio->queue_request_v(info->rxQueues[0],
+	status_t status = rxQueue->info->virtio->queue_request_v(rxQueue->queue,
 		entries, 0, 2, buf);
 	if (status != B_OK) {
-		ERROR("rx queueing on queue %d failed (%s)\n", 0, strerror(status));
+		ERROR("rx queueing on queue %" B_PRIu32 " failed (%s)\n",
+			rxQueue->index, strerror(status));
 		return status;
 	}
 
@@ -263,6 +309,48 @@ virtio_net_ctrl_exec_cmd(virtio_net_driver_info* info, int cmd, bool value)
 }
 
 
+static status_t
+virtio_net_ctrl_set_pairs(virtio_net_driver_info* info, uint16 pairs)
+{
+	struct {
+		struct virtio_net_ctrl_hdr hdr;
+		uint8 pad1;
+		struct virtio_net_ctrl_mq mq;
+		uint8 pad2;
+		uint8 ack;
+	} s __attribute__((aligned(2)));
+
+	s.hdr.net_class = VIRTIO_NET_CTRL_MQ;
+	s.hdr.cmd = VIRTIO_NET_CTRL_MQ_VQ_PAIRS_SET;
+	s.mq.virtqueue_pairs = pairs;
+	s.ack = VIRTIO_NET_ERR;
+
+	physical_entry entries[3];
+	status_t status = get_memory_map(&s.hdr, sizeof(s.hdr), &entries[0], 1);
+	if (status != B_OK)
+		return status;
+	status = get_memory_map(&s.mq, sizeof(s.mq), &entries[1], 1);
+	if (status != B_OK)
+		return status;
+	status = get_memory_map(&s.ack, sizeof(s.ack), &entries[2], 1);
+	if (status != B_OK)
+		return status;
+
+	if (!info->virtio->queue_is_empty(info->ctrlQueue))
+		return B_ERROR;
+
+	status = info->virtio->queue_request_v(info->ctrlQueue, entries, 2, 1,
+		NULL);
+	if (status != B_OK)
+		return status;
+
+	while (!info->virtio->queue_dequeue(info->ctrlQueue, NULL, NULL))
+		spin(10);
+
+	return s.ack == VIRTIO_NET_OK ? B_OK : B_IO_ERROR;
+}
+
+
 static status_t
 virtio_net_set_promisc(virtio_net_driver_info* info, bool on)
 {
@@ -297,70 +385,100 @@ virtio_net_init_device(void* _info, void** _cookie)
 	info->virtio->negotiate_features(info->virtio_device,
 		VIRTIO_NET_F_STATUS | VIRTIO_NET_F_MAC | VIRTIO_NET_F_MTU
 			| VIRTIO_NET_F_CTRL_VQ | VIRTIO_NET_F_CTRL_RX | VIRTIO_NET_F_GUEST_CSUM
-			/* | VIRTIO_NET_F_MQ */,
+			| VIRTIO_NET_F_MQ,
 		&info->features, &get_feature_name);
 
+	// The control queue always follows the last possible queue pair, even if
+	// we do not use all of them.
+	uint16 maxPairs = 1;
 	if ((info->features & VIRTIO_NET_F_MQ) != 0
 			&& (info->features & VIRTIO_NET_F_CTRL_VQ) != 0
 			&& info->virtio->read_device_config(info->virtio_device,
 				offsetof(struct virtio_net_config, max_virtqueue_pairs),
-				&info->pairsCount, sizeof(info->pairsCount)) == B_OK) {
+				&maxPairs, sizeof(maxPairs)) == B_OK
+			&& maxPairs >= VIRTIO_NET_CTRL_MQ_VQ_PAIRS_MIN) {
+		if (maxPairs > VIRTIO_NET_CTRL_MQ_VQ_PAIRS_MAX) {
+			ERROR("invalid number of queue pairs %" B_PRIu16 "\n", maxPairs);
+			return B_BAD_DATA;
+		}
+		info->pairsCount = min_c(maxPairs, MAX_RX_QUEUES);
 		system_info sysinfo;
 		if (get_system_info(&sysinfo) == B_OK
 			&& info->pairsCount > sysinfo.cpu_count) {
 			info->pairsCount = sysinfo.cpu_count;
 		}
-	} else
+	} else {
+		maxPairs = 1;
 		info->pairsCount = 1;
-
-	// TODO read config
+	}
 
 	// Setup queues
-	uint32 queueCount = info->pairsCount * 2;
+	uint32 queueCount = maxPairs * 2;
 	if ((info->features & VIRTIO_NET_F_CTRL_VQ) != 0)
 		queueCount++;
-	::virtio_queue virtioQueues[queueCount];
+	// there may be many more queues than we use, so this can't be on the stack
+	::virtio_queue* virtioQueues = (::virtio_queue*)malloc(
+		sizeof(::virtio_queue) * queueCount);
+	if (virtioQueues == NULL)
+		return B_NO_MEMORY;
 	status_t status = info->virtio->alloc_queues(info->virtio_device, queueCount,
 		virtioQueues, NULL);
 	if (status != B_OK) {
 		ERROR("queue allocation failed (%s)\n", strerror(status));
+		free(virtioQueues);
 		return status;
 	}
 
 	char* rxBuffer;
 	char* txBuffer;
+	size_t rxBufferCount = 0;
 
-	info->rxQueues = new(std::nothrow) virtio_queue[info->pairsCount];
+	info->rxQueues = new(std::nothrow) RxQueue[info->pairsCount];
 	info->txQueues = new(std::nothrow) virtio_queue[info->pairsCount];
-	info->rxSizes = new(std::nothrow) uint16[info->pairsCount];
 	info->txSizes = new(std::nothrow) uint16[info->pairsCount];
 	if (info->rxQueues == NULL || info->txQueues == NULL
-		|| info->rxSizes == NULL || info->txSizes == NULL) {
+		|| info->txSizes == NULL) {
+		free(virtioQueues);
 		status = B_NO_MEMORY;
 		goto err1;
 	}
 	for (uint32 i = 0; i < info->pairsCount; i++) {
-		info->rxQueues[i] = virtioQueues[i * 2];
+		RxQueue& rxQueue = info->rxQueues[i];
+		rxQueue.info = info;
+		rxQueue.index = i;
+		rxQueue.queue = virtioQueues[i * 2];
+		rxQueue.size = info->virtio->queue_size(rxQueue.queue) / 2;
+		rxQueue.bufInfos = NULL;
+		rxQueue.done = -1;
+		rxBufferCount += rxQueue.size;
+
 		info->txQueues[i] = virtioQueues[i * 2 + 1];
-		info->rxSizes[i] = info->virtio->queue_size(info->rxQueues[i]) / 2;
 		info->txSizes[i] = info->virtio->queue_size(info->txQueues[i]) / 2;
 	}
 	if ((info->features & VIRTIO_NET_F_CTRL_VQ) != 0)
-		info->ctrlQueue = virtioQueues[info->pairsCount * 2];
+		info->ctrlQueue = virtioQueues[maxPairs * 2];
+	free(virtioQueues);
 
-	info->rxBufInfos = new(std::nothrow) BufInfo*[info->rxSizes[0]];
+	for (uint32 i = 0; i < info->pairsCount; i++) {
+		RxQueue& rxQueue = info->rxQueues[i];
+		rxQueue.bufInfos = new(std::nothrow) BufInfo*[rxQueue.size];
+		if (rxQueue.bufInfos == NULL) {
+			status = B_NO_MEMORY;
+			goto err2;
+		}
+		memset(rxQueue.bufInfos, 0, sizeof(BufInfo*) * rxQueue.size);
+	}
 	info->txBufInfos = new(std::nothrow) BufInfo*[info->txSizes[0]];
-	if (info->rxBufInfos == NULL || info->txBufInfos == NULL) {
+	if (info->txBufInfos == NULL) {
 		status = B_NO_MEMORY;
 		goto err2;
 	}
-	memset(info->rxBufInfos, 0, sizeof(BufInfo*) * info->rxSizes[0]);
 	memset(info->txBufInfos, 0, sizeof(BufInfo*) * info->txSizes[0]);
 
-	// create receive buffer area
+	// create receive buffer area, shared by all receive queues
 	info->rxArea = create_area("virtionet rx buffer", (void**)&rxBuffer,
 		B_ANY_KERNEL_BLOCK_ADDRESS, ROUND_TO_PAGE_SIZE(
-			BUFFER_SIZE * info->rxSizes[0]),
+			BUFFER_SIZE * rxBufferCount),
 		B_FULL_LOCK, B_KERNEL_READ_AREA | B_KERNEL_WRITE_AREA);
 	if (info->rxArea < B_OK) {
 		status = info->rxArea;
@@ -368,27 +486,31 @@ virtio_net_init_device(void* _info, void** _cookie)
 	}
 
 	// initialize receive buffer descriptors
-	for (int i = 0; i < info->rxSizes[0]; i++) {
-		BufInfo* buf = new(std::nothrow) BufInfo;
-		if (buf == NULL) {
-			status = B_NO_MEMORY;
-			goto err4;
-		}
-
-		info->rxBufInfos[i] = buf;
-		buf->hdr = (struct virtio_net_hdr*)((addr_t)rxBuffer
-			+ i * BUFFER_SIZE);
-		buf->buffer = (char*)((addr_t)buf->hdr + sizeof(virtio_net_rx_hdr));
-
-		status = get_memory_map(buf->buffer,
-			BUFFER_SIZE - sizeof(virtio_net_rx_hdr), &buf->entry, 1);
-		if (status != B_OK)
-			goto err4;
+	for (uint32 q = 0; q < info->pairsCount; q++) {
+		RxQueue& rxQueue = info->rxQueues[q];
+		for (int i = 0; i < rxQueue.size; i++) {
+			BufInfo* buf = new(std::nothrow) BufInfo;
+			if (buf == NULL) {
+				status = B_NO_MEMORY;
+				goto err4;
+			}
 
-		status = get_memory_map(buf->hdr, sizeof(struct virtio_net_hdr),
-			&buf->hdrEntry, 1);
-		if (status != B_OK)
-			goto err4;
+			rxQueue.bufInfos[i] = buf;
+			buf->netBuffer = NULL;
+			buf->hdr = (struct virtio_net_hdr*)rxBuffer;
+			buf->buffer = (char*)((addr_t)buf->hdr + sizeof(virtio_net_rx_hdr));
+			rxBuffer += BUFFER_SIZE;
+
+			status = get_memory_map(buf->buffer,
+				BUFFER_SIZE - sizeof(virtio_net_rx_hdr), &buf->entry, 1);
+			if (status != B_OK)
+				goto err4;
+
+			status = get_memory_map(buf->hdr, sizeof(struct virtio_net_hdr),
+				&buf->hdrEntry, 1);
+			if (status != B_OK)
+				goto err4;
+		}
 	}
 
 	// create transmit buffer area
@@ -427,7 +549,8 @@ virtio_net_init_device(void* _info, void** _cookie)
 		info->txFreeList.Add(buf);
 	}
 
-	mutex_init(&info->rxLock, "virtionet rx lock");
+	for (uint32 i = 0; i < info->pairsCount; i++)
+		mutex_init(&info->rxQueues[i].lock, "virtionet rx lock");
 	mutex_init(&info->txLock, "virtionet tx lock");
 
 	// Setup interrupt
@@ -437,11 +560,13 @@ virtio_net_init_device(void* _info, void** _cookie)
 		goto err6;
 	}
 
-	status = info->virtio->queue_setup_interrupt(info->rxQueues[0],
-		virtio_net_rxDone, info);
-	if (status != B_OK) {
-		ERROR("queue interrupt setup failed (%s)\n", strerror(status));
-		goto err6;
+	for (uint32 i = 0; i < info->pairsCount; i++) {
+		status = info->virtio->queue_setup_interrupt(info->rxQueues[i].queue,
+			virtio_net_rxDone, &info->rxQueues[i]);
+		if (status != B_OK) {
+			ERROR("queue interrupt setup failed (%s)\n", strerror(status));
+			goto err6;
+		}
 	}
 
 	status = info->virtio->queue_setup_interrupt(info->txQueues[0],
@@ -460,6 +585,27 @@ virtio_net_init_device(void* _info, void** _cookie)
 		}
 	}
 
+	info->rxQueueCount = 1;
+	if ((info->features & VIRTIO_NET_F_MQ) != 0 && info->pairsCount > 1) {
+		// let the device steer flows across the receive queues we use
+		status = virtio_net_ctrl_set_pairs(info, info->pairsCount);
+		if (status == B_OK)
+			info->rxQueueCount = info->pairsCount;
+		else {
+			ERROR("setting %" B_PRIu32 " queue pairs failed (%s)\n",
+				info->pairsCount, strerror(status));
+		}
+	}
+
+	// Receive buffers from this pool are filled by the device directly and
+	// passed up the stack without copying. There are twice as many as fit
+	// into the receive queues, so that the queues can be refilled while
+	// the stack is still holding on to received frames.
+	info->rxPool = sBufferModule->create_pool("virtionet rx pool", 0,
+		RX_DATA_SIZE, rxBufferCount * 2);
+	if (info->rxPool == NULL)
+		ERROR("could not create receive buffer pool, copying frames\n");
+
 	*_cookie = info;
 	return B_OK;
 
@@ -469,17 +615,19 @@ err6:
 err5:
 	delete_area(info->txArea);
 err4:
-	for (int i = 0; i < info->rxSizes[0]; i++)
-		delete info->rxBufInfos[i];
+	for (uint32 q = 0; q < info->pairsCount; q++) {
+		for (int i = 0; i < info->rxQueues[q].size; i++)
+			delete info->rxQueues[q].bufInfos[i];
+	}
 err3:
 	delete_area(info->rxArea);
 err2:
-	delete[] info->rxBufInfos;
+	for (uint32 i = 0; i < info->pairsCount; i++)
+		delete[] info->rxQueues[i].bufInfos;
 	delete[] info->txBufInfos;
 err1:
 	delete[] info->rxQueues;
 	delete[] info->txQueues;
-	delete[] info->rxSizes;
 	delete[] info->txSizes;
 	return status;
 }
@@ -493,7 +641,6 @@ virtio_net_uninit_device(void* _cookie)
 
 	info->virtio->free_interrupts(info->virtio_device);
 
-	mutex_destroy(&info->rxLock);
 	mutex_destroy(&info->txLock);
 
 	while (true) {
@@ -502,17 +649,20 @@ virtio_net_uninit_device(void* _cookie)
 			break;
 	}
 
-	for (int i = 0; i < info->rxSizes[0]; i++) {
-		delete info->rxBufInfos[i];
+	for (uint32 q = 0; q < info->pairsCount; q++) {
+		RxQueue& rxQueue = info->rxQueues[q];
+		mutex_destroy(&rxQueue.lock);
+		for (int i = 0; i < rxQueue.size; i++)
+			delete rxQueue.bufInfos[i];
+		delete[] rxQueue.bufInfos;
 	}
 	for (int i = 0; i < info->txSizes[0]; i++) {
 		delete info->txBufInfos[i];
 	}
+	sBufferModule->delete_pool(info->rxPool);
 	delete_area(info->rxArea);
 	delete_area(info->txArea);
-	delete[] info->rxBufInfos;
 	delete[] info->txBufInfos;
-	delete[] info->rxSizes;
 	delete[] info->txSizes;
 	delete[] info->rxQueues;
 	delete[] info->txQueues;
@@ -534,9 +684,13 @@ virtio_net_open(void* _info, const char* path, int openMode, void** _cookie)
 
 	info->nonblocking = (openMode & O_NONBLOCK) != 0;
 	info->maxframesize = MAX_FRAME_SIZE;
-	info->rxDone = create_sem(0, "virtio_net_rx");
+	for (uint32 i = 0; i < info->pairsCount; i++) {
+		info->rxQueues[i].done = create_sem(0, "virtio_net_rx");
+		if (info->rxQueues[i].done < B_OK)
+			goto error;
+	}
 	info->txDone = create_sem(1, "virtio_net_tx");
-	if (info->rxDone < B_OK || info->txDone < B_OK)
+	if (info->txDone < B_OK)
 		goto error;
 	handle->info = info;
 
@@ -561,16 +715,22 @@ virtio_net_open(void* _info, const char* path, int openMode, void** _cookie)
 		dprintf("virtio_net: no mtu feature\n");
 	}
 
-	for (int i = 0; i < info->rxSizes[0]; i++)
-		virtio_net_rx_enqueue_buf(info, info->rxBufInfos[i]);
+	for (uint32 q = 0; q < info->pairsCount; q++) {
+		RxQueue& rxQueue = info->rxQueues[q];
+		for (int i = 0; i < rxQueue.size; i++)
+			virtio_net_rx_enqueue_buf(&rxQueue, rxQueue.bufInfos[i]);
+	}
 
 	*_cookie = handle;
 	return B_OK;
 
 error:
-	delete_sem(info->rxDone);
+	for (uint32 i = 0; i < info->pairsCount; i++) {
+		delete_sem(info->rxQueues[i].done);
+		info->rxQueues[i].done = -1;
+	}
 	delete_sem(info->txDone);
-	info->rxDone = info->txDone = -1;
+	info->txDone = -1;
 	free(handle);
 	return B_ERROR;
 }
@@ -583,9 +743,12 @@ virtio_net_close(void* cookie)
 	CALLED();
 
 	virtio_net_driver_info* info = handle->info;
-	delete_sem(info->rxDone);
+	for (uint32 i = 0; i < info->pairsCount; i++) {
+		delete_sem(info->rxQueues[i].done);
+		info->rxQueues[i].done = -1;
+	}
 	delete_sem(info->txDone);
-	info->rxDone = info->txDone = -1;
+	info->txDone = -1;
 
 	return B_OK;
 }
@@ -608,41 +771,46 @@ static void
 virtio_net_rxDone(void* driverCookie, void* cookie)
 {
 	CALLED();
-	virtio_net_driver_info* info = (virtio_net_driver_info*)cookie;
+	RxQueue* rxQueue = (RxQueue*)cookie;
 
-	release_sem_etc(info->rxDone, 1, B_DO_NOT_RESCHEDULE);
+	release_sem_etc(rxQueue->done, 1, B_DO_NOT_RESCHEDULE);
 }
 
 
 static status_t
-virtio_net_receive(void* cookie, net_buffer** _buffer)
+virtio_net_receive(void* cookie, uint32 queue, net_buffer** _buffer)
 {
 	CALLED();
 	virtio_net_handle* handle = (virtio_net_handle*)cookie;
 	virtio_net_driver_info* info = handle->info;
 
-	MutexLocker rxLocker(info->rxLock);
-	while (info->rxFullList.Head() == NULL) {
+	if (queue >= info->rxQueueCount)
+		return B_BAD_INDEX;
+
+	RxQueue* rxQueue = &info->rxQueues[queue];
+
+	MutexLocker rxLocker(rxQueue->lock);
+	while (rxQueue->fullList.Head() == NULL) {
 		rxLocker.Unlock();
 
 		if (info->nonblocking)
 			return B_WOULD_BLOCK;
 		TRACE("virtio_net_read: waiting\n");
-		status_t status = acquire_sem(info->rxDone);
+		status_t status = acquire_sem(rxQueue->done);
 		if (status != B_OK) {
 			ERROR("acquire_sem(rxDone) failed (%s)\n", strerror(status));
 			return status;
 		}
 		int32 semCount = 0;
-		get_sem_count(info->rxDone, &semCount);
+		get_sem_count(rxQueue->done, &semCount);
 		if (semCount > 0)
-			acquire_sem_etc(info->rxDone, semCount, B_RELATIVE_TIMEOUT, 0);
+			acquire_sem_etc(rxQueue->done, semCount, B_RELATIVE_TIMEOUT, 0);
 
 		rxLocker.Lock();
-		while (info->rxDone != -1) {
+		while (rxQueue->done != -1) {
 			uint32 usedLength = 0;
 			BufInfo* buf = NULL;
-			if (!info->virtio->queue_dequeue(info->rxQueues[0], (void**)&buf,
+			if (!info->virtio->queue_dequeue(rxQueue->queue, (void**)&buf,
 					&usedLength) || buf == NULL) {
 				break;
 			}
@@ -651,25 +819,33 @@ virtio_net_receive(void* cookie, net_buffer** _buffer)
 				buf->rxUsedLength = usedLength - sizeof(virtio_net_hdr);
 			else
 				buf->rxUsedLength = 0;
-			info->rxFullList.Add(buf);
+			rxQueue->fullList.Add(buf);
 		}
 		TRACE("virtio_net_read: finished waiting\n");
 	}
 
-	net_buffer* buffer = sBufferModule->create(0);
-	if (buffer == NULL)
-		return B_NO_MEMORY;
-
-	BufInfo* buf = info->rxFullList.RemoveHead();
+	BufInfo* buf = rxQueue->fullList.RemoveHead();
 	rxLocker.Unlock();
 
-	if (sBufferModule->append(buffer, buf->buffer, buf->rxUsedLength) != B_OK) {
-		sBufferModule->free(buffer);
-		buffer = NULL;
+	net_buffer* buffer = buf->netBuffer;
+	buf->netBuffer = NULL;
+	if (buffer != NULL) {
+		// the device has already written the frame into the buffer
+		if (sBufferModule->trim(buffer, buf->rxUsedLength) != B_OK) {
+			sBufferModule->free(buffer);
+			buffer = NULL;
+		}
+	} else {
+		buffer = sBufferModule->create(0);
+		if (buffer != NULL && sBufferModule->append(buffer, buf->buffer,
+				buf->rxUsedLength) != B_OK) {
+			sBufferModule->free(buffer);
+			buffer = NULL;
+		}
 	}
 	const uint8_t flags = buf->hdr->flags;
 	rxLocker.Lock();
-	virtio_net_rx_enqueue_buf(info, buf);
+	virtio_net_rx_enqueue_buf(rxQueue, buf);
 	rxLocker.Unlock();
 
 	if (buffer == NULL)
@@ -924,7 +1100,26 @@ virtio_net_ioctl(void* cookie, uint32 op, void* buffer, size_t length)
 				return B_BAD_DATA;
 			if (!IS_KERNEL_ADDRESS(buffer))
 				return B_BAD_ADDRESS;
-			return virtio_net_receive(cookie, (net_buffer**)buffer);
+			return virtio_net_receive(cookie, 0, (net_buffer**)buffer);
+
+		case ETHER_GET_RX_QUEUE_COUNT:
+			TRACE("ioctl: get rx queue count\n");
+			if (length != sizeof(info->rxQueueCount))
+				return B_BAD_VALUE;
+
+			return user_memcpy(buffer, &info->rxQueueCount,
+				sizeof(info->rxQueueCount));
+
+		case ETHER_RECEIVE_NET_BUFFER_QUEUE:
+		{
+			if (buffer == NULL || length != sizeof(ether_rx_queue_buffer))
+				return B_BAD_DATA;
+			if (!IS_KERNEL_ADDRESS(buffer))
+				return B_BAD_ADDRESS;
+			ether_rx_queue_buffer* request = (ether_rx_queue_buffer*)buffer;
+			return virtio_net_receive(cookie, request->queue,
+				&request->buffer);
+		}
 
 		case SIOCGIFSTATS:
 			break;
@@ -33,11 +33,15 @@
 struct ethernet_device : net_device, DoublyLinkedListLinkImpl<ethernet_device> {
 	int		fd;
 	uint32	frame_size;
+	uint32	receive_queue_count;
 	bool	supports_net_buffer;
+	net_buffer_pool* receive_pool;
 };
 
 static const bigtime_t kLinkCheckInterval = 1000000;
 	// 1 second
+static const size_t kReceiveHeaderSpace = 256;
+static const uint32 kReceivePoolSize = 256;
 
 net_buffer_module_info *gBufferModule;
 static net_stack_module_info *sStackModule;
@@ -163,8 +167,11 @@ ethernet_init(const char *name, net_device **_device)
 
 
 status_t
-ethernet_uninit(net_device *device)
+ethernet_uninit(net_device *_device)
 {
+	ethernet_device *device = (ethernet_device *)_device;
+
+	gBufferModule->delete_pool(device->receive_pool);
 	put_module(NET_BUFFER_MODULE_NAME);
 	delete device;
 
@@ -199,6 +206,17 @@ ethernet_up(net_device *_device)
 		device->frame_size = ETHER_MAX_FRAME_SIZE;
 	}
 
+	device->receive_queue_count = 1;
+	if (device->supports_net_buffer) {
+		uint32 queueCount;
+		if (ioctl(device->fd, ETHER_GET_RX_QUEUE_COUNT, &queueCount,
+				sizeof(uint32)) == 0 && queueCount > 1) {
+			device->receive_queue_count = queueCount;
+			dprintf("%s: %" B_PRIu32 " receive queues\n", device->name,
+				queueCount);
+		}
+	}
+
 #if 1
 	// The network stack does not handle path MTU discovery correctly at present,
 	// so don't report frame sizes larger than the standard ethernet maximum.
@@ -207,6 +225,15 @@ ethernet_up(net_device *_device)
 		device->frame_size = ETHER_MAX_FRAME_SIZE;
 #endif
 
+	if (!device->supports_net_buffer && device->receive_pool == NULL) {
+		// Frames are read into buffers from a pool of full sized ones, which
+		// saves allocating their data headers on every receive.
+		// It's fine if this fails, we'll just allocate all of them, then.
+		device->receive_pool = gBufferModule->create_pool(
+			"ethernet receive pool", kReceiveHeaderSpace, device->frame_size,
+			kReceivePoolSize);
+	}
+
 	if (update_link_state(device, false) == B_OK) {
 		// device supports retrieval of the link state
 
@@ -339,7 +366,11 @@ ethernet_receive_data(net_device *_device, net_buffer **_buffer)
 	// read/write only works for standard ethernet frames. For larger frames,
 	// the driver should support send/receive of net_buffers directly, above.
 
-	net_buffer *buffer = gBufferModule->create(256);
+	net_buffer *buffer = NULL;
+	if (device->receive_pool != NULL)
+		buffer = gBufferModule->create_from_pool(device->receive_pool);
+	if (buffer == NULL)
+		buffer = gBufferModule->create(kReceiveHeaderSpace);
 	if (buffer == NULL)
 		return ENOBUFS;
 
@@ -376,6 +407,41 @@ err:
 }
 
 
+uint32
+ethernet_receive_queue_count(net_device *_device)
+{
+	ethernet_device *device = (ethernet_device *)_device;
+	return device->receive_queue_count;
+}
+
+
+status_t
+ethernet_receive_queue_data(net_device *_device, uint32 queue,
+	net_buffer **_buffer)
+{
+	ethernet_device *device = (ethernet_device *)_device;
+
+	if (device->fd == -1)
+		return B_FILE_ERROR;
+
+	if (device->receive_queue_count <= 1)
+		return ethernet_receive_data(_device, _buffer);
+
+	if (queue >= device->receive_queue_count)
+		return B_BAD_INDEX;
+
+	ether_rx_queue_buffer request;
+	request.queue = queue;
+	request.buffer = NULL;
+	if (ioctl(device->fd, ETHER_RECEIVE_NET_BUFFER_QUEUE, &request,
+			sizeof(request)) != 0)
+		return errno;
+
+	*_buffer = request.buffer;
+	return B_OK;
+}
+
+
 status_t
 ethernet_set_mtu(net_device *_device, size_t mtu)
 {
@@ -509,6 +575,8 @@ net_device_module_info sEthernetModule = {
 	ethernet_set_media,
 	ethernet_add_multicast,
 	ethernet_remove_multicast,
+	ethernet_receive_queue_count,
+	ethernet_receive_queue_data,
 };
 
 module_info *modules[] = {
@@ -28,6 +28,7 @@
 #include <algorithm>
 #include <netinet/in.h>
 #include <netinet/ip.h>
+#include <netinet/udp.h>
 #include <new>
 #include <stdlib.h>
 #include <string.h>
@@ -100,6 +101,9 @@ public:
 			status_t			SendData(net_buffer* buffer);
 			ssize_t				SendAvailable();
 
+			status_t			SetSegmentSize(int size);
+			int					SegmentSize() const { return fSegmentSize; }
+
 			ssize_t				BytesAvailable();
 			status_t			FetchData(size_t numBytes, uint32 flags,
 									net_buffer** _buffer);
@@ -125,6 +129,7 @@ private:
 
 			UdpEndpoint*		fLink;
 			uint32				fFlags;
+			uint16				fSegmentSize;
 };
 
 
@@ -957,7 +962,8 @@ UdpEndpoint::UdpEndpoint(net_socket *socket)
 	:
 	DatagramSocket<>("udp endpoint", socket),
 	fActive(false),
-	fFlags(0)
+	fFlags(0),
+	fSegmentSize(0)
 {
 }
 
@@ -1101,10 +1107,35 @@ UdpEndpoint::SendData(net_buffer *buffer)
 	if (status != B_OK)
 		return status;
 
+	// With UDP_SEGMENT set, a single large send is split into datagrams of
+	// the segment size; only the last one may be shorter.
+	while (fSegmentSize != 0 && buffer->size > fSegmentSize) {
+		net_buffer* segment = gBufferModule->split(buffer, fSegmentSize);
+		if (segment == NULL)
+			return B_NO_MEMORY;
+
+		status = gDatalinkModule->send_data(this, NULL, segment);
+		if (status != B_OK) {
+			gBufferModule->free(segment);
+			return status;
+		}
+	}
+
 	return gDatalinkModule->send_data(this, NULL, buffer);
 }
 
 
+status_t
+UdpEndpoint::SetSegmentSize(int size)
+{
+	if (size < 0 || size > (int)(0xffff - sizeof(udp_header)))
+		return B_BAD_VALUE;
+
+	fSegmentSize = size;
+	return B_OK;
+}
+
+
 ssize_t
 UdpEndpoint::SendAvailable()
 {
@@ -1263,6 +1294,17 @@ status_t
 udp_getsockopt(net_protocol *protocol, int level, int option, void *value,
 	int *length)
 {
+	if (level == IPPROTO_UDP) {
+		if (option != UDP_SEGMENT)
+			return B_BAD_VALUE;
+
+		if (*length != sizeof(int))
+			return B_BAD_VALUE;
+
+		*(int *)value = ((UdpEndpoint *)protocol)->SegmentSize();
+		return B_OK;
+	}
+
 	return protocol->next->module->getsockopt(protocol->next, level, option,
 		value, length);
 }
@@ -1272,6 +1314,15 @@ status_t
 udp_setsockopt(net_protocol *protocol, int level, int option,
 	const void *value, int length)
 {
+	if (level == IPPROTO_UDP) {
+		if (option != UDP_SEGMENT)
+			return B_BAD_VALUE;
+		if (length != sizeof(int))
+			return B_BAD_VALUE;
+
+		return ((UdpEndpoint *)protocol)->SetSegmentSize(*(const int *)value);
+	}
+
 	return protocol->next->module->setsockopt(protocol->next, level, option,
 		value, length);
 }
@@ -391,10 +391,11 @@ datalink_send_routed_data(struct net_route* route, net_buffer* buffer)
 		if (atomic_get(&interface->DeviceInterface()->monitor_count) > 0)
 			device_interface_monitor_receive(interface->DeviceInterface(), buffer);
 
-		// this one goes back to the domain directly
+		// this one goes back to the domain directly; the buffer has not
+		// been deframed, so it cannot be steered by flow
 		const size_t packetSize = buffer->size;
 		status_t status = fifo_enqueue_buffer(
-			&interface->DeviceInterface()->receive_queue, buffer);
+			&interface->DeviceInterface()->consumers[0].queue, buffer);
 		update_device_send_stats(interface->DeviceInterface()->device,
 			status, packetSize);
 		return status;
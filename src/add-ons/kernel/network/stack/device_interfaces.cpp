@@ -16,7 +16,10 @@
 #include <net_device.h>
 
 #include <lock.h>
+#include <smp.h>
+#include <thread.h>
 #include <util/AutoLock.h>
+#include <util/ThreadAutoLock.h>
 
 #include <KernelExport.h>
 
@@ -41,20 +44,131 @@ static DeviceInterfaceList sInterfaces;
 static uint32 sDeviceIndex;
 
 
-/*!	A service thread for each device interface. It just reads as many packets
-	as available, deframes them, and puts them into the receive queue of the
-	device interface.
+/*!	Binds the calling thread to the given CPU, so that the reader and
+	consumer threads of a receive queue share the caches of a single CPU.
+*/
+static void
+bind_current_thread_to_cpu(int32 cpu)
+{
+	Thread* thread = thread_get_current_thread();
+
+	ThreadLocker locker(thread);
+	thread->cpumask.ClearAll();
+	thread->cpumask.SetBit(cpu);
+	bool reschedule = thread->cpu->cpu_num != cpu;
+	locker.Unlock();
+
+	if (reschedule)
+		thread_yield();
+}
+
+
+/*!	Computes a hash over the addresses and ports of a deframed IPv4 or IPv6
+	packet, so that all packets of a single flow end up with the same value.
+	Returns 0 for anything that is not IP.
+*/
+static uint32
+device_flow_hash(net_buffer* buffer)
+{
+	uint32 words[10];
+	uint32 count = 0;
+	uint8 protocol;
+	size_t headerLength;
+
+	if (buffer->type == B_NET_FRAME_TYPE_IPV4) {
+		uint8 header[20];
+		if (gNetBufferModule.read(buffer, 0, header, sizeof(header)) != B_OK)
+			return 0;
+
+		memcpy(&words[0], header + 12, 8);
+			// source and destination address
+		count = 2;
+		protocol = header[9];
+		headerLength = (header[0] & 0xf) << 2;
+
+		// do not look at the ports of fragments
+		if ((ntohs(*(uint16*)(header + 6)) & 0x3fff) != 0)
+			protocol = 0;
+	} else if (buffer->type == B_NET_FRAME_TYPE_IPV6) {
+		uint8 header[40];
+		if (gNetBufferModule.read(buffer, 0, header, sizeof(header)) != B_OK)
+			return 0;
+
+		memcpy(&words[0], header + 8, 32);
+			// source and destination address
+		count = 8;
+		protocol = header[6];
+		headerLength = sizeof(header);
+	} else
+		return 0;
+
+	if (protocol == IPPROTO_TCP || protocol == IPPROTO_UDP) {
+		if (gNetBufferModule.read(buffer, headerLength, &words[count], 4)
+				== B_OK)
+			count++;
+	}
+	words[count++] = protocol;
+
+	// Jenkins one-at-a-time over 32 bit words
+	uint32 hash = 0;
+	for (uint32 i = 0; i < count; i++) {
+		hash += words[i];
+		hash += hash << 10;
+		hash ^= hash >> 6;
+	}
+	hash += hash << 3;
+	hash ^= hash >> 11;
+	hash += hash << 15;
+
+	return hash;
+}
+
+
+/*!	Chooses the consumer that will handle the \a buffer. Buffers of
+	multi-queue devices stay with the consumer belonging to their receive
+	queue, as the hardware already steered them by flow. For single-queue
+	devices, this implements software receive packet steering, and picks
+	the consumer by the flow hash of the packet.
+*/
+static net_device_consumer*
+steer_buffer(net_device_interface* interface, net_device_reader* reader,
+	net_buffer* buffer)
+{
+	if (interface->consumer_count == 1)
+		return &interface->consumers[0];
+
+	if (reader != NULL && interface->reader_count > 1) {
+		return &interface->consumers[
+			reader->index % interface->consumer_count];
+	}
+
+	return &interface->consumers[
+		device_flow_hash(buffer) % interface->consumer_count];
+}
+
+
+/*!	A service thread for each receive queue of a device interface. It just
+	reads as many packets as available, deframes them, and puts them into
+	the receive queue of the consumer responsible for their flow.
 */
 static status_t
-device_reader_thread(void* _interface)
+device_reader_thread(void* _reader)
 {
-	net_device_interface* interface = (net_device_interface*)_interface;
+	net_device_reader* reader = (net_device_reader*)_reader;
+	net_device_interface* interface = reader->interface;
 	net_device* device = interface->device;
 	status_t status = B_OK;
 
+	if (interface->reader_count > 1)
+		bind_current_thread_to_cpu(reader->index % smp_get_num_cpus());
+
 	while ((device->flags & IFF_UP) != 0) {
 		net_buffer* buffer;
-		status = device->module->receive_data(device, &buffer);
+		if (interface->reader_count > 1) {
+			status = device->module->receive_queue_data(device, reader->index,
+				&buffer);
+		} else
+			status = device->module->receive_data(device, &buffer);
 		if (status == B_OK) {
 			// feed device monitors
 			if (atomic_get(&interface->monitor_count) > 0)
@@ -68,8 +182,11 @@ device_reader_thread(void* _interface)
 				continue;
 			}
 
+			net_device_consumer* consumer = steer_buffer(interface, reader,
+				buffer);
+
 			const size_t packetSize = buffer->size;
-			status = fifo_enqueue_buffer(&interface->receive_queue, buffer);
+			status = fifo_enqueue_buffer(&consumer->queue, buffer);
 			if (status == B_OK) {
 				atomic_add((int32*)&device->stats.receive.packets, 1);
 				atomic_add64((int64*)&device->stats.receive.bytes, packetSize);
@@ -94,14 +211,18 @@ device_reader_thread(void* _interface)
 
 
 static status_t
-device_consumer_thread(void* _interface)
+device_consumer_thread(void* _consumer)
 {
-	net_device_interface* interface = (net_device_interface*)_interface;
+	net_device_consumer* consumer = (net_device_consumer*)_consumer;
+	net_device_interface* interface = consumer->interface;
 	net_device* device = interface->device;
 	net_buffer* buffer;
 
+	if (interface->consumer_count > 1)
+		bind_current_thread_to_cpu(consumer->index % smp_get_num_cpus());
+
 	while (atomic_get(&interface->ref_count) > 0) {
-		ssize_t status = fifo_dequeue_buffer(&interface->receive_queue, 0,
+		ssize_t status = fifo_dequeue_buffer(&consumer->queue, 0,
 			B_INFINITE_TIMEOUT, &buffer);
 		if (status != B_OK) {
 			if (status == B_INTERRUPTED)
@@ -186,13 +307,8 @@ allocate_device_interface(net_device* device, net_device_module_info* module)
 	recursive_lock_init(&interface->receive_lock, "device interface receive");
 	recursive_lock_init(&interface->monitor_lock, "device interface monitors");
 
-	char name[128];
-	snprintf(name, sizeof(name), "%s receive queue", device->name);
-
-	if (init_fifo(&interface->receive_queue, name, 16 * 1024 * 1024) < B_OK)
-		goto error1;
-
 	interface->device = device;
+	interface->reader_count = 0;
 	interface->up_count = 0;
 	interface->ref_count = 1;
 	interface->busy = false;
@@ -200,14 +316,43 @@ allocate_device_interface(net_device* device, net_device_module_info* module)
 	interface->deframe_func = NULL;
 	interface->deframe_ref_count = 0;
 
-	snprintf(name, sizeof(name), "%s consumer", device->name);
+	// one consumer per CPU, so that received packets can be steered by flow
+	interface->consumer_count = min_c((uint32)smp_get_num_cpus(),
+		MAX_DEVICE_RECEIVE_QUEUES);
+
+	uint32 count = 0;
+	for (; count < interface->consumer_count; count++) {
+		net_device_consumer& consumer = interface->consumers[count];
+		consumer.interface = interface;
+		consumer.index = count;
+
+		char name[128];
+		if (interface->consumer_count > 1) {
+			snprintf(name, sizeof(name), "%s receive queue %" B_PRIu32,
+				device->name, count);
+		} else
+			snprintf(name, sizeof(name), "%s receive queue", device->name);
+
+		if (init_fifo(&consumer.queue, name,
+				16 * 1024 * 1024 / interface->consumer_count) < B_OK)
+			goto error;
+
+		if (interface->consumer_count > 1) {
+			snprintf(name, sizeof(name), "%s consumer %" B_PRIu32,
+				device->name, count);
+		} else
+			snprintf(name, sizeof(name), "%s consumer", device->name);
+
+		consumer.thread = spawn_kernel_thread(device_consumer_thread, name,
+			B_DISPLAY_PRIORITY, &consumer);
+		if (consumer.thread < B_OK) {
+			uninit_fifo(&consumer.queue);
+			goto error;
+		}
+	}
 
-	interface->reader_thread   = -1;
-	interface->consumer_thread = spawn_kernel_thread(device_consumer_thread,
-		name, B_DISPLAY_PRIORITY, interface);
-	if (interface->consumer_thread < B_OK)
-		goto error2;
-	resume_thread(interface->consumer_thread);
+	for (uint32 i = 0; i < interface->consumer_count; i++)
+		resume_thread(interface->consumers[i].thread);
 
 	// TODO: proper interface index allocation
 	device->index = ++sDeviceIndex;
@@ -216,9 +361,15 @@ allocate_device_interface(net_device* device, net_device_module_info* module)
 	sInterfaces.Add(interface);
 	return interface;
 
-error2:
-	uninit_fifo(&interface->receive_queue);
-error1:
+error:
+	// the threads have not been resumed yet
+	interface->ref_count = 0;
+	while (count-- > 0) {
+		uninit_fifo(&interface->consumers[count].queue);
+		resume_thread(interface->consumers[count].thread);
+		wait_for_thread(interface->consumers[count].thread, NULL);
+	}
+
 	recursive_lock_destroy(&interface->receive_lock);
 	recursive_lock_destroy(&interface->monitor_lock);
 	delete interface;
@@ -256,12 +407,15 @@ dump_device_interface(int argc, char** argv)
 		= (net_device_interface*)parse_expression(argv[1]);
 
 	kprintf("device:            %p\n", interface->device);
-	kprintf("reader_thread:     %" B_PRId32 "\n", interface->reader_thread);
+	kprintf("readers:\n");
+	for (uint32 i = 0; i < interface->reader_count; i++) {
+		kprintf("  queue %" B_PRIu32 ": thread %" B_PRId32 "\n",
+			interface->readers[i].index, interface->readers[i].thread);
+	}
 	kprintf("up_count:          %" B_PRIu32 "\n", interface->up_count);
 	kprintf("ref_count:         %" B_PRId32 "\n", interface->ref_count);
 	kprintf("deframe_func:      %p\n", interface->deframe_func);
 	kprintf("deframe_ref_count: %" B_PRId32 "\n", interface->ref_count);
-	kprintf("consumer_thread:   %" B_PRId32 "\n", interface->consumer_thread);
 
 	kprintf("monitor_count:     %" B_PRId32 "\n", interface->monitor_count);
 	kprintf("monitor_lock:      %p\n", &interface->monitor_lock);
@@ -272,7 +426,11 @@ dump_device_interface(int argc, char** argv)
 		kprintf("  %p\n", monitorIterator.Next());
 
 	kprintf("receive_lock:      %p\n", &interface->receive_lock);
-	kprintf("receive_queue:     %p\n", &interface->receive_queue);
+	kprintf("consumers:\n");
+	for (uint32 i = 0; i < interface->consumer_count; i++) {
+		kprintf("  thread %" B_PRId32 ", receive_queue %p\n",
+			interface->consumers[i].thread, &interface->consumers[i].queue);
+	}
 	kprintf("receive_funcs:\n");
 	DeviceHandlerList::Iterator handlerIterator
 		= interface->receive_funcs.GetIterator();
@@ -400,8 +558,10 @@ put_device_interface(struct net_device_interface* interface)
 	sInterfaces.Remove(interface);
 	locker.Unlock();
 
-	uninit_fifo(&interface->receive_queue);
-	wait_for_thread(interface->consumer_thread, NULL);
+	for (uint32 i = 0; i < interface->consumer_count; i++)
+		uninit_fifo(&interface->consumers[i].queue);
+	for (uint32 i = 0; i < interface->consumer_count; i++)
+		wait_for_thread(interface->consumers[i].thread, NULL);
 
 	net_device* device = interface->device;
 	const char* moduleName = device->module->info.name;
@@ -514,6 +674,18 @@ device_interface_monitor_receive(net_device_interface* interface,
 }
 
 
+/*!	Hands the \a buffer to the consumer responsible for its flow. The buffer
+	must already have been deframed.
+*/
+status_t
+device_interface_enqueue_buffer(net_device_interface* interface,
+	net_buffer* buffer)
+{
+	return fifo_enqueue_buffer(&steer_buffer(interface, NULL, buffer)->queue,
+		buffer);
+}
+
+
 status_t
 up_device_interface(net_device_interface* interface)
 {
@@ -530,21 +702,52 @@ up_device_interface(net_device_interface* interface)
 	if (status != B_OK)
 		return status;
 
+	interface->reader_count = 0;
+
 	if (device->module->receive_data != NULL) {
-		// give the thread a nice name
-		char name[B_OS_NAME_LENGTH];
-		snprintf(name, sizeof(name), "%s reader", device->name);
-
-		interface->reader_thread = spawn_kernel_thread(device_reader_thread,
-			name, B_REAL_TIME_DISPLAY_PRIORITY - 10, interface);
-		if (interface->reader_thread < B_OK)
-			return interface->reader_thread;
+		uint32 queueCount = 1;
+		if (device->module->receive_queue_count != NULL
+			&& device->module->receive_queue_data != NULL) {
+			queueCount = device->module->receive_queue_count(device);
+			queueCount = max_c(min_c(queueCount, MAX_DEVICE_RECEIVE_QUEUES),
+				1);
+		}
+
+		for (uint32 i = 0; i < queueCount; i++) {
+			net_device_reader& reader = interface->readers[i];
+			reader.interface = interface;
+			reader.index = i;
+
+			// give the thread a nice name
+			char name[B_OS_NAME_LENGTH];
+			if (queueCount > 1) {
+				snprintf(name, sizeof(name), "%s reader %" B_PRIu32,
+					device->name, i);
+			} else
+				snprintf(name, sizeof(name), "%s reader", device->name);
+
+			reader.thread = spawn_kernel_thread(device_reader_thread, name,
+				B_REAL_TIME_DISPLAY_PRIORITY - 10, &reader);
+			if (reader.thread < B_OK) {
+				status = reader.thread;
+
+				// the readers will leave immediately, as IFF_UP is not set
+				for (uint32 j = 0; j < i; j++) {
+					resume_thread(interface->readers[j].thread);
+					wait_for_thread(interface->readers[j].thread, NULL);
+				}
+				device->module->down(device);
+				return status;
+			}
+		}
+
+		interface->reader_count = queueCount;
 	}
 
 	device->flags |= IFF_UP;
 
-	if (device->module->receive_data != NULL)
-		resume_thread(interface->reader_thread);
+	for (uint32 i = 0; i < interface->reader_count; i++)
+		resume_thread(interface->readers[i].thread);
 
 	interface->up_count = 1;
 	return B_OK;
@@ -577,13 +780,11 @@ down_device_interface(net_device_interface* interface)
 
 	notify_device_monitors(interface, B_DEVICE_GOING_DOWN);
 
-	if (device->module->receive_data != NULL) {
-		thread_id readerThread = interface->reader_thread;
-
-		// make sure the reader thread is gone before shutting down the interface
-		// (note that we may be the reader thread)
+	// make sure the reader threads are gone before shutting down the
+	// interface (note that we may be one of the reader threads)
+	for (uint32 i = 0; i < interface->reader_count; i++) {
 		status_t status;
-		wait_for_thread(readerThread, &status);
+		wait_for_thread(interface->readers[i].thread, &status);
 	}
 }
 
@@ -838,7 +1039,7 @@ device_enqueue_buffer(net_device* device, net_buffer* buffer)
 		return status;
 	}
 
-	status = fifo_enqueue_buffer(&interface->receive_queue, buffer);
+	status = device_interface_enqueue_buffer(interface, buffer);
 
 	put_device_interface(interface);
 	return status;
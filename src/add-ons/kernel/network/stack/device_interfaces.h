@@ -26,9 +26,28 @@ typedef DoublyLinkedList<net_device_handler> DeviceHandlerList;
 typedef DoublyLinkedList<net_device_monitor,
 	DoublyLinkedListCLink<net_device_monitor> > DeviceMonitorList;
 
+#define MAX_DEVICE_RECEIVE_QUEUES	16
+
+struct net_device_interface;
+
+struct net_device_reader {
+	net_device_interface*	interface;
+	uint32					index;
+		// the device receive queue this reader drains
+	thread_id				thread;
+};
+
+struct net_device_consumer {
+	net_device_interface*	interface;
+	uint32					index;
+	thread_id				thread;
+	net_fifo				queue;
+};
+
 struct net_device_interface : DoublyLinkedListLinkImpl<net_device_interface> {
 	struct net_device*	device;
-	thread_id			reader_thread;
+	net_device_reader	readers[MAX_DEVICE_RECEIVE_QUEUES];
+	uint32				reader_count;
 	uint32				up_count;
 		// a device can be brought up by more than one interface
 	int32				ref_count;
@@ -44,8 +63,8 @@ struct net_device_interface : DoublyLinkedListLinkImpl<net_device_interface> {
 	DeviceHandlerList	receive_funcs;
 	recursive_lock		receive_lock;
 
-	thread_id			consumer_thread;
-	net_fifo			receive_queue;
+	net_device_consumer	consumers[MAX_DEVICE_RECEIVE_QUEUES];
+	uint32				consumer_count;
 };
 
 typedef DoublyLinkedList<net_device_interface> DeviceInterfaceList;
@@ -63,6 +82,8 @@ struct net_device_interface* get_device_interface(const char* name,
 	bool create = true);
 void device_interface_monitor_receive(net_device_interface* interface,
 	net_buffer* buffer);
+status_t device_interface_enqueue_buffer(net_device_interface* interface,
+	net_buffer* buffer);
 status_t up_device_interface(net_device_interface* interface);
 void down_device_interface(net_device_interface* interface);
 
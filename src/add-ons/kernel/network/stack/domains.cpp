@@ -139,6 +139,8 @@ register_domain(int family, const char* name,
 	domain->module = module;
 	domain->address_module = addressModule;
 
+	init_route_lookup(domain);
+
 	sDomains.Add(domain);
 
 	*_domain = domain;
@@ -157,6 +159,7 @@ unregister_domain(net_domain* _domain)
 
 	sDomains.Remove(domain);
 
+	uninit_route_lookup(domain);
 	recursive_lock_destroy(&domain->lock);
 	delete domain;
 	return B_OK;
@@ -17,6 +17,7 @@
 
 
 struct net_device_interface;
+struct route_lookup_table;
 
 
 struct net_domain_private : net_domain,
@@ -25,6 +26,13 @@ struct net_domain_private : net_domain,
 
 	RouteList			routes;
 	RouteInfoList		route_infos;
+
+	// lock-free route lookup, see routes.cpp
+	route_lookup_table*	lookup_table;
+	route_lookup_table*	retired_lookup_tables;
+	int32				lookup_generation;
+	int32				lookup_readers[2];
+	net_timer			lookup_timer;
 };
 
 
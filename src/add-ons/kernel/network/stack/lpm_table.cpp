@@ -0,0 +1,275 @@
+/*
+ * Copyright 2026, Haiku, Inc. All Rights Reserved.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+#include "lpm_table.h"
+
+#include <stdlib.h>
+
+
+static const uint32 kStride = 6;
+
+
+LPMTable::LPMTable()
+	:
+	fKeyBits(0),
+	fBinaryNodes(NULL),
+	fBinaryNodeCount(0),
+	fBinaryNodeCapacity(0),
+	fNodes(NULL),
+	fNodeCount(0),
+	fNodeCapacity(0),
+	fLeaves(NULL),
+	fLeafCount(0),
+	fLeafCapacity(0)
+{
+}
+
+
+LPMTable::~LPMTable()
+{
+	free(fBinaryNodes);
+	free(fNodes);
+	free(fLeaves);
+}
+
+
+status_t
+LPMTable::Init(uint32 keyBits)
+{
+	if (keyBits == 0 || keyBits > 128)
+		return B_BAD_VALUE;
+
+	fKeyBits = keyBits;
+
+	// the root of the binary trie always exists
+	uint32 root;
+	return _AllocateBinaryNode(root);
+}
+
+
+/*!	Adds the prefix consisting of the first \a length bits of \a key.
+	If the same prefix is added more than once, the value that was added
+	first is kept.
+	Must be called before Build().
+*/
+status_t
+LPMTable::Add(const uint64* key, uint32 length, uint32 value)
+{
+	if (fBinaryNodes == NULL)
+		return B_NO_INIT;
+	if (length > fKeyBits || value == 0)
+		return B_BAD_VALUE;
+
+	uint32 node = 0;
+	for (uint32 i = 0; i < length; i++) {
+		uint32 bit = (key[i / 64] >> (63 - i % 64)) & 1;
+		uint32 child = fBinaryNodes[node].child[bit];
+		if (child == 0) {
+			status_t status = _AllocateBinaryNode(child);
+			if (status != B_OK)
+				return status;
+
+			fBinaryNodes[node].child[bit] = child;
+		}
+		node = child;
+	}
+
+	if (fBinaryNodes[node].value == 0)
+		fBinaryNodes[node].value = value;
+
+	return B_OK;
+}
+
+
+/*!	Compiles the prefixes added so far into the lookup structure, and frees
+	the memory used to collect them. Afterwards, no more prefixes can be
+	added.
+*/
+status_t
+LPMTable::Build()
+{
+	if (fBinaryNodes == NULL)
+		return B_NO_INIT;
+
+	uint32 root;
+	status_t status = _AllocateNodes(1, root);
+	if (status == B_OK)
+		status = _BuildNode(0, 0, fBinaryNodes[0].value, root);
+
+	free(fBinaryNodes);
+	fBinaryNodes = NULL;
+	fBinaryNodeCount = fBinaryNodeCapacity = 0;
+
+	if (status != B_OK) {
+		free(fNodes);
+		fNodes = NULL;
+		fNodeCount = fNodeCapacity = 0;
+	}
+
+	return status;
+}
+
+
+size_t
+LPMTable::MemoryUsage() const
+{
+	return fNodeCapacity * sizeof(Node) + fLeafCapacity * sizeof(uint32);
+}
+
+
+/*!	Follows the binary trie from \a binaryNode at \a depth along the bits of
+	\a slot. \a _value is updated with the value of the longest prefix found
+	on the way. Returns \c true if the slot ends in a binary node that has
+	longer prefixes below it, which is then returned in \a _node.
+*/
+bool
+LPMTable::_WalkSlot(uint32 binaryNode, uint32 depth, uint32 slot,
+	uint32& _node, uint32& _value) const
+{
+	uint32 node = binaryNode;
+	for (uint32 i = 0; i < kStride; i++) {
+		if (depth + i >= fKeyBits)
+			return false;
+
+		node = fBinaryNodes[node].child[(slot >> (kStride - 1 - i)) & 1];
+		if (node == 0)
+			return false;
+		if (fBinaryNodes[node].value != 0)
+			_value = fBinaryNodes[node].value;
+	}
+
+	_node = node;
+	return fBinaryNodes[node].child[0] != 0 || fBinaryNodes[node].child[1] != 0;
+}
+
+
+status_t
+LPMTable::_BuildNode(uint32 binaryNode, uint32 depth, uint32 inherited,
+	uint32 nodeIndex)
+{
+	// Note, this is called recursively once per level of the trie, so keep
+	// the stack usage low -- the slots are walked a second time below rather
+	// than remembered.
+
+	uint64 internal = 0;
+	uint64 leaves = 0;
+	uint32 leafBase = fLeafCount;
+	uint32 lastValue = 0;
+
+	for (uint32 slot = 0; slot < 64; slot++) {
+		uint32 child;
+		uint32 value = inherited;
+		if (_WalkSlot(binaryNode, depth, slot, child, value)) {
+			internal |= (uint64)1 << slot;
+			continue;
+		}
+
+		if (leaves == 0 || value != lastValue) {
+			status_t status = _AddLeaf(value);
+			if (status != B_OK)
+				return status;
+
+			leaves |= (uint64)1 << slot;
+			lastValue = value;
+		}
+	}
+
+	uint32 nodeBase = 0;
+	if (internal != 0) {
+		status_t status = _AllocateNodes(__builtin_popcountll(internal),
+			nodeBase);
+		if (status != B_OK)
+			return status;
+	}
+
+	Node& node = fNodes[nodeIndex];
+	node.internal = internal;
+	node.leaves = leaves;
+	node.leaf_base = leafBase;
+	node.node_base = nodeBase;
+
+	for (uint32 slot = 0; internal != 0; slot++) {
+		if ((internal & ((uint64)1 << slot)) == 0)
+			continue;
+
+		uint32 child;
+		uint32 value = inherited;
+		_WalkSlot(binaryNode, depth, slot, child, value);
+
+		status_t status = _BuildNode(child, depth + kStride, value,
+			nodeBase++);
+		if (status != B_OK)
+			return status;
+
+		internal &= ~((uint64)1 << slot);
+	}
+
+	return B_OK;
+}
+
+
+status_t
+LPMTable::_AllocateBinaryNode(uint32& _index)
+{
+	if (fBinaryNodeCount == fBinaryNodeCapacity) {
+		uint32 capacity = fBinaryNodeCapacity == 0
+			? 64 : fBinaryNodeCapacity * 2;
+		BinaryNode* nodes = (BinaryNode*)realloc(fBinaryNodes,
+			capacity * sizeof(BinaryNode));
+		if (nodes == NULL)
+			return B_NO_MEMORY;
+
+		fBinaryNodes = nodes;
+		fBinaryNodeCapacity = capacity;
+	}
+
+	BinaryNode& node = fBinaryNodes[fBinaryNodeCount];
+	node.child[0] = node.child[1] = 0;
+	node.value = 0;
+
+	_index = fBinaryNodeCount++;
+	return B_OK;
+}
+
+
+status_t
+LPMTable::_AllocateNodes(uint32 count, uint32& _base)
+{
+	if (fNodeCount + count > fNodeCapacity) {
+		uint32 capacity = fNodeCapacity == 0 ? 64 : fNodeCapacity * 2;
+		while (capacity < fNodeCount + count)
+			capacity *= 2;
+
+		Node* nodes = (Node*)realloc(fNodes, capacity * sizeof(Node));
+		if (nodes == NULL)
+			return B_NO_MEMORY;
+
+		fNodes = nodes;
+		fNodeCapacity = capacity;
+	}
+
+	_base = fNodeCount;
+	fNodeCount += count;
+	return B_OK;
+}
+
+
+status_t
+LPMTable::_AddLeaf(uint32 value)
+{
+	if (fLeafCount == fLeafCapacity) {
+		uint32 capacity = fLeafCapacity == 0 ? 64 : fLeafCapacity * 2;
+		uint32* leaves = (uint32*)realloc(fLeaves, capacity * sizeof(uint32));
+		if (leaves == NULL)
+			return B_NO_MEMORY;
+
+		fLeaves = leaves;
+		fLeafCapacity = capacity;
+	}
+
+	fLeaves[fLeafCount++] = value;
+	return B_OK;
+}
@@ -0,0 +1,124 @@
+/*
+ * Copyright 2026, Haiku, Inc. All Rights Reserved.
+ * Distributed under the terms of the MIT License.
+ */
+#ifndef LPM_TABLE_H
+#define LPM_TABLE_H
+
+
+#include <SupportDefs.h>
+
+
+/*!	A read-optimized longest prefix match table for keys of up to 128 bits,
+	modelled after Poptrie.
+
+	Prefixes are first collected in a plain binary trie by Add(), and then
+	compiled by Build() into a multibit trie with a stride of 6 bits. Each
+	node of that trie stores two bitmaps: one telling which of its 64 slots
+	lead to child nodes, and one telling where a new run of equal leaves
+	starts. Children and leaves are kept in two flat arrays, and are found
+	by counting the bits set in front of the slot, so that a lookup touches
+	only a handful of cache lines, and never needs to lock anything.
+
+	Keys are passed as two 64 bit words, most significant bits first; shorter
+	keys (like IPv4 addresses) must be left aligned in the first word.
+	Values are opaque non-zero numbers, zero means "no match".
+*/
+class LPMTable {
+public:
+								LPMTable();
+								~LPMTable();
+
+			status_t			Init(uint32 keyBits);
+
+			status_t			Add(const uint64* key, uint32 length,
+									uint32 value);
+			status_t			Build();
+
+	inline	uint32				Lookup(const uint64* key) const;
+
+			size_t				MemoryUsage() const;
+			uint32				CountNodes() const { return fNodeCount; }
+
+private:
+	struct BinaryNode {
+		uint32					child[2];
+		uint32					value;
+	};
+
+	struct Node {
+		uint64					internal;
+			// slots that lead to another node
+		uint64					leaves;
+			// slots that start a new run of leaves
+		uint32					leaf_base;
+		uint32					node_base;
+	};
+
+	static	uint32				_Slot(const uint64* key, uint32 offset);
+
+			bool				_WalkSlot(uint32 binaryNode, uint32 depth,
+									uint32 slot, uint32& _node,
+									uint32& _value) const;
+			status_t			_BuildNode(uint32 binaryNode, uint32 depth,
+									uint32 inherited, uint32 nodeIndex);
+
+			status_t			_AllocateBinaryNode(uint32& _index);
+			status_t			_AllocateNodes(uint32 count, uint32& _base);
+			status_t			_AddLeaf(uint32 value);
+
+private:
+			uint32				fKeyBits;
+
+			BinaryNode*			fBinaryNodes;
+			uint32				fBinaryNodeCount;
+			uint32				fBinaryNodeCapacity;
+
+			Node*				fNodes;
+			uint32				fNodeCount;
+			uint32				fNodeCapacity;
+
+			uint32*				fLeaves;
+			uint32				fLeafCount;
+			uint32				fLeafCapacity;
+};
+
+
+/*static*/ inline uint32
+LPMTable::_Slot(const uint64* key, uint32 offset)
+{
+	uint32 word = offset / 64;
+	uint32 shift = offset % 64;
+
+	uint64 bits = key[word] << shift;
+	if (shift > 58 && word == 0)
+		bits |= key[1] >> (64 - shift);
+
+	return bits >> 58;
+}
+
+
+inline uint32
+LPMTable::Lookup(const uint64* key) const
+{
+	const Node* node = fNodes;
+	if (node == NULL)
+		return 0;
+
+	for (uint32 offset = 0;; offset += 6) {
+		uint64 bit = (uint64)1 << _Slot(key, offset);
+		uint64 mask = (bit << 1) - 1;
+
+		if ((node->internal & bit) != 0) {
+			node = &fNodes[node->node_base
+				+ __builtin_popcountll(node->internal & mask) - 1];
+			continue;
+		}
+
+		return fLeaves[node->leaf_base
+			+ __builtin_popcountll(node->leaves & mask) - 1];
+	}
+}
+
+
+#endif	// LPM_TABLE_H
@@ -1,5 +1,5 @@
 /*
- * Copyright 2006-2016, Haiku, Inc. All Rights Reserved.
+ * Copyright 2006-2026, Haiku, Inc. All Rights Reserved.
  * Distributed under the terms of the MIT License.
  *
  * Authors:
@@ -19,9 +19,12 @@
 #include <debug.h>
 #include <kernel.h>
 #include <KernelExport.h>
+#include <lock.h>
+#include <util/AutoLock.h>
 #include <util/DoublyLinkedList.h>
 
 #include <algorithm>
+#include <new>
 #include <stdlib.h>
 #include <string.h>
 #include <sys/param.h>
@@ -66,6 +69,8 @@ struct free_data {
 struct data_header {
 	int32			ref_count;
 	addr_t			physical_address;
+	net_buffer_pool* pool;
+		// the pool this header is recycled to, if any
 	free_data*		first_free;
 	uint8*			data_end;
 	header_space	space;
@@ -146,14 +151,48 @@ struct net_buffer_private : net_buffer {
 };
 
 
+/*!	A pool of preallocated data headers of a fixed size, typically owned by a
+	network device. The headers live in a single physically contiguous area,
+	so that drivers can let the hardware write received frames directly into
+	a buffer's data. When the last reference to a pooled header is released,
+	it is put back into the pool instead of being freed.
+	The pool is reference counted by its owner and by every header that is
+	currently handed out, so buffers may outlive delete_pool().
+*/
+struct net_buffer_pool : DoublyLinkedListLinkImpl<net_buffer_pool> {
+	char			name[B_OS_NAME_LENGTH];
+	area_id			area;
+	uint8*			base;
+	phys_addr_t		physical_base;
+	size_t			buffer_size;
+	size_t			header_space;
+	uint32			count;
+
+	spinlock		lock;
+	data_header**	free_headers;
+	uint32			free_count;
+	int32			ref_count;
+
+	int32			hits;
+	int32			misses;
+	int32			recycled;
+};
+
+typedef DoublyLinkedList<net_buffer_pool> PoolList;
+
+
 #define DATA_HEADER_SIZE				_ALIGN(sizeof(data_header))
 #define DATA_NODE_SIZE					_ALIGN(sizeof(data_node))
 #define MAX_FREE_BUFFER_SIZE			(BUFFER_SIZE - DATA_HEADER_SIZE)
+#define POOL_BUFFER_ALIGNMENT			64
 
 
 static object_cache* sNetBufferCache;
 static object_cache* sDataNodeCache;
 
+static mutex sPoolListLock;
+static PoolList sPoolList;
+
 
 static status_t append_data(net_buffer* buffer, const void* data, size_t size);
 static status_t trim_data(net_buffer* _buffer, size_t newSize);
@@ -172,6 +211,9 @@ static int32 sEverAllocatedDataHeaderCount = 0;
 static int32 sEverAllocatedNetBufferCount = 0;
 static int32 sMaxAllocatedDataHeaderCount = 0;
 static int32 sMaxAllocatedNetBufferCount = 0;
+static int32 sPoolHitCount = 0;
+static int32 sPoolMissCount = 0;
+static int32 sRecycledDataHeaderCount = 0;
 #endif
 
 
@@ -659,6 +701,22 @@ dump_net_buffer_stats(int argc, char** argv)
 	kprintf("allocated net buffers:  %7" B_PRId32 " / %7" B_PRId32 ", peak %7"
 		B_PRId32 "\n", sAllocatedNetBufferCount, sEverAllocatedNetBufferCount,
 		sMaxAllocatedNetBufferCount);
+
+	int32 requests = sPoolHitCount + sPoolMissCount;
+	kprintf("pooled buffers: %" B_PRId32 " hits, %" B_PRId32 " misses (%"
+		B_PRId32 "%% hit rate), %" B_PRId32 " recycled\n", sPoolHitCount,
+		sPoolMissCount, requests > 0
+			? int32((int64)sPoolHitCount * 100 / requests) : 0,
+		sRecycledDataHeaderCount);
+
+	for (PoolList::Iterator iterator = sPoolList.GetIterator();
+			net_buffer_pool* pool = iterator.Next();) {
+		kprintf("  %p %-24s %5" B_PRIuSIZE " bytes, %4" B_PRIu32 "/%4" B_PRIu32
+			" free, %" B_PRId32 " hits, %" B_PRId32 " misses, %" B_PRId32
+			" recycled\n", pool, pool->name, pool->buffer_size,
+			pool->free_count, pool->count, pool->hits, pool->misses,
+			pool->recycled);
+	}
 	return 0;
 }
 
@@ -776,9 +834,47 @@ allocate_net_buffer()
 }
 
 
+static void
+put_pool(net_buffer_pool* pool)
+{
+	if (atomic_add(&pool->ref_count, -1) != 1)
+		return;
+
+	MutexLocker locker(sPoolListLock);
+	sPoolList.Remove(pool);
+	locker.Unlock();
+
+	delete_area(pool->area);
+	delete[] pool->free_headers;
+	delete pool;
+}
+
+
+static void
+recycle_data_header(data_header* header)
+{
+	net_buffer_pool* pool = header->pool;
+
+	InterruptsSpinLocker locker(pool->lock);
+	pool->free_headers[pool->free_count++] = header;
+	locker.Unlock();
+
+#if ENABLE_STATS
+	atomic_add(&pool->recycled, 1);
+	atomic_add(&sRecycledDataHeaderCount, 1);
+#endif
+	put_pool(pool);
+}
+
+
 static inline void
 free_data_header(data_header* header)
 {
+	if (header != NULL && header->pool != NULL) {
+		recycle_data_header(header);
+		return;
+	}
+
 #if ENABLE_STATS
 	if (header != NULL)
 		atomic_add(&sAllocatedDataHeaderCount, -1);
@@ -798,29 +894,47 @@ free_net_buffer(net_buffer_private* buffer)
 }
 
 
-static data_header*
-create_data_header(size_t headerSpace)
+static void
+init_data_header(data_header* header, size_t headerSpace, size_t bufferSize)
 {
-	data_header* header = allocate_data_header();
-	if (header == NULL)
-		return NULL;
-
 	header->ref_count = 1;
-	header->physical_address = 0;
-		// TODO: initialize this correctly
 	header->space.size = headerSpace;
 	header->space.free = headerSpace;
 	header->data_end = (uint8*)header + DATA_HEADER_SIZE;
-	header->tail_space = (uint8*)header + BUFFER_SIZE - header->data_end
+	header->tail_space = (uint8*)header + bufferSize - header->data_end
 		- headerSpace;
 	header->first_free = NULL;
 
 	TRACE(("%d:   create new data header %p\n", find_thread(NULL), header));
 	T2(CreateDataHeader(header));
+}
+
+
+static data_header*
+create_data_header(size_t headerSpace)
+{
+	data_header* header = allocate_data_header();
+	if (header == NULL)
+		return NULL;
+
+	header->physical_address = 0;
+		// TODO: initialize this correctly
+	header->pool = NULL;
+	init_data_header(header, headerSpace, BUFFER_SIZE);
 	return header;
 }
 
 
+/*!	Returns the end of the memory block that belongs to \a header.
+*/
+static inline uint8*
+data_header_end(data_header* header)
+{
+	return (uint8*)header + (header->pool != NULL
+		? header->pool->buffer_size : BUFFER_SIZE);
+}
+
+
 static void
 release_data_header(data_header* header)
 {
@@ -1086,30 +1200,9 @@ copy_metadata(net_buffer* destination, const net_buffer* source)
 }
 
 
-//	#pragma mark - module API
-
-
-static net_buffer*
-create_buffer(size_t headerSpace)
+static void
+init_buffer(net_buffer_private* buffer, data_header* header)
 {
-	net_buffer_private* buffer = allocate_net_buffer();
-	if (buffer == NULL)
-		return NULL;
-
-	TRACE(("%d: create buffer %p\n", find_thread(NULL), buffer));
-
-	// Make sure headerSpace is valid and at least the initial node fits.
-	headerSpace = _ALIGN(headerSpace);
-	if (headerSpace < DATA_NODE_SIZE)
-		headerSpace = DATA_NODE_SIZE;
-	else if (headerSpace > MAX_FREE_BUFFER_SIZE)
-		headerSpace = MAX_FREE_BUFFER_SIZE;
-
-	data_header* header = create_data_header(headerSpace);
-	if (header == NULL) {
-		free_net_buffer(buffer);
-		return NULL;
-	}
 	buffer->allocation_header = header;
 
 	data_node* node = add_first_data_node(header);
@@ -1136,7 +1229,35 @@ create_buffer(size_t headerSpace)
 	CREATE_PARANOIA_CHECK_SET(buffer, "net_buffer");
 	SET_PARANOIA_CHECK(PARANOIA_SUSPICIOUS, buffer, &buffer->size,
 		sizeof(buffer->size));
+}
+
 
+//	#pragma mark - module API
+
+
+static net_buffer*
+create_buffer(size_t headerSpace)
+{
+	net_buffer_private* buffer = allocate_net_buffer();
+	if (buffer == NULL)
+		return NULL;
+
+	TRACE(("%d: create buffer %p\n", find_thread(NULL), buffer));
+
+	// Make sure headerSpace is valid and at least the initial node fits.
+	headerSpace = _ALIGN(headerSpace);
+	if (headerSpace < DATA_NODE_SIZE)
+		headerSpace = DATA_NODE_SIZE;
+	else if (headerSpace > MAX_FREE_BUFFER_SIZE)
+		headerSpace = MAX_FREE_BUFFER_SIZE;
+
+	data_header* header = create_data_header(headerSpace);
+	if (header == NULL) {
+		free_net_buffer(buffer);
+		return NULL;
+	}
+
+	init_buffer(buffer, header);
 	T(Create(headerSpace, buffer));
 
 	return buffer;
@@ -1417,7 +1538,7 @@ merge_buffer(net_buffer* _buffer, net_buffer* _with, bool after)
 			break;
 
 		if ((uint8*)node > (uint8*)node->header
-			&& (uint8*)node < (uint8*)node->header + BUFFER_SIZE) {
+			&& (uint8*)node < data_header_end(node->header)) {
 			// The node is already in the buffer, we can just move it
 			// over to the new owner
 			list_remove_item(&with->buffers, node);
@@ -2307,6 +2428,131 @@ swap_addresses(net_buffer* buffer)
 }
 
 
+/*!	Creates a pool of \a count buffers, each of which has room for
+	\a dataSize bytes of contiguous data behind \a headerSpace bytes of
+	header space. Data headers allocated from the pool have their
+	physical address set, and are recycled to the pool when freed.
+*/
+static net_buffer_pool*
+create_pool(const char* name, size_t headerSpace, size_t dataSize,
+	uint32 count)
+{
+	headerSpace = _ALIGN(headerSpace);
+	if (headerSpace < DATA_NODE_SIZE)
+		headerSpace = DATA_NODE_SIZE;
+
+	size_t bufferSize = ROUNDUP(DATA_HEADER_SIZE + headerSpace + dataSize,
+		POOL_BUFFER_ALIGNMENT);
+	if (count == 0 || bufferSize - DATA_HEADER_SIZE > 0xffff) {
+		// the header and tail space must fit into their uint16 fields
+		return NULL;
+	}
+
+	net_buffer_pool* pool = new(std::nothrow) net_buffer_pool;
+	if (pool == NULL)
+		return NULL;
+
+	pool->free_headers = new(std::nothrow) data_header*[count];
+	if (pool->free_headers == NULL) {
+		delete pool;
+		return NULL;
+	}
+
+	pool->area = create_area(name, (void**)&pool->base,
+		B_ANY_KERNEL_ADDRESS, ROUNDUP(bufferSize * count, B_PAGE_SIZE),
+		B_CONTIGUOUS, B_KERNEL_READ_AREA | B_KERNEL_WRITE_AREA);
+	if (pool->area < B_OK) {
+		delete[] pool->free_headers;
+		delete pool;
+		return NULL;
+	}
+
+	physical_entry entry;
+	get_memory_map(pool->base, B_PAGE_SIZE, &entry, 1);
+
+	strlcpy(pool->name, name, sizeof(pool->name));
+	pool->physical_base = entry.address;
+	pool->buffer_size = bufferSize;
+	pool->header_space = headerSpace;
+	pool->count = count;
+	B_INITIALIZE_SPINLOCK(&pool->lock);
+	pool->free_count = count;
+	pool->ref_count = 1;
+	pool->hits = 0;
+	pool->misses = 0;
+	pool->recycled = 0;
+
+	for (uint32 i = 0; i < count; i++) {
+		data_header* header = (data_header*)(pool->base + i * bufferSize);
+		header->physical_address = pool->physical_base + i * bufferSize;
+		header->pool = pool;
+		pool->free_headers[i] = header;
+	}
+
+	MutexLocker locker(sPoolListLock);
+	sPoolList.Add(pool);
+
+	return pool;
+}
+
+
+/*!	Releases the owner's reference to the \a pool. The pool goes away once
+	all of its buffers have been freed.
+*/
+static void
+delete_pool(net_buffer_pool* pool)
+{
+	if (pool != NULL)
+		put_pool(pool);
+}
+
+
+/*!	Creates a buffer whose first data node is located in a data header taken
+	from the \a pool, so that up to the pool's data size can be appended
+	contiguously. Returns \c NULL if the pool is exhausted; the caller is
+	expected to fall back to create() in this case.
+*/
+static net_buffer*
+create_from_pool(net_buffer_pool* pool)
+{
+	data_header* header = NULL;
+
+	InterruptsSpinLocker locker(pool->lock);
+	if (pool->free_count > 0)
+		header = pool->free_headers[--pool->free_count];
+	locker.Unlock();
+
+	if (header == NULL) {
+#if ENABLE_STATS
+		atomic_add(&pool->misses, 1);
+		atomic_add(&sPoolMissCount, 1);
+#endif
+		return NULL;
+	}
+
+	atomic_add(&pool->ref_count, 1);
+#if ENABLE_STATS
+	atomic_add(&pool->hits, 1);
+	atomic_add(&sPoolHitCount, 1);
+#endif
+
+	net_buffer_private* buffer = allocate_net_buffer();
+	if (buffer == NULL) {
+		recycle_data_header(header);
+		return NULL;
+	}
+
+	TRACE(("%d: create buffer %p from pool %p\n", find_thread(NULL), buffer,
+		pool));
+
+	init_data_header(header, pool->header_space, pool->buffer_size);
+	init_buffer(buffer, header);
+	T(Create(pool->header_space, buffer));
+
+	return buffer;
+}
+
+
 static status_t
 std_ops(int32 op, ...)
 {
@@ -2327,6 +2573,9 @@ std_ops(int32 op, ...)
 				return B_NO_MEMORY;
 			}
 
+			mutex_init(&sPoolListLock, "net buffer pools");
+			new (&sPoolList) PoolList;
+
 #if ENABLE_STATS
 			add_debugger_command_etc("net_buffer_stats", &dump_net_buffer_stats,
 				"Print net buffer statistics",
@@ -2348,6 +2597,7 @@ std_ops(int32 op, ...)
 #endif
 			delete_object_cache(sNetBufferCache);
 			delete_object_cache(sDataNodeCache);
+			mutex_destroy(&sPoolListLock);
 			return B_OK;
 
 		default:
@@ -2405,5 +2655,9 @@ net_buffer_module_info gNetBufferModule = {
 	swap_addresses,
 
 	dump_buffer,	// dump
+
+	create_pool,
+	delete_pool,
+	create_from_pool,
 };
 
@@ -1,5 +1,5 @@
 /*
- * Copyright 2006-2010, Haiku, Inc. All Rights Reserved.
+ * Copyright 2006-2026, Haiku, Inc. All Rights Reserved.
  * Distributed under the terms of the MIT License.
  *
  * Authors:
@@ -9,6 +9,7 @@
 
 #include "domains.h"
 #include "interfaces.h"
+#include "lpm_table.h"
 #include "routes.h"
 #include "stack_private.h"
 #include "utility.h"
@@ -18,11 +19,14 @@
 
 #include <lock.h>
 #include <util/AutoLock.h>
+#include <util/atomic.h>
 
 #include <KernelExport.h>
 
 #include <net/if_dl.h>
 #include <net/route.h>
+#include <netinet/in.h>
+#include <netinet6/in6.h>
 #include <new>
 #include <stdlib.h>
 #include <string.h>
@@ -37,6 +41,20 @@
 #endif
 
 
+/*!	A snapshot of a domain's route list that can be searched without holding
+	the domain lock. It holds a reference to each of its routes.
+*/
+struct route_lookup_table {
+	LPMTable			table;
+	net_route_private**	routes;
+	uint32				route_count;
+	route_lookup_table*	next_retired;
+};
+
+static const bigtime_t kRouteLookupRebuildDelay = 10000;
+	// collects route changes that come in bursts into a single rebuild
+
+
 net_route_private::net_route_private()
 {
 	destination = mask = gateway = NULL;
@@ -188,14 +206,10 @@ find_route(net_domain* _domain, const sockaddr* address)
 
 
 static void
-put_route_internal(struct net_domain_private* domain, net_route* _route)
+delete_route(struct net_domain_private* domain, net_route_private* route)
 {
 	ASSERT_LOCKED_RECURSIVE(&domain->lock);
 
-	net_route_private* route = (net_route_private*)_route;
-	if (route == NULL || atomic_add(&route->ref_count, -1) != 1)
-		return;
-
 	// delete route - it must already have been removed at this point
 	if (route->interface_address != NULL)
 		((InterfaceAddress*)route->interface_address)->ReleaseReference();
@@ -204,6 +218,19 @@ put_route_internal(struct net_domain_private* domain, net_route* _route)
 }
 
 
+static void
+put_route_internal(struct net_domain_private* domain, net_route* _route)
+{
+	ASSERT_LOCKED_RECURSIVE(&domain->lock);
+
+	net_route_private* route = (net_route_private*)_route;
+	if (route == NULL || atomic_add(&route->ref_count, -1) != 1)
+		return;
+
+	delete_route(domain, route);
+}
+
+
 static struct net_route*
 get_route_internal(struct net_domain_private* domain,
 	const struct sockaddr* address)
@@ -284,9 +311,312 @@ fill_route_entry(route_entry* target, void* _buffer, size_t bufferSize,
 }
 
 
+//	#pragma mark - lock-free lookup
+
+
+/*!	Converts \a address into a key for the LPMTable, if the domain supports
+	lock-free lookups.
+*/
+static bool
+route_lookup_key(int family, const sockaddr* address, uint64* key)
+{
+	if (address == NULL || address->sa_family != family)
+		return false;
+
+	switch (family) {
+		case AF_INET:
+			key[0] = (uint64)ntohl(
+				((const sockaddr_in*)address)->sin_addr.s_addr) << 32;
+			key[1] = 0;
+			return true;
+
+		case AF_INET6:
+		{
+			const uint8* bytes
+				= ((const sockaddr_in6*)address)->sin6_addr.s6_addr;
+			key[0] = key[1] = 0;
+			for (int i = 0; i < 16; i++)
+				key[i / 8] |= (uint64)bytes[i] << (56 - (i % 8) * 8);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+
+static uint32
+route_lookup_key_bits(int family)
+{
+	switch (family) {
+		case AF_INET:
+			return 32;
+		case AF_INET6:
+			return 128;
+	}
+	return 0;
+}
+
+
+/*!	Returns the prefix length of \a route, or -1 if the route cannot be
+	represented in the lookup table.
+*/
+static int32
+route_prefix_length(net_domain_private* domain, net_route_private* route)
+{
+	uint32 keyBits = route_lookup_key_bits(domain->family);
+
+	if (route->mask == NULL)
+		return (route->flags & RTF_DEFAULT) != 0 ? 0 : keyBits;
+
+	uint64 mask[2];
+	if (!route_lookup_key(domain->family, route->mask, mask)) {
+		// default routes may come with an empty mask
+		return route->mask->sa_len == 0 ? 0 : -1;
+	}
+
+	// the mask has already been checked to be contiguous
+	uint32 length = 0;
+	for (int i = 0; i < 2; i++) {
+		if (mask[i] == ~(uint64)0) {
+			length += 64;
+			continue;
+		}
+		if (mask[i] != 0)
+			length += __builtin_clzll(~mask[i]);
+		break;
+	}
+
+	return length > keyBits ? keyBits : length;
+}
+
+
+static void
+delete_route_lookup_table(net_domain_private* domain,
+	route_lookup_table* table)
+{
+	for (uint32 i = 0; i < table->route_count; i++)
+		put_route_internal(domain, table->routes[i]);
+
+	free(table->routes);
+	delete table;
+}
+
+
+/*!	Creates a lookup table for the current route list of the \a domain. */
+static route_lookup_table*
+create_route_lookup_table(net_domain_private* domain)
+{
+	ASSERT_LOCKED_RECURSIVE(&domain->lock);
+
+	route_lookup_table* table = new(std::nothrow) route_lookup_table;
+	if (table == NULL)
+		return NULL;
+
+	table->route_count = 0;
+	table->routes = (net_route_private**)malloc(
+		sizeof(net_route_private*) * max_c(domain->routes.Count(), 1));
+	if (table->routes == NULL
+		|| table->table.Init(route_lookup_key_bits(domain->family)) != B_OK) {
+		delete_route_lookup_table(domain, table);
+		return NULL;
+	}
+
+	// The routes are sorted by the length of their mask, and the lookup
+	// table keeps the first one added for equal prefixes, so it finds
+	// the same route as find_route() does.
+	RouteList::Iterator iterator = domain->routes.GetIterator();
+	while (net_route_private* route = iterator.Next()) {
+		uint64 key[2] = { 0, 0 };
+		int32 length = route_prefix_length(domain, route);
+		if (length < 0 || (length > 0
+				&& !route_lookup_key(domain->family, route->destination, key))) {
+			delete_route_lookup_table(domain, table);
+			return NULL;
+		}
+
+		if (table->table.Add(key, length, table->route_count + 1) != B_OK) {
+			delete_route_lookup_table(domain, table);
+			return NULL;
+		}
+
+		atomic_add(&route->ref_count, 1);
+		table->routes[table->route_count++] = route;
+	}
+
+	if (table->table.Build() != B_OK) {
+		delete_route_lookup_table(domain, table);
+		return NULL;
+	}
+
+	return table;
+}
+
+
+/*!	Waits until no reader can still be using a table that has been removed
+	from the domain before this call.
+	The readers are counted in one of two counters, selected by the lowest
+	bit of the generation at the time they start. Flipping the generation
+	twice and waiting for each counter to drain covers readers that picked
+	a counter right before a flip.
+*/
+static void
+wait_for_route_lookups(net_domain_private* domain)
+{
+	for (int i = 0; i < 2; i++) {
+		int32 index = atomic_add(&domain->lookup_generation, 1) & 1;
+		while (atomic_get(&domain->lookup_readers[index]) != 0)
+			snooze(100);
+	}
+}
+
+
+static void
+rebuild_route_lookup_table(net_timer* timer, void* _domain)
+{
+	net_domain_private* domain = (net_domain_private*)_domain;
+
+	RecursiveLocker locker(domain->lock);
+
+	route_lookup_table* table = create_route_lookup_table(domain);
+	if (table == NULL) {
+		dprintf("%s: could not create route lookup table\n", domain->name);
+			// we'll just keep using the slow path
+	}
+	route_lookup_table* retired = atomic_pointer_get_and_set(
+		&domain->lookup_table, table);
+	if (retired != NULL) {
+		retired->next_retired = domain->retired_lookup_tables;
+		domain->retired_lookup_tables = retired;
+	}
+
+	retired = domain->retired_lookup_tables;
+	domain->retired_lookup_tables = NULL;
+	locker.Unlock();
+
+	if (retired == NULL)
+		return;
+
+	wait_for_route_lookups(domain);
+
+	locker.Lock();
+	while (retired != NULL) {
+		route_lookup_table* next = retired->next_retired;
+		delete_route_lookup_table(domain, retired);
+		retired = next;
+	}
+}
+
+
+/*!	Must be called whenever the route list of the \a domain changes. Stops
+	lock-free lookups until the lookup table has been rebuilt.
+*/
+static void
+invalidate_route_lookup_table(net_domain_private* domain)
+{
+	ASSERT_LOCKED_RECURSIVE(&domain->lock);
+
+	if (route_lookup_key_bits(domain->family) == 0)
+		return;
+
+	route_lookup_table* table = atomic_pointer_get_and_set(
+		&domain->lookup_table, (route_lookup_table*)NULL);
+	if (table != NULL) {
+		table->next_retired = domain->retired_lookup_tables;
+		domain->retired_lookup_tables = table;
+	}
+
+	if (!is_timer_active(&domain->lookup_timer))
+		set_timer(&domain->lookup_timer, kRouteLookupRebuildDelay);
+}
+
+
+/*!	Looks up the route for \a address in the domain's lookup table without
+	taking the domain lock. If the table cannot give a definite answer,
+	\c false is returned, and the caller has to search the route list
+	instead.
+	Otherwise, \a _route is set to a referenced route, or \c NULL if there
+	is none.
+*/
+static bool
+lookup_route(net_domain_private* domain, const sockaddr* address,
+	net_route_private*& _route)
+{
+	uint64 key[2];
+	if (!route_lookup_key(domain->family, address, key))
+		return false;
+
+	int32 index = atomic_get(&domain->lookup_generation) & 1;
+	atomic_add(&domain->lookup_readers[index], 1);
+
+	route_lookup_table* table = atomic_pointer_get(&domain->lookup_table);
+	net_route_private* route = NULL;
+	if (table != NULL) {
+		uint32 value = table->table.Lookup(key);
+		if (value != 0) {
+			route = table->routes[value - 1];
+			atomic_add(&route->ref_count, 1);
+				// the table keeps the route alive, so this can't be the
+				// first reference
+		}
+	}
+
+	atomic_add(&domain->lookup_readers[index], -1);
+
+	if (table == NULL)
+		return false;
+
+	if (route != NULL
+		&& (route->interface_address->interface->device->flags & IFF_LINK)
+			== 0) {
+		// find_route() might prefer a less specific route that has a link
+		put_route(domain, route);
+		return false;
+	}
+
+	_route = route;
+	return true;
+}
+
+
 //	#pragma mark - exported functions
 
 
+void
+init_route_lookup(net_domain_private* domain)
+{
+	domain->lookup_table = NULL;
+	domain->retired_lookup_tables = NULL;
+	domain->lookup_generation = 0;
+	domain->lookup_readers[0] = 0;
+	domain->lookup_readers[1] = 0;
+	init_timer(&domain->lookup_timer, &rebuild_route_lookup_table, domain);
+}
+
+
+void
+uninit_route_lookup(net_domain_private* domain)
+{
+	cancel_timer(&domain->lookup_timer);
+	wait_for_timer(&domain->lookup_timer);
+
+	RecursiveLocker locker(domain->lock);
+
+	route_lookup_table* table = domain->lookup_table;
+	domain->lookup_table = NULL;
+	if (table != NULL) {
+		table->next_retired = domain->retired_lookup_tables;
+		domain->retired_lookup_tables = table;
+	}
+
+	while (domain->retired_lookup_tables != NULL) {
+		table = domain->retired_lookup_tables;
+		domain->retired_lookup_tables = table->next_retired;
+		delete_route_lookup_table(domain, table);
+	}
+}
+
+
 /*!	Determines the size of a buffer large enough to contain the whole
 	routing table.
 */
@@ -514,6 +844,7 @@ add_route(struct net_domain* _domain, const struct net_route* newRoute)
 	}
 
 	domain->routes.InsertBefore(before, route);
+	invalidate_route_lookup_table(domain);
 	update_route_infos(domain);
 
 	return B_OK;
@@ -542,6 +873,7 @@ remove_route(struct net_domain* _domain, const struct net_route* removeRoute)
 		return B_ENTRY_NOT_FOUND;
 
 	domain->routes.Remove(route);
+	invalidate_route_lookup_table(domain);
 
 	put_route_internal(domain, route);
 	update_route_infos(domain);
@@ -623,6 +955,11 @@ struct net_route*
 get_route(struct net_domain* _domain, const struct sockaddr* address)
 {
 	struct net_domain_private* domain = (net_domain_private*)_domain;
+
+	net_route_private* route;
+	if (lookup_route(domain, address, route))
+		return route;
+
 	RecursiveLocker locker(domain->lock);
 
 	return get_route_internal(domain, address);
@@ -652,9 +989,7 @@ get_buffer_route(net_domain* _domain, net_buffer* buffer, net_route** _route)
 {
 	net_domain_private* domain = (net_domain_private*)_domain;
 
-	RecursiveLocker _(domain->lock);
-
-	net_route* route = get_route_internal(domain, buffer->destination);
+	net_route* route = get_route(domain, buffer->destination);
 	if (route == NULL)
 		return ENETUNREACH;
 
@@ -671,7 +1006,7 @@ get_buffer_route(net_domain* _domain, net_buffer* buffer, net_route** _route)
 	}
 
 	if (status != B_OK)
-		put_route_internal(domain, route);
+		put_route(domain, route);
 	else
 		*_route = route;
 
@@ -683,12 +1018,15 @@ void
 put_route(struct net_domain* _domain, net_route* route)
 {
 	struct net_domain_private* domain = (net_domain_private*)_domain;
-	if (domain == NULL || route == NULL)
+	if (domain == NULL || route == NULL
+		|| atomic_add(&((net_route_private*)route)->ref_count, -1) != 1)
 		return;
 
+	// The last reference is gone, so the route has already been removed
+	// from the domain; only deleting it needs the lock.
 	RecursiveLocker locker(domain->lock);
 
-	put_route_internal(domain, (net_route*)route);
+	delete_route(domain, (net_route_private*)route);
 }
 
 
@@ -31,6 +31,9 @@ typedef DoublyLinkedList<net_route_info,
 	DoublyLinkedListCLink<net_route_info> > RouteInfoList;
 
 
+void init_route_lookup(struct net_domain_private* domain);
+void uninit_route_lookup(struct net_domain_private* domain);
+
 uint32 route_table_size(struct net_domain_private* domain);
 status_t list_routes(struct net_domain_private* domain, void* buffer,
 				size_t size);
@@ -27,7 +27,7 @@ print_usage(const char *app)
 {
 	printf("usage:\t%s <host> [-p <port>] [-w <width>] [-h <height>]\n", app);
 	printf("usage:\t%s <user@host> -s [<sshPort>] [-p <port>] [-w <width>]"
-		" [-h <height>] [-c <command>]\n", app);
+		" [-h <height>] [-c <command>] [-f]\n", app);
 	printf("\t%s --help\n\n", app);
 
 	printf("Connect to & run applications from a different computer\n\n");
@@ -37,6 +37,8 @@ print_usage(const char *app)
 	printf("\t-s\t\tuse SSH, optionally specify the SSH port to use (22)\n");
 	printf("\t-w\t\tmake the virtual desktop use the specified width\n");
 	printf("\t-h\t\tmake the virtual desktop use the specified height\n");
+	printf("\t-f\t\tlet the other computer draw, and send compressed screen"
+		" updates\n\t\t\tinstead of drawing commands (needs -s)\n");
 	printf("\nIf no width and height are specified, the window is opened with"
 		" the size of the the local screen.\n");
 }
@@ -55,6 +57,7 @@ main(int argc, char *argv[])
 	int32 width = -1;
 	int32 height = -1;
 	bool useSSH = false;
+	bool frameMode = false;
 	const char *command = NULL;
 	const char *host = argv[1];
 
@@ -98,6 +101,11 @@ main(int argc, char *argv[])
 			continue;
 		}
 
+		if (strcmp(argv[i], "-f") == 0) {
+			frameMode = true;
+			continue;
+		}
+
 		if (strcmp(argv[i], "-c") == 0) {
 			if (argc <= i + 1) {
 				print_usage(argv[0]);
@@ -113,7 +121,7 @@ main(int argc, char *argv[])
 		return 2;
 	}
 
-	if (command != NULL && !useSSH) {
+	if ((command != NULL || frameMode) && !useSSH) {
 		print_usage(argv[0]);
 		return 2;
 	}
@@ -136,8 +144,8 @@ main(int argc, char *argv[])
 
 		char shellCommand[4096];
 		snprintf(shellCommand, sizeof(shellCommand),
-			"echo connected; export TARGET_SCREEN=%" B_PRIu16 "; %s\n", port,
-			command);
+			"echo connected; export TARGET_SCREEN=%" B_PRIu16 "%s; %s\n", port,
+			frameMode ? ":frames" : "", command);
 
 		int pipes[4];
 		if (pipe(&pipes[0]) != 0 || pipe(&pipes[2]) != 0) {
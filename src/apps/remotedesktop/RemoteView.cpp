@@ -6,6 +6,7 @@
  *		Michael Lotz <mmlr@mlotz.ch>
  */
 
+#include "FrameTileCodec.h"
 #include "NetReceiver.h"
 #include "NetSender.h"
 #include "RemoteMessage.h"
@@ -24,6 +25,8 @@
 
 #include <new>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 
 
 static const uint8 kCursorData[] = { 16 /* size, 16x16 */,
@@ -69,7 +72,8 @@ RemoteView::RemoteView(BRect frame, const char *remoteHost, uint16 remotePort)
 	fOffscreen(NULL),
 	fViewCursor(kCursorData),
 	fCursorBitmap(NULL),
-	fCursorVisible(false)
+	fCursorVisible(false),
+	fFrameTileCache(NULL)
 {
 	fReceiveBuffer = new(std::nothrow) StreamingRingBuffer(16 * 1024);
 	if (fReceiveBuffer == NULL) {
@@ -174,6 +178,8 @@ RemoteView::~RemoteView()
 
 	int32 result;
 	wait_for_thread(fDrawThread, &result);
+
+	free(fFrameTileCache);
 }
 
 
@@ -567,6 +573,70 @@ RemoteView::_DrawThread()
 				continue;
 			}
 
+			case RP_FRAME_TILE:
+			case RP_FRAME_TILE_CACHED:
+			{
+				int32 left, top, width, height;
+				uint32 slot;
+				message.Read(left);
+				message.Read(top);
+				message.Read(width);
+				message.Read(height);
+				if (message.Read(slot) != B_OK)
+					continue;
+
+				BRect bounds = fOffscreenBitmap->Bounds();
+				if (slot >= kFrameTileCacheSize || width <= 0 || height <= 0
+					|| width > kFrameTileSize || height > kFrameTileSize
+					|| left < 0 || top < 0
+					|| left + width > bounds.IntegerWidth() + 1
+					|| top + height > bounds.IntegerHeight() + 1) {
+					TRACE_ERROR("invalid frame tile\n");
+					continue;
+				}
+
+				if (fFrameTileCache == NULL) {
+					fFrameTileCache = (uint8 *)malloc(kFrameTileCacheSize
+						* kFrameTileSize * kFrameTileSize * 4);
+					if (fFrameTileCache == NULL) {
+						TRACE_ERROR("no memory for the frame tile cache\n");
+						continue;
+					}
+				}
+
+				const uint32 tileBytesPerRow = kFrameTileSize * 4;
+				uint8 *tile = fFrameTileCache
+					+ slot * kFrameTileSize * tileBytesPerRow;
+
+				if (code == RP_FRAME_TILE) {
+					char *data;
+					size_t size;
+					if (message.ReadString(&data, size) != B_OK)
+						continue;
+
+					status_t result = decode_frame_tile((const uint8 *)data,
+						size, tile, tileBytesPerRow, width, height);
+					free(data);
+
+					if (result != B_OK) {
+						TRACE_ERROR("failed to decode frame tile\n");
+						continue;
+					}
+				}
+
+				uint32 bytesPerRow = fOffscreenBitmap->BytesPerRow();
+				uint8 *bits = (uint8 *)fOffscreenBitmap->Bits()
+					+ top * bytesPerRow + left * 4;
+				for (int32 y = 0; y < height; y++) {
+					memcpy(bits + y * bytesPerRow, tile + y * tileBytesPerRow,
+						width * 4);
+				}
+
+				Invalidate(BRect(left, top, left + width - 1,
+					top + height - 1));
+				continue;
+			}
+
 			case RP_FILL_REGION_COLOR_NO_CLIPPING:
 			{
 				BRegion region;
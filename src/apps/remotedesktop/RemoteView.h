@@ -81,6 +81,8 @@ static	int32						_DrawEntry(void *data);
 		BRect						fCursorFrame;
 		bool						fCursorVisible;
 
+		uint8 *						fFrameTileCache;
+
 		BObjectList<engine_state>	fStates;
 };
 
@@ -26,15 +26,23 @@ BDirectMessageTarget::~BDirectMessageTarget()
 }
 
 
+/*!	Adds \a message to the queue without locking it. If \a _wasEmpty is
+	given, it is set to whether the queue was empty before, that is, whether
+	the looper might have to be woken up.
+*/
 bool
-BDirectMessageTarget::AddMessage(BMessage* message)
+BDirectMessageTarget::AddMessage(BMessage* message, bool* _wasEmpty)
 {
 	if (fClosed) {
 		delete message;
+		if (_wasEmpty != NULL)
+			*_wasEmpty = false;
 		return false;
 	}
 
-	fQueue.AddMessage(message);
+	bool wasEmpty = fQueue._AddMessage(message);
+	if (_wasEmpty != NULL)
+		*_wasEmpty = wasEmpty;
 	return true;
 }
 
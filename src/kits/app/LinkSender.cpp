@@ -61,14 +61,25 @@ LinkSender::LinkSender(port_id port)
 
 	fCurrentEnd(0),
 	fCurrentStart(0),
-	fCurrentStatus(B_OK)
+	fCurrentStatus(B_OK),
+
+	fSavedBuffer(NULL),
+	fSavedBufferSize(0),
+
+	fCommandBufferArea(-1),
+	fCommandBuffer(NULL),
+	fCommandBufferSize(0),
+	fCommandBufferSemaphore(-1),
+	fCommandBufferPosition(0),
+	fSegmentStart(0),
+	fRecordingNesting(0)
 {
 }
 
 
 LinkSender::~LinkSender()
 {
-	free(fBuffer);
+	free(IsRecording() ? fSavedBuffer : fBuffer);
 }
 
 
@@ -96,7 +107,18 @@ LinkSender::StartMessage(int32 code, size_t minSize)
 	// Eventually flush buffer to make space for the new message.
 	// Note, we do not take the actual buffer size into account to not
 	// delay the time between buffer flushes too much.
-	if (fBufferSize > 0 && (minSize > SpaceLeft() || fCurrentStart >= kWatermark)) {
+	// While recording, the commands are only sent when the buffer is full,
+	// or when they are flushed explicitly.
+	if (IsRecording()) {
+		if (minSize > SpaceLeft()) {
+			status_t status = FlushRecorded(true);
+			if (status < B_OK)
+				return status;
+		}
+		if (minSize > fBufferSize)
+			return fCurrentStatus = B_BUFFER_OVERFLOW;
+	} else if (fBufferSize > 0
+		&& (minSize > SpaceLeft() || fCurrentStart >= kWatermark)) {
 		status_t status = Flush();
 		if (status < B_OK)
 			return status;
@@ -397,6 +419,25 @@ LinkSender::FlushCompleted(size_t newBufferSize)
 	int32 start = fCurrentStart;
 	fCurrentEnd = fCurrentStart;
 
+	if (IsRecording()) {
+		// The command buffer cannot grow; once the server is done with it,
+		// the incomplete message is moved to its start
+		if (newBufferSize > fBufferSize) {
+			fCurrentEnd = end;
+			return B_BUFFER_OVERFLOW;
+		}
+
+		status_t status = FlushRecorded(true);
+		if (status < B_OK) {
+			fCurrentEnd = end;
+			return status;
+		}
+
+		fCurrentEnd = end - start;
+		memmove(fBuffer, fBuffer + start, fCurrentEnd);
+		return B_OK;
+	}
+
 	status_t status = Flush();
 	if (status < B_OK) {
 		fCurrentEnd = end;
@@ -426,6 +467,9 @@ LinkSender::Flush(bigtime_t timeout, bool needsReply)
 	if (fCurrentStatus < B_OK)
 		return fCurrentStatus;
 
+	if (IsRecording())
+		return FlushRecorded(false, timeout, needsReply);
+
 	EndMessage(needsReply);
 	if (fCurrentStart == 0)
 		return B_OK;
@@ -460,4 +504,137 @@ LinkSender::Flush(bigtime_t timeout, bool needsReply)
 	return B_OK;
 }
 
+
+/*!	Sets the buffer shared with the server that StartRecording() records
+	into. The server releases \a consumedSemaphore once it is done with
+	the buffer, so that it can be reused from the start.
+*/
+status_t
+LinkSender::SetCommandBuffer(area_id area, void* buffer, size_t size,
+	sem_id consumedSemaphore)
+{
+	if (IsRecording())
+		return B_BUSY;
+
+	fCommandBufferArea = area;
+	fCommandBuffer = (char*)buffer;
+	fCommandBufferSize = size;
+	fCommandBufferSemaphore = consumedSemaphore;
+	fCommandBufferPosition = 0;
+	return B_OK;
+}
+
+
+/*!	Starts recording messages into the command buffer instead of sending
+	them through the port. Whenever the link is flushed, the server is only
+	told which part of the buffer to execute. Calls can be nested.
+*/
+status_t
+LinkSender::StartRecording()
+{
+	if (fCommandBuffer == NULL)
+		return B_NO_INIT;
+
+	if (fRecordingNesting > 0) {
+		fRecordingNesting++;
+		return B_OK;
+	}
+
+	// the server executes the commands in the order they were sent
+	status_t status = Flush();
+	if (status < B_OK)
+		return status;
+
+	fSavedBuffer = fBuffer;
+	fSavedBufferSize = fBufferSize;
+	fBuffer = fCommandBuffer;
+	fBufferSize = fCommandBufferSize;
+
+	fCurrentStart = fCurrentEnd = fSegmentStart = fCommandBufferPosition;
+	fRecordingNesting = 1;
+	return B_OK;
+}
+
+
+status_t
+LinkSender::StopRecording()
+{
+	if (fRecordingNesting == 0)
+		return B_NO_INIT;
+	if (--fRecordingNesting > 0)
+		return B_OK;
+
+	status_t status = B_OK;
+	if (fCurrentStatus == B_OK)
+		status = FlushRecorded(false);
+
+	// the next recording continues after what the server still executes
+	fCommandBufferPosition = fSegmentStart;
+
+	fBuffer = fSavedBuffer;
+	fBufferSize = fSavedBufferSize;
+	fSavedBuffer = NULL;
+	fSavedBufferSize = 0;
+
+	fCurrentStart = fCurrentEnd = 0;
+	fCurrentStatus = B_OK;
+	return status;
+}
+
+
+/*!	Tells the server to execute the recorded messages it has not seen yet.
+	If \a rewind is \c true, waits until the server is done with the buffer,
+	and starts over at its beginning.
+*/
+status_t
+LinkSender::FlushRecorded(bool rewind, bigtime_t timeout, bool needsReply)
+{
+	EndMessage(needsReply);
+	if (fCurrentStart == fSegmentStart && !rewind)
+		return B_OK;
+
+	struct {
+		message_header	header;
+		uint32			start;
+		uint32			end;
+		uint32			rewind;
+	} message;
+	message.header.size = sizeof(message);
+	message.header.code = AS_EXECUTE_COMMAND_BUFFER;
+	message.header.flags = 0;
+	message.start = fSegmentStart;
+	message.end = fCurrentStart;
+	message.rewind = rewind;
+
+	status_t err;
+	if (timeout != B_INFINITE_TIMEOUT) {
+		do {
+			err = write_port_etc(fPort, kLinkCode, &message, sizeof(message),
+				B_RELATIVE_TIMEOUT, timeout);
+		} while (err == B_INTERRUPTED);
+	} else {
+		do {
+			err = write_port(fPort, kLinkCode, &message, sizeof(message));
+		} while (err == B_INTERRUPTED);
+	}
+
+	if (err < B_OK)
+		return err;
+
+	fSegmentStart = fCurrentStart;
+
+	if (rewind) {
+		do {
+			err = acquire_sem(fCommandBufferSemaphore);
+		} while (err == B_INTERRUPTED);
+
+		if (err < B_OK)
+			return err;
+
+		fCurrentStart = fCurrentEnd = fSegmentStart = 0;
+	}
+
+	return B_OK;
+}
+
 }	// namespace BPrivate
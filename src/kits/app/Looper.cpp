@@ -31,6 +31,7 @@
 #include <AutoLocker.h>
 #include <DirectMessageTarget.h>
 #include <LooperList.h>
+#include <MessageAdapter.h>
 #include <MessagePrivate.h>
 #include <TokenSpace.h>
 
@@ -1050,11 +1051,11 @@ BLooper::_InitData(const char* name, int32 priority, port_id port,
 void
 BLooper::AddMessage(BMessage* message)
 {
-	_AddMessagePriv(message);
+	bool wasEmpty;
+	fDirectTarget->AddMessage(message, &wasEmpty);
 
 	// wakeup looper when being called from other threads if necessary
-	if (find_thread(NULL) != Thread()
-		&& fDirectTarget->Queue()->IsNextMessage(message)
+	if (wasEmpty && find_thread(NULL) != Thread()
 		&& port_count(fMsgPort) <= 0) {
 		// there is currently no message waiting, and we need to wakeup the
 		// looper
@@ -1095,6 +1096,13 @@ BLooper::_task0_(void* arg)
 
 void*
 BLooper::ReadRawFromPort(int32* msgCode, bigtime_t timeout)
+{
+	return _ReadRawFromPort(msgCode, NULL, timeout);
+}
+
+
+void*
+BLooper::_ReadRawFromPort(int32* msgCode, ssize_t* _size, bigtime_t timeout)
 {
 	PRINT(("BLooper::ReadRawFromPort()\n"));
 	uint8* buffer = NULL;
@@ -1127,6 +1135,9 @@ BLooper::ReadRawFromPort(int32* msgCode, bigtime_t timeout)
 	PRINT(("BLooper::ReadRawFromPort() read: %.4s, %p (%d bytes)\n",
 		(char*)msgCode, buffer, bufferSize));
 
+	if (_size != NULL)
+		*_size = bufferSize;
+
 	return buffer;
 }
 
@@ -1136,14 +1147,27 @@ BLooper::ReadMessageFromPort(bigtime_t timeout)
 {
 	PRINT(("BLooper::ReadMessageFromPort()\n"));
 	int32 msgCode;
+	ssize_t size;
 	BMessage* message = NULL;
 
-	void* buffer = ReadRawFromPort(&msgCode, timeout);
+	void* buffer = _ReadRawFromPort(&msgCode, &size, timeout);
 	if (buffer == NULL)
 		return NULL;
 
-	message = ConvertToMessage(buffer, msgCode);
-	free(buffer);
+	if (size >= (ssize_t)sizeof(uint32)
+		&& *(uint32*)buffer == MESSAGE_FORMAT_HAIKU) {
+		// Native messages take over the buffer, and are read from it
+		// directly, instead of being copied by ConvertToMessage().
+		message = new BMessage();
+		if (BMessage::Private(message).AdoptFlattened(buffer, size) != B_OK) {
+			PRINT(("BLooper::ReadMessageFromPort(): invalid message\n"));
+			delete message;
+			message = NULL;
+		}
+	} else {
+		message = ConvertToMessage(buffer, msgCode);
+		free(buffer);
+	}
 
 	PRINT(("BLooper::ReadMessageFromPort() done: %p\n", message));
 	return message;
@@ -35,6 +35,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/uio.h>
 
 #include "tracing_config.h"
 	// kernel tracing configuration
@@ -75,6 +76,9 @@ extern "C" {
 	// private os function to set the owning team of an area
 	status_t _kern_transfer_area(area_id area, void** _address,
 		uint32 addressSpec, team_id target);
+	status_t _kern_writev_port_etc(port_id port, int32 messageCode,
+		const struct iovec* vecs, size_t vecCount, size_t bufferSize,
+		uint32 flags, bigtime_t timeout);
 }
 
 
@@ -124,8 +128,8 @@ handle_reply(port_id replyPort, int32* _code, bigtime_t timeout,
 	if (size < 0)
 		return size;
 
-	BStackOrHeapArray<char, 4096> buffer(size);
-	if (!buffer.IsValid())
+	char* buffer = (char*)malloc(size);
+	if (buffer == NULL)
 		return B_NO_MEMORY;
 
 	status_t result;
@@ -133,10 +137,19 @@ handle_reply(port_id replyPort, int32* _code, bigtime_t timeout,
 		result = read_port(replyPort, _code, buffer, size);
 	} while (result == B_INTERRUPTED);
 
-	if (result < 0 || *_code != kPortMessageCode)
+	if (result < 0 || *_code != kPortMessageCode) {
+		free(buffer);
 		return result < 0 ? result : B_ERROR;
+	}
+
+	if (size >= (ssize_t)sizeof(uint32)
+		&& *(uint32*)buffer == MESSAGE_FORMAT_HAIKU) {
+		// the reply is looked up right in the buffer
+		return BMessage::Private(reply).AdoptFlattened(buffer, size);
+	}
 
 	result = reply->Unflatten(buffer);
+	free(buffer);
 	return result;
 }
 
@@ -193,14 +206,29 @@ BMessage::operator=(const BMessage& other)
 
 	_Clear();
 
-	fHeader = (message_header*)malloc(sizeof(message_header));
-	if (fHeader == NULL)
-		return *this;
+	ssize_t size = other.FlattenedSize();
+	if (size > 0 && size <= MAX_INLINE_BUFFER_SIZE
+		&& (other.fHeader->field_count == 0 || other.fFields != NULL)
+		&& (other.fHeader->data_size == 0 || other.fData != NULL)) {
+		// Small messages are copied into a single buffer, laid out like
+		// the flattened message
+		fHeader = (message_header*)malloc(size);
+		if (fHeader == NULL)
+			return *this;
 
-	if (other.fHeader == NULL)
-		return *this;
+		other.Flatten((char*)fHeader, size);
+		fBufferSize = size;
+		_UpdateInlineLayout();
+	} else {
+		fHeader = (message_header*)malloc(sizeof(message_header));
+		if (fHeader == NULL)
+			return *this;
+
+		if (other.fHeader == NULL)
+			return *this;
 
-	memcpy(fHeader, other.fHeader, sizeof(message_header));
+		memcpy(fHeader, other.fHeader, sizeof(message_header));
+	}
 
 	// Clear some header flags inherited from the original message that don't
 	// apply to the clone.
@@ -209,6 +237,12 @@ BMessage::operator=(const BMessage& other)
 		| MESSAGE_FLAG_PASS_BY_AREA);
 	// Note, that BeOS R5 seems to keep the reply info.
 
+	if (_IsInline()) {
+		fHeader->what = what = other.what;
+		fHeader->message_area = -1;
+		return *this;
+	}
+
 	if (fHeader->field_count > 0) {
 		size_t fieldsSize = fHeader->field_count * sizeof(field_header);
 		if (other.fFields != NULL)
@@ -357,6 +391,7 @@ BMessage::_InitCommon(bool initHeader)
 	fQueueLink = NULL;
 
 	fArchivingPointer = NULL;
+	fBufferSize = 0;
 
 	if (initHeader)
 		return _InitHeader();
@@ -370,9 +405,11 @@ BMessage::_InitHeader()
 {
 	DEBUG_FUNCTION_ENTER;
 	if (fHeader == NULL) {
-		fHeader = (message_header*)malloc(sizeof(message_header));
+		fHeader = (message_header*)malloc(INLINE_BUFFER_SIZE);
 		if (fHeader == NULL)
 			return B_NO_MEMORY;
+
+		fBufferSize = INLINE_BUFFER_SIZE;
 	}
 
 	memset(fHeader, 0, sizeof(message_header) - sizeof(fHeader->hash_table));
@@ -391,6 +428,10 @@ BMessage::_InitHeader()
 	// initializing the hash table to -1 because 0 is a valid index
 	fHeader->hash_table_size = MESSAGE_BODY_HASH_TABLE_SIZE;
 	memset(&fHeader->hash_table, 255, sizeof(fHeader->hash_table));
+
+	if (_IsInline())
+		_UpdateInlineLayout();
+
 	return B_OK;
 }
 
@@ -413,10 +454,13 @@ BMessage::_Clear()
 		fHeader = NULL;
 	}
 
-	free(fFields);
+	if (!_IsInline()) {
+		free(fFields);
+		free(fData);
+	}
 	fFields = NULL;
-	free(fData);
 	fData = NULL;
+	fBufferSize = 0;
 
 	fArchivingPointer = NULL;
 
@@ -783,6 +827,10 @@ BMessage::Rename(const char* oldEntry, const char* newEntry)
 			return result;
 	}
 
+	result = _Reserve(strlen(newEntry) + 1);
+	if (result != B_OK)
+		return result;
+
 	uint32 hash = _HashName(oldEntry) % fHeader->hash_table_size;
 	int32* nextField = &fHeader->hash_table[hash];
 
@@ -1048,6 +1096,12 @@ BMessage::Flatten(char* buffer, ssize_t size) const
 	/* we have to sync the what code as it is a public member */
 	fHeader->what = what;
 
+	if (_IsInline()) {
+		// the buffer is laid out like the flattened message already
+		memcpy(buffer, fHeader, FlattenedSize());
+		return B_OK;
+	}
+
 	memcpy(buffer, fHeader, sizeof(message_header));
 	buffer += sizeof(message_header);
 
@@ -1074,6 +1128,18 @@ BMessage::Flatten(BDataIO* stream, ssize_t* size) const
 	/* we have to sync the what code as it is a public member */
 	fHeader->what = what;
 
+	if (_IsInline()) {
+		ssize_t flattenedSize = FlattenedSize();
+		ssize_t result = stream->Write(fHeader, flattenedSize);
+		if (result != flattenedSize)
+			return result < 0 ? result : B_ERROR;
+
+		if (size)
+			*size = result;
+
+		return B_OK;
+	}
+
 	ssize_t result1 = stream->Write(fHeader, sizeof(message_header));
 	if (result1 != sizeof(message_header))
 		return result1 < 0 ? result1 : B_ERROR;
@@ -1263,24 +1329,129 @@ BMessage::_ValidateMessage()
 	if (fHeader == NULL)
 		return B_NO_INIT;
 
-	if (fHeader->field_count == 0)
-		return B_OK;
+	// the hash table has to point to existing fields only, since lookups
+	// follow it without any further checks
+	bool valid = fHeader->hash_table_size > 0
+		&& fHeader->hash_table_size <= MESSAGE_BODY_HASH_TABLE_SIZE;
+	for (uint32 i = 0; valid && i < fHeader->hash_table_size; i++) {
+		valid = fHeader->hash_table[i] >= -1
+			&& fHeader->hash_table[i] < (int32)fHeader->field_count;
+	}
 
-	if (fFields == NULL)
+	if (valid && fHeader->field_count > 0 && fFields == NULL)
 		return B_NO_INIT;
 
-	for (uint32 i = 0; i < fHeader->field_count; i++) {
+	for (uint32 i = 0; valid && i < fHeader->field_count; i++) {
 		field_header* field = &fFields[i];
-		if ((field->next_field >= 0
-				&& (uint32)field->next_field > fHeader->field_count)
-			|| (field->offset + field->name_length + field->data_size
-				> fHeader->data_size)) {
-			// the message is corrupt
-			MakeEmpty();
-			return B_BAD_VALUE;
+		valid = (field->next_field < 0
+				|| (uint32)field->next_field < fHeader->field_count)
+			&& field->name_length > 0
+			&& (uint64)field->offset + field->name_length + field->data_size
+				<= fHeader->data_size
+			&& fData[field->offset + field->name_length - 1] == '\0';
+	}
+
+	if (!valid) {
+		// the message is corrupt
+		MakeEmpty();
+		return B_BAD_VALUE;
+	}
+
+	return B_OK;
+}
+
+
+bool
+BMessage::_IsInline() const
+{
+	return fBufferSize != 0;
+}
+
+
+/*!	Points fFields and fData into the buffer of an inline message, right
+	behind the header, where they are in the flattened message, too.
+*/
+void
+BMessage::_UpdateInlineLayout()
+{
+	fFields = (field_header*)(fHeader + 1);
+	fData = (uint8*)(fFields + fHeader->field_count);
+	fFieldsAvailable = 0;
+	fDataAvailable = fBufferSize - sizeof(message_header)
+		- fHeader->field_count * sizeof(field_header) - fHeader->data_size;
+}
+
+
+/*!	Makes sure that \a size bytes of fields and data can be added to an
+	inline message without moving its buffer, so that pointers to its fields
+	stay valid. This has to be done before a field is added or grown.
+	The buffer is enlarged as needed; messages that would no longer fit into
+	MAX_INLINE_BUFFER_SIZE get their fields and data moved out of it.
+*/
+status_t
+BMessage::_Reserve(size_t size)
+{
+	if (!_IsInline() || fDataAvailable >= size)
+		return B_OK;
+
+	// adopted buffers may be larger than inline buffers could grow
+	size_t used = fBufferSize - fDataAvailable;
+	if (used > MAX_INLINE_BUFFER_SIZE || size > MAX_INLINE_BUFFER_SIZE - used)
+		return _MoveOutOfLine();
+
+	size_t bufferSize = max_c(fBufferSize * 2, used + size);
+	bufferSize = min_c(bufferSize, (size_t)MAX_INLINE_BUFFER_SIZE);
+
+	message_header* header = (message_header*)realloc(fHeader, bufferSize);
+	if (header == NULL)
+		return B_NO_MEMORY;
+
+	fHeader = header;
+	fBufferSize = bufferSize;
+	_UpdateInlineLayout();
+	return B_OK;
+}
+
+
+/*!	Moves the fields and data of an inline message into buffers of their
+	own, which are grown separately from then on.
+*/
+status_t
+BMessage::_MoveOutOfLine()
+{
+	field_header* newFields = NULL;
+	uint8* newData = NULL;
+
+	if (fHeader->field_count > 0) {
+		size_t fieldsSize = fHeader->field_count * sizeof(field_header);
+		newFields = (field_header*)malloc(fieldsSize);
+		if (newFields == NULL)
+			return B_NO_MEMORY;
+
+		memcpy(newFields, fFields, fieldsSize);
+	}
+
+	if (fHeader->data_size > 0) {
+		newData = (uint8*)malloc(fHeader->data_size);
+		if (newData == NULL) {
+			free(newFields);
+			return B_NO_MEMORY;
 		}
+
+		memcpy(newData, fData, fHeader->data_size);
 	}
 
+	// the header does not need the rest of the buffer anymore
+	message_header* header = (message_header*)realloc(fHeader,
+		sizeof(message_header));
+	if (header != NULL)
+		fHeader = header;
+
+	fFields = newFields;
+	fData = newData;
+	fFieldsAvailable = 0;
+	fDataAvailable = 0;
+	fBufferSize = 0;
 	return B_OK;
 }
 
@@ -1317,29 +1488,57 @@ BMessage::Unflatten(BDataIO* stream)
 
 	_Clear();
 
-	fHeader = (message_header*)malloc(sizeof(message_header));
-	if (fHeader == NULL)
-		return B_NO_MEMORY;
-
-	fHeader->format = format;
-	uint8* header = (uint8*)fHeader;
-	ssize_t result = stream->Read(header + sizeof(uint32),
+	message_header header;
+	header.format = format;
+	ssize_t result = stream->Read((uint8*)&header + sizeof(uint32),
 		sizeof(message_header) - sizeof(uint32));
 	if (result != sizeof(message_header) - sizeof(uint32)
-		|| (fHeader->flags & MESSAGE_FLAG_VALID) == 0) {
+		|| (header.flags & MESSAGE_FLAG_VALID) == 0) {
 		_InitHeader();
 		return result < 0 ? result : B_BAD_VALUE;
 	}
 
+	bool passByArea = (header.flags & MESSAGE_FLAG_PASS_BY_AREA) != 0
+		&& header.message_area >= 0;
+
+	// Small messages are read into a single buffer, since it is laid out
+	// just like the flattened message
+	size_t size = sizeof(message_header);
+	bool isInline = false;
+	if (!passByArea && header.data_size <= MAX_INLINE_BUFFER_SIZE
+		&& header.field_count <= MAX_INLINE_BUFFER_SIZE / sizeof(field_header)) {
+		size += header.field_count * sizeof(field_header) + header.data_size;
+		isInline = size <= MAX_INLINE_BUFFER_SIZE;
+		if (!isInline)
+			size = sizeof(message_header);
+	}
+
+	fHeader = (message_header*)malloc(size);
+	if (fHeader == NULL)
+		return B_NO_MEMORY;
+
+	memcpy(fHeader, &header, sizeof(message_header));
 	what = fHeader->what;
 
-	if ((fHeader->flags & MESSAGE_FLAG_PASS_BY_AREA) != 0
-		&& fHeader->message_area >= 0) {
+	if (passByArea) {
 		status_t result = _Reference();
 		if (result != B_OK) {
 			_InitHeader();
 			return result;
 		}
+	} else if (isInline) {
+		fHeader->message_area = -1;
+		fBufferSize = size;
+		_UpdateInlineLayout();
+
+		ssize_t bodySize = size - sizeof(message_header);
+		if (bodySize > 0) {
+			result = stream->Read(fFields, bodySize);
+			if (result != bodySize) {
+				_InitHeader();
+				return result < 0 ? result : B_BAD_VALUE;
+			}
+		}
 	} else {
 		fHeader->message_area = -1;
 
@@ -1381,6 +1580,56 @@ BMessage::Unflatten(BDataIO* stream)
 }
 
 
+/*!	Makes the message use \a buffer, that contains a flattened message of
+	\a size bytes, instead of copying it like Unflatten() does. Since it is
+	laid out just like an inline message, the fields are found right in the
+	buffer, and it is only copied once the message grows out of it. Messages
+	passed by area reference it just like after Unflatten().
+	The buffer needs to be allocated with malloc(), and belongs to the
+	message afterwards, even if this fails.
+*/
+status_t
+BMessage::_AdoptFlattened(void* buffer, size_t size)
+{
+	DEBUG_FUNCTION_ENTER;
+	message_header* header = (message_header*)buffer;
+	if (buffer == NULL || size < sizeof(message_header) || size > UINT32_MAX
+		|| header->format != MESSAGE_FORMAT_HAIKU
+		|| (header->flags & MESSAGE_FLAG_VALID) == 0) {
+		free(buffer);
+		return B_BAD_VALUE;
+	}
+
+	bool passByArea = (header->flags & MESSAGE_FLAG_PASS_BY_AREA) != 0
+		&& header->message_area >= 0;
+	if (!passByArea && sizeof(message_header)
+			+ (uint64)header->field_count * sizeof(field_header)
+			+ header->data_size != size) {
+		free(buffer);
+		return B_BAD_VALUE;
+	}
+
+	_Clear();
+
+	fHeader = header;
+	what = fHeader->what;
+
+	if (passByArea) {
+		status_t result = _Reference();
+		if (result != B_OK) {
+			_InitHeader();
+			return result;
+		}
+	} else {
+		fHeader->message_area = -1;
+		fBufferSize = size;
+		_UpdateInlineLayout();
+	}
+
+	return _ValidateMessage();
+}
+
+
 status_t
 BMessage::AddSpecifier(const char* property)
 {
@@ -1587,6 +1836,12 @@ BMessage::_ResizeData(uint32 offset, int32 change)
 			return B_OK;
 		}
 
+		if (_IsInline()) {
+			// the space needs to be reserved beforehand, since growing the
+			// buffer would move the fields as well
+			return B_NO_MEMORY;
+		}
+
 		// We need to grow the buffer. We try to optimize reallocations by
 		// preallocating space for more fields.
 		size_t size = fHeader->data_size * 2;
@@ -1614,7 +1869,7 @@ BMessage::_ResizeData(uint32 offset, int32 change)
 		fHeader->data_size += change;
 		fDataAvailable -= change;
 
-		if (fDataAvailable > MAX_DATA_PREALLOCATION) {
+		if (!_IsInline() && fDataAvailable > MAX_DATA_PREALLOCATION) {
 			ssize_t available = MAX_DATA_PREALLOCATION / 2;
 			ssize_t size = fHeader->data_size + available;
 			uint8* newData = (uint8*)realloc(fData, size);
@@ -1694,7 +1949,17 @@ BMessage::_AddField(const char* name, type_code type, bool isFixedSize,
 	if (fHeader == NULL)
 		return B_NO_INIT;
 
-	if (fFieldsAvailable <= 0) {
+	if (_IsInline()) {
+		// move the data to make room for the field, the space has been
+		// reserved by the caller
+		if (fDataAvailable < sizeof(field_header) + strlen(name) + 1)
+			return B_NO_MEMORY;
+
+		memmove(fData + sizeof(field_header), fData, fHeader->data_size);
+		fData += sizeof(field_header);
+		fDataAvailable -= sizeof(field_header);
+		fFieldsAvailable++;
+	} else if (fFieldsAvailable <= 0) {
 		uint32 count = fHeader->field_count * 2 + 1;
 		count = min_c(count, fHeader->field_count + MAX_FIELD_PREALLOCATION);
 
@@ -1770,6 +2035,15 @@ BMessage::_RemoveField(field_header* field)
 	fHeader->field_count--;
 	fFieldsAvailable++;
 
+	if (_IsInline()) {
+		// close the gap between the fields and the data
+		memmove(fData - sizeof(field_header), fData, fHeader->data_size);
+		fData -= sizeof(field_header);
+		fDataAvailable += sizeof(field_header);
+		fFieldsAvailable--;
+		return B_OK;
+	}
+
 	if (fFieldsAvailable > MAX_FIELD_PREALLOCATION) {
 		ssize_t available = MAX_FIELD_PREALLOCATION / 2;
 		size = (fHeader->field_count + available) * sizeof(field_header);
@@ -1808,6 +2082,14 @@ BMessage::AddData(const char* name, type_code type, const void* data,
 			return result;
 	}
 
+	if (name == NULL)
+		return B_BAD_VALUE;
+
+	result = _Reserve(sizeof(field_header) + strlen(name) + 1 + numBytes
+		+ sizeof(uint32));
+	if (result != B_OK)
+		return result;
+
 	field_header* field = NULL;
 	result = _FindField(name, type, &field);
 	if (result == B_NAME_NOT_FOUND)
@@ -1995,6 +2277,10 @@ BMessage::ReplaceData(const char* name, type_code type, int32 index,
 			return result;
 	}
 
+	result = _Reserve(numBytes);
+	if (result != B_OK)
+		return result;
+
 	field_header* field = NULL;
 	result = _FindField(name, type, &field);
 	if (result != B_OK)
@@ -2137,6 +2423,7 @@ BMessage::_SendMessage(port_id port, team_id portOwner, int32 token,
 	char stackBuffer[4096];
 	char* buffer = NULL;
 	message_header* header = NULL;
+	message_header sendHeader;
 	status_t result = B_OK;
 
 	BPrivate::BDirectMessageTarget* direct = NULL;
@@ -2200,6 +2487,14 @@ BMessage::_SendMessage(port_id port, team_id portOwner, int32 token,
 #endif
 	} else {
 		size = FlattenedSize();
+#ifndef HAIKU_TARGET_PLATFORM_LIBBE_TEST
+		// Only the header needs to be changed for the target, the fields
+		// and data are written to the port right from where they are, so
+		// that the message does not have to be flattened first.
+		memcpy(&sendHeader, fHeader, sizeof(message_header));
+		sendHeader.what = what;
+		header = &sendHeader;
+#else
 		if (size > (ssize_t)sizeof(stackBuffer)) {
 			buffer = (char*)malloc(size);
 			if (buffer == NULL)
@@ -2215,6 +2510,7 @@ BMessage::_SendMessage(port_id port, team_id portOwner, int32 token,
 		}
 
 		header = (message_header*)buffer;
+#endif
 	}
 
 	if (!replyTo.IsValid()) {
@@ -2243,10 +2539,37 @@ BMessage::_SendMessage(port_id port, team_id portOwner, int32 token,
 			"message: '%c%c%c%c'", portOwner, port, token,
 			char(what >> 24), char(what >> 16), char(what >> 8), (char)what);
 
-		do {
-			result = write_port_etc(port, kPortMessageCode, (void*)buffer,
-				size, B_RELATIVE_TIMEOUT, timeout);
-		} while (result == B_INTERRUPTED);
+#ifndef HAIKU_TARGET_PLATFORM_LIBBE_TEST
+		if (header == &sendHeader) {
+			iovec vecs[3];
+			size_t vecCount = 0;
+			vecs[vecCount].iov_base = header;
+			vecs[vecCount++].iov_len = sizeof(message_header);
+
+			size_t fieldsSize = fHeader->field_count * sizeof(field_header);
+			if (_IsInline())
+				fieldsSize += fHeader->data_size;
+			if (fieldsSize > 0) {
+				vecs[vecCount].iov_base = fFields;
+				vecs[vecCount++].iov_len = fieldsSize;
+			}
+			if (!_IsInline() && fHeader->data_size > 0) {
+				vecs[vecCount].iov_base = fData;
+				vecs[vecCount++].iov_len = fHeader->data_size;
+			}
+
+			do {
+				result = _kern_writev_port_etc(port, kPortMessageCode, vecs,
+					vecCount, size, B_RELATIVE_TIMEOUT, timeout);
+			} while (result == B_INTERRUPTED);
+		}
+#endif
+		if (buffer != NULL) {
+			do {
+				result = write_port_etc(port, kPortMessageCode, (void*)buffer,
+					size, B_RELATIVE_TIMEOUT, timeout);
+			} while (result == B_INTERRUPTED);
+		}
 	}
 
 	if (result == B_OK && IsSourceWaiting()) {
@@ -2265,8 +2588,9 @@ BMessage::_SendMessage(port_id port, team_id portOwner, int32 token,
 			char(what >> 24), char(what >> 16), char(what >> 8), (char)what);
 
 		// this is a local message transmission
-		direct->AddMessage(copy);
-		if (direct->Queue()->IsNextMessage(copy) && port_count(port) <= 0) {
+		bool wasEmpty;
+		direct->AddMessage(copy, &wasEmpty);
+		if (wasEmpty && port_count(port) <= 0) {
 			// there is currently no message waiting, and we need to wakeup the
 			// looper
 			write_port_etc(port, 0, NULL, 0, B_RELATIVE_TIMEOUT, 0);
@@ -16,12 +16,26 @@
 #include <Message.h>
 
 
+/*!	Messages are added without taking the lock: they are pushed onto the
+	fPending list, which only ever grows at its head, by any number of
+	threads. Whoever holds the lock takes over the whole list at once, and
+	moves it in order to the end of the queue, which is only accessed with
+	the lock held. So posting messages does not contend with the looper
+	taking them out, nor with other threads posting messages.
+
+	fMessageCount is only changed atomically, and is raised after a message
+	has been pushed, so that the one who added a message to an empty queue
+	knows it has to wake up the looper.
+*/
+
+
 BMessageQueue::BMessageQueue()
 	:
 	fHead(NULL),
 	fTail(NULL),
 	fMessageCount(0),
-	fLock("BMessageQueue Lock")
+	fLock("BMessageQueue Lock"),
+	fPending(NULL)
 {
 }
 
@@ -31,6 +45,8 @@ BMessageQueue::~BMessageQueue()
 	if (!Lock())
 		return;
 
+	_TakePendingMessages();
+
 	BMessage* message = fHead;
 	while (message != NULL) {
 		BMessage* next = message->fQueueLink;
@@ -44,27 +60,7 @@ BMessageQueue::~BMessageQueue()
 void
 BMessageQueue::AddMessage(BMessage* message)
 {
-	if (message == NULL)
-		return;
-
-	BAutolock _(fLock);
-	if (!IsLocked())
-		return;
-
-	// The message passed in will be the last message on the queue so its
-	// link member should be set to null.
-	message->fQueueLink = NULL;
-
-	fMessageCount++;
-
-	if (fTail == NULL) {
-		// there are no messages in the queue yet
-		fHead = fTail = message;
-	} else {
-		// just add it after the tail
-		fTail->fQueueLink = message;
-		fTail = message;
-	}
+	_AddMessage(message);
 }
 
 
@@ -78,6 +74,8 @@ BMessageQueue::RemoveMessage(BMessage* message)
 	if (!IsLocked())
 		return;
 
+	_TakePendingMessages();
+
 	BMessage* last = NULL;
 	for (BMessage* entry = fHead; entry != NULL; entry = entry->fQueueLink) {
 		if (entry == message) {
@@ -90,7 +88,7 @@ BMessageQueue::RemoveMessage(BMessage* message)
 			if (entry == fTail)
 				fTail = last;
 
-			fMessageCount--;
+			atomic_add(&fMessageCount, -1);
 			return;
 		}
 		last = entry;
@@ -101,14 +99,16 @@ BMessageQueue::RemoveMessage(BMessage* message)
 int32
 BMessageQueue::CountMessages() const
 {
-    return fMessageCount;
+	// the count can be off by the messages that are just being added
+	int32 count = atomic_get((int32*)&fMessageCount);
+	return count > 0 ? count : 0;
 }
 
 
 bool
 BMessageQueue::IsEmpty() const
 {
-    return fMessageCount == 0;
+	return CountMessages() == 0;
 }
 
 
@@ -119,9 +119,11 @@ BMessageQueue::FindMessage(int32 index) const
 	if (!IsLocked())
 		return NULL;
 
-	if (index < 0 || index >= fMessageCount)
+	if (index < 0)
 		return NULL;
 
+	const_cast<BMessageQueue*>(this)->_TakePendingMessages();
+
 	for (BMessage* message = fHead; message != NULL; message = message->fQueueLink) {
 		// If the index reaches zero, then we have found a match.
 		if (index == 0)
@@ -141,9 +143,11 @@ BMessageQueue::FindMessage(uint32 what, int32 index) const
 	if (!IsLocked())
 		return NULL;
 
-	if (index < 0 || index >= fMessageCount)
+	if (index < 0)
 		return NULL;
 
+	const_cast<BMessageQueue*>(this)->_TakePendingMessages();
+
 	for (BMessage* message = fHead; message != NULL; message = message->fQueueLink) {
 		if (message->what == what) {
 			// If the index reaches zero, then we have found a match.
@@ -188,11 +192,14 @@ BMessageQueue::NextMessage()
 
 	// remove the head of the queue, if any, and return it
 
+	if (fHead == NULL)
+		_TakePendingMessages();
+
 	BMessage* head = fHead;
 	if (head == NULL)
 		return NULL;
 
-	fMessageCount--;
+	atomic_add(&fMessageCount, -1);
 	fHead = head->fQueueLink;
 
 	if (fHead == NULL) {
@@ -210,6 +217,10 @@ bool
 BMessageQueue::IsNextMessage(const BMessage* message) const
 {
 	BAutolock _(fLock);
+
+	if (fHead == NULL)
+		const_cast<BMessageQueue*>(this)->_TakePendingMessages();
+
 	return fHead == message;
 }
 
@@ -223,7 +234,54 @@ BMessageQueue::IsLocked()
 }
 
 
+/*!	Adds \a message to the queue without locking it, and returns whether
+	the queue was empty before.
+*/
+bool
+BMessageQueue::_AddMessage(BMessage* message)
+{
+	if (message == NULL)
+		return false;
+
+	BMessage* pending = __atomic_load_n(&fPending, __ATOMIC_RELAXED);
+	do {
+		message->fQueueLink = pending;
+	} while (!__atomic_compare_exchange_n(&fPending, &pending, message, true,
+		__ATOMIC_RELEASE, __ATOMIC_RELAXED));
+
+	return atomic_add(&fMessageCount, 1) <= 0;
+}
+
+
+/*!	Moves all pending messages to the end of the queue. The queue must be
+	locked.
+*/
+void
+BMessageQueue::_TakePendingMessages()
+{
+	BMessage* pending = __atomic_exchange_n(&fPending, (BMessage*)NULL,
+		__ATOMIC_ACQUIRE);
+	if (pending == NULL)
+		return;
+
+	// the newest message comes first, and will end up last
+	BMessage* tail = pending;
+	BMessage* head = NULL;
+	while (pending != NULL) {
+		BMessage* next = pending->fQueueLink;
+		pending->fQueueLink = head;
+		head = pending;
+		pending = next;
+	}
+
+	if (fTail == NULL)
+		fHead = head;
+	else
+		fTail->fQueueLink = head;
+	fTail = tail;
+}
+
+
 void BMessageQueue::_ReservedMessageQueue1() {}
 void BMessageQueue::_ReservedMessageQueue2() {}
 void BMessageQueue::_ReservedMessageQueue3() {}
-
@@ -12,9 +12,12 @@
 
 
 #include <AppServerLink.h>
+#include <ApplicationPrivate.h>
 #include <FontPrivate.h>
 #include <ObjectList.h>
 #include <ServerProtocol.h>
+#include <ServerReadOnlyMemory.h>
+#include <SharedFontMetrics.h>
 #include <truncate_string.h>
 #include <utf8_functions.h>
 
@@ -30,6 +33,7 @@
 #include <new>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <pthread.h>
 
 
@@ -496,6 +500,165 @@ update_font_families(bool /*checkOnly*/)
 }
 
 
+//	#pragma mark - shared font metrics
+
+
+static area_id sFontMetricsServerArea = -1;
+static const shared_font_metrics_area* sFontMetrics = NULL;
+static pthread_once_t sFontMetricsInitOnce = PTHREAD_ONCE_INIT;
+
+
+static void
+init_font_metrics()
+{
+	server_read_only_memory* shared
+		= BApplication::Private::ServerReadOnlyMemory();
+	if (shared == NULL || shared->font_metrics_area < 0)
+		return;
+
+	void* address;
+	area_id area = clone_area("font metrics", &address, B_ANY_ADDRESS,
+		B_READ_AREA, shared->font_metrics_area);
+	if (area < 0)
+		return;
+
+	const shared_font_metrics_area* metrics
+		= (const shared_font_metrics_area*)address;
+	if (metrics->version != kSharedFontMetricsVersion) {
+		delete_area(area);
+		return;
+	}
+
+	sFontMetricsServerArea = shared->font_metrics_area;
+	sFontMetrics = metrics;
+}
+
+
+/*!	Returns the font metrics the app_server shares with its clients, or
+	\c NULL if there are none.
+*/
+static const shared_font_metrics_area*
+get_shared_font_metrics()
+{
+	if (be_app == NULL)
+		return NULL;
+
+	pthread_once(&sFontMetricsInitOnce, &init_font_metrics);
+	if (sFontMetrics == NULL)
+		return NULL;
+
+	// the metrics of a restarted app_server are not mapped
+	server_read_only_memory* shared
+		= BApplication::Private::ServerReadOnlyMemory();
+	if (shared == NULL || shared->font_metrics_area != sFontMetricsServerArea)
+		return NULL;
+
+	return sFontMetrics;
+}
+
+
+static inline bool
+is_white_space(uint32 charCode)
+{
+	// the same as GlyphLayoutEngine::IsWhiteSpace() in the app_server
+	switch (charCode) {
+		case 0x0009:	/* tab */
+		case 0x000b:	/* vertical tab */
+		case 0x000c:	/* form feed */
+		case 0x0020:	/* space */
+		case 0x00a0:	/* non breaking space */
+		case 0x000a:	/* line feed */
+		case 0x000d:	/* carriage return */
+		case 0x2028:	/* line separator */
+		case 0x2029:	/* paragraph separator */
+			return true;
+	}
+
+	return false;
+}
+
+
+/*!	Measures \a string from the shared font metrics exactly like the
+	app_server would. Returns \c false if the font is not published (yet),
+	or if the string contains characters that are not part of the
+	metrics; it then needs to be measured by the app_server.
+	If \a exactFont is \c true, the metrics are only used if they were
+	taken with the rotation and flags of \a font, too.
+*/
+static bool
+measure_from_shared_metrics(const BFont& font, const char* string,
+	int32 length, int32 maxChars, const escapement_delta* delta,
+	bool exactFont, float escapements[], float* _width)
+{
+	// kerning is not part of the metrics
+	if (font.Spacing() == B_STRING_SPACING)
+		return false;
+
+	const shared_font_metrics_area* area = get_shared_font_metrics();
+	if (area == NULL)
+		return false;
+
+	int32 generation = atomic_get((int32*)&area->generation);
+	if ((generation & 1) != 0)
+		return false;
+
+	uint32 fontID = font.FamilyAndStyle();
+	const shared_font_metrics* metrics = find_shared_font_metrics(area,
+		fontID >> 16, fontID & 0xffff, font.Size());
+	if (metrics == NULL)
+		return false;
+
+	// the metrics are taken from unrotated fonts with the default flags
+	if (exactFont && (font.Rotation() != 0.0f
+			|| font.Flags() != metrics->flags)) {
+		return false;
+	}
+
+	double size = font.Size();
+	double x = 0.0;
+	double advanceX = 0.0;
+	int32 index = 0;
+	const char* start = string;
+	uint32 charCode;
+
+	while (maxChars-- > 0 && (charCode = UTF8ToCharCode(&string)) != 0) {
+		if (charCode >= kSharedFontMetricsCharCount)
+			return false;
+
+		x += advanceX;
+
+		if (shared_font_metrics_missing(metrics, charCode)) {
+			advanceX = 0.0;
+			if (escapements != NULL)
+				escapements[index] = 0.0f;
+		} else {
+			const shared_glyph_metrics& glyph = metrics->glyphs[charCode];
+			if (font.Spacing() == B_CHAR_SPACING)
+				advanceX = glyph.precise_advance * size;
+			else
+				advanceX = glyph.advance;
+
+			if (delta != NULL) {
+				advanceX += is_white_space(charCode)
+					? delta->space : delta->nonspace;
+			}
+			if (escapements != NULL)
+				escapements[index] = advanceX / font.Size();
+		}
+
+		index++;
+		if (string - start + 1 > length)
+			break;
+	}
+
+	if (_width != NULL)
+		*_width = x + advanceX;
+
+	// the metrics must not have been replaced in the meantime
+	return atomic_get((int32*)&area->generation) == generation;
+}
+
+
 //	#pragma mark -
 
 
@@ -1041,6 +1204,24 @@ BFont::GetStringWidths(const char* stringArray[], const int32 lengthArray[],
 		return;
 	}
 
+	int32 measured = 0;
+	for (; measured < numStrings; measured++) {
+		const char* string = stringArray[measured];
+		int32 length = lengthArray[measured];
+		if (string == NULL || length <= 0) {
+			widthArray[measured] = 0.0f;
+			continue;
+		}
+
+		length = strnlen(string, length);
+		if (!measure_from_shared_metrics(*this, string, length, INT32_MAX,
+				NULL, false, NULL, &widthArray[measured])) {
+			break;
+		}
+	}
+	if (measured == numStrings)
+		return;
+
 	BPrivate::AppServerLink link;
 	link.StartMessage(AS_GET_STRING_WIDTHS);
 	link.Attach<uint16>(fFamilyID);
@@ -1078,6 +1259,12 @@ BFont::GetEscapements(const char charArray[], int32 numChars,
 	if (charArray == NULL || numChars < 1 || escapementArray == NULL)
 		return;
 
+	if (measure_from_shared_metrics(*this, charArray,
+			UTF8CountBytes(charArray, numChars), numChars, delta, true,
+			escapementArray, NULL)) {
+		return;
+	}
+
 	BPrivate::AppServerLink link;
 	link.StartMessage(AS_GET_ESCAPEMENTS_AS_FLOATS);
 	link.Attach<uint16>(fFamilyID);
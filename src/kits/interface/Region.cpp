@@ -22,23 +22,36 @@
 const static int32 kDataBlockSize = 8;
 
 
+/*!	Returns whether the two rectangles in the internal format, where right
+	and bottom are not part of the rectangle, share any pixels.
+*/
+static inline bool
+bounds_intersect(const clipping_rect& a, const clipping_rect& b)
+{
+	return a.left < b.right && b.left < a.right
+		&& a.top < b.bottom && b.top < a.bottom;
+}
+
+
+/*!	Small regions keep their only rectangle in fBounds, so that empty and
+	single rectangle regions never need to allocate memory.
+*/
 BRegion::BRegion()
 	:
 	fCount(0),
-	fDataSize(0),
+	fDataSize(1),
 	fBounds((clipping_rect){ 0, 0, 0, 0 }),
-	fData(NULL)
+	fData(&fBounds)
 {
-	_SetSize(kDataBlockSize);
 }
 
 
 BRegion::BRegion(const BRegion& other)
 	:
 	fCount(0),
-	fDataSize(0),
+	fDataSize(1),
 	fBounds((clipping_rect){ 0, 0, 0, 0 }),
-	fData(NULL)
+	fData(&fBounds)
 {
 	*this = other;
 }
@@ -63,9 +76,9 @@ BRegion::BRegion(const BRect rect)
 BRegion::BRegion(BRegion&& other)
 	:
 	fCount(0),
-	fDataSize(0),
+	fDataSize(1),
 	fBounds((clipping_rect){ 0, 0, 0, 0 }),
-	fData(NULL)
+	fData(&fBounds)
 {
 	MoveFrom(other);
 }
@@ -97,7 +110,7 @@ BRegion::operator=(const BRegion& other)
 		return *this;
 
 	// handle reallocation if we're too small to contain the other's data
-	if (_SetSize(other.fDataSize)) {
+	if (_SetSize(other.fCount)) {
 		memcpy(fData, other.fData, other.fCount * sizeof(clipping_rect));
 
 		fBounds = other.fBounds;
@@ -164,15 +177,18 @@ BRegion::MoveFrom(BRegion& other)
 		other.MakeEmpty();
 		return;
 	}
+	if (fData != &fBounds)
+		free(fData);
+
 	fCount = other.fCount;
 	fDataSize = other.fDataSize;
 	fBounds = other.fBounds;
 	fData = other.fData;
 
 	other.fCount = 0;
-	other.fDataSize = 0;
+	other.fDataSize = 1;
 	other.fBounds = (clipping_rect){ 0, 0, 0, 0 };
-	other.fData = NULL;
+	other.fData = &other.fBounds;
 }
 
 
@@ -373,6 +389,14 @@ BRegion::Include(clipping_rect clipping)
 	clipping.right++;
 	clipping.bottom++;
 
+	if (fCount == 0 || rect_contains(clipping, fBounds)) {
+		fCount = 1;
+		fData[0] = fBounds = clipping;
+		return;
+	}
+	if (Support::XRectInRegion(this, clipping) == Support::RectangleIn)
+		return;
+
 	// use private clipping_rect constructor which avoids malloc()
 	BRegion temp(clipping);
 
@@ -386,6 +410,19 @@ BRegion::Include(clipping_rect clipping)
 void
 BRegion::Include(const BRegion* region)
 {
+	if (region->fCount == 0 || region == this)
+		return;
+	if (fCount == 0 || (region->fCount == 1
+			&& rect_contains(region->fBounds, fBounds))) {
+		*this = *region;
+		return;
+	}
+	if (region->fCount == 1
+		&& Support::XRectInRegion(this, region->fBounds)
+			== Support::RectangleIn) {
+		return;
+	}
+
 	BRegion result;
 	Support::XUnionRegion(this, region, &result);
 
@@ -410,6 +447,13 @@ BRegion::Exclude(clipping_rect clipping)
 	clipping.right++;
 	clipping.bottom++;
 
+	if (fCount == 0 || !bounds_intersect(fBounds, clipping))
+		return;
+	if (rect_contains(clipping, fBounds)) {
+		MakeEmpty();
+		return;
+	}
+
 	// use private clipping_rect constructor which avoids malloc()
 	BRegion temp(clipping);
 
@@ -423,6 +467,16 @@ BRegion::Exclude(clipping_rect clipping)
 void
 BRegion::Exclude(const BRegion* region)
 {
+	if (fCount == 0 || region->fCount == 0
+		|| !bounds_intersect(fBounds, region->fBounds)) {
+		return;
+	}
+	if (region == this || (region->fCount == 1
+			&& rect_contains(region->fBounds, fBounds))) {
+		MakeEmpty();
+		return;
+	}
+
 	BRegion result;
 	Support::XSubtractRegion(this, region, &result);
 
@@ -433,6 +487,20 @@ BRegion::Exclude(const BRegion* region)
 void
 BRegion::IntersectWith(const BRegion* region)
 {
+	if (region == this)
+		return;
+	if (fCount == 0 || region->fCount == 0
+		|| !bounds_intersect(fBounds, region->fBounds)) {
+		MakeEmpty();
+		return;
+	}
+	if (region->fCount == 1 && rect_contains(region->fBounds, fBounds))
+		return;
+	if (fCount == 1 && rect_contains(fBounds, region->fBounds)) {
+		*this = *region;
+		return;
+	}
+
 	BRegion result;
 	Support::XIntersectRegion(this, region, &result);
 
@@ -457,20 +525,28 @@ BRegion::ExclusiveInclude(const BRegion* region)
 	\fn void BRegion::_AdoptRegionData(BRegion& region)
 	\brief Takes over the data of \a region and empties it.
 
+	Our previous rectangle array is handed to the per-thread cache, where
+	the next operation picks it up for its result. Single rectangle results
+	are kept inline.
+
 	\param region The \a region to adopt data from.
 */
 void
 BRegion::_AdoptRegionData(BRegion& region)
 {
+	if (region.fCount <= 1)
+		Support::RecycleBuffer(&region);
+	Support::RecycleBuffer(this);
+
 	fCount = region.fCount;
-	fDataSize = region.fDataSize;
 	fBounds = region.fBounds;
-	if (fData != &fBounds)
-		free(fData);
-	if (region.fData != &region.fBounds)
+	if (region.fData != &region.fBounds) {
 		fData = region.fData;
-	else
+		fDataSize = region.fDataSize;
+	} else {
 		fData = &fBounds;
+		fDataSize = 1;
+	}
 
 	// NOTE: MakeEmpty() is not called since _AdoptRegionData is only
 	// called with internally allocated regions, so they don't need to
@@ -502,7 +578,8 @@ BRegion::_SetSize(int32 newSize)
 	if (newSize > 0) {
 		if (fData == &fBounds) {
 			fData = (clipping_rect*)malloc(newSize * sizeof(clipping_rect));
-			fData[0] = fBounds;
+			if (fData != NULL)
+				fData[0] = fBounds;
 		} else if (fData) {
 			clipping_rect* resizedData = (clipping_rect*)realloc(fData,
 				newSize * sizeof(clipping_rect));
@@ -522,8 +599,9 @@ BRegion::_SetSize(int32 newSize)
 	}
 
 	if (!fData) {
-		// allocation actually failed
-		fDataSize = 0;
+		// allocation actually failed, fall back to the inline storage
+		fData = &fBounds;
+		fDataSize = 1;
 		MakeEmpty();
 		return false;
 	}
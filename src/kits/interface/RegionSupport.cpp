@@ -74,6 +74,7 @@ SOFTWARE.
 
 #include "RegionSupport.h"
 
+#include <pthread.h>
 #include <stdlib.h>
 #include <new>
 
@@ -871,7 +872,10 @@ BRegion::Support::miRegionOp(
      * reallocate and copy the array, which is time consuming, yet we don't
      * have to worry about using too much memory. I hope to be able to
      * nuke the realloc() at the end of this function eventually.
+     * The array left over by the previous operation of this thread is
+     * usually large enough already.
      */
+    AcquireBuffer(newReg);
     if (!newReg->_SetSize(max_c(reg1->fCount,reg2->fCount) * 2)) {
 		return;
     }
@@ -1524,40 +1528,57 @@ int
 BRegion::Support::XXorRegion(const BRegion* sra, const BRegion* srb,
 	BRegion* dr)
 {
-    BRegion* tra = NULL;
-    BRegion* trb = NULL;
-
-    if ((! (tra = CreateRegion())) || (! (trb = CreateRegion())))
-    {
-        DestroyRegion(tra);
-        DestroyRegion(trb);
-		return 0;
-    }
-    (void) XSubtractRegion(sra,srb,tra);
-    (void) XSubtractRegion(srb,sra,trb);
-    (void) XUnionRegion(tra,trb,dr);
-    DestroyRegion(tra);
-    DestroyRegion(trb);
+    BRegion tra;
+    BRegion trb;
+
+    (void) XSubtractRegion(sra,srb,&tra);
+    (void) XSubtractRegion(srb,sra,&trb);
+    (void) XUnionRegion(&tra,&trb,dr);
+    RecycleBuffer(&tra);
+    RecycleBuffer(&trb);
     return 0;
 }
 
 
+/*!	Returns the index of the first rectangle of the band that contains \a y,
+	or of the first band below it. Since the bands are sorted by y and don't
+	overlap, the bottoms of the rectangles are sorted as well.
+*/
+static int32
+find_band(const clipping_rect* rects, int32 count, int y)
+{
+	int32 lower = 0;
+	int32 upper = count;
+
+	while (lower < upper) {
+		int32 middle = (lower + upper) / 2;
+		if (rects[middle].bottom <= y)
+			lower = middle + 1;
+		else
+			upper = middle;
+	}
+
+	return lower;
+}
+
+
 bool
 BRegion::Support::XPointInRegion(
     const BRegion* pRegion,
     int x, int y)
 {
-	// TODO: binary search by "y"!
-    int i;
-
     if (pRegion->fCount == 0)
         return false;
     if (!INBOX(pRegion->fBounds, x, y))
         return false;
-    for (i=0; i<pRegion->fCount; i++)
+
+    const clipping_rect* rect = pRegion->fData
+        + find_band(pRegion->fData, pRegion->fCount, y);
+    const clipping_rect* end = pRegion->fData + pRegion->fCount;
+    for (; rect < end && rect->top <= y && rect->left <= x; rect++)
     {
-        if (INBOX (pRegion->fData[i], x, y))
-	    return true;
+        if (rect->right > x)
+            return true;
     }
     return false;
 }
@@ -1583,7 +1604,9 @@ BRegion::Support::XRectInRegion(
     partIn = false;
 
     /* can stop when both partOut and partIn are true, or we reach prect->bottom */
-    for (pbox = region->fData, pboxEnd = pbox + region->fCount;
+    /* skip the bands above the rectangle */
+    for (pbox = region->fData + find_band(region->fData, region->fCount, ry),
+	 pboxEnd = region->fData + region->fCount;
 	 pbox < pboxEnd;
 	 pbox++)
     {
@@ -1639,3 +1662,111 @@ BRegion::Support::XRectInRegion(
     return(partIn ? ((ry < prect->bottom) ? RectanglePart : RectangleIn) :
 		RectangleOut);
 }
+
+
+// #pragma mark - rectangle array cache
+
+
+static const int32 kMaxCachedBufferSize = 4096;
+	// in rectangles, larger arrays are given back to the heap
+
+struct region_buffer {
+	clipping_rect*	data;
+	int32			size;
+};
+
+static pthread_key_t sBufferKey;
+static bool sBufferKeyValid = false;
+static pthread_once_t sBufferKeyInitOnce = PTHREAD_ONCE_INIT;
+
+
+static void
+free_region_buffer(void* _buffer)
+{
+	region_buffer* buffer = (region_buffer*)_buffer;
+	free(buffer->data);
+	free(buffer);
+}
+
+
+static void
+init_region_buffer_key()
+{
+	sBufferKeyValid
+		= pthread_key_create(&sBufferKey, &free_region_buffer) == 0;
+}
+
+
+static region_buffer*
+get_region_buffer(bool create)
+{
+	pthread_once(&sBufferKeyInitOnce, &init_region_buffer_key);
+	if (!sBufferKeyValid)
+		return NULL;
+
+	region_buffer* buffer = (region_buffer*)pthread_getspecific(sBufferKey);
+	if (buffer != NULL || !create)
+		return buffer;
+
+	buffer = (region_buffer*)malloc(sizeof(region_buffer));
+	if (buffer == NULL)
+		return NULL;
+
+	buffer->data = NULL;
+	buffer->size = 0;
+	if (pthread_setspecific(sBufferKey, buffer) != 0) {
+		free(buffer);
+		return NULL;
+	}
+	return buffer;
+}
+
+
+/*!	Gives \a region, which must not use an allocated array yet, the array
+	cached for the current thread, if there is one.
+*/
+void
+BRegion::Support::AcquireBuffer(BRegion* region)
+{
+	if (region->fData != &region->fBounds)
+		return;
+
+	region_buffer* buffer = get_region_buffer(false);
+	if (buffer == NULL || buffer->data == NULL)
+		return;
+
+	region->fData = buffer->data;
+	region->fDataSize = buffer->size;
+
+	buffer->data = NULL;
+	buffer->size = 0;
+}
+
+
+/*!	Takes the allocated array away from \a region, and keeps it for the
+	next operation of the current thread if it is larger than the one that
+	is already cached. Afterwards, \a region uses its inline storage again;
+	it keeps its contents if it had no more than one rectangle, and is made
+	empty otherwise.
+*/
+void
+BRegion::Support::RecycleBuffer(BRegion* region)
+{
+	if (region->fData != &region->fBounds && region->fData != NULL) {
+		region_buffer* buffer = NULL;
+		if (region->fDataSize <= kMaxCachedBufferSize)
+			buffer = get_region_buffer(true);
+
+		if (buffer != NULL && buffer->size < region->fDataSize) {
+			free(buffer->data);
+			buffer->data = region->fData;
+			buffer->size = region->fDataSize;
+		} else
+			free(region->fData);
+	}
+
+	region->fData = &region->fBounds;
+	region->fDataSize = 1;
+	if (region->fCount > 1)
+		region->MakeEmpty();
+}
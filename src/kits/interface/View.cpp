@@ -1220,6 +1220,33 @@ BView::Sync() const
 }
 
 
+/*!	Records the drawing commands of the window into memory shared with the
+	app_server until EndDrawingBatch() is called. Flushing the window then
+	only tells the server which commands to execute, so that a whole frame
+	usually needs a single port message. Batches can be nested.
+*/
+status_t
+BView::BeginDrawingBatch()
+{
+	if (fOwner == NULL)
+		return B_NO_INIT;
+
+	_CheckOwnerLock();
+	return fOwner->_BeginDrawingBatch();
+}
+
+
+status_t
+BView::EndDrawingBatch()
+{
+	if (fOwner == NULL)
+		return B_NO_INIT;
+
+	_CheckOwnerLock();
+	return fOwner->_EndDrawingBatch();
+}
+
+
 BWindow*
 BView::Window() const
 {
@@ -6474,7 +6501,7 @@ BView::_UpdatePattern(::pattern pattern)
 void
 BView::_FlushIfNotInTransaction()
 {
-	if (!fOwner->fInTransaction) {
+	if (!fOwner->fInTransaction && !fOwner->fLink->Sender().IsRecording()) {
 		fOwner->Flush();
 	}
 }
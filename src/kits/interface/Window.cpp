@@ -42,6 +42,7 @@
 #include <Roster.h>
 #include <RosterPrivate.h>
 #include <Screen.h>
+#include <ServerMemoryAllocator.h>
 #include <ServerProtocol.h>
 #include <String.h>
 #include <TextView.h>
@@ -72,6 +73,9 @@
 #define _SEND_BEHIND_		'_WSB'
 #define _SEND_TO_FRONT_		'_WSF'
 
+static const int32 kCommandBufferSize = 64 * 1024;
+	// the largest message a link can send
+
 
 void do_minimize_team(BRect zoomRect, team_id team, bool zoom);
 
@@ -436,6 +440,10 @@ BWindow::~BWindow()
 	// disable pulsing
 	SetPulseRate(0);
 
+	// recorded commands need to be executed before the window goes away
+	while (fLink->Sender().IsRecording())
+		fLink->Sender().StopRecording();
+
 	// tell app_server about our demise
 	fLink->StartMessage(AS_DELETE_WINDOW);
 	// sync with the server so that for example
@@ -446,6 +454,8 @@ BWindow::~BWindow()
 	int32 code;
 	fLink->FlushWithReply(code);
 
+	_DeleteCommandBuffer();
+
 	// the sender port belongs to the app_server
 	delete_port(fLink->ReceiverPort());
 	delete fLink;
@@ -4121,6 +4131,90 @@ BWindow::_PropagateMessageToChildViews(BMessage* message)
 }
 
 
+status_t
+BWindow::_BeginDrawingBatch()
+{
+	if (fLink->Sender().CommandBufferArea() < 0) {
+		status_t status = _CreateCommandBuffer();
+		if (status != B_OK)
+			return status;
+	}
+
+	return fLink->Sender().StartRecording();
+}
+
+
+status_t
+BWindow::_EndDrawingBatch()
+{
+	return fLink->Sender().StopRecording();
+}
+
+
+/*!	Asks the app_server for a buffer to record drawing commands into, and
+	maps it into our address space.
+*/
+status_t
+BWindow::_CreateCommandBuffer()
+{
+	sem_id semaphore = create_sem(0, "command buffer consumed");
+	if (semaphore < 0)
+		return semaphore;
+
+	fLink->StartMessage(AS_CREATE_COMMAND_BUFFER);
+	fLink->Attach<int32>(kCommandBufferSize);
+	fLink->Attach<sem_id>(semaphore);
+
+	int32 status;
+	if (fLink->FlushWithReply(status) == B_OK && status == B_OK) {
+		area_id serverArea;
+		int32 areaOffset;
+		fLink->Read<area_id>(&serverArea);
+		fLink->Read<int32>(&areaOffset);
+
+		area_id area;
+		uint8* base;
+		{
+			// like BBitmap, use the application's link lock to protect the
+			// allocator
+			BPrivate::AppServerLink lock;
+			status = BApplication::Private::ServerAllocator()->AddArea(
+				serverArea, area, base, kCommandBufferSize);
+		}
+		if (status == B_OK) {
+			status = fLink->Sender().SetCommandBuffer(serverArea,
+				base + areaOffset, kCommandBufferSize, semaphore);
+			if (status == B_OK)
+				return B_OK;
+
+			BPrivate::AppServerLink lock;
+			BApplication::Private::ServerAllocator()->RemoveArea(serverArea);
+		}
+	} else if (status == B_OK)
+		status = B_ERROR;
+
+	delete_sem(semaphore);
+	return status;
+}
+
+
+void
+BWindow::_DeleteCommandBuffer()
+{
+	BPrivate::LinkSender& sender = fLink->Sender();
+	if (sender.CommandBufferArea() < 0)
+		return;
+
+	{
+		BPrivate::AppServerLink lock;
+		BApplication::Private::ServerAllocator()->RemoveArea(
+			sender.CommandBufferArea());
+	}
+	delete_sem(sender.CommandBufferSemaphore());
+	sender.SetCommandBuffer(-1, NULL, 0, -1);
+}
+
+
 //	#pragma mark - C++ binary compatibility kludge
 
 
@@ -2,6 +2,7 @@
  * Copyright 2017-2023, Andrew Lindesay <apl@lindesay.co.nz>
  * Copyright 2014-2017, Augustin Cavalier (waddlesplash)
  * Copyright 2014, Stephan Aßmus <superstippi@gmx.de>
+ * Copyright 2026, Haiku, Inc. All rights reserved.
  * Distributed under the terms of the MIT License.
  */
 
@@ -13,6 +14,10 @@
 #include <ctype.h>
 #include <cerrno>
 
+#ifdef __SSE2__
+#	include <emmintrin.h>
+#endif
+
 #include <AutoDeleter.h>
 #include <DataIO.h>
 #include <UnicodeChar.h>
@@ -43,6 +48,96 @@ static const size_t kAssemblyBufferSizeIncrement = 256;
 
 static const size_t kMaximumUtf8SequenceLength = 7;
 
+/*!	Input from a stream is read in blocks of this size, rather than one byte
+	at a time.
+*/
+
+static const size_t kInputBufferSize = 16 * 1024;
+
+
+/*!	Returns the number of characters at the start of \a data that go into a
+	string as they are; anything but a quote, a backslash, or a control
+	character. With SSE2, 16 characters are checked at once.
+*/
+
+static size_t
+json_string_run_length(const char* data, size_t length)
+{
+	size_t offset = 0;
+
+#ifdef __SSE2__
+	const __m128i quote = _mm_set1_epi8('"');
+	const __m128i backslash = _mm_set1_epi8('\\');
+	const __m128i lastControl = _mm_set1_epi8(0x1f);
+
+	for (; offset + 16 <= length; offset += 16) {
+		const __m128i block = _mm_loadu_si128((const __m128i*)(data + offset));
+		const __m128i special = _mm_or_si128(
+			_mm_or_si128(_mm_cmpeq_epi8(block, quote),
+				_mm_cmpeq_epi8(block, backslash)),
+			_mm_cmpeq_epi8(_mm_max_epu8(block, lastControl), lastControl));
+		const uint32 mask = _mm_movemask_epi8(special);
+		if (mask != 0)
+			return offset + __builtin_ctz(mask);
+	}
+#endif
+
+	for (; offset < length; offset++) {
+		const uint8 c = static_cast<uint8>(data[offset]);
+		if (c == '"' || c == '\\' || c < 0x20)
+			break;
+	}
+
+	return offset;
+}
+
+
+/*!	Returns the number of whitespace characters at the start of \a data, and
+	adds the line breaks among them to \a _lineNumber. Like in
+	BJson::NextNonWhitespaceChar(), both line feeds and carriage returns count
+	as line breaks.
+*/
+
+static size_t
+json_whitespace_length(const char* data, size_t length, uint32& _lineNumber)
+{
+	size_t offset = 0;
+
+#ifdef __SSE2__
+	const __m128i space = _mm_set1_epi8(' ');
+	const __m128i lineFeed = _mm_set1_epi8(0x0a);
+	const __m128i carriageReturn = _mm_set1_epi8(0x0d);
+
+	for (; offset + 16 <= length; offset += 16) {
+		const __m128i block = _mm_loadu_si128((const __m128i*)(data + offset));
+		const __m128i lineBreaks = _mm_or_si128(
+			_mm_cmpeq_epi8(block, lineFeed),
+			_mm_cmpeq_epi8(block, carriageReturn));
+		const uint32 lineBreakMask = _mm_movemask_epi8(lineBreaks);
+		const uint32 otherMask = ~_mm_movemask_epi8(
+			_mm_or_si128(lineBreaks, _mm_cmpeq_epi8(block, space))) & 0xffff;
+
+		if (otherMask != 0) {
+			const uint32 whitespace = __builtin_ctz(otherMask);
+			_lineNumber += __builtin_popcount(
+				lineBreakMask & ((1 << whitespace) - 1));
+			return offset + whitespace;
+		}
+		_lineNumber += __builtin_popcount(lineBreakMask);
+	}
+#endif
+
+	for (; offset < length; offset++) {
+		const char c = data[offset];
+		if (c == 0x0a || c == 0x0d)
+			_lineNumber++;
+		else if (c != ' ')
+			break;
+	}
+
+	return offset;
+}
+
 
 class JsonParseAssemblyBuffer {
 public:
@@ -100,7 +195,7 @@ public:
 		return result;
 	}
 
-	status_t AppendCharacters(char* str, size_t len)
+	status_t AppendCharacters(const char* str, size_t len)
 	{
 		status_t result = _EnsureAssemblyBufferAllocatedSize(fAssemblyBufferUsedSize + len);
 
@@ -183,7 +278,11 @@ private:
 };
 
 
-/*! This class carries state around the parsing process. */
+/*! This class carries state around the parsing process. The input is read
+	into a buffer in blocks, or used in place if it is in memory already, so
+	that most characters are taken from there without a call, and runs of
+	string characters and whitespace can be scanned over in one go.
+*/
 
 class JsonParseContext {
 public:
@@ -192,8 +291,25 @@ public:
 		fListener(listener),
 		fData(data),
 		fLineNumber(1), // 1 is the first line
-		fPushbackChar(0),
-		fHasPushbackChar(false),
+		fInputBuffer(new char[kInputBufferSize]),
+		fInput(fInputBuffer),
+		fInputLength(0),
+		fInputPosition(0),
+		fAssemblyBuffer(new JsonParseAssemblyBuffer())
+	{
+	}
+
+
+	JsonParseContext(const char* input, size_t length,
+		BJsonEventListener* listener)
+		:
+		fListener(listener),
+		fData(NULL),
+		fLineNumber(1), // 1 is the first line
+		fInputBuffer(NULL),
+		fInput(input),
+		fInputLength(length),
+		fInputPosition(0),
 		fAssemblyBuffer(new JsonParseAssemblyBuffer())
 	{
 	}
@@ -201,6 +317,15 @@ public:
 
 	~JsonParseContext()
 	{
+		// give back what was read ahead, if possible, so that the stream is
+		// left where the parsed data ends.
+		BPositionIO* positionIO = dynamic_cast<BPositionIO*>(fData);
+		if (positionIO != NULL && fInputPosition < fInputLength) {
+			positionIO->Seek(-static_cast<off_t>(fInputLength - fInputPosition),
+				SEEK_CUR);
+		}
+
+		delete[] fInputBuffer;
 		delete fAssemblyBuffer;
 	}
 
@@ -230,21 +355,52 @@ public:
 
 	status_t NextChar(char* buffer)
 	{
-		if (fHasPushbackChar) {
-			buffer[0] = fPushbackChar;
-			fHasPushbackChar = false;
-			return B_OK;
+		if (fInputPosition == fInputLength) {
+			status_t result = _FillInputBuffer();
+			if (result != B_OK)
+				return result;
 		}
 
-		return Data()->ReadExactly(buffer, 1);
+		buffer[0] = fInput[fInputPosition++];
+		return B_OK;
 	}
 
+	/*!	The character has to be the one last returned by NextChar(), which is
+		still in the input buffer then.
+	*/
+
 	void PushbackChar(char c)
 	{
-		if (fHasPushbackChar)
-			debugger("illegal state - more than one character pushed back");
-		fPushbackChar = c;
-		fHasPushbackChar = true;
+		if (fInputPosition == 0 || fInput[fInputPosition - 1] != c)
+			debugger("illegal state - pushed back character was not read");
+		fInputPosition--;
+	}
+
+	/*!	Skips the whitespace that is in the input buffer already; reading more
+		input is left to NextChar().
+	*/
+
+	void SkipWhitespace()
+	{
+		fInputPosition += json_whitespace_length(fInput + fInputPosition,
+			fInputLength - fInputPosition, fLineNumber);
+	}
+
+	/*!	Moves the characters in the input buffer that go into the string as
+		they are over to the assembly buffer.
+	*/
+
+	status_t AppendStringRun()
+	{
+		size_t length = json_string_run_length(fInput + fInputPosition,
+			fInputLength - fInputPosition);
+		if (length == 0)
+			return B_OK;
+
+		status_t result = fAssemblyBuffer->AppendCharacters(
+			fInput + fInputPosition, length);
+		fInputPosition += length;
+		return result;
 	}
 
 
@@ -254,12 +410,36 @@ public:
 	}
 
 
+private:
+
+	/*!	Like BDataIO::ReadExactly(), this returns B_PARTIAL_READ at the end of
+		the input.
+	*/
+
+	status_t _FillInputBuffer()
+	{
+		if (fData == NULL)
+			return B_PARTIAL_READ;
+
+		ssize_t bytesRead = fData->Read(fInputBuffer, kInputBufferSize);
+		if (bytesRead < 0)
+			return bytesRead;
+		if (bytesRead == 0)
+			return B_PARTIAL_READ;
+
+		fInputLength = bytesRead;
+		fInputPosition = 0;
+		return B_OK;
+	}
+
 private:
 	BJsonEventListener*		fListener;
 	BDataIO*				fData;
 	uint32					fLineNumber;
-	char					fPushbackChar;
-	bool					fHasPushbackChar;
+	char*					fInputBuffer;
+	const char*				fInput;
+	size_t					fInputLength;
+	size_t					fInputPosition;
 	JsonParseAssemblyBuffer*
 							fAssemblyBuffer;
 };
@@ -275,12 +455,13 @@ BJson::Parse(const BString& JSON, BMessage& message)
 status_t
 BJson::Parse(const char* JSON, size_t length, BMessage& message)
 {
-	BMemoryIO* input = new BMemoryIO(JSON, length);
-	ObjectDeleter<BMemoryIO> inputDeleter(input);
 	BJsonMessageWriter* writer = new BJsonMessageWriter(message);
 	ObjectDeleter<BJsonMessageWriter> writerDeleter(writer);
 
-	Parse(input, writer);
+	// the input is parsed in place, rather than through a BMemoryIO
+	JsonParseContext context(JSON, length, writer);
+	ParseAny(context);
+	writer->Complete();
 	status_t result = writer->ErrorStatus();
 
 	return result;
@@ -346,6 +527,8 @@ bool
 BJson::NextNonWhitespaceChar(JsonParseContext& jsonParseContext, char* c)
 {
 	while (true) {
+		jsonParseContext.SkipWhitespace();
+
 		if (!NextChar(jsonParseContext, c))
 			return false;
 
@@ -718,8 +901,15 @@ BJson::ParseString(JsonParseContext& jsonParseContext,
 	JsonParseAssemblyBufferResetter assembleBufferResetter(assemblyBuffer);
 
 	while(true) {
+		status_t result = jsonParseContext.AppendStringRun();
+		if (result != B_OK) {
+			jsonParseContext.Listener()->HandleError(result,
+				jsonParseContext.LineNumber(), "unable to store string");
+			return false;
+		}
+
 		if (!NextChar(jsonParseContext, &c))
-    		return false;
+			return false;
 
 		switch (c) {
 			case '"':
@@ -1,5 +1,6 @@
 /*
  * Copyright 2017, Andrew Lindesay <apl@lindesay.co.nz>
+ * Copyright 2026, Haiku, Inc. All rights reserved.
  * Distributed under the terms of the MIT License.
  */
 
@@ -8,6 +9,11 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+
+#ifdef __SSE2__
+#	include <emmintrin.h>
+#endif
 
 #include <UnicodeChar.h>
 
@@ -55,10 +61,35 @@ b_json_simple_esc_sequence(char c)
 }
 
 
+/*!	Returns the number of characters at the start of \a c that can be written
+	out as they are. With SSE2, 16 characters are checked at once.
+*/
+
 static size_t
 b_json_len_7bit_clean_non_esc(uint8* c, size_t length) {
 	size_t result = 0;
 
+#ifdef __SSE2__
+	const __m128i firstClean = _mm_set1_epi8(0x20);
+	const __m128i lastClean = _mm_set1_epi8(0x7e);
+	const __m128i quote = _mm_set1_epi8('"');
+	const __m128i backslash = _mm_set1_epi8('\\');
+	const __m128i slash = _mm_set1_epi8('/');
+
+	for (; result + 16 <= length; result += 16) {
+		const __m128i block = _mm_loadu_si128((const __m128i*)(c + result));
+		const __m128i clean = _mm_cmpeq_epi8(block,
+			_mm_min_epu8(_mm_max_epu8(block, firstClean), lastClean));
+		const __m128i escaped = _mm_or_si128(_mm_cmpeq_epi8(block, quote),
+			_mm_or_si128(_mm_cmpeq_epi8(block, backslash),
+				_mm_cmpeq_epi8(block, slash)));
+		const uint32 mask
+			= _mm_movemask_epi8(_mm_andnot_si128(escaped, clean)) ^ 0xffff;
+		if (mask != 0)
+			return result + __builtin_ctz(mask);
+	}
+#endif
+
 	while (result < length
 		&& b_json_is_7bit_clean(c[result])
 		&& b_json_simple_esc_sequence(c[result]) == NULL) {
@@ -523,7 +554,8 @@ BJsonTextWriterObjectStackedEventListener::Handle(const BJsonEvent& event)
 BJsonTextWriter::BJsonTextWriter(
 	BDataIO* dataIO)
 	:
-	fDataIO(dataIO)
+	fDataIO(dataIO),
+	fBufferLength(0)
 {
 
 		// this is a preparation for this buffer to easily be used later
@@ -538,6 +570,8 @@ BJsonTextWriter::BJsonTextWriter(
 
 BJsonTextWriter::~BJsonTextWriter()
 {
+	FlushBuffer();
+
 	BJsonTextWriterStackedEventListener* listener = fStackedListener;
 
 	while (listener != NULL) {
@@ -550,10 +584,27 @@ BJsonTextWriter::~BJsonTextWriter()
 }
 
 
+/*!	The output is buffered, but written out whenever a value at the top level
+	is complete, so that the data is in the BDataIO once there is a whole
+	document.
+*/
+
 bool
 BJsonTextWriter::Handle(const BJsonEvent& event)
 {
-	return fStackedListener->Handle(event);
+	if (!fStackedListener->Handle(event))
+		return false;
+
+	if (fStackedListener->Parent() == NULL) {
+		status_t writeResult = FlushBuffer();
+		if (writeResult != B_OK) {
+			HandleError(writeResult, JSON_EVENT_LISTENER_ANY_LINE,
+				"error writing output");
+			return false;
+		}
+	}
+
+	return true;
 }
 
 
@@ -569,6 +620,12 @@ BJsonTextWriter::Complete()
 		HandleError(B_BAD_DATA, JSON_EVENT_LISTENER_ANY_LINE,
 			"unexpected end of input data");
 	}
+
+	status_t writeResult = FlushBuffer();
+	if (writeResult != B_OK) {
+		HandleError(writeResult, JSON_EVENT_LISTENER_ANY_LINE,
+			"error writing output");
+	}
 }
 
 
@@ -598,7 +655,18 @@ status_t
 BJsonTextWriter::StreamStringVerbatim(const char* string,
 	off_t offset, size_t length)
 {
-	return fDataIO->WriteExactly(&string[offset], length);
+	if (fBufferLength + length > sizeof(fBuffer)) {
+		status_t writeResult = FlushBuffer();
+		if (writeResult != B_OK)
+			return writeResult;
+
+		if (length > sizeof(fBuffer))
+			return fDataIO->WriteExactly(&string[offset], length);
+	}
+
+	memcpy(fBuffer + fBufferLength, &string[offset], length);
+	fBufferLength += length;
+	return B_OK;
 }
 
 
@@ -609,13 +677,38 @@ BJsonTextWriter::StreamStringEncoded(const char* string)
 }
 
 
+/*!	Characters beyond the basic multilingual plane are written as a pair of
+	UTF-16 surrogates, as JSON has it.
+*/
+
 status_t
 BJsonTextWriter::StreamStringUnicodeCharacter(uint32 c)
 {
-	sprintf(&fUnicodeAssemblyBuffer[2], "%04" B_PRIx32, c);
-		// note that the buffer's first two bytes are populated with the JSON
-		// prefix for a unicode char.
-	return StreamStringVerbatim(fUnicodeAssemblyBuffer, 0, 6);
+	static const char kHexDigits[] = "0123456789abcdef";
+
+	// note that the buffer's first two bytes are populated with the JSON
+	// prefix for a unicode char.
+	size_t length = 6;
+	uint32 unit = c;
+
+	if (c > 0xffff && c <= 0x10ffff) {
+		c -= 0x10000;
+		unit = 0xd800 + (c >> 10);
+		uint32 lowSurrogate = 0xdc00 + (c & 0x3ff);
+
+		fUnicodeAssemblyBuffer[6] = '\\';
+		fUnicodeAssemblyBuffer[7] = 'u';
+		for (int i = 0; i < 4; i++) {
+			fUnicodeAssemblyBuffer[11 - i]
+				= kHexDigits[(lowSurrogate >> (i * 4)) & 0xf];
+		}
+		length = 12;
+	}
+
+	for (int i = 0; i < 4; i++)
+		fUnicodeAssemblyBuffer[5 - i] = kHexDigits[(unit >> (i * 4)) & 0xf];
+
+	return StreamStringVerbatim(fUnicodeAssemblyBuffer, 0, length);
 }
 
 
@@ -646,7 +739,7 @@ BJsonTextWriter::StreamStringEncoded(const char* string,
 				// such characters and output them as a sequence so that it's
 				// included as one write operation.
 				size_t l = 1 + b_json_len_7bit_clean_non_esc(
-					&string8bit[offset + i + 1], length - (offset + i + 1));
+					&string8bit[offset + i + 1], length - (i + 1));
 				writeResult = StreamStringVerbatim(&string[offset + i], 0, l);
 				i += static_cast<size_t>(l);
 			} else {
@@ -702,5 +795,24 @@ BJsonTextWriter::StreamQuotedEncodedString(const char* string,
 status_t
 BJsonTextWriter::StreamChar(char c)
 {
-	return fDataIO->WriteExactly(&c, 1);
+	if (fBufferLength == sizeof(fBuffer)) {
+		status_t writeResult = FlushBuffer();
+		if (writeResult != B_OK)
+			return writeResult;
+	}
+
+	fBuffer[fBufferLength++] = c;
+	return B_OK;
+}
+
+
+status_t
+BJsonTextWriter::FlushBuffer()
+{
+	if (fBufferLength == 0)
+		return B_OK;
+
+	status_t writeResult = fDataIO->WriteExactly(fBuffer, fBufferLength);
+	fBufferLength = 0;
+	return writeResult;
 }
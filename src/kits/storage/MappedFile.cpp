@@ -0,0 +1,428 @@
+/*
+ * Copyright 2026, Haiku, Inc. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+/*!	A read-only BPositionIO that maps the file into memory, so that the many
+	small reads of parsers, like the package reader, or the resources code,
+	cost a memcpy() rather than a syscall each.
+
+	Files up to the window size are mapped as a whole, larger ones through a
+	window of that size, which starts at a multiple of half of it, so that
+	any read of up to half the window size is served from a single mapping.
+
+	The size of the file is taken when it is set. The file must not shrink
+	while it is mapped, since reading the missing part would fault.
+*/
+
+
+#include <MappedFile.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+
+#include <Entry.h>
+
+#include <syscalls.h>
+
+
+#ifdef B_HAIKU_64_BIT
+static const size_t kDefaultWindowSize = 1024 * 1024 * 1024;
+#else
+static const size_t kDefaultWindowSize = 64 * 1024 * 1024;
+#endif
+static const size_t kMinWindowSize = 2 * B_PAGE_SIZE;
+
+
+BMappedFile::BMappedFile()
+	:
+	BPositionIO(),
+	fFD(-1),
+	fOwnsFD(false),
+	fInitStatus(B_NO_INIT),
+	fSize(0),
+	fPosition(0),
+	fAccess(B_MAPPED_FILE_ACCESS_NORMAL),
+	fWindowSize(kDefaultWindowSize),
+	fWindow(NULL),
+	fWindowOffset(0),
+	fWindowLength(0)
+{
+}
+
+
+BMappedFile::BMappedFile(const char* path, mapped_file_access access)
+	:
+	BPositionIO(),
+	fFD(-1),
+	fOwnsFD(false),
+	fInitStatus(B_NO_INIT),
+	fSize(0),
+	fPosition(0),
+	fAccess(B_MAPPED_FILE_ACCESS_NORMAL),
+	fWindowSize(kDefaultWindowSize),
+	fWindow(NULL),
+	fWindowOffset(0),
+	fWindowLength(0)
+{
+	SetTo(path, access);
+}
+
+
+BMappedFile::BMappedFile(const entry_ref* ref, mapped_file_access access)
+	:
+	BPositionIO(),
+	fFD(-1),
+	fOwnsFD(false),
+	fInitStatus(B_NO_INIT),
+	fSize(0),
+	fPosition(0),
+	fAccess(B_MAPPED_FILE_ACCESS_NORMAL),
+	fWindowSize(kDefaultWindowSize),
+	fWindow(NULL),
+	fWindowOffset(0),
+	fWindowLength(0)
+{
+	SetTo(ref, access);
+}
+
+
+BMappedFile::BMappedFile(int fd, bool keepFd, mapped_file_access access)
+	:
+	BPositionIO(),
+	fFD(-1),
+	fOwnsFD(false),
+	fInitStatus(B_NO_INIT),
+	fSize(0),
+	fPosition(0),
+	fAccess(B_MAPPED_FILE_ACCESS_NORMAL),
+	fWindowSize(kDefaultWindowSize),
+	fWindow(NULL),
+	fWindowOffset(0),
+	fWindowLength(0)
+{
+	SetTo(fd, keepFd, access);
+}
+
+
+BMappedFile::~BMappedFile()
+{
+	Unset();
+}
+
+
+status_t
+BMappedFile::SetTo(const char* path, mapped_file_access access)
+{
+	Unset();
+
+	if (path == NULL)
+		return fInitStatus = B_BAD_VALUE;
+
+	int fd = open(path, O_RDONLY | O_CLOEXEC);
+	if (fd < 0)
+		return fInitStatus = errno;
+
+	return SetTo(fd, true, access);
+}
+
+
+status_t
+BMappedFile::SetTo(const entry_ref* ref, mapped_file_access access)
+{
+	Unset();
+
+	if (ref == NULL)
+		return fInitStatus = B_BAD_VALUE;
+
+	int fd = _kern_open_entry_ref(ref->device, ref->directory, ref->name,
+		O_RDONLY | O_CLOEXEC, 0);
+	if (fd < 0)
+		return fInitStatus = fd;
+
+	return SetTo(fd, true, access);
+}
+
+
+/*!	The file descriptor has to be open for reading. Its position isn't
+	changed by reading from the object.
+*/
+status_t
+BMappedFile::SetTo(int fd, bool keepFd, mapped_file_access access)
+{
+	Unset();
+
+	fFD = fd;
+	fOwnsFD = keepFd;
+	fAccess = access;
+
+	struct stat st;
+	if (fstat(fd, &st) != 0)
+		return fInitStatus = errno;
+	if (!S_ISREG(st.st_mode))
+		return fInitStatus = B_BAD_TYPE;
+
+	fSize = st.st_size;
+	return fInitStatus = B_OK;
+}
+
+
+void
+BMappedFile::Unset()
+{
+	_Unmap();
+
+	if (fOwnsFD && fFD >= 0)
+		close(fFD);
+
+	fFD = -1;
+	fOwnsFD = false;
+	fInitStatus = B_NO_INIT;
+	fSize = 0;
+	fPosition = 0;
+}
+
+
+status_t
+BMappedFile::InitCheck() const
+{
+	return fInitStatus;
+}
+
+
+mapped_file_access
+BMappedFile::Access() const
+{
+	return fAccess;
+}
+
+
+/*!	Tells the system how the file is going to be read, so that it can adapt
+	its read-ahead, or read in the whole window right away.
+*/
+void
+BMappedFile::SetAccess(mapped_file_access access)
+{
+	fAccess = access;
+	_Advise();
+}
+
+
+size_t
+BMappedFile::WindowSize() const
+{
+	return fWindowSize;
+}
+
+
+void
+BMappedFile::SetWindowSize(size_t size)
+{
+	size = std::max(size, kMinWindowSize);
+	size = (size + kMinWindowSize - 1) / kMinWindowSize * kMinWindowSize;
+	if (size == fWindowSize)
+		return;
+
+	_Unmap();
+	fWindowSize = size;
+}
+
+
+/*!	Returns a pointer to the \a size bytes of the file at \a position,
+	without copying them, or \c NULL, if they are not in the file, or are
+	more than half of the window size.
+*/
+const void*
+BMappedFile::DataAt(off_t position, size_t size)
+{
+	if (fInitStatus != B_OK || position < 0 || position >= fSize
+		|| (off_t)size > fSize - position || size > fWindowSize / 2) {
+		return NULL;
+	}
+
+	if (_MapWindow(position, size) != B_OK)
+		return NULL;
+
+	return fWindow + (position - fWindowOffset);
+}
+
+
+ssize_t
+BMappedFile::Read(void* buffer, size_t size)
+{
+	ssize_t bytesRead = ReadAt(fPosition, buffer, size);
+	if (bytesRead > 0)
+		fPosition += bytesRead;
+	return bytesRead;
+}
+
+
+ssize_t
+BMappedFile::Write(const void* buffer, size_t size)
+{
+	return B_NOT_ALLOWED;
+}
+
+
+ssize_t
+BMappedFile::ReadAt(off_t position, void* buffer, size_t size)
+{
+	if (fInitStatus != B_OK)
+		return fInitStatus;
+	if (position < 0)
+		return B_BAD_VALUE;
+	if (position >= fSize)
+		return 0;
+
+	size = std::min((off_t)size, fSize - position);
+
+	uint8* target = (uint8*)buffer;
+	size_t bytesRead = 0;
+	while (bytesRead < size) {
+		status_t error = _MapWindow(position, 1);
+		if (error != B_OK)
+			return bytesRead > 0 ? (ssize_t)bytesRead : error;
+
+		size_t offset = position - fWindowOffset;
+		size_t toCopy = std::min(size - bytesRead, fWindowLength - offset);
+		memcpy(target + bytesRead, fWindow + offset, toCopy);
+
+		bytesRead += toCopy;
+		position += toCopy;
+	}
+
+	return bytesRead;
+}
+
+
+ssize_t
+BMappedFile::WriteAt(off_t position, const void* buffer, size_t size)
+{
+	return B_NOT_ALLOWED;
+}
+
+
+off_t
+BMappedFile::Seek(off_t position, uint32 seekMode)
+{
+	if (fInitStatus != B_OK)
+		return fInitStatus;
+
+	switch (seekMode) {
+		case SEEK_SET:
+			break;
+		case SEEK_CUR:
+			position += fPosition;
+			break;
+		case SEEK_END:
+			position += fSize;
+			break;
+		default:
+			return B_BAD_VALUE;
+	}
+
+	if (position < 0)
+		return B_BAD_VALUE;
+
+	return fPosition = position;
+}
+
+
+off_t
+BMappedFile::Position() const
+{
+	return fPosition;
+}
+
+
+status_t
+BMappedFile::SetSize(off_t size)
+{
+	return B_NOT_ALLOWED;
+}
+
+
+status_t
+BMappedFile::GetSize(off_t* _size) const
+{
+	if (fInitStatus != B_OK)
+		return fInitStatus;
+
+	*_size = fSize;
+	return B_OK;
+}
+
+
+status_t
+BMappedFile::_MapWindow(off_t position, size_t size)
+{
+	if (fWindow != NULL && position >= fWindowOffset
+		&& position + (off_t)size <= fWindowOffset + (off_t)fWindowLength) {
+		return B_OK;
+	}
+
+	_Unmap();
+
+	off_t offset = 0;
+	if (fSize > (off_t)fWindowSize) {
+		size_t alignment = fWindowSize / 2;
+		offset = position / alignment * alignment;
+	}
+	size_t length = std::min((off_t)fWindowSize, fSize - offset);
+
+	void* window = mmap(NULL, length, PROT_READ, MAP_SHARED, fFD, offset);
+	if (window == MAP_FAILED)
+		return errno;
+
+	fWindow = (uint8*)window;
+	fWindowOffset = offset;
+	fWindowLength = length;
+
+	_Advise();
+	return B_OK;
+}
+
+
+void
+BMappedFile::_Unmap()
+{
+	if (fWindow == NULL)
+		return;
+
+	munmap(fWindow, fWindowLength);
+	fWindow = NULL;
+	fWindowOffset = 0;
+	fWindowLength = 0;
+}
+
+
+void
+BMappedFile::_Advise()
+{
+	if (fWindow == NULL)
+		return;
+
+	int advice = POSIX_MADV_NORMAL;
+	switch (fAccess) {
+		case B_MAPPED_FILE_ACCESS_NORMAL:
+			break;
+		case B_MAPPED_FILE_ACCESS_SEQUENTIAL:
+			advice = POSIX_MADV_SEQUENTIAL;
+			break;
+		case B_MAPPED_FILE_ACCESS_RANDOM:
+			advice = POSIX_MADV_RANDOM;
+			break;
+		case B_MAPPED_FILE_ACCESS_WILL_NEED:
+			advice = POSIX_MADV_WILLNEED;
+			break;
+	}
+
+	posix_madvise(fWindow, fWindowLength, advice);
+}
@@ -1,5 +1,6 @@
 /*
  * Copyright 2011-2013, Axel Dörfler, axeld@pinc-software.de.
+ * Copyright 2026, Haiku, Inc. All rights reserved.
  * Distributed under the terms of the MIT License.
  */
 
@@ -11,6 +12,8 @@
 #include <stdio.h>
 #include <string.h>
 
+#include <OS.h>
+
 
 //#define TRACE_DATA_IO
 #ifdef TRACE_DATA_IO
@@ -20,6 +23,72 @@
 #endif
 
 
+static const size_t kMaxBufferSize = 1024 * 1024;
+static const int32 kSequentialCount = 2;
+	// how many full buffers have to be read or written in a row before the
+	// buffer grows, and before reading ahead starts
+
+
+/*!	The buffer grows up to kMaxBufferSize while the stream keeps filling,
+	or taking, whole buffers. Once a file has been read sequentially, the next
+	buffer is read ahead on a helper thread while the current one is being
+	consumed; the helper thread is the only one that uses the stream then.
+*/
+struct BBufferedDataIO::Private {
+	Private(BDataIO& stream, size_t bufferSize)
+		:
+		stream(stream),
+		bufferSize(bufferSize),
+		sequentialCount(0),
+		canPrefetch(false),
+		thread(-1),
+		requestSemaphore(-1),
+		doneSemaphore(-1),
+		prefetchBuffer(NULL),
+		prefetchBufferSize(0),
+		prefetchResult(0),
+		prefetchPending(false),
+		quit(false)
+	{
+		// Only read ahead from files; a blocking read from a pipe or a
+		// socket could keep the helper thread from ever returning.
+		BPositionIO* file = dynamic_cast<BPositionIO*>(&stream);
+		off_t size;
+		canPrefetch = file != NULL && dynamic_cast<BMemoryIO*>(file) == NULL
+			&& dynamic_cast<BMallocIO*>(file) == NULL
+			&& file->GetSize(&size) == B_OK && size > 0;
+	}
+
+	~Private()
+	{
+		if (thread >= 0) {
+			quit = true;
+			release_sem(requestSemaphore);
+			status_t result;
+			wait_for_thread(thread, &result);
+		}
+		delete_sem(requestSemaphore);
+		delete_sem(doneSemaphore);
+		delete[] prefetchBuffer;
+	}
+
+	BDataIO&	stream;
+	size_t		bufferSize;
+	int32		sequentialCount;
+	bool		canPrefetch;
+
+	thread_id	thread;
+	sem_id		requestSemaphore;
+	sem_id		doneSemaphore;
+	uint8*		prefetchBuffer;
+	size_t		prefetchBufferSize;
+	ssize_t		prefetchResult;
+	bool		prefetchPending;
+	bool		quit;
+};
+
+
+
 BBufferedDataIO::BBufferedDataIO(BDataIO& stream, size_t bufferSize,
 	bool ownsStream, bool partialReads)
 	:
@@ -32,12 +101,20 @@ BBufferedDataIO::BBufferedDataIO(BDataIO& stream, size_t bufferSize,
 {
 	fBufferSize = max_c(bufferSize, 512);
 	fBuffer = new(std::nothrow) uint8[fBufferSize];
+
+	// without it, the buffer just keeps its size
+	fPrivate = new(std::nothrow) Private(fStream, fBufferSize);
 }
 
 
 BBufferedDataIO::~BBufferedDataIO()
 {
 	Flush();
+
+	if (fPrivate != NULL) {
+		_WaitForPrefetch();
+		delete fPrivate;
+	}
 	delete[] fBuffer;
 
 	if (fOwnsStream)
@@ -98,7 +175,7 @@ BBufferedDataIO::Flush()
 		return B_PARTIAL_WRITE;
 	}
 
-	return B_OK;
+	return bytesWritten;
 }
 
 
@@ -128,36 +205,59 @@ BBufferedDataIO::Read(void* buffer, size_t size)
 			return bytesRead;
 	}
 
-	if (size > fBufferSize || fBuffer == NULL) {
-		// request is larger than our buffer, just fill it directly
-		return fStream.Read(buffer, size);
-	}
+	if (size == 0)
+		return bytesRead;
 
-	if (size > 0) {
-		// retrieve next buffer
+	if (fBuffer == NULL) {
+		ssize_t directRead = fStream.Read(buffer, size);
+		if (directRead < 0)
+			return bytesRead > 0 ? (ssize_t)bytesRead : directRead;
+		return bytesRead + directRead;
+	}
 
-		status_t status = Flush();
-		if (status != B_OK)
-			return status;
+	status_t status = Flush();
+	if (status != B_OK)
+		return bytesRead > 0 ? (ssize_t)bytesRead : status;
+
+	if (size >= fBufferSize
+		&& (fPrivate == NULL || !fPrivate->prefetchPending)) {
+		// Read the whole buffers of the request directly, and only the rest
+		// through the buffer, so that the next small read can be served from
+		// it, too.
+		size_t toRead = size - size % fBufferSize;
+		TRACE("%p: read %" B_PRIuSIZE " bytes directly\n", this, toRead);
+		ssize_t directRead = fStream.Read(buffer, toRead);
+		if (directRead < 0)
+			return bytesRead > 0 ? (ssize_t)bytesRead : directRead;
+
+		buffer = (void*)((uint8_t*)buffer + directRead);
+		size -= directRead;
+		bytesRead += directRead;
+
+		if ((size_t)directRead < toRead || fPartialReads || size == 0)
+			return bytesRead;
+	}
 
-		TRACE("%p: read %" B_PRIuSIZE " bytes from stream\n", this,
-			fBufferSize);
-		ssize_t nextRead = fStream.Read(fBuffer, fBufferSize);
+	while (size > 0) {
+		// retrieve next buffer
+		ssize_t nextRead = _FillBuffer();
 		if (nextRead < 0)
-			return nextRead;
-
-		fSize = nextRead;
-		TRACE("%p: retrieved %" B_PRIuSIZE " bytes from stream\n", this, fSize);
-		fPosition = 0;
+			return bytesRead > 0 ? (ssize_t)bytesRead : nextRead;
 
 		// Copy the remaining part
 		size_t copy = min_c(size, fSize);
 		memcpy(buffer, fBuffer, copy);
 		TRACE("%p: copy %" B_PRIuSIZE" bytes to buffer\n", this, copy);
 
+		buffer = (void*)((uint8_t*)buffer + copy);
+		size -= copy;
 		bytesRead += copy;
 		fPosition = copy;
 		fSize -= copy;
+
+		// only keep going as long as the stream has more data right away
+		if ((size_t)nextRead < fBufferSize || fPartialReads)
+			break;
 	}
 
 	return bytesRead;
@@ -172,28 +272,45 @@ BBufferedDataIO::Write(const void* buffer, size_t size)
 
 	TRACE("%p::Write(size %lu)\n", this, size);
 
-	if (size > fBufferSize || fBuffer == NULL) {
-		// request is larger than our buffer, just fill it directly
-		status_t status = Flush();
-		if (status != B_OK)
-			return status;
-
-		return fStream.Write(buffer, size);
-	}
-
 	if (!fDirty) {
 		// Throw away a read-only buffer if necessary
 		TRACE("%p: throw away previous buffer.\n", this);
+		_StopPrefetching();
 		fPosition = 0;
 		fSize = 0;
 	}
 
+	if (fBuffer == NULL)
+		return fStream.Write(buffer, size);
+
 	size_t bytesWritten = 0;
 	while (size > 0) {
+		if (fSize == 0 && size >= fBufferSize) {
+			// Write whole buffers directly; what has been written before
+			// has already been combined with the start of the request.
+			size_t toWrite = size - size % fBufferSize;
+			TRACE("%p: write %" B_PRIuSIZE " bytes directly.\n", this,
+				toWrite);
+			ssize_t directWritten = fStream.Write(buffer, toWrite);
+			if (directWritten < 0) {
+				return bytesWritten > 0
+					? (ssize_t)bytesWritten : directWritten;
+			}
+
+			buffer = (const void*)((const uint8*)buffer + directWritten);
+			size -= directWritten;
+			bytesWritten += directWritten;
+
+			if ((size_t)directWritten < toWrite)
+				return bytesWritten;
+			continue;
+		}
+
 		size_t toCopy = min_c(size, fBufferSize - (fPosition + fSize));
 		TRACE("%p: write %" B_PRIuSIZE " bytes to the buffer.\n", this,
 			toCopy);
 		memcpy(fBuffer + (fPosition + fSize), buffer, toCopy);
+		buffer = (const void*)((const uint8*)buffer + toCopy);
 		fSize += toCopy;
 		bytesWritten += toCopy;
 		size -= toCopy;
@@ -203,6 +320,11 @@ BBufferedDataIO::Write(const void* buffer, size_t size)
 			status_t status = Flush();
 			if (status != B_OK)
 				return bytesWritten;
+
+			if (fPrivate != NULL) {
+				_SequentialAccess();
+				_ResizeBuffer();
+			}
 		}
 	}
 
@@ -210,6 +332,181 @@ BBufferedDataIO::Write(const void* buffer, size_t size)
 }
 
 
+//	#pragma mark - private
+
+
+/*!	Reads the next buffer from the stream, or takes the one read ahead, and
+	returns the number of bytes in it. The buffer must have been consumed,
+	and must not be dirty.
+*/
+ssize_t
+BBufferedDataIO::_FillBuffer()
+{
+	fPosition = 0;
+	fSize = 0;
+
+	ssize_t bytesRead;
+	if (fPrivate != NULL && fPrivate->prefetchPending) {
+		_WaitForPrefetch();
+
+		uint8* buffer = fBuffer;
+		size_t bufferSize = fBufferSize;
+		fBuffer = fPrivate->prefetchBuffer;
+		fBufferSize = fPrivate->prefetchBufferSize;
+		fPrivate->prefetchBuffer = buffer;
+		fPrivate->prefetchBufferSize = bufferSize;
+
+		bytesRead = fPrivate->prefetchResult;
+	} else {
+		if (fPrivate != NULL)
+			_ResizeBuffer();
+
+		TRACE("%p: read %" B_PRIuSIZE " bytes from stream\n", this,
+			fBufferSize);
+		bytesRead = fStream.Read(fBuffer, fBufferSize);
+	}
+
+	if (bytesRead < 0)
+		return bytesRead;
+
+	fSize = bytesRead;
+	TRACE("%p: retrieved %" B_PRIuSIZE " bytes from stream\n", this, fSize);
+
+	if (fPrivate != NULL) {
+		if ((size_t)bytesRead == fBufferSize) {
+			_SequentialAccess();
+			_Prefetch();
+		} else
+			fPrivate->sequentialCount = 0;
+	}
+
+	return bytesRead;
+}
+
+
+/*!	Counts a full buffer read or written, and doubles the size for the
+	buffers with every one after the first kSequentialCount.
+*/
+void
+BBufferedDataIO::_SequentialAccess()
+{
+	Private& data = *fPrivate;
+	if (++data.sequentialCount >= kSequentialCount
+		&& data.bufferSize < kMaxBufferSize) {
+		data.bufferSize = min_c(data.bufferSize * 2, kMaxBufferSize);
+	}
+}
+
+
+/*!	Brings the buffer to the current size, if it's empty. */
+void
+BBufferedDataIO::_ResizeBuffer()
+{
+	Private& data = *fPrivate;
+	if (fSize > 0 || fBufferSize >= data.bufferSize)
+		return;
+
+	uint8* buffer = new(std::nothrow) uint8[data.bufferSize];
+	if (buffer == NULL)
+		return;
+
+	TRACE("%p: grow buffer to %" B_PRIuSIZE " bytes\n", this,
+		data.bufferSize);
+	delete[] fBuffer;
+	fBuffer = buffer;
+	fBufferSize = data.bufferSize;
+	fPosition = 0;
+}
+
+
+/*!	Starts reading the next buffer of a file that is being read
+	sequentially on the helper thread.
+*/
+void
+BBufferedDataIO::_Prefetch()
+{
+	Private& data = *fPrivate;
+	if (!data.canPrefetch || data.prefetchPending
+		|| data.sequentialCount < kSequentialCount) {
+		return;
+	}
+
+	if (data.thread < 0) {
+		data.requestSemaphore = create_sem(0, "buffered I/O request");
+		data.doneSemaphore = create_sem(0, "buffered I/O done");
+		if (data.requestSemaphore >= 0 && data.doneSemaphore >= 0) {
+			data.thread = spawn_thread(&_PrefetchThread, "buffered I/O read",
+				B_NORMAL_PRIORITY, &data);
+		}
+		if (data.thread < 0 || resume_thread(data.thread) != B_OK) {
+			// Only try once, and keep reading synchronously from now on
+			data.canPrefetch = false;
+			return;
+		}
+	}
+
+	if (data.prefetchBufferSize < data.bufferSize) {
+		uint8* buffer = new(std::nothrow) uint8[data.bufferSize];
+		if (buffer == NULL)
+			return;
+
+		delete[] data.prefetchBuffer;
+		data.prefetchBuffer = buffer;
+		data.prefetchBufferSize = data.bufferSize;
+	}
+
+	data.prefetchPending = true;
+	release_sem(data.requestSemaphore);
+}
+
+
+void
+BBufferedDataIO::_WaitForPrefetch()
+{
+	if (fPrivate == NULL || !fPrivate->prefetchPending)
+		return;
+
+	while (acquire_sem(fPrivate->doneSemaphore) == B_INTERRUPTED)
+		;
+	fPrivate->prefetchPending = false;
+}
+
+
+/*!	Waits for a pending read ahead, and drops its data, as well as the
+	pattern seen so far.
+*/
+void
+BBufferedDataIO::_StopPrefetching()
+{
+	if (fPrivate == NULL)
+		return;
+
+	_WaitForPrefetch();
+	fPrivate->sequentialCount = 0;
+}
+
+
+/*static*/ status_t
+BBufferedDataIO::_PrefetchThread(void* _data)
+{
+	Private& data = *(Private*)_data;
+
+	while (true) {
+		status_t status = acquire_sem(data.requestSemaphore);
+		if (status == B_INTERRUPTED)
+			continue;
+		if (status != B_OK || data.quit)
+			break;
+
+		data.prefetchResult = data.stream.Read(data.prefetchBuffer,
+			data.prefetchBufferSize);
+		release_sem(data.doneSemaphore);
+	}
+
+	return B_OK;
+}
+
+
 //	#pragma mark - FBC
 
 
@@ -22,6 +22,10 @@
 #include <stdlib.h>
 #include <strings.h>
 
+#ifdef __SSE2__
+#	include <emmintrin.h>
+#endif
+
 #include <Debug.h>
 #include <StringList.h>
 
@@ -78,6 +82,106 @@ safestr(const char* string)
 }
 
 
+//! Compares \a length bytes like strncasecmp(), but does not stop at a null.
+static inline bool
+equal_ignore_case(const char* a, const char* b, int32 length)
+{
+	for (int32 i = 0; i < length; i++) {
+		if (tolower((uint8)a[i]) != tolower((uint8)b[i]))
+			return false;
+	}
+	return true;
+}
+
+
+template<bool IgnoreCase>
+static inline bool
+equal_at(const char* source, const char* find, int32 findLength)
+{
+	return IgnoreCase ? equal_ignore_case(source, find, findLength)
+		: memcmp(source, find, findLength) == 0;
+}
+
+
+/*!	Returns the offset of the first occurrence of the \a findLength bytes at
+	\a find within the \a length bytes at \a source, or -1 if there is none.
+	\a findLength must be at least 1.
+
+	Only positions that start with the first and end with the last byte of
+	\a find are compared in full. With SSE2, 16 positions are checked for
+	that at once, which rules out all but very few of them in typical text.
+*/
+template<bool IgnoreCase>
+static int32
+find_string(const char* source, int32 length, const char* find,
+	int32 findLength)
+{
+	const int32 lastStart = length - findLength;
+	if (lastStart < 0)
+		return -1;
+
+	const uint8 first = (uint8)find[0];
+	const uint8 last = (uint8)find[findLength - 1];
+	const uint8 firstLower = IgnoreCase ? tolower(first) : first;
+	const uint8 firstUpper = IgnoreCase ? toupper(first) : first;
+	const uint8 lastLower = IgnoreCase ? tolower(last) : last;
+	const uint8 lastUpper = IgnoreCase ? toupper(last) : last;
+
+	int32 start = 0;
+
+#ifdef __SSE2__
+	const __m128i firstLowerVector = _mm_set1_epi8(firstLower);
+	const __m128i firstUpperVector = _mm_set1_epi8(firstUpper);
+	const __m128i lastLowerVector = _mm_set1_epi8(lastLower);
+	const __m128i lastUpperVector = _mm_set1_epi8(lastUpper);
+
+	while (start + 16 <= lastStart + 1) {
+		// look for candidates first, as verifying them needs a call
+		uint32 mask = 0;
+		for (; start + 16 <= lastStart + 1; start += 16) {
+			const __m128i firstBlock
+				= _mm_loadu_si128((const __m128i*)(source + start));
+			const __m128i lastBlock = _mm_loadu_si128(
+				(const __m128i*)(source + start + findLength - 1));
+
+			__m128i firstMatches
+				= _mm_cmpeq_epi8(firstBlock, firstLowerVector);
+			__m128i lastMatches = _mm_cmpeq_epi8(lastBlock, lastLowerVector);
+			if (IgnoreCase) {
+				firstMatches = _mm_or_si128(firstMatches,
+					_mm_cmpeq_epi8(firstBlock, firstUpperVector));
+				lastMatches = _mm_or_si128(lastMatches,
+					_mm_cmpeq_epi8(lastBlock, lastUpperVector));
+			}
+
+			mask = _mm_movemask_epi8(
+				_mm_and_si128(firstMatches, lastMatches));
+			if (mask != 0)
+				break;
+		}
+		if (mask == 0)
+			break;
+
+		for (; mask != 0; mask &= mask - 1) {
+			const int32 offset = start + __builtin_ctz(mask);
+			if (equal_at<IgnoreCase>(source + offset, find, findLength))
+				return offset;
+		}
+		start += 16;
+	}
+#endif
+
+	for (; start <= lastStart; start++) {
+		const uint8 c = (uint8)source[start];
+		if ((c == firstLower || c == firstUpper)
+			&& equal_at<IgnoreCase>(source + start, find, findLength))
+			return start;
+	}
+
+	return -1;
+}
+
+
 //	#pragma mark - PosVect
 
 
@@ -1167,19 +1271,11 @@ BString::FindFirst(const char* string, int32 fromOffset) const
 int32
 BString::FindFirst(char c) const
 {
-	const char* start = String();
-	const char* end = String() + Length();
-
-	// Scans the string until we found the
-	// character, or we reach the string's start
-	while (start != end && *start != c) {
-		start++;
-	}
-
-	if (start == end)
+	const char* found = (const char*)memchr(String(), c, Length());
+	if (found == NULL)
 		return B_ERROR;
 
-	return start - String();
+	return found - String();
 }
 
 
@@ -1189,19 +1285,14 @@ BString::FindFirst(char c, int32 fromOffset) const
 	if (fromOffset < 0)
 		return B_ERROR;
 
-	const char* start = String() + min_clamp0(fromOffset, Length());
-	const char* end = String() + Length();
-
-	// Scans the string until we found the
-	// character, or we reach the string's start
-	while (start < end && *start != c) {
-		start++;
-	}
+	fromOffset = min_clamp0(fromOffset, Length());
 
-	if (start >= end)
+	const char* found = (const char*)memchr(String() + fromOffset, c,
+		Length() - fromOffset);
+	if (found == NULL)
 		return B_ERROR;
 
-	return start - String();
+	return found - String();
 }
 
 
@@ -2508,36 +2599,37 @@ BString::_DoInsert(const char* string, int32 offset, int32 length)
 int32
 BString::_ShortFindAfter(const char* string, int32 len) const
 {
-	const char* ptr = strstr(String(), string);
-
-	if (ptr != NULL)
-		return ptr - String();
-
-	return B_ERROR;
+	return _FindAfter(string, 0, len);
 }
 
 
 int32
 BString::_FindAfter(const char* string, int32 offset, int32 length) const
 {
-	const char* ptr = strstr(String() + offset, string);
+	if (length == 0)
+		return offset;
 
-	if (ptr != NULL)
-		return ptr - String();
+	int32 pos = find_string<false>(String() + offset, Length() - offset,
+		string, length);
+	if (pos < 0)
+		return B_ERROR;
 
-	return B_ERROR;
+	return offset + pos;
 }
 
 
 int32
 BString::_IFindAfter(const char* string, int32 offset, int32 length) const
 {
-	const char* ptr = strcasestr(String() + offset, string);
+	if (length == 0)
+		return offset;
 
-	if (ptr != NULL)
-		return ptr - String();
+	int32 pos = find_string<true>(String() + offset, Length() - offset,
+		string, length);
+	if (pos < 0)
+		return B_ERROR;
 
-	return B_ERROR;
+	return offset + pos;
 }
 
 
@@ -2677,8 +2769,21 @@ void
 BString::_ReplaceAtPositions(const PosVect* positions, int32 searchLength,
 	const char* with, int32 withLength)
 {
-	int32 length = Length();
 	uint32 count = positions->CountItems();
+	if (count == 0)
+		return;
+
+	if (withLength == searchLength) {
+		// the string keeps its length, and can be changed in place
+		if (_MakeWritable() != B_OK)
+			return;
+
+		for (uint32 i = 0; i < count; i++)
+			memcpy(fPrivateData + positions->ItemAt(i), with, withLength);
+		return;
+	}
+
+	int32 length = Length();
 	int32 newLength = length + count * (withLength - searchLength);
 	if (!newLength) {
 		_Resize(0);
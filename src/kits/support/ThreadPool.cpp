@@ -0,0 +1,639 @@
+/*
+ * Copyright 2026, Haiku, Inc. All Rights Reserved.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+/*!	A pool of worker threads that run tasks, one per CPU by default.
+
+	Every worker has a deque of its own: the tasks a worker spawns are pushed
+	to, and taken from, its bottom without any locking, which keeps the
+	tasks of a fork/join computation on the thread that forked them, in the
+	order that keeps the working set small. Workers that run out of tasks
+	steal the oldest ones from the top of the deques of the others, which
+	tend to be the largest pieces of the work left.
+
+	Tasks that are submitted from other threads, or with a priority other
+	than TASK_PRIORITY_NORMAL, are queued in a FIFO per priority instead.
+	High priority tasks are picked up before the own tasks of a worker, the
+	others only when it has none left.
+
+	Threads that wait for a TaskGroup run tasks in the meantime, so that
+	waiting for tasks from within a task neither blocks a worker, nor can
+	deadlock the pool.
+*/
+
+
+#include <ThreadPool.h>
+
+#include <Autolock.h>
+#include <Job.h>
+
+#include <JobQueue.h>
+
+
+namespace BSupportKit {
+
+namespace BPrivate {
+
+
+static const int32 kDequeSize = 1024;
+	// must be a power of two
+static const bigtime_t kWaitInterval = 1000;
+	// how often a waiting thread looks for new tasks to help with
+static const bigtime_t kJobPollInterval = 100000;
+	// how often a job queue is checked for being drained, since failed jobs
+	// remove their dependants without waking up anyone
+
+
+/*!	The deque is the one described by Chase and Lev, in its simplest, fixed
+	size form: when it is full, the spawning thread runs the task itself.
+	Only the owning worker changes \c bottom, everyone may change \c top.
+*/
+struct ThreadPool::Worker {
+	ThreadPool*		pool;
+	thread_id		thread;
+	uint32			random;
+
+	int64			top;
+	uint8			padding[64];
+		// keeps the thieves from invalidating the cache line of the owner
+	int64			bottom;
+	Task*			tasks[kDequeSize];
+
+	bool Push(Task* task)
+	{
+		int64 index = bottom;
+		if (index - atomic_get64(&top) >= kDequeSize)
+			return false;
+
+		tasks[index & (kDequeSize - 1)] = task;
+		atomic_get_and_set64(&bottom, index + 1);
+			// also needs to be visible before the idle count is read
+		return true;
+	}
+
+	Task* Take()
+	{
+		int64 index = bottom - 1;
+		atomic_get_and_set64(&bottom, index);
+			// needs to be visible before top is read
+
+		int64 first = atomic_get64(&top);
+		if (first > index) {
+			atomic_set64(&bottom, index + 1);
+			return NULL;
+		}
+
+		Task* task = tasks[index & (kDequeSize - 1)];
+		if (first == index) {
+			// the last task, thieves might be after it as well
+			if (atomic_test_and_set64(&top, first + 1, first) != first)
+				task = NULL;
+			atomic_set64(&bottom, index + 1);
+		}
+
+		return task;
+	}
+
+	Task* Steal()
+	{
+		int64 first = atomic_get64(&top);
+		if (first >= atomic_get64(&bottom))
+			return NULL;
+
+		Task* task = tasks[first & (kDequeSize - 1)];
+		if (atomic_test_and_set64(&top, first + 1, first) != first)
+			return NULL;
+
+		return task;
+	}
+
+	uint32 NextRandom()
+	{
+		// xorshift
+		random ^= random << 13;
+		random ^= random >> 17;
+		random ^= random << 5;
+		return random;
+	}
+};
+
+
+class ThreadPool::JobTask : public Task {
+public:
+	JobTask(BJob* job)
+		:
+		fJob(job)
+	{
+	}
+
+	virtual void Run()
+	{
+		fJob->Run();
+	}
+
+private:
+	BJob*		fJob;
+};
+
+
+class ThreadPool::JobQueueTask : public Task {
+public:
+	JobQueueTask(JobQueue& queue)
+		:
+		fQueue(queue)
+	{
+	}
+
+	virtual void Run()
+	{
+		while (!IsCanceled()) {
+			BJob* job;
+			status_t status = fQueue.Pop(kJobPollInterval, true, &job);
+			if (status == B_TIMED_OUT) {
+				if (fQueue.CountJobs() > 0)
+					continue;
+				break;
+			}
+			if (status != B_OK)
+				break;
+
+			job->Run();
+			delete job;
+		}
+	}
+
+private:
+	JobQueue&	fQueue;
+};
+
+
+// #pragma mark - Task
+
+
+Task::Task()
+	:
+	fGroup(NULL),
+	fNext(NULL)
+{
+}
+
+
+Task::~Task()
+{
+}
+
+
+bool
+Task::IsCanceled() const
+{
+	return fGroup != NULL && fGroup->IsCanceled();
+}
+
+
+// #pragma mark - TaskGroup
+
+
+TaskGroup::TaskGroup(ThreadPool& pool)
+	:
+	fPool(pool),
+	fPendingCount(0),
+	fNotifyingCount(0),
+	fCanceled(0)
+{
+	fDoneSemaphore = create_sem(0, "task group done");
+}
+
+
+TaskGroup::~TaskGroup()
+{
+	Wait();
+
+	// the last task to finish might not be done with us yet
+	while (atomic_get(&fNotifyingCount) > 0)
+		snooze(10);
+
+	delete_sem(fDoneSemaphore);
+}
+
+
+status_t
+TaskGroup::Spawn(Task* task, task_priority priority)
+{
+	if (fDoneSemaphore < 0) {
+		delete task;
+		return fDoneSemaphore;
+	}
+
+	task->fGroup = this;
+	atomic_add(&fPendingCount, 1);
+
+	status_t status = fPool._Enqueue(task, priority);
+	if (status != B_OK) {
+		task->fGroup = NULL;
+		delete task;
+		_TaskDone();
+	}
+	return status;
+}
+
+
+status_t
+TaskGroup::Spawn(BJob* job, task_priority priority)
+{
+	Task* task = new(std::nothrow) ThreadPool::JobTask(job);
+	if (task == NULL)
+		return B_NO_MEMORY;
+
+	return Spawn(task, priority);
+}
+
+
+/*!	Returns when all tasks of the group are done, and runs tasks of any
+	group until then.
+*/
+void
+TaskGroup::Wait()
+{
+	ThreadPool::Worker* worker = fPool._CurrentWorker();
+
+	while (atomic_get(&fPendingCount) > 0) {
+		Task* task = fPool._NextTask(worker);
+		if (task != NULL) {
+			fPool._RunTask(task);
+			continue;
+		}
+
+		// The remaining tasks are running elsewhere, but might still spawn
+		// more for us to help with, so don't block for long.
+		acquire_sem_etc(fDoneSemaphore, 1, B_RELATIVE_TIMEOUT, kWaitInterval);
+	}
+}
+
+
+/*!	Keeps the tasks of the group that have not started yet from running, and
+	lets the running ones know via Task::IsCanceled(). Tasks that are spawned
+	afterwards won't run either.
+*/
+void
+TaskGroup::Cancel()
+{
+	atomic_set(&fCanceled, 1);
+}
+
+
+bool
+TaskGroup::IsCanceled() const
+{
+	return atomic_get((int32*)&fCanceled) != 0;
+}
+
+
+void
+TaskGroup::_TaskDone()
+{
+	atomic_add(&fNotifyingCount, 1);
+	if (atomic_add(&fPendingCount, -1) == 1)
+		release_sem(fDoneSemaphore);
+	atomic_add(&fNotifyingCount, -1);
+}
+
+
+// #pragma mark - ThreadPool
+
+
+ThreadPool::ThreadPool(const char* name, int32 workerCount,
+	int32 threadPriority)
+	:
+	fLock("thread pool"),
+	fWorkers(NULL),
+	fWorkerCount(0),
+	fWakeUpSemaphore(-1),
+	fIdleCount(0),
+	fStealIndex(0),
+	fQuit(0)
+{
+	for (int32 i = 0; i < kPriorityCount; i++) {
+		fQueueHeads[i] = NULL;
+		fQueueTails[i] = NULL;
+		fQueuedCounts[i] = 0;
+	}
+
+	fInitStatus = _Init(name, workerCount, threadPriority);
+}
+
+
+/*!	Stops the workers after the tasks they are running, and deletes the
+	tasks that are still waiting, without running them.
+*/
+ThreadPool::~ThreadPool()
+{
+	atomic_set(&fQuit, 1);
+
+	if (fWakeUpSemaphore >= 0)
+		release_sem_etc(fWakeUpSemaphore, fWorkerCount, 0);
+
+	for (int32 i = 0; i < fWorkerCount; i++) {
+		status_t result;
+		wait_for_thread(fWorkers[i].thread, &result);
+	}
+
+	while (Task* task = _DequeueQueued(TASK_PRIORITY_LOW))
+		_DiscardTask(task);
+	for (int32 i = 0; i < fWorkerCount; i++) {
+		while (Task* task = fWorkers[i].Steal())
+			_DiscardTask(task);
+	}
+
+	delete[] fWorkers;
+
+	if (fWakeUpSemaphore >= 0)
+		delete_sem(fWakeUpSemaphore);
+}
+
+
+status_t
+ThreadPool::InitCheck() const
+{
+	return fInitStatus;
+}
+
+
+int32
+ThreadPool::CountWorkers() const
+{
+	return fWorkerCount;
+}
+
+
+bool
+ThreadPool::IsWorkerThread() const
+{
+	return _CurrentWorker() != NULL;
+}
+
+
+status_t
+ThreadPool::Submit(Task* task, task_priority priority)
+{
+	status_t status = _Enqueue(task, priority);
+	if (status != B_OK)
+		delete task;
+	return status;
+}
+
+
+/*!	Pops the jobs off the \a queue with all workers, and the calling thread,
+	runs them, and deletes them, until the queue is empty. The queue keeps
+	track of the dependencies between the jobs, as usual.
+*/
+status_t
+ThreadPool::RunJobs(JobQueue& queue)
+{
+	if (fInitStatus != B_OK)
+		return fInitStatus;
+
+	TaskGroup group(*this);
+	for (int32 i = 0; i < fWorkerCount; i++) {
+		Task* task = new(std::nothrow) JobQueueTask(queue);
+		status_t status = task != NULL ? group.Spawn(task) : B_NO_MEMORY;
+		if (status != B_OK) {
+			// the ones that have been spawned will do the work
+			if (i > 0)
+				break;
+			return status;
+		}
+	}
+
+	group.Wait();
+	return B_OK;
+}
+
+
+status_t
+ThreadPool::_Init(const char* name, int32 workerCount, int32 threadPriority)
+{
+	status_t status = fLock.InitCheck();
+	if (status != B_OK)
+		return status;
+
+	if (workerCount < 0) {
+		system_info info;
+		workerCount = get_system_info(&info) == B_OK ? info.cpu_count : 1;
+	}
+	if (workerCount < 1)
+		workerCount = 1;
+
+	fWakeUpSemaphore = create_sem(0, "thread pool wake up");
+	if (fWakeUpSemaphore < 0)
+		return fWakeUpSemaphore;
+
+	fWorkers = new(std::nothrow) Worker[workerCount];
+	if (fWorkers == NULL)
+		return B_NO_MEMORY;
+
+	// set up all workers before any of them starts to steal from the others
+	for (int32 i = 0; i < workerCount; i++) {
+		Worker& worker = fWorkers[i];
+		worker.pool = this;
+		worker.thread = -1;
+		worker.random = i * 2654435761U + 1;
+		worker.top = 0;
+		worker.bottom = 0;
+	}
+
+	for (int32 i = 0; i < workerCount; i++) {
+		thread_id thread = spawn_thread(&_WorkerLoop, name, threadPriority,
+			&fWorkers[i]);
+		if (thread < 0) {
+			if (fWorkerCount > 0)
+				break;
+			return thread;
+		}
+
+		fWorkers[i].thread = thread;
+		fWorkerCount++;
+	}
+
+	for (int32 i = 0; i < fWorkerCount; i++)
+		resume_thread(fWorkers[i].thread);
+
+	return B_OK;
+}
+
+
+status_t
+ThreadPool::_Enqueue(Task* task, task_priority priority)
+{
+	if (fInitStatus != B_OK)
+		return fInitStatus;
+
+	Worker* worker = priority == TASK_PRIORITY_NORMAL
+		? _CurrentWorker() : NULL;
+	if (worker != NULL) {
+		if (!worker->Push(task)) {
+			_RunTask(task);
+			return B_OK;
+		}
+	} else {
+		if ((uint32)priority >= (uint32)kPriorityCount)
+			return B_BAD_VALUE;
+
+		BAutolock locker(fLock);
+		task->fNext = NULL;
+		if (fQueueTails[priority] != NULL)
+			fQueueTails[priority]->fNext = task;
+		else
+			fQueueHeads[priority] = task;
+		fQueueTails[priority] = task;
+		atomic_add(&fQueuedCounts[priority], 1);
+	}
+
+	_WakeUpWorker();
+	return B_OK;
+}
+
+
+/*!	Returns the next task for the \a worker, or, if that is \c NULL, for a
+	thread that is waiting for a group.
+*/
+Task*
+ThreadPool::_NextTask(Worker* worker)
+{
+	Task* task = _DequeueQueued(TASK_PRIORITY_HIGH);
+	if (task == NULL && worker != NULL)
+		task = worker->Take();
+	if (task == NULL)
+		task = _DequeueQueued(TASK_PRIORITY_LOW);
+	if (task == NULL)
+		task = _Steal(worker);
+
+	return task;
+}
+
+
+Task*
+ThreadPool::_DequeueQueued(task_priority minPriority)
+{
+	int32 priority = kPriorityCount - 1;
+	while (priority >= minPriority
+		&& atomic_get(&fQueuedCounts[priority]) == 0) {
+		priority--;
+	}
+	if (priority < minPriority)
+		return NULL;
+
+	BAutolock locker(fLock);
+	for (; priority >= minPriority; priority--) {
+		Task* task = fQueueHeads[priority];
+		if (task == NULL)
+			continue;
+
+		fQueueHeads[priority] = task->fNext;
+		if (fQueueHeads[priority] == NULL)
+			fQueueTails[priority] = NULL;
+		atomic_add(&fQueuedCounts[priority], -1);
+		return task;
+	}
+
+	return NULL;
+}
+
+
+Task*
+ThreadPool::_Steal(Worker* thief)
+{
+	uint32 start = thief != NULL
+		? thief->NextRandom() : (uint32)atomic_add(&fStealIndex, 1);
+
+	for (int32 i = 0; i < fWorkerCount; i++) {
+		Worker& victim = fWorkers[(start + i) % fWorkerCount];
+		if (&victim == thief)
+			continue;
+
+		if (Task* task = victim.Steal())
+			return task;
+	}
+
+	return NULL;
+}
+
+
+void
+ThreadPool::_RunTask(Task* task)
+{
+	TaskGroup* group = task->fGroup;
+	if (group == NULL || !group->IsCanceled())
+		task->Run();
+
+	delete task;
+
+	if (group != NULL)
+		group->_TaskDone();
+}
+
+
+void
+ThreadPool::_DiscardTask(Task* task)
+{
+	TaskGroup* group = task->fGroup;
+	delete task;
+
+	if (group != NULL)
+		group->_TaskDone();
+}
+
+
+void
+ThreadPool::_WakeUpWorker()
+{
+	if (atomic_get(&fIdleCount) > 0)
+		release_sem_etc(fWakeUpSemaphore, 1, B_DO_NOT_RESCHEDULE);
+}
+
+
+ThreadPool::Worker*
+ThreadPool::_CurrentWorker() const
+{
+	thread_id thread = find_thread(NULL);
+	for (int32 i = 0; i < fWorkerCount; i++) {
+		if (fWorkers[i].thread == thread)
+			return &fWorkers[i];
+	}
+
+	return NULL;
+}
+
+
+/*static*/ status_t
+ThreadPool::_WorkerLoop(void* data)
+{
+	Worker* worker = (Worker*)data;
+	ThreadPool* pool = worker->pool;
+
+	while (atomic_get(&pool->fQuit) == 0) {
+		Task* task = pool->_NextTask(worker);
+		if (task == NULL) {
+			// Look once more after announcing that we're going to sleep, so
+			// that a task queued in the meantime isn't left waiting.
+			atomic_add(&pool->fIdleCount, 1);
+			task = pool->_NextTask(worker);
+			if (task == NULL && atomic_get(&pool->fQuit) == 0) {
+				while (acquire_sem(pool->fWakeUpSemaphore) == B_INTERRUPTED)
+					;
+			}
+			atomic_add(&pool->fIdleCount, -1);
+		}
+
+		if (task != NULL)
+			pool->_RunTask(task);
+	}
+
+	return B_OK;
+}
+
+
+}	// namespace BPrivate
+
+}	// namespace BSupportKit
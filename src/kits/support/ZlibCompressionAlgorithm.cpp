@@ -15,6 +15,7 @@
 #include <zlib.h>
 
 #include <DataIO.h>
+#include <OS.h>
 
 
 // build compression support only for userland
@@ -46,7 +47,8 @@ BZlibCompressionParameters::BZlibCompressionParameters(
 	BCompressionParameters(),
 	fCompressionLevel(compressionLevel),
 	fBufferSize(kDefaultBufferSize),
-	fGzipFormat(false)
+	fGzipFormat(false),
+	fWorkerCount(0)
 {
 }
 
@@ -98,6 +100,28 @@ BZlibCompressionParameters::SetGzipFormat(bool gzipFormat)
 }
 
 
+int32
+BZlibCompressionParameters::WorkerCount() const
+{
+	return fWorkerCount;
+}
+
+
+/*!	Sets the number of threads a compressing output stream compresses with,
+	the calling one included. With more than one, the data is split into
+	blocks that are compressed independently, each primed with the end of
+	the one before it, and put together into a single regular zlib or gzip
+	stream. That costs a little in compression ratio, and a stream that can
+	no longer be flushed without being finished: the first Flush() ends the
+	stream. Compressing input streams and CompressBuffer() ignore the count.
+*/
+void
+BZlibCompressionParameters::SetWorkerCount(int32 count)
+{
+	fWorkerCount = std::max(count, (int32)0);
+}
+
+
 // #pragma mark - BZlibDecompressionParameters
 
 
@@ -306,6 +330,420 @@ private:
 };
 
 
+#ifdef B_ZLIB_COMPRESSION_SUPPORT
+
+// #pragma mark - ParallelCompressingStream
+
+
+static const size_t kParallelBlockSize	= 128 * 1024;
+static const size_t kDictionarySize		= 32 * 1024;
+static const int32 kMaxWorkerCount		= 64;
+
+
+class BZlibCompressionAlgorithm::ParallelCompressingStream : public BDataIO {
+public:
+	ParallelCompressingStream(BDataIO* output)
+		:
+		fOutput(output),
+		fCompressionLevel(B_ZLIB_COMPRESSION_DEFAULT),
+		fGzipFormat(false),
+		fBlocks(NULL),
+		fBlockCount(0),
+		fFilledBlocks(0),
+		fDictionarySize(0),
+		fChecksum(0),
+		fTotalSize(0),
+		fHeaderWritten(false),
+		fFinished(false),
+		fError(B_OK),
+		fThreads(NULL),
+		fThreadCount(0),
+		fJobSemaphore(-1),
+		fDoneSemaphore(-1),
+		fNextJob(0),
+		fJobCount(0),
+		fFinishing(false),
+		fQuit(false)
+	{
+	}
+
+	virtual ~ParallelCompressingStream()
+	{
+		if (fBlocks != NULL && !fFinished)
+			Flush();
+
+		fQuit = true;
+		if (fJobSemaphore >= 0)
+			release_sem_etc(fJobSemaphore, fThreadCount, 0);
+		for (int32 i = 0; i < fThreadCount; i++) {
+			status_t result;
+			wait_for_thread(fThreads[i], &result);
+		}
+		delete[] fThreads;
+
+		if (fJobSemaphore >= 0)
+			delete_sem(fJobSemaphore);
+		if (fDoneSemaphore >= 0)
+			delete_sem(fDoneSemaphore);
+
+		for (int32 i = 0; i < fBlockCount; i++) {
+			free(fBlocks[i].input);
+			free(fBlocks[i].output);
+		}
+		delete[] fBlocks;
+	}
+
+	status_t Init(const BZlibCompressionParameters* parameters)
+	{
+		fCompressionLevel = parameters->CompressionLevel();
+		fGzipFormat = parameters->IsGzipFormat();
+		fChecksum = fGzipFormat ? crc32(0, Z_NULL, 0) : adler32(0, Z_NULL, 0);
+
+		// The calling thread compresses blocks as well.
+		int32 blockCount = std::min(parameters->WorkerCount(), kMaxWorkerCount);
+		fBlocks = new(std::nothrow) Block[blockCount];
+		if (fBlocks == NULL)
+			return B_NO_MEMORY;
+		fBlockCount = blockCount;
+
+		memset(fBlocks, 0, sizeof(Block) * fBlockCount);
+		for (int32 i = 0; i < fBlockCount; i++) {
+			fBlocks[i].input = (uint8*)malloc(kParallelBlockSize);
+			if (fBlocks[i].input == NULL)
+				return B_NO_MEMORY;
+		}
+
+		fJobSemaphore = create_sem(0, "zlib compression jobs");
+		if (fJobSemaphore < 0)
+			return fJobSemaphore;
+		fDoneSemaphore = create_sem(0, "zlib compression done");
+		if (fDoneSemaphore < 0)
+			return fDoneSemaphore;
+
+		fThreads = new(std::nothrow) thread_id[fBlockCount - 1];
+		if (fThreads == NULL)
+			return B_NO_MEMORY;
+
+		for (int32 i = 0; i < fBlockCount - 1; i++) {
+			thread_id thread = spawn_thread(&_WorkerThread, "zlib compressor",
+				B_NORMAL_PRIORITY, this);
+			if (thread < 0)
+				return thread;
+
+			fThreads[fThreadCount++] = thread;
+			resume_thread(thread);
+		}
+
+		return B_OK;
+	}
+
+	virtual ssize_t Write(const void* buffer, size_t size)
+	{
+		if (fFinished)
+			return B_NOT_ALLOWED;
+		if (fError != B_OK)
+			return fError;
+
+		const uint8* data = (const uint8*)buffer;
+		size_t remaining = size;
+		while (remaining > 0) {
+			Block& block = fBlocks[fFilledBlocks];
+			size_t toCopy = std::min(remaining,
+				kParallelBlockSize - block.inputSize);
+			memcpy(block.input + block.inputSize, data, toCopy);
+			block.inputSize += toCopy;
+			data += toCopy;
+			remaining -= toCopy;
+
+			if (block.inputSize < kParallelBlockSize)
+				break;
+
+			if (++fFilledBlocks == fBlockCount) {
+				status_t error = _CompressBlocks(false);
+				if (error != B_OK)
+					return error;
+			}
+		}
+
+		return size;
+	}
+
+	virtual status_t Flush()
+	{
+		if (!fFinished) {
+			fFinished = true;
+			if (fError != B_OK)
+				return fError;
+
+			// the partially filled block becomes the last one, or, if there is
+			// none, an empty block is written to end the stream
+			if (fBlocks[fFilledBlocks].inputSize > 0 || fFilledBlocks == 0)
+				fFilledBlocks++;
+
+			status_t error = _CompressBlocks(true);
+			if (error == B_OK)
+				error = _WriteTrailer();
+			if (error != B_OK)
+				return fError = error;
+		}
+
+		return fOutput->Flush();
+	}
+
+	static status_t Create(BDataIO* output,
+		const BZlibCompressionParameters* parameters, BDataIO*& _stream)
+	{
+		ParallelCompressingStream* stream
+			= new(std::nothrow) ParallelCompressingStream(output);
+		if (stream == NULL)
+			return B_NO_MEMORY;
+
+		status_t error = stream->Init(parameters);
+		if (error != B_OK) {
+			// nothing has been written yet, don't write a stream either
+			stream->fFinished = true;
+			delete stream;
+			return error;
+		}
+
+		_stream = stream;
+		return B_OK;
+	}
+
+private:
+	struct Block {
+		uint8*		input;
+		size_t		inputSize;
+		uint8*		output;
+		size_t		outputSize;
+		size_t		outputCapacity;
+		uLong		checksum;
+		status_t	status;
+	};
+
+	static status_t _WorkerThread(void* data)
+	{
+		ParallelCompressingStream* stream = (ParallelCompressingStream*)data;
+
+		while (true) {
+			status_t error;
+			do {
+				error = acquire_sem(stream->fJobSemaphore);
+			} while (error == B_INTERRUPTED);
+
+			if (error != B_OK || stream->fQuit)
+				return B_OK;
+
+			stream->_ProcessJobs();
+			release_sem(stream->fDoneSemaphore);
+		}
+	}
+
+	void _ProcessJobs()
+	{
+		int32 index;
+		while ((index = atomic_add(&fNextJob, 1)) < fJobCount) {
+			Block& block = fBlocks[index];
+
+			// All blocks but the last one are full, so the one before is
+			// always larger than the dictionary.
+			const uint8* dictionary = fDictionary;
+			size_t dictionarySize = fDictionarySize;
+			if (index > 0) {
+				dictionary = fBlocks[index - 1].input + kParallelBlockSize
+					- kDictionarySize;
+				dictionarySize = kDictionarySize;
+			}
+
+			block.status = _CompressBlock(block, dictionary, dictionarySize,
+				fFinishing && index == fJobCount - 1);
+		}
+	}
+
+	/*!	Compresses the block into raw deflate data that ends on a byte
+		boundary, or, for the \a last block, ends the deflate stream.
+	*/
+	status_t _CompressBlock(Block& block, const uint8* dictionary,
+		size_t dictionarySize, bool last)
+	{
+		block.outputSize = 0;
+		block.checksum = fGzipFormat
+			? crc32(crc32(0, Z_NULL, 0), block.input, block.inputSize)
+			: adler32(adler32(0, Z_NULL, 0), block.input, block.inputSize);
+
+		z_stream stream;
+		memset(&stream, 0, sizeof(stream));
+		int zlibError = deflateInit2(&stream, fCompressionLevel, Z_DEFLATED,
+			-MAX_WBITS, MAX_MEM_LEVEL, Z_DEFAULT_STRATEGY);
+		if (zlibError != Z_OK)
+			return _TranslateZlibError(zlibError);
+
+		if (dictionarySize > 0)
+			deflateSetDictionary(&stream, dictionary, dictionarySize);
+
+		// the flush marker takes a few bytes on top of the bound
+		size_t capacity = deflateBound(&stream, block.inputSize) + 16;
+		if (block.outputCapacity < capacity) {
+			uint8* output = (uint8*)realloc(block.output, capacity);
+			if (output == NULL) {
+				deflateEnd(&stream);
+				return B_NO_MEMORY;
+			}
+			block.output = output;
+			block.outputCapacity = capacity;
+		}
+
+		stream.next_in = block.input;
+		stream.avail_in = block.inputSize;
+		stream.next_out = block.output;
+		stream.avail_out = block.outputCapacity;
+
+		zlibError = deflate(&stream, last ? Z_FINISH : Z_SYNC_FLUSH);
+		bool complete = last
+			? zlibError == Z_STREAM_END
+			: zlibError == Z_OK && stream.avail_in == 0
+				&& stream.avail_out > 0;
+
+		block.outputSize = block.outputCapacity - stream.avail_out;
+		deflateEnd(&stream);
+
+		if (!complete) {
+			return zlibError == Z_OK || zlibError == Z_STREAM_END
+				? B_BUFFER_OVERFLOW : _TranslateZlibError(zlibError);
+		}
+		return B_OK;
+	}
+
+	status_t _CompressBlocks(bool finish)
+	{
+		fJobCount = fFilledBlocks;
+		fNextJob = 0;
+		fFinishing = finish;
+
+		int32 workers = std::min(fThreadCount, fJobCount - 1);
+		if (workers > 0)
+			release_sem_etc(fJobSemaphore, workers, 0);
+
+		_ProcessJobs();
+
+		for (int32 i = 0; i < workers; i++) {
+			while (acquire_sem(fDoneSemaphore) == B_INTERRUPTED)
+				;
+		}
+
+		status_t error = B_OK;
+		if (!fHeaderWritten) {
+			error = _WriteHeader();
+			fHeaderWritten = true;
+		}
+
+		for (int32 i = 0; error == B_OK && i < fJobCount; i++) {
+			Block& block = fBlocks[i];
+			error = block.status;
+			if (error == B_OK)
+				error = fOutput->WriteExactly(block.output, block.outputSize);
+			if (error != B_OK)
+				break;
+
+			fChecksum = fGzipFormat
+				? crc32_combine(fChecksum, block.checksum, block.inputSize)
+				: adler32_combine(fChecksum, block.checksum, block.inputSize);
+			fTotalSize += block.inputSize;
+		}
+
+		if (error == B_OK && fJobCount > 0) {
+			Block& lastBlock = fBlocks[fJobCount - 1];
+			if (lastBlock.inputSize == kParallelBlockSize) {
+				memcpy(fDictionary, lastBlock.input + kParallelBlockSize
+					- kDictionarySize, kDictionarySize);
+				fDictionarySize = kDictionarySize;
+			}
+		}
+
+		for (int32 i = 0; i < fJobCount; i++)
+			fBlocks[i].inputSize = 0;
+		fFilledBlocks = 0;
+
+		if (error != B_OK)
+			fError = error;
+		return error;
+	}
+
+	int _LevelFlags() const
+	{
+		// the same as deflate() uses for the headers
+		int32 level = fCompressionLevel == Z_DEFAULT_COMPRESSION
+			? 6 : fCompressionLevel;
+		if (level < 2)
+			return 0;
+		if (level < 6)
+			return 1;
+		return level == 6 ? 2 : 3;
+	}
+
+	status_t _WriteHeader()
+	{
+		if (fGzipFormat) {
+			int32 level = fCompressionLevel;
+			uint8 header[10] = {
+				0x1f, 0x8b, Z_DEFLATED, 0, 0, 0, 0, 0,
+				(uint8)(level == 9 ? 2 : (level >= 0 && level < 2 ? 4 : 0)),
+				3
+			};
+			return fOutput->WriteExactly(header, sizeof(header));
+		}
+
+		uint16 header = ((Z_DEFLATED + ((MAX_WBITS - 8) << 4)) << 8)
+			| (_LevelFlags() << 6);
+		header += 31 - header % 31;
+		uint8 bytes[2] = { (uint8)(header >> 8), (uint8)header };
+		return fOutput->WriteExactly(bytes, sizeof(bytes));
+	}
+
+	status_t _WriteTrailer()
+	{
+		uint8 trailer[8];
+		if (fGzipFormat) {
+			uint32 values[2] = { (uint32)fChecksum, (uint32)fTotalSize };
+			for (int32 i = 0; i < 8; i++)
+				trailer[i] = values[i / 4] >> (i % 4 * 8);
+			return fOutput->WriteExactly(trailer, 8);
+		}
+
+		for (int32 i = 0; i < 4; i++)
+			trailer[i] = fChecksum >> ((3 - i) * 8);
+		return fOutput->WriteExactly(trailer, 4);
+	}
+
+private:
+	BDataIO*		fOutput;
+	int32			fCompressionLevel;
+	bool			fGzipFormat;
+	Block*			fBlocks;
+	int32			fBlockCount;
+	int32			fFilledBlocks;
+	uint8			fDictionary[kDictionarySize];
+	size_t			fDictionarySize;
+	uLong			fChecksum;
+	off_t			fTotalSize;
+	bool			fHeaderWritten;
+	bool			fFinished;
+	status_t		fError;
+
+	thread_id*		fThreads;
+	int32			fThreadCount;
+	sem_id			fJobSemaphore;
+	sem_id			fDoneSemaphore;
+	int32			fNextJob;
+	int32			fJobCount;
+	bool			fFinishing;
+	volatile bool	fQuit;
+};
+
+
+#endif	// B_ZLIB_COMPRESSION_SUPPORT
+
+
 // #pragma mark - BZlibCompressionAlgorithm
 
 
@@ -339,6 +777,13 @@ BZlibCompressionAlgorithm::CreateCompressingOutputStream(BDataIO* output,
 	const BCompressionParameters* parameters, BDataIO*& _stream)
 {
 #ifdef B_ZLIB_COMPRESSION_SUPPORT
+	const BZlibCompressionParameters* zlibParameters
+		= dynamic_cast<const BZlibCompressionParameters*>(parameters);
+	if (zlibParameters != NULL && zlibParameters->WorkerCount() > 1) {
+		return ParallelCompressingStream::Create(output, zlibParameters,
+			_stream);
+	}
+
 	return Stream<BAbstractOutputStream, CompressionStrategy>::Create(
 		output, parameters, _stream);
 #else
@@ -50,7 +50,12 @@ BZstdCompressionParameters::BZstdCompressionParameters(
 	:
 	BCompressionParameters(),
 	fCompressionLevel(compressionLevel),
-	fBufferSize(kDefaultBufferSize)
+	fBufferSize(kDefaultBufferSize),
+	fWorkerCount(0),
+	fWindowLog(0),
+	fLongDistanceMatching(false),
+	fDictionary(NULL),
+	fDictionarySize(0)
 {
 }
 
@@ -88,13 +93,99 @@ BZstdCompressionParameters::SetBufferSize(size_t size)
 }
 
 
+int32
+BZstdCompressionParameters::WorkerCount() const
+{
+	return fWorkerCount;
+}
+
+
+/*!	Sets the number of threads that compress in the background. With the
+	default of 0, streams compress in the thread that writes or reads them.
+	Only streams compress in parallel, and they only do so for input larger
+	than a few MB; the output stays a regular zstd stream. Ignored if zstd
+	has been built without thread support.
+*/
+void
+BZstdCompressionParameters::SetWorkerCount(int32 count)
+{
+	fWorkerCount = std::max(count, (int32)0);
+}
+
+
+bool
+BZstdCompressionParameters::LongDistanceMatching() const
+{
+	return fLongDistanceMatching;
+}
+
+
+/*!	Lets zstd find matches much further back than the compression level
+	would, which helps with large inputs that repeat themselves, like
+	packages with many similar files. Implies a window log of 27 (128 MB),
+	unless one is set explicitly.
+*/
+void
+BZstdCompressionParameters::SetLongDistanceMatching(bool enabled)
+{
+	fLongDistanceMatching = enabled;
+}
+
+
+int32
+BZstdCompressionParameters::WindowLog() const
+{
+	return fWindowLog;
+}
+
+
+/*!	Sets the size of the window as a power of two, 0 lets the compression
+	level decide. Decompressing data with windows larger than 27 (128 MB)
+	requires BZstdDecompressionParameters::SetMaxWindowLog().
+*/
+void
+BZstdCompressionParameters::SetWindowLog(int32 windowLog)
+{
+	fWindowLog = windowLog;
+}
+
+
+const void*
+BZstdCompressionParameters::Dictionary() const
+{
+	return fDictionary;
+}
+
+
+size_t
+BZstdCompressionParameters::DictionarySize() const
+{
+	return fDictionarySize;
+}
+
+
+/*!	Sets a dictionary to compress with, which the same dictionary has to be
+	given for when decompressing. It is not copied, and has to stay valid as
+	long as the parameters are used to create streams or compress buffers.
+*/
+void
+BZstdCompressionParameters::SetDictionary(const void* dictionary, size_t size)
+{
+	fDictionary = size > 0 ? dictionary : NULL;
+	fDictionarySize = fDictionary != NULL ? size : 0;
+}
+
+
 // #pragma mark - BZstdDecompressionParameters
 
 
 BZstdDecompressionParameters::BZstdDecompressionParameters()
 	:
 	BDecompressionParameters(),
-	fBufferSize(kDefaultBufferSize)
+	fBufferSize(kDefaultBufferSize),
+	fMaxWindowLog(0),
+	fDictionary(NULL),
+	fDictionarySize(0)
 {
 }
 
@@ -118,12 +209,98 @@ BZstdDecompressionParameters::SetBufferSize(size_t size)
 }
 
 
+int32
+BZstdDecompressionParameters::MaxWindowLog() const
+{
+	return fMaxWindowLog;
+}
+
+
+/*!	Sets the largest window, as a power of two, that compressed data may
+	use, 0 keeps zstd's default of 27 (128 MB).
+*/
+void
+BZstdDecompressionParameters::SetMaxWindowLog(int32 windowLog)
+{
+	fMaxWindowLog = windowLog;
+}
+
+
+const void*
+BZstdDecompressionParameters::Dictionary() const
+{
+	return fDictionary;
+}
+
+
+size_t
+BZstdDecompressionParameters::DictionarySize() const
+{
+	return fDictionarySize;
+}
+
+
+/*!	Sets the dictionary the data has been compressed with. It is not copied,
+	and has to stay valid as long as the parameters are used.
+*/
+void
+BZstdDecompressionParameters::SetDictionary(const void* dictionary,
+	size_t size)
+{
+	fDictionary = size > 0 ? dictionary : NULL;
+	fDictionarySize = fDictionary != NULL ? size : 0;
+}
+
+
 // #pragma mark - CompressionStrategy
 
 
 #ifdef B_ZSTD_COMPRESSION_SUPPORT
 
 
+static size_t
+set_compression_parameters(ZSTD_CCtx* context,
+	const BZstdCompressionParameters* parameters)
+{
+	int32 compressionLevel = B_ZSTD_COMPRESSION_DEFAULT;
+	if (parameters != NULL)
+		compressionLevel = parameters->CompressionLevel();
+
+	size_t zstdError = ZSTD_CCtx_setParameter(context,
+		ZSTD_c_compressionLevel, compressionLevel);
+	if (ZSTD_isError(zstdError) || parameters == NULL)
+		return zstdError;
+
+	if (parameters->WorkerCount() > 0) {
+		// This fails if zstd has been built without thread support, in which
+		// case we just compress without workers.
+		ZSTD_CCtx_setParameter(context, ZSTD_c_nbWorkers,
+			parameters->WorkerCount());
+	}
+
+	if (parameters->LongDistanceMatching()) {
+		zstdError = ZSTD_CCtx_setParameter(context,
+			ZSTD_c_enableLongDistanceMatching, 1);
+		if (ZSTD_isError(zstdError))
+			return zstdError;
+	}
+
+	if (parameters->WindowLog() != 0) {
+		zstdError = ZSTD_CCtx_setParameter(context, ZSTD_c_windowLog,
+			parameters->WindowLog());
+		if (ZSTD_isError(zstdError))
+			return zstdError;
+	}
+
+	if (parameters->Dictionary() != NULL) {
+		zstdError = ZSTD_CCtx_loadDictionary(context,
+			parameters->Dictionary(), parameters->DictionarySize());
+	}
+
+	return zstdError;
+}
+
+
 struct BZstdCompressionAlgorithm::CompressionStrategy {
 	typedef BZstdCompressionParameters Parameters;
 
@@ -132,13 +309,11 @@ struct BZstdCompressionAlgorithm::CompressionStrategy {
 	static size_t Init(ZSTD_CStream **stream,
 		const BZstdCompressionParameters* parameters)
 	{
-		int32 compressionLevel = B_ZSTD_COMPRESSION_DEFAULT;
-		if (parameters != NULL) {
-			compressionLevel = parameters->CompressionLevel();
-		}
-
 		*stream = ZSTD_createCStream();
-		return ZSTD_initCStream(*stream, compressionLevel);
+		if (*stream == NULL)
+			return (size_t)-ZSTD_error_memory_allocation;
+
+		return set_compression_parameters(*stream, parameters);
 	}
 
 	static void Uninit(ZSTD_CStream *stream)
@@ -149,10 +324,8 @@ struct BZstdCompressionAlgorithm::CompressionStrategy {
 	static size_t Process(ZSTD_CStream *stream, ZSTD_inBuffer *input,
 		ZSTD_outBuffer *output, bool flush)
 	{
-		if (flush)
-			return ZSTD_flushStream(stream, output);
-		else
-			return ZSTD_compressStream(stream, output, input);
+		return ZSTD_compressStream2(stream, output, input,
+			flush ? ZSTD_e_flush : ZSTD_e_continue);
 	}
 };
 
@@ -166,16 +339,42 @@ struct BZstdCompressionAlgorithm::CompressionStrategy {
 #ifdef ZSTD_ENABLED
 
 
+static size_t
+set_decompression_parameters(ZSTD_DCtx* context,
+	const BZstdDecompressionParameters* parameters)
+{
+	if (parameters == NULL)
+		return 0;
+
+	if (parameters->MaxWindowLog() != 0) {
+		size_t zstdError = ZSTD_DCtx_setParameter(context,
+			ZSTD_d_windowLogMax, parameters->MaxWindowLog());
+		if (ZSTD_isError(zstdError))
+			return zstdError;
+	}
+
+	if (parameters->Dictionary() != NULL) {
+		return ZSTD_DCtx_loadDictionary(context, parameters->Dictionary(),
+			parameters->DictionarySize());
+	}
+
+	return 0;
+}
+
+
 struct BZstdCompressionAlgorithm::DecompressionStrategy {
 	typedef BZstdDecompressionParameters Parameters;
 
 	static const bool kNeedsFinalFlush = false;
 
 	static size_t Init(ZSTD_DStream **stream,
-		const BZstdDecompressionParameters* /*parameters*/)
+		const BZstdDecompressionParameters* parameters)
 	{
 		*stream = ZSTD_createDStream();
-		return ZSTD_initDStream(*stream);
+		if (*stream == NULL)
+			return (size_t)-ZSTD_error_memory_allocation;
+
+		return set_decompression_parameters(*stream, parameters);
 	}
 
 	static void Uninit(ZSTD_DStream *stream)
@@ -375,12 +574,17 @@ BZstdCompressionAlgorithm::CompressBuffer(const iovec& input, iovec& output,
 	// TODO: Make use of scratch buffer (if available.)
 	const BZstdCompressionParameters* zstdParameters
 		= dynamic_cast<const BZstdCompressionParameters*>(parameters);
-	int compressionLevel = zstdParameters != NULL
-		? zstdParameters->CompressionLevel()
-		: B_ZSTD_COMPRESSION_DEFAULT;
 
-	size_t zstdError = ZSTD_compress(output.iov_base, output.iov_len,
-		input.iov_base, input.iov_len, compressionLevel);
+	ZSTD_CCtx* cctx = ZSTD_createCCtx();
+	if (cctx == NULL)
+		return B_NO_MEMORY;
+	CObjectDeleter<ZSTD_CCtx, size_t, ZSTD_freeCCtx> cctxDeleter(cctx);
+
+	size_t zstdError = set_compression_parameters(cctx, zstdParameters);
+	if (!ZSTD_isError(zstdError)) {
+		zstdError = ZSTD_compress2(cctx, output.iov_base, output.iov_len,
+			input.iov_base, input.iov_len);
+	}
 	if (ZSTD_isError(zstdError))
 		return _TranslateZstdError(zstdError);
 
@@ -405,10 +609,21 @@ BZstdCompressionAlgorithm::DecompressBuffer(const iovec& input, iovec& output,
 	else
 #endif
 		dctxDeleter.SetTo(dctx = ZSTD_createDCtx());
+	if (dctx == NULL)
+		return B_NO_MEMORY;
+
+	const BZstdDecompressionParameters* zstdParameters
+#ifdef _BOOT_MODE
+		= static_cast<const BZstdDecompressionParameters*>(parameters);
+#else
+		= dynamic_cast<const BZstdDecompressionParameters*>(parameters);
+#endif
 
-	size_t zstdError = ZSTD_decompressDCtx(dctx,
-		output.iov_base, output.iov_len,
-		input.iov_base, input.iov_len);
+	size_t zstdError = set_decompression_parameters(dctx, zstdParameters);
+	if (!ZSTD_isError(zstdError)) {
+		zstdError = ZSTD_decompressDCtx(dctx, output.iov_base,
+			output.iov_len, input.iov_base, input.iov_len);
+	}
 	if (ZSTD_isError(zstdError))
 		return _TranslateZstdError(zstdError);
 
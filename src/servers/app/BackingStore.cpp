@@ -0,0 +1,277 @@
+/*
+ * Copyright 2026, Haiku, Inc.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+#include "BackingStore.h"
+
+#include <new>
+
+#include <Autolock.h>
+
+#include "DrawingEngine.h"
+#include "ServerBitmap.h"
+#include "Window.h"
+
+
+BackingStore::BackingStore(::Window* window)
+	:
+	fWindow(window),
+	fManager(NULL),
+	fBitmap(NULL),
+	fLeft(0),
+	fTop(0),
+	fLastUsed(0)
+{
+}
+
+
+BackingStore::~BackingStore()
+{
+	Free();
+}
+
+
+size_t
+BackingStore::MemorySize() const
+{
+	return fBitmap != NULL ? fBitmap->BitsLength() : 0;
+}
+
+
+/*!	Saves \a region of the window's contents from the screen. \a frame is
+	the current frame of the window contents, \a region is in the same
+	coordinates. If the window has been moved by \a xOffset and \a yOffset
+	since its contents were last drawn, they are read from where they are
+	still shown.
+*/
+status_t
+BackingStore::Save(BackingStoreManager* manager, DrawingEngine* engine,
+	const BRect& frame, BRegion& region, int32 xOffset, int32 yOffset)
+{
+	int32 width = frame.IntegerWidth() + 1;
+	int32 height = frame.IntegerHeight() + 1;
+
+	if (fBitmap == NULL || fBitmap->Width() != width
+		|| fBitmap->Height() != height) {
+		Free();
+
+		status_t status = manager->Allocate(this, width, height);
+		if (status != B_OK)
+			return status;
+	}
+
+	if (fLeft != (int32)frame.left || fTop != (int32)frame.top) {
+		fValidRegion.MakeEmpty();
+		fLeft = (int32)frame.left;
+		fTop = (int32)frame.top;
+	}
+
+	region.OffsetBy(-xOffset, -yOffset);
+	status_t status = engine->CopyRegionToBitmap(region, fBitmap,
+		fLeft - xOffset, fTop - yOffset);
+	region.OffsetBy(xOffset, yOffset);
+	if (status != B_OK)
+		return status;
+
+	fValidRegion.Include(&region);
+	fLastUsed = fManager->NextStamp();
+	return B_OK;
+}
+
+
+/*!	Copies the saved parts of \a region back to the screen, and removes
+	them from the store. \a region is reduced to what has been restored.
+*/
+void
+BackingStore::Restore(DrawingEngine* engine, BRegion& region)
+{
+	region.IntersectWith(&fValidRegion);
+	if (region.CountRects() == 0)
+		return;
+
+	if (engine->CopyRegionFromBitmap(region, fBitmap, fLeft, fTop) != B_OK) {
+		region.MakeEmpty();
+		return;
+	}
+
+	fValidRegion.Exclude(&region);
+	fLastUsed = fManager->NextStamp();
+}
+
+
+void
+BackingStore::MoveBy(int32 x, int32 y)
+{
+	fLeft += x;
+	fTop += y;
+	fValidRegion.OffsetBy(x, y);
+}
+
+
+void
+BackingStore::Invalidate(const BRegion& region)
+{
+	fValidRegion.Exclude(&region);
+}
+
+
+void
+BackingStore::Invalidate(const clipping_rect& rect)
+{
+	fValidRegion.Exclude(rect);
+}
+
+
+void
+BackingStore::Free()
+{
+	if (fManager != NULL)
+		fManager->Free(this);
+
+	fValidRegion.MakeEmpty();
+}
+
+
+// #pragma mark -
+
+
+BackingStoreManager::BackingStoreManager()
+	:
+	fLock("backing stores"),
+	fBudget(0),
+	fUsed(0),
+	fClock(0)
+{
+}
+
+
+BackingStoreManager::~BackingStoreManager()
+{
+	FreeAll();
+}
+
+
+void
+BackingStoreManager::SetBudget(size_t budget)
+{
+	BAutolock _(fLock);
+
+	fBudget = budget;
+
+	while (fUsed > fBudget) {
+		BackingStore* victim = _FindVictim(NULL);
+		if (victim == NULL)
+			break;
+
+		_Free(victim);
+	}
+}
+
+
+/*!	Allocates the bitmap of \a store, freeing other stores as needed to
+	stay within the budget. Since this looks at their windows, it must only
+	be called with all windows locked.
+*/
+status_t
+BackingStoreManager::Allocate(BackingStore* store, int32 width, int32 height)
+{
+	BAutolock _(fLock);
+
+	size_t size = (size_t)width * height * 4;
+	if (size > fBudget)
+		return B_NO_MEMORY;
+
+	while (fUsed + size > fBudget) {
+		BackingStore* victim = _FindVictim(store);
+		if (victim == NULL)
+			return B_NO_MEMORY;
+
+		_Free(victim);
+	}
+
+	UtilityBitmap* bitmap = new(std::nothrow) UtilityBitmap(
+		BRect(0, 0, width - 1, height - 1), B_RGB32, 0);
+	if (bitmap == NULL)
+		return B_NO_MEMORY;
+	if (!bitmap->IsValid()) {
+		bitmap->ReleaseReference();
+		return B_NO_MEMORY;
+	}
+
+	store->fBitmap = bitmap;
+	store->fManager = this;
+	store->fValidRegion.MakeEmpty();
+	store->fLastUsed = NextStamp();
+
+	fStores.Add(store);
+	fUsed += store->MemorySize();
+	return B_OK;
+}
+
+
+void
+BackingStoreManager::Free(BackingStore* store)
+{
+	BAutolock _(fLock);
+
+	_Free(store);
+}
+
+
+void
+BackingStoreManager::FreeAll()
+{
+	BAutolock _(fLock);
+
+	while (BackingStore* store = fStores.Head())
+		_Free(store);
+}
+
+
+int64
+BackingStoreManager::NextStamp()
+{
+	return atomic_add64(&fClock, 1);
+}
+
+
+void
+BackingStoreManager::_Free(BackingStore* store)
+{
+	if (store->fBitmap == NULL)
+		return;
+
+	fUsed -= store->MemorySize();
+	fStores.Remove(store);
+
+	store->fBitmap->ReleaseReference();
+	store->fBitmap = NULL;
+	store->fManager = NULL;
+	store->fValidRegion.MakeEmpty();
+}
+
+
+BackingStore*
+BackingStoreManager::_FindVictim(BackingStore* exclude) const
+{
+	BackingStore* victim = NULL;
+	bool victimVisible = true;
+
+	StoreList::ConstIterator iterator = fStores.GetIterator();
+	while (BackingStore* store = iterator.Next()) {
+		if (store == exclude)
+			continue;
+
+		bool visible = store->Window()->IsVisible();
+		if (victim == NULL || (victimVisible && !visible)
+			|| (visible == victimVisible
+				&& store->LastUsed() < victim->LastUsed())) {
+			victim = store;
+			victimVisible = visible;
+		}
+	}
+
+	return victim;
+}
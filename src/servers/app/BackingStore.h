@@ -0,0 +1,110 @@
+/*
+ * Copyright 2026, Haiku, Inc.
+ * Distributed under the terms of the MIT License.
+ */
+#ifndef BACKING_STORE_H
+#define BACKING_STORE_H
+
+
+#include <Locker.h>
+#include <Rect.h>
+#include <Region.h>
+
+#include <util/DoublyLinkedList.h>
+
+
+class BackingStoreManager;
+class DrawingEngine;
+class UtilityBitmap;
+class Window;
+
+
+/*!	Keeps a copy of the contents of a window that are currently hidden
+	behind other windows, or outside of the screen. When they are exposed
+	again, they can be copied back to the screen, instead of waiting for the
+	client to draw them.
+
+	The contents are saved right before the window loses them on screen,
+	in screen coordinates of the window's current position. Anything that
+	changes them needs to invalidate the respective part of the store.
+	The memory is accounted for, and reclaimed by the BackingStoreManager.
+*/
+class BackingStore : public DoublyLinkedListLinkImpl<BackingStore> {
+public:
+								BackingStore(::Window* window);
+								~BackingStore();
+
+			::Window*			Window() const
+									{ return fWindow; }
+
+			bool				IsEmpty() const
+									{ return fValidRegion.CountRects() == 0; }
+			const BRegion&		ValidRegion() const
+									{ return fValidRegion; }
+			size_t				MemorySize() const;
+			int64				LastUsed() const
+									{ return fLastUsed; }
+
+			status_t			Save(BackingStoreManager* manager,
+									DrawingEngine* engine, const BRect& frame,
+									BRegion& region, int32 xOffset,
+									int32 yOffset);
+			void				Restore(DrawingEngine* engine,
+									BRegion& region);
+
+			void				MoveBy(int32 x, int32 y);
+			void				Invalidate(const BRegion& region);
+			void				Invalidate(const clipping_rect& rect);
+			void				Free();
+
+private:
+	friend class BackingStoreManager;
+
+			::Window*			fWindow;
+			BackingStoreManager* fManager;
+			UtilityBitmap*		fBitmap;
+			int32				fLeft;
+			int32				fTop;
+			BRegion				fValidRegion;
+			int64				fLastUsed;
+};
+
+
+/*!	Owns the memory budget of all backing stores. When it would be exceeded,
+	the stores of windows that are not visible are freed first, then the
+	least recently used ones.
+*/
+class BackingStoreManager {
+public:
+								BackingStoreManager();
+								~BackingStoreManager();
+
+			void				SetBudget(size_t budget);
+			size_t				Budget() const
+									{ return fBudget; }
+			size_t				UsedMemory() const
+									{ return fUsed; }
+
+			status_t			Allocate(BackingStore* store, int32 width,
+									int32 height);
+			void				Free(BackingStore* store);
+			void				FreeAll();
+
+			int64				NextStamp();
+
+private:
+			void				_Free(BackingStore* store);
+			BackingStore*		_FindVictim(BackingStore* exclude) const;
+
+private:
+	typedef DoublyLinkedList<BackingStore> StoreList;
+
+			BLocker				fLock;
+			StoreList			fStores;
+			size_t				fBudget;
+			size_t				fUsed;
+			int64				fClock;
+};
+
+
+#endif	// BACKING_STORE_H
@@ -21,6 +21,7 @@
 
 #include "Desktop.h"
 
+#include <stdint.h>
 #include <stdio.h>
 #include <string.h>
 #include <syslog.h>
@@ -505,6 +506,21 @@ Desktop::Init()
 
 	fSettings.SetTo(new DesktopSettingsPrivate(fServerReadOnlyMemory));
 
+	// clients measure text on their own where they can, this is not required
+	snprintf(name, sizeof(name), "d:%d:font metrics", fUserID);
+	if (fFontMetrics.Init(name) == B_OK)
+		fServerReadOnlyMemory->font_metrics_area = fFontMetrics.Area();
+	else
+		fServerReadOnlyMemory->font_metrics_area = -1;
+
+	// keeping the hidden contents of windows is optional
+	if (fSettings->UseBackingStores()) {
+		// the limit is in MB, and may exceed the address space
+		uint64 budget = (uint64)fSettings->BackingStoreMemoryLimit()
+			* 1024 * 1024;
+		fBackingStores.SetBudget((size_t)min_c(budget, (uint64)SIZE_MAX));
+	}
+
 	for (int32 i = 0; i < kMaxWorkspaces; i++) {
 		_Windows(i).SetIndex(i);
 		fWorkspaces[i].RestoreConfiguration(*fSettings->WorkspacesMessage(i));
@@ -1510,7 +1526,7 @@ Desktop::MoveWindowBy(Window* window, float x, float y, int32 workspace)
 	window->MoveBy((int32)x, (int32)y);
 
 	BRegion background;
-	_RebuildClippingForAllWindows(background);
+	_RebuildClippingAfterWindowChange(window, newDirtyRegion, background);
 
 	// construct the region that is possible to be blitted
 	// to move the contents of the window
@@ -1588,7 +1604,8 @@ Desktop::ResizeWindowBy(Window* window, float x, float y)
 	window->ResizeBy((int32)x, (int32)y, &newDirtyRegion);
 
 	BRegion background;
-	_RebuildClippingForAllWindows(background);
+	_RebuildClippingAfterWindowChange(window, previouslyOccupiedRegion,
+		background);
 
 	// we just care for the region outside the window
 	previouslyOccupiedRegion.Exclude(&window->VisibleRegion());
@@ -1629,11 +1646,13 @@ Desktop::SetWindowOutlinesDelta(Window* window, BPoint delta)
 	if (!window->IsVisible())
 		return;
 
+	BRegion oldVisibleRegion(window->VisibleRegion());
+
 	BRegion newDirtyRegion;
 	window->SetOutlinesDelta(delta, &newDirtyRegion);
 
 	BRegion background;
-	_RebuildClippingForAllWindows(background);
+	_RebuildClippingAfterWindowChange(window, oldVisibleRegion, background);
 
 	MarkDirty(newDirtyRegion);
 	_SetBackground(background);
@@ -2206,6 +2225,12 @@ Desktop::MarkDirty(BRegion& dirtyRegion, BRegion& exposeRegion)
 void
 Desktop::Redraw()
 {
+	// the saved contents of the windows are outdated as well
+	if (LockAllWindows()) {
+		fBackingStores.FreeAll();
+		UnlockAllWindows();
+	}
+
 	BRegion dirty(fVirtualScreen.Frame());
 	MarkDirty(dirty);
 }
@@ -2238,6 +2263,7 @@ Desktop::RedrawBackground()
 			view = view->NextSibling();
 		}
 
+		window->FreeBackingStore();
 		window->ProcessDirtyRegion(redraw);
 	} else {
 		redraw = BackgroundRegion();
@@ -3477,6 +3503,79 @@ Desktop::_RebuildClippingForAllWindows(BRegion& stillAvailableOnScreen)
 }
 
 
+/*!	Updates the clipping of the windows after only the regions of
+	\a changedWindow changed, \a oldVisibleRegion being its visible region
+	from before the change. Only the clipping within the area the window
+	covered before, or covers now, can be different; only the windows
+	overlapping that area are updated, and only within it.
+
+	If \a dirty is given, it is restricted to what is not covered by the
+	windows in front of \a changedWindow.
+	Requires fBackgroundRegion to be up to date.
+*/
+void
+Desktop::_RebuildClippingAfterWindowChange(Window* changedWindow,
+	const BRegion& oldVisibleRegion, BRegion& stillAvailableOnScreen,
+	BRegion* dirty)
+{
+	BRegion* changedArea = fRegionPool.GetRegion(oldVisibleRegion);
+	BRegion* available = fRegionPool.GetRegion();
+	BRegion* covered = fRegionPool.GetRegion();
+	if (changedArea == NULL || available == NULL || covered == NULL) {
+		if (changedArea != NULL)
+			fRegionPool.Recycle(changedArea);
+		if (available != NULL)
+			fRegionPool.Recycle(available);
+		if (covered != NULL)
+			fRegionPool.Recycle(covered);
+
+		_RebuildClippingForAllWindows(stillAvailableOnScreen);
+		return;
+	}
+
+	WindowStack* stack = changedWindow->GetWindowStack();
+	if (stack != NULL && stack->CountWindows() > 1) {
+		// the other windows of the stack changed along with it
+		*changedArea = fScreenRegion;
+	} else {
+		changedWindow->GetFullRegion(covered);
+		changedArea->Include(covered);
+		changedArea->IntersectWith(&fScreenRegion);
+	}
+
+	// what is still available of the changed area, from front to back
+	*available = *changedArea;
+
+	for (Window* window = CurrentWindows().LastWindow(); window != NULL;
+			window = window->PreviousWindow(fCurrentWorkspace)) {
+		if (window->IsHidden())
+			continue;
+
+		if (window == changedWindow && dirty != NULL)
+			dirty->IntersectWith(available);
+
+		if (!window->UpdateClipping(*changedArea, *available, *covered))
+			continue;
+
+		window->SetScreen(_DetermineScreenFor(window->Frame()));
+
+		if (window->ServerWindow()->IsDirectlyAccessing()) {
+			window->ServerWindow()->HandleDirectConnection(
+				B_DIRECT_MODIFY | B_CLIPPING_MODIFIED);
+		}
+	}
+
+	// outside of the changed area, the background stays the same
+	stillAvailableOnScreen = fBackgroundRegion;
+	stillAvailableOnScreen.Exclude(changedArea);
+	stillAvailableOnScreen.Include(available);
+
+	fRegionPool.Recycle(changedArea);
+	fRegionPool.Recycle(available);
+	fRegionPool.Recycle(covered);
+}
+
+
 void
 Desktop::_TriggerWindowRedrawing(BRegion& dirtyRegion, BRegion& exposeRegion)
 {
@@ -3524,32 +3623,13 @@ Desktop::RebuildAndRedrawAfterWindowChange(Window* changedWindow,
 	if (!changedWindow->IsVisible() || dirty.CountRects() == 0)
 		return;
 
-	// The following loop is pretty much a copy of
-	// _RebuildClippingForAllWindows(), but will also
-	// take care about restricting our dirty region.
-
-	// figure out what the entire screen area is
-	BRegion stillAvailableOnScreen(fScreenRegion);
+	// the visible region of the window is still the one from before the
+	// change
+	BRegion oldVisibleRegion(changedWindow->VisibleRegion());
 
-	// set clipping of each window
-	for (Window* window = CurrentWindows().LastWindow(); window != NULL;
-			window = window->PreviousWindow(fCurrentWorkspace)) {
-		if (!window->IsHidden()) {
-			if (window == changedWindow)
-				dirty.IntersectWith(&stillAvailableOnScreen);
-
-			window->SetClipping(&stillAvailableOnScreen);
-			window->SetScreen(_DetermineScreenFor(window->Frame()));
-
-			if (window->ServerWindow()->IsDirectlyAccessing()) {
-				window->ServerWindow()->HandleDirectConnection(
-					B_DIRECT_MODIFY | B_CLIPPING_MODIFIED);
-			}
-
-			// that windows region is not available on screen anymore
-			stillAvailableOnScreen.Exclude(&window->VisibleRegion());
-		}
-	}
+	BRegion stillAvailableOnScreen;
+	_RebuildClippingAfterWindowChange(changedWindow, oldVisibleRegion,
+		stillAvailableOnScreen, &dirty);
 
 	_SetBackground(stillAvailableOnScreen);
 	_WindowChanged(changedWindow);
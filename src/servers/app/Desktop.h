@@ -29,13 +29,16 @@
 
 #include <ServerProtocolStructs.h>
 
+#include "BackingStore.h"
 #include "CursorManager.h"
 #include "DelayedMessage.h"
 #include "DesktopListener.h"
 #include "DesktopSettings.h"
 #include "EventDispatcher.h"
+#include "FontMetricsPublisher.h"
 #include "MessageLooper.h"
 #include "MultiLocker.h"
+#include "RegionPool.h"
 #include "Screen.h"
 #include "ScreenManager.h"
 #include "ServerCursor.h"
@@ -77,6 +80,11 @@ public:
 	virtual port_id				MessagePort() const { return fMessagePort; }
 			area_id				SharedReadOnlyArea() const
 									{ return fSharedReadOnlyArea; }
+			FontMetricsPublisher& FontMetrics()
+									{ return fFontMetrics; }
+			BackingStoreManager* BackingStores()
+									{ return fBackingStores.Budget() > 0
+										? &fBackingStores : NULL; }
 
 			::EventDispatcher&	EventDispatcher() { return fEventDispatcher; }
 
@@ -313,6 +321,11 @@ private:
 			Screen*				_DetermineScreenFor(BRect frame);
 			void				_RebuildClippingForAllWindows(
 									BRegion& stillAvailableOnScreen);
+			void				_RebuildClippingAfterWindowChange(
+									Window* changedWindow,
+									const BRegion& oldVisibleRegion,
+									BRegion& stillAvailableOnScreen,
+									BRegion* dirty = NULL);
 			void				_TriggerWindowRedrawing(
 									BRegion& dirtyRegion, BRegion& exposeRegion);
 			void				_SetBackground(BRegion& background);
@@ -340,6 +353,8 @@ private:
 			::EventDispatcher	fEventDispatcher;
 			area_id				fSharedReadOnlyArea;
 			server_read_only_memory* fServerReadOnlyMemory;
+			FontMetricsPublisher fFontMetrics;
+			BackingStoreManager	fBackingStores;
 
 			BLocker				fApplicationsLock;
 			BObjectList<ServerApp> fApplications;
@@ -370,6 +385,7 @@ private:
 
 			BRegion				fBackgroundRegion;
 			BRegion				fScreenRegion;
+			::RegionPool		fRegionPool;
 
 			Window*				fMouseEventWindow;
 			const Window*		fWindowUnderMouse;
@@ -57,6 +57,8 @@ DesktopSettingsPrivate::_SetDefaults()
 	fFocusFollowsMouseMode = B_NORMAL_FOCUS_FOLLOWS_MOUSE;
 	fAcceptFirstClick = true;
 	fShowAllDraggers = true;
+	fUseBackingStores = false;
+	fBackingStoreMemoryLimit = 64;
 
 	// init scrollbar info
 	fScrollBarInfo.proportional = true;
@@ -335,6 +337,28 @@ DesktopSettingsPrivate::_Load()
 		}
 	}
 
+	// read compositing settings, these are not changed at runtime
+
+	path = basePath;
+	path.Append("compositing");
+
+	status = file.SetTo(path.Path(), B_READ_ONLY);
+	if (status == B_OK) {
+		BMessage settings;
+		status = settings.Unflatten(&file);
+		if (status == B_OK) {
+			if (settings.FindBool("backing stores", &fUseBackingStores) != B_OK)
+				fUseBackingStores = false;
+
+			// in MB
+			int32 limit;
+			if (settings.FindInt32("memory limit", &limit) == B_OK
+				&& limit > 0) {
+				fBackingStoreMemoryLimit = limit;
+			}
+		}
+	}
+
 	return B_OK;
 }
 
@@ -614,6 +638,20 @@ DesktopSettingsPrivate::ShowAllDraggers() const
 }
 
 
+bool
+DesktopSettingsPrivate::UseBackingStores() const
+{
+	return fUseBackingStores;
+}
+
+
+int32
+DesktopSettingsPrivate::BackingStoreMemoryLimit() const
+{
+	return fBackingStoreMemoryLimit;
+}
+
+
 void
 DesktopSettingsPrivate::SetWorkspacesLayout(int32 columns, int32 rows)
 {
@@ -1003,6 +1041,7 @@ void
 LockedDesktopSettings::SetDefaultPlainFont(const ServerFont &font)
 {
 	fSettings->SetDefaultPlainFont(font);
+	fDesktop->FontMetrics().Reset();
 }
 
 
@@ -1074,6 +1113,7 @@ void
 LockedDesktopSettings::SetSubpixelAntialiasing(bool subpix)
 {
 	fSettings->SetSubpixelAntialiasing(subpix);
+	fDesktop->FontMetrics().Reset();
 }
 
 
@@ -1081,6 +1121,7 @@ void
 LockedDesktopSettings::SetHinting(uint8 hinting)
 {
 	fSettings->SetHinting(hinting);
+	fDesktop->FontMetrics().Reset();
 }
 
 
@@ -1088,6 +1129,7 @@ void
 LockedDesktopSettings::SetSubpixelAverageWeight(uint8 averageWeight)
 {
 	fSettings->SetSubpixelAverageWeight(averageWeight);
+	fDesktop->FontMetrics().Reset();
 }
 
 void
@@ -65,6 +65,9 @@ public:
 			void				SetShowAllDraggers(bool show);
 			bool				ShowAllDraggers() const;
 
+			bool				UseBackingStores() const;
+			int32				BackingStoreMemoryLimit() const;
+
 			void				SetWorkspacesLayout(int32 columns, int32 rows);
 			int32				WorkspacesCount() const;
 			int32				WorkspacesColumns() const;
@@ -116,6 +119,8 @@ private:
 			mode_focus_follows_mouse	fFocusFollowsMouseMode;
 			bool				fAcceptFirstClick;
 			bool				fShowAllDraggers;
+			bool				fUseBackingStores;
+			int32				fBackingStoreMemoryLimit;
 			int32				fWorkspacesColumns;
 			int32				fWorkspacesRows;
 			BMessage			fWorkspaceMessages[kMaxWorkspaces];
@@ -320,6 +320,10 @@ string_for_message_code(uint32 code)
 		CODE(AS_DIRECT_WINDOW_GET_SYNC_DATA);
 		CODE(AS_DIRECT_WINDOW_SET_FULLSCREEN);
 
+		// Recorded drawing commands
+		CODE(AS_CREATE_COMMAND_BUFFER);
+		CODE(AS_EXECUTE_COMMAND_BUFFER);
+
 		default:
 			return "unknown code";
 			break;
@@ -2174,6 +2174,10 @@ ServerApp::_DispatchMessage(int32 code, BPrivate::LinkReceiver& link)
 
 			for (int32 i = 0; i < numStrings; i++)
 				free(stringArray[i]);
+
+			// let the client measure this font on its own next time
+			if (status == B_OK && size > 0)
+				fDesktop->FontMetrics().Publish(familyID, styleID, size);
 			break;
 		}
 
@@ -2755,6 +2759,9 @@ ServerApp::_DispatchMessage(int32 code, BPrivate::LinkReceiver& link)
 				fLink.StartMessage(status);
 
 			fLink.Flush();
+
+			if (status == B_OK)
+				fDesktop->FontMetrics().Publish(familyID, styleID, size);
 			break;
 		}
 
@@ -98,6 +98,9 @@ public:
 
 			AppFontManager*		FontManager() { return fAppFontManager; }
 
+			ClientMemoryAllocator* MemoryAllocator()
+									{ return fMemoryAllocator.Get(); }
+
 private:
 	virtual	void				_GetLooperName(char* name, size_t size);
 	virtual	void				_DispatchMessage(int32 code,
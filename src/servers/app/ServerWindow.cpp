@@ -150,6 +150,37 @@ compare_message_profiles(const void* _a, const void* _b)
 #endif
 
 
+static const int32 kMaxCommandBufferSize = 1024 * 1024;
+
+
+/*!	Reads the messages a client recorded into its command buffer, in place.
+*/
+class CommandBufferReceiver : public BPrivate::LinkReceiver {
+public:
+	CommandBufferReceiver(uint8* buffer, uint32 size)
+		:
+		LinkReceiver(-1)
+	{
+		fRecvBuffer = (char*)buffer;
+		fRecvBufferSize = size;
+		fDataSize = size;
+	}
+
+	virtual ~CommandBufferReceiver()
+	{
+		// the buffer belongs to the ServerWindow
+		fRecvBuffer = NULL;
+	}
+
+protected:
+	virtual status_t ReadFromPort(bigtime_t timeout)
+	{
+		// all messages have been read
+		return B_ENTRY_NOT_FOUND;
+	}
+};
+
+
 //	#pragma mark -
 
 
@@ -177,7 +208,10 @@ ServerWindow::ServerWindow(const char* title, ServerApp* app,
 	fCurrentDrawingRegion(),
 	fCurrentDrawingRegionValid(false),
 
-	fIsDirectlyAccessing(false)
+	fIsDirectlyAccessing(false),
+
+	fCommandBufferSize(0),
+	fCommandBufferSemaphore(-1)
 {
 	STRACE(("ServerWindow(%s)::ServerWindow()\n", title));
 
@@ -1167,6 +1201,59 @@ ServerWindow::_DispatchMessage(int32 code, BPrivate::LinkReceiver& link)
 			break;
 		}
 
+		case AS_CREATE_COMMAND_BUFFER:
+		{
+			// Attached data:
+			// 1) int32 size
+			// 2) sem_id the semaphore released when the buffer may be reused
+			int32 size;
+			sem_id semaphore;
+			link.Read<int32>(&size);
+			if (link.Read<sem_id>(&semaphore) != B_OK)
+				break;
+
+			DTRACE(("ServerWindow %s: Message AS_CREATE_COMMAND_BUFFER: "
+				"%" B_PRId32 " bytes\n", Title(), size));
+
+			status_t status = B_BAD_VALUE;
+			if (size > 0 && size <= kMaxCommandBufferSize) {
+				ObjectDeleter<ClientMemory> memory(
+					new(std::nothrow) ClientMemory());
+				status = B_NO_MEMORY;
+				if (memory.IsSet() && memory->Allocate(
+						fServerApp->MemoryAllocator(), size) != NULL) {
+					fCommandBuffer.SetTo(memory.Detach());
+					fCommandBufferSize = size;
+					fCommandBufferSemaphore = semaphore;
+					status = B_OK;
+				}
+			}
+
+			fLink.StartMessage(status);
+			if (status == B_OK) {
+				fLink.Attach<area_id>(fCommandBuffer->Area());
+				fLink.Attach<int32>(fCommandBuffer->AreaOffset());
+			}
+			fLink.Flush();
+			break;
+		}
+		case AS_EXECUTE_COMMAND_BUFFER:
+		{
+			uint32 start;
+			uint32 end;
+			uint32 rewind;
+			link.Read<uint32>(&start);
+			link.Read<uint32>(&end);
+			if (link.Read<uint32>(&rewind) != B_OK)
+				break;
+
+			_ExecuteCommandBuffer(start, end);
+
+			if (rewind != 0 && fCommandBufferSemaphore >= 0)
+				release_sem(fCommandBufferSemaphore);
+			break;
+		}
+
 		case AS_TALK_TO_DESKTOP_LISTENER:
 		{
 			if (fDesktop->MessageForListener(fWindow.Get(), fLink.Receiver(),
@@ -1237,6 +1324,10 @@ ServerWindow::_DispatchViewMessage(int32 code,
 				fCurrentView->Name(), src.left, src.top, src.right, src.bottom,
 				dst.left, dst.top, dst.right, dst.bottom));
 
+			// only the visible part of the destination is copied, what is
+			// saved of the rest of the view is outdated as well
+			fWindow->InvalidateBackingStore(fCurrentView);
+
 			BRegion contentRegion;
 			// TODO: avoid copy operation maybe?
 			fWindow->GetContentRegion(&contentRegion);
@@ -2478,6 +2569,12 @@ void
 ServerWindow::_DispatchViewDrawingMessage(int32 code,
 	BPrivate::LinkReceiver &link)
 {
+	// whatever is saved of the view's hidden parts is outdated now, even
+	// if nothing of it is drawn on screen; during an update, drawing is
+	// restricted to the update region, which is never saved
+	if (!fWindow->InUpdate())
+		fWindow->InvalidateBackingStore(fCurrentView);
+
 	if (!fCurrentView->IsVisible() || !fWindow->IsVisible()) {
 		if (link.NeedsReply()) {
 			debug_printf("ServerWindow::DispatchViewDrawingMessage() got "
@@ -4123,6 +4220,72 @@ ServerWindow::_DispatchPictureMessage(int32 code, BPrivate::LinkReceiver& link)
 }
 
 
+/*!	Executes the messages the client recorded between \a start and \a end
+	of its command buffer, as if they had been sent through the port.
+	The desktop clipping must be read locked when entering this method;
+	that lock, and the window's, are released in between, though, so that
+	a full buffer cannot hold them any longer than the message loop would.
+*/
+void
+ServerWindow::_ExecuteCommandBuffer(uint32 start, uint32 end)
+{
+	if (!fCommandBuffer.IsSet() || start > end || end > fCommandBufferSize)
+		return;
+
+	CommandBufferReceiver receiver(fCommandBuffer->Address() + start,
+		end - start);
+
+	int32 messagesProcessed = 0;
+	bigtime_t processingStart = system_time();
+
+	int32 code;
+	while (receiver.GetNextMessage(code) == B_OK) {
+		// Like the message loop, only process up to 70 messages at once,
+		// and don't hold the locks longer than 10 ms
+		if (++messagesProcessed > 70
+			|| system_time() - processingStart > 10000) {
+			fDesktop->UnlockSingleWindow();
+			Unlock();
+			Lock();
+			fDesktop->LockSingleWindow();
+
+			messagesProcessed = 1;
+			processingStart = system_time();
+		}
+
+		if (atomic_and(&fRedrawRequested, 0) != 0)
+			fWindow->RedrawDirtyRegion();
+
+		switch (code) {
+			case AS_DELETE_WINDOW:
+			case kMsgQuitLooper:
+			case AS_CREATE_COMMAND_BUFFER:
+			case AS_EXECUTE_COMMAND_BUFFER:
+			case AS_TALK_TO_DESKTOP_LISTENER:
+				// these need to go through the port
+				debug_printf("ServerWindow %s: message '%s' cannot be "
+					"recorded\n", Title(), string_for_message_code(code));
+				if (receiver.NeedsReply()) {
+					fLink.StartMessage(B_NOT_ALLOWED);
+					fLink.Flush();
+				}
+				continue;
+		}
+
+		if (!_MessageNeedsAllWindowsLocked(code)) {
+			_DispatchMessage(code, receiver);
+			continue;
+		}
+
+		fDesktop->UnlockSingleWindow();
+		fDesktop->LockAllWindows();
+		_DispatchMessage(code, receiver);
+		fDesktop->UnlockAllWindows();
+		fDesktop->LockSingleWindow();
+	}
+}
+
+
 /*!	\brief Message-dispatching loop for the ServerWindow
 
 	Watches the ServerWindow's message port and dispatches as necessary
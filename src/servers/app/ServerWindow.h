@@ -42,6 +42,7 @@ class Window;
 class Workspace;
 class View;
 class ServerPicture;
+class ClientMemory;
 class DirectWindowInfo;
 struct window_info;
 
@@ -133,6 +134,8 @@ private:
 									BPrivate::LinkReceiver &link);
 			bool				_DispatchPictureMessage(int32 code,
 									BPrivate::LinkReceiver &link);
+			void				_ExecuteCommandBuffer(uint32 start,
+									uint32 end);
 			void				_MessageLooper();
 	virtual void				_PrepareQuit();
 	virtual void				_GetLooperName(char* name, size_t size);
@@ -178,6 +181,11 @@ private:
 			ObjectDeleter<DirectWindowInfo>
 								fDirectWindowInfo;
 			bool				fIsDirectlyAccessing;
+
+			ObjectDeleter<ClientMemory>
+								fCommandBuffer;
+			uint32				fCommandBufferSize;
+			sem_id				fCommandBufferSemaphore;
 };
 
 #endif	// SERVER_WINDOW_H
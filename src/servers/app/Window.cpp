@@ -91,6 +91,10 @@ Window::Window(const BRect& frame, const char *name,
 
 	fRegionPool(),
 
+	fBackingStore(this),
+	fMovedSinceClipping(0, 0),
+	fResizedSinceClipping(false),
+
 	fWindow(window),
 	fDrawingEngine(drawingEngine),
 	fDesktop(window->Desktop()),
@@ -169,6 +173,10 @@ Window::Window(const BRect& frame, const char *name,
 
 Window::~Window()
 {
+	// before the backing store manager could look at us while we're
+	// already partially destructed
+	fBackingStore.Free();
+
 	if (fTopView.IsSet()) {
 		fTopView->DetachedFromWindow();
 	}
@@ -202,6 +210,70 @@ Window::SetClipping(BRegion* stillAvailableOnScreen)
 
 	fVisibleContentRegionValid = false;
 	fEffectiveDrawingRegionValid = false;
+
+	fMovedSinceClipping.Set(0, 0);
+	fResizedSinceClipping = false;
+}
+
+
+/*!	Updates the visible region after the area available on screen only
+	changed within \a changedArea. \a stillAvailable is what is available of
+	that area to this window, the part the window covers is removed from it,
+	and set to \a covered.
+	Returns \c false if the window does not overlap \a changedArea, and its
+	visible region is still valid.
+*/
+bool
+Window::UpdateClipping(const BRegion& changedArea, BRegion& stillAvailable,
+	BRegion& covered)
+{
+	// this function is only called from the Desktop thread
+
+	BRect frame = fFrame;
+	::Decorator* decorator = Decorator();
+	if (decorator != NULL) {
+		BRect footprint = decorator->GetFootprint().Frame();
+		if (footprint.IsValid())
+			frame = frame | footprint;
+	}
+	if (!changedArea.Intersects(frame)) {
+		fMovedSinceClipping.Set(0, 0);
+		fResizedSinceClipping = false;
+		return false;
+	}
+
+	BRegion* hidden = NULL;
+	if (!fResizedSinceClipping && _UsesBackingStore()) {
+		// the contents visible so far, at the window's current position
+		hidden = fRegionPool.GetRegion();
+		if (hidden != NULL) {
+			GetContentRegion(hidden);
+			hidden->OffsetBy(-fMovedSinceClipping.x, -fMovedSinceClipping.y);
+			hidden->IntersectWith(&fVisibleRegion);
+			hidden->OffsetBy(fMovedSinceClipping.x, fMovedSinceClipping.y);
+		}
+	}
+
+	GetFullRegion(&covered);
+	covered.IntersectWith(&stillAvailable);
+
+	fVisibleRegion.Exclude(&changedArea);
+	fVisibleRegion.Include(&covered);
+	stillAvailable.Exclude(&covered);
+
+	fVisibleContentRegionValid = false;
+	fEffectiveDrawingRegionValid = false;
+
+	if (hidden != NULL) {
+		hidden->Exclude(&fVisibleRegion);
+		if (hidden->CountRects() > 0)
+			_SaveHiddenContents(*hidden);
+		fRegionPool.Recycle(hidden);
+	}
+
+	fMovedSinceClipping.Set(0, 0);
+	fResizedSinceClipping = false;
+	return true;
 }
 
 
@@ -291,6 +363,9 @@ Window::MoveBy(int32 x, int32 y, bool moveStack)
 	fDirtyRegion.OffsetBy(x, y);
 	fExposeRegion.OffsetBy(x, y);
 
+	fBackingStore.MoveBy(x, y);
+	fMovedSinceClipping += IntPoint(x, y);
+
 	if (fContentRegionValid)
 		fContentRegion.OffsetBy(x, y);
 
@@ -368,6 +443,10 @@ Window::ResizeBy(int32 x, int32 y, BRegion* dirtyRegion, bool resizeStack)
 	fContentRegionValid = false;
 	fEffectiveDrawingRegionValid = false;
 
+	// the views might have moved around
+	fBackingStore.Free();
+	fResizedSinceClipping = true;
+
 	if (fTopView.IsSet()) {
 		fTopView->ResizeBy(x, y, dirtyRegion);
 		fTopView->UpdateOverlay();
@@ -429,6 +508,7 @@ Window::SetOutlinesDelta(BPoint delta, BRegion* dirtyRegion)
 		decorator->SetOutlinesDelta(delta, dirtyRegion);
 
 	_UpdateContentRegion();
+	fResizedSinceClipping = true;
 }
 
 
@@ -441,6 +521,8 @@ Window::ScrollViewBy(View* view, int32 dx, int32 dy)
 	if (!view || view == fTopView.Get() || (dx == 0 && dy == 0))
 		return;
 
+	InvalidateBackingStore(view);
+
 	BRegion* dirty = fRegionPool.GetRegion();
 	if (!dirty)
 		return;
@@ -464,6 +546,13 @@ void
 Window::CopyContents(BRegion* region, int32 xOffset, int32 yOffset)
 {
 	// executed in ServerWindow thread with the read lock held
+	if (!fBackingStore.IsEmpty()) {
+		// the hidden parts of the destination are not copied
+		region->OffsetBy(xOffset, yOffset);
+		fBackingStore.Invalidate(*region);
+		region->OffsetBy(-xOffset, -yOffset);
+	}
+
 	if (!IsVisible())
 		return;
 
@@ -784,6 +873,7 @@ Window::RedrawDirtyRegion()
 		dirtyContentRegion->IntersectWith(&fDirtyRegion);
 		exposeContentRegion->IntersectWith(&fExposeRegion);
 
+		_RestoreHiddenContents(*dirtyContentRegion, *exposeContentRegion);
 		_TriggerContentRedraw(*dirtyContentRegion, *exposeContentRegion);
 
 		fRegionPool.Recycle(dirtyContentRegion);
@@ -821,6 +911,8 @@ Window::MarkContentDirty(BRegion& dirtyRegion, BRegion& exposeRegion)
 	// since this won't affect other windows, read locking
 	// is sufficient. If there was no dirty region before,
 	// an update message is triggered
+	fBackingStore.Invalidate(dirtyRegion);
+
 	if (fHidden || IsOffscreenWindow())
 		return;
 
@@ -834,6 +926,8 @@ void
 Window::MarkContentDirtyAsync(BRegion& dirtyRegion)
 {
 	// NOTE: see comments in ProcessDirtyRegion()
+	fBackingStore.Invalidate(dirtyRegion);
+
 	if (fHidden || IsOffscreenWindow())
 		return;
 
@@ -850,6 +944,8 @@ Window::MarkContentDirtyAsync(BRegion& dirtyRegion)
 void
 Window::InvalidateView(View* view, BRegion& viewRegion)
 {
+	InvalidateBackingStore(view);
+
 	if (view && IsVisible() && view->IsVisible()) {
 		if (!fContentRegionValid)
 			_UpdateContentRegion();
@@ -867,6 +963,29 @@ Window::InvalidateView(View* view, BRegion& viewRegion)
 	}
 }
 
+/*!	Removes everything \a view could draw into from the backing store,
+	since the view is drawn without regard to what is saved of it.
+*/
+void
+Window::InvalidateBackingStore(View* view)
+{
+	if (fBackingStore.IsEmpty() || view == NULL)
+		return;
+
+	IntRect bounds = view->Bounds();
+	view->ConvertToVisibleInTopView(&bounds);
+	if (bounds.IsValid())
+		fBackingStore.Invalidate((clipping_rect)bounds);
+}
+
+
+void
+Window::FreeBackingStore()
+{
+	fBackingStore.Free();
+}
+
+
 // DisableUpdateRequests
 void
 Window::DisableUpdateRequests()
@@ -1790,6 +1909,77 @@ Window::_TriggerContentRedraw(BRegion& dirty, const BRegion& expose)
 }
 
 
+bool
+Window::_UsesBackingStore()
+{
+	// the contents of these are not only drawn by us
+	return !IsOffscreenWindow() && (fFlags & kWindowScreenFlag) == 0
+		&& fDesktop->BackingStores() != NULL
+		&& !fWindow->IsDirectlyAccessing()
+		&& TopLayerStackWindow() == this;
+}
+
+
+/*!	Saves the contents of the window that are \a hidden now, but still on
+	screen, to be restored once they are exposed again. This is done from
+	the Desktop thread while the clipping is updated.
+*/
+void
+Window::_SaveHiddenContents(BRegion& hidden)
+{
+	// what is going to be redrawn anyway doesn't need to be saved
+	hidden.Exclude(&fDirtyRegion);
+	hidden.Exclude(&fExposeRegion);
+	if (fCurrentUpdateSession->IsUsed())
+		hidden.Exclude(&fCurrentUpdateSession->DirtyRegion());
+	if (fPendingUpdateSession->IsUsed())
+		hidden.Exclude(&fPendingUpdateSession->DirtyRegion());
+
+	if (hidden.CountRects() == 0 || !fDrawingEngine->LockParallelAccess())
+		return;
+
+	fBackingStore.Save(fDesktop->BackingStores(), fDrawingEngine.Get(),
+		fFrame, hidden, fMovedSinceClipping.x, fMovedSinceClipping.y);
+
+	fDrawingEngine->UnlockParallelAccess();
+}
+
+
+/*!	Copies what is saved of the \a dirty contents back to the screen, and
+	removes that from \a dirty and \a expose, so that the client does not
+	need to redraw it.
+*/
+void
+Window::_RestoreHiddenContents(BRegion& dirty, BRegion& expose)
+{
+	if (fBackingStore.IsEmpty())
+		return;
+
+	if (!_UsesBackingStore()) {
+		// the client might be drawing into the frame buffer directly now
+		fBackingStore.Free();
+		return;
+	}
+
+	BRegion* restored = fRegionPool.GetRegion(dirty);
+	if (restored == NULL)
+		return;
+
+	if (fDrawingEngine->LockParallelAccess()) {
+		fBackingStore.Restore(fDrawingEngine.Get(), *restored);
+		fDrawingEngine->UnlockParallelAccess();
+
+		dirty.Exclude(restored);
+		expose.Exclude(restored);
+	}
+
+	fRegionPool.Recycle(restored);
+
+	// only what is still hidden is kept
+	fBackingStore.Invalidate(VisibleContentRegion());
+}
+
+
 void
 Window::_DrawBorder()
 {
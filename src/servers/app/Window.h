@@ -16,6 +16,8 @@
 #define WINDOW_H
 
 
+#include "BackingStore.h"
+#include "IntPoint.h"
 #include "RegionPool.h"
 #include "ServerWindow.h"
 #include "View.h"
@@ -114,6 +116,8 @@ public:
 			// setting and getting the "hard" clipping, you need to have
 			// WriteLock()ed the clipping!
 			void				SetClipping(BRegion* stillAvailableOnScreen);
+			bool				UpdateClipping(const BRegion& changedArea,
+									BRegion& stillAvailable, BRegion& covered);
 			// you need to have ReadLock()ed the clipping!
 	inline	BRegion&			VisibleRegion() { return fVisibleRegion; }
 			BRegion&			VisibleContentRegion();
@@ -160,6 +164,10 @@ public:
 			// shortcut for invalidating just one view
 			void				InvalidateView(View* view, BRegion& viewRegion);
 
+			// the saved contents of the window that are hidden
+			void				InvalidateBackingStore(View* view);
+			void				FreeBackingStore();
+
 			void				DisableUpdateRequests();
 			void				EnableUpdateRequests();
 
@@ -337,6 +345,11 @@ protected:
 
 			void				_UpdateContentRegion();
 
+			bool				_UsesBackingStore();
+			void				_SaveHiddenContents(BRegion& hidden);
+			void				_RestoreHiddenContents(BRegion& dirty,
+									BRegion& expose);
+
 			void				_ObeySizeLimits();
 			void				_PropagatePosition();
 
@@ -377,6 +390,13 @@ protected:
 
 			::RegionPool		fRegionPool;
 
+			// The contents on screen are only moved along with the window
+			// after its clipping has been updated; until then, they can
+			// still be saved from the previous position.
+			BackingStore		fBackingStore;
+			IntPoint			fMovedSinceClipping;
+			bool				fResizedSinceClipping;
+
 			BObjectList<Window> fSubsets;
 
 			ObjectDeleter<WindowBehaviour>
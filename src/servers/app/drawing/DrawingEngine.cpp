@@ -24,6 +24,7 @@
 #include "ServerBitmap.h"
 #include "ServerCursor.h"
 #include "RenderingBuffer.h"
+#include "TileWorkerPool.h"
 
 #include "drawing_support.h"
 
@@ -64,6 +65,11 @@ extend_by_stroke_width(BRect& rect, float penSize)
 }
 
 
+// Below this many pixels, waking up the tile workers costs more than they
+// save.
+static const int64 kMinTiledArea = 256 * 1024;
+
+
 class AutoFloatingOverlaysHider {
 	public:
 		AutoFloatingOverlaysHider(HWInterface* interface, const BRect& area)
@@ -166,6 +172,29 @@ public:
 		return fOverlaysHidden;
 	}
 
+	// Draws the job spread over the tile workers when the dirty area is
+	// large enough to be worth it. Returns false if the caller still needs
+	// to draw the job itself.
+	bool DrawTiled(TileWorkerPool::Job &job)
+	{
+		Painter *painter = fEngine->fPainter.Get();
+		if (painter->HasAlphaMask())
+			return false;
+
+		clipping_rect frame = fDirty.FrameInt();
+		int64 area = (int64)(frame.right - frame.left + 1)
+			* (frame.bottom - frame.top + 1);
+		if (area < kMinTiledArea)
+			return false;
+
+		TileWorkerPool *pool = TileWorkerPool::Default();
+		if (pool == NULL)
+			return false;
+
+		return pool->Run(painter, fEngine->fGraphicsCard->DrawingBuffer(),
+			frame, job) == B_OK;
+	}
+
 private:
 	DrawingEngine *fEngine;
 	bool fOverlaysHidden;
@@ -173,6 +202,88 @@ private:
 };
 
 
+class FillRectJob : public TileWorkerPool::Job {
+public:
+	FillRectJob(const BRect &rect, const rgb_color *color = NULL)
+		:
+		fRect(rect),
+		fColor(color)
+	{
+	}
+
+	virtual void DrawTile(Painter *painter, const clipping_rect &tile)
+	{
+		if (fColor != NULL)
+			painter->FillRect(fRect, *fColor);
+		else
+			painter->FillRect(fRect);
+	}
+
+private:
+	BRect fRect;
+	const rgb_color *fColor;
+};
+
+
+class FillRegionJob : public TileWorkerPool::Job {
+public:
+	FillRegionJob(const BRegion &region, const rgb_color *color = NULL)
+		:
+		fRegion(region),
+		fColor(color)
+	{
+	}
+
+	virtual void DrawTile(Painter *painter, const clipping_rect &tile)
+	{
+		int32 count = fRegion.CountRects();
+		for (int32 i = 0; i < count; i++) {
+			if (fColor == NULL) {
+				painter->FillRect(fRegion.RectAt(i));
+				continue;
+			}
+
+			// the region is already clipped, only the tile needs to be
+			// taken into account
+			clipping_rect rect = fRegion.RectAtInt(i);
+			rect.top = std::max(rect.top, tile.top);
+			rect.bottom = std::min(rect.bottom, tile.bottom);
+			if (rect.top <= rect.bottom)
+				painter->FillRectNoClipping(rect, *fColor);
+		}
+	}
+
+private:
+	const BRegion &fRegion;
+	const rgb_color *fColor;
+};
+
+
+class DrawBitmapJob : public TileWorkerPool::Job {
+public:
+	DrawBitmapJob(ServerBitmap *bitmap, const BRect &bitmapRect,
+			const BRect &viewRect, uint32 options)
+		:
+		fBitmap(bitmap),
+		fBitmapRect(bitmapRect),
+		fViewRect(viewRect),
+		fOptions(options)
+	{
+	}
+
+	virtual void DrawTile(Painter *painter, const clipping_rect &tile)
+	{
+		painter->DrawBitmap(fBitmap, fBitmapRect, fViewRect, fOptions);
+	}
+
+private:
+	ServerBitmap *fBitmap;
+	BRect fBitmapRect;
+	BRect fViewRect;
+	uint32 fOptions;
+};
+
+
 //	#pragma mark -
 
 
@@ -636,8 +747,18 @@ DrawingEngine::DrawBitmap(ServerBitmap* bitmap, const BRect& bitmapRect,
 	ASSERT_PARALLEL_LOCKED();
 
 	DrawTransaction transaction(this, fPainter->TransformAndClipRect(viewRect));
-	if (transaction.IsDirty())
-		fPainter->DrawBitmap(bitmap, bitmapRect, viewRect, options);
+	if (!transaction.IsDirty())
+		return;
+
+	// other color spaces are converted by the painter, which should not
+	// happen once per tile
+	if (bitmap->ColorSpace() == B_RGBA32 || bitmap->ColorSpace() == B_RGB32) {
+		DrawBitmapJob job(bitmap, bitmapRect, viewRect, options);
+		if (transaction.DrawTiled(job))
+			return;
+	}
+
+	fPainter->DrawBitmap(bitmap, bitmapRect, viewRect, options);
 }
 
 
@@ -857,7 +978,9 @@ DrawingEngine::FillRect(BRect r, const rgb_color& color)
 	if (!transaction.IsDirty())
 		return;
 
-	fPainter->FillRect(r, color);
+	FillRectJob job(r, &color);
+	if (!transaction.DrawTiled(job))
+		fPainter->FillRect(r, color);
 }
 
 
@@ -885,6 +1008,10 @@ DrawingEngine::FillRegion(BRegion& r, const rgb_color& color)
 
 	DrawTransaction transaction(this, r);
 
+	FillRegionJob job(r, &color);
+	if (transaction.DrawTiled(job))
+		return;
+
 	int32 count = r.CountRects();
 	for (int32 i = 0; i < count; i++)
 		fPainter->FillRectNoClipping(r.RectAtInt(i), color);
@@ -924,7 +1051,9 @@ DrawingEngine::FillRect(BRect r)
 	if (!transaction.IsDirty())
 		return;
 
-	fPainter->FillRect(r);
+	FillRectJob job(r);
+	if (!transaction.DrawTiled(job))
+		fPainter->FillRect(r);
 }
 
 
@@ -954,6 +1083,10 @@ DrawingEngine::FillRegion(BRegion& r)
 	if (!transaction.IsDirty())
 		return;
 
+	FillRegionJob job(r);
+	if (transaction.DrawTiled(job))
+		return;
+
 	int32 count = r.CountRects();
 	for (int32 i = 0; i < count; i++)
 		fPainter->FillRect(r.RectAt(i));
@@ -1379,6 +1512,33 @@ DrawingEngine::ReadBitmap(ServerBitmap* bitmap, bool drawCursor, BRect bounds)
 }
 
 
+/*!	Copies the parts of the drawing buffer within \a region into \a bitmap,
+	the top left pixel of which corresponds to \a left, \a top on screen.
+	Only 32 bit buffers and bitmaps are supported.
+*/
+status_t
+DrawingEngine::CopyRegionToBitmap(const BRegion& region, ServerBitmap* bitmap,
+	int32 left, int32 top)
+{
+	ASSERT_PARALLEL_LOCKED();
+
+	return _CopyRegionBits(region, bitmap, left, top, true);
+}
+
+
+/*!	Copies the parts of \a bitmap within \a region back into the drawing
+	buffer, see CopyRegionToBitmap().
+*/
+status_t
+DrawingEngine::CopyRegionFromBitmap(const BRegion& region,
+	ServerBitmap* bitmap, int32 left, int32 top)
+{
+	ASSERT_PARALLEL_LOCKED();
+
+	return _CopyRegionBits(region, bitmap, left, top, false);
+}
+
+
 // #pragma mark -
 
 
@@ -1430,6 +1590,70 @@ DrawingEngine::SetRendererOffset(int32 offsetX, int32 offsetY)
 }
 
 
+status_t
+DrawingEngine::_CopyRegionBits(const BRegion& region, ServerBitmap* bitmap,
+	int32 left, int32 top, bool toBitmap)
+{
+	RenderingBuffer* buffer = fGraphicsCard->DrawingBuffer();
+	if (buffer == NULL)
+		return B_ERROR;
+
+	color_space space = buffer->ColorSpace();
+	if ((space != B_RGB32 && space != B_RGBA32)
+		|| (bitmap->ColorSpace() != B_RGB32
+			&& bitmap->ColorSpace() != B_RGBA32)) {
+		return B_UNSUPPORTED;
+	}
+
+	clipping_rect clip;
+	clip.left = std::max((int32)0, left);
+	clip.top = std::max((int32)0, top);
+	clip.right = std::min((int32)buffer->Width(), left + bitmap->Width()) - 1;
+	clip.bottom = std::min((int32)buffer->Height(), top + bitmap->Height())
+		- 1;
+
+	AutoFloatingOverlaysHider _(fGraphicsCard, region.Frame());
+
+	uint8* screenBits = (uint8*)buffer->Bits();
+	uint32 screenBytesPerRow = buffer->BytesPerRow();
+	uint8* bitmapBits = bitmap->Bits();
+	uint32 bitmapBytesPerRow = bitmap->BytesPerRow();
+
+	for (int32 i = 0; i < region.CountRects(); i++) {
+		clipping_rect rect = region.RectAtInt(i);
+		rect.left = std::max(rect.left, clip.left);
+		rect.top = std::max(rect.top, clip.top);
+		rect.right = std::min(rect.right, clip.right);
+		rect.bottom = std::min(rect.bottom, clip.bottom);
+		if (rect.left > rect.right || rect.top > rect.bottom)
+			continue;
+
+		size_t bytes = (rect.right - rect.left + 1) * 4;
+		uint8* screen = screenBits + (size_t)rect.top * screenBytesPerRow
+			+ rect.left * 4;
+		uint8* bits = bitmapBits + (size_t)(rect.top - top) * bitmapBytesPerRow
+			+ (rect.left - left) * 4;
+
+		// whole rows of a rect are contiguous, memcpy() uses the widest
+		// vector instructions the CPU supports for them
+		for (int32 y = rect.top; y <= rect.bottom; y++) {
+			if (toBitmap)
+				memcpy(bits, screen, bytes);
+			else
+				memcpy(screen, bits, bytes);
+			screen += screenBytesPerRow;
+			bits += bitmapBytesPerRow;
+		}
+
+		if (!toBitmap)
+			fGraphicsCard->Invalidate(BRect(rect.left, rect.top, rect.right,
+				rect.bottom));
+	}
+
+	return B_OK;
+}
+
+
 void
 DrawingEngine::_CopyRect(uint8* src, uint32 width, uint32 height,
 	uint32 bytesPerRow, int32 xOffset, int32 yOffset) const
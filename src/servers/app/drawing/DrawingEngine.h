@@ -66,6 +66,12 @@ public:
 	virtual	status_t		ReadBitmap(ServerBitmap *bitmap, bool drawCursor,
 								BRect bounds);
 
+	// for the backing stores of windows
+	virtual	status_t		CopyRegionToBitmap(const BRegion& region,
+								ServerBitmap* bitmap, int32 left, int32 top);
+	virtual	status_t		CopyRegionFromBitmap(const BRegion& region,
+								ServerBitmap* bitmap, int32 left, int32 top);
+
 	// clipping for all drawing functions, passing a NULL region
 	// will remove any clipping (drawing allowed everywhere)
 	virtual	void			ConstrainClippingRegion(const BRegion* region);
@@ -203,6 +209,9 @@ private:
 			void			_CopyRect(uint8* bits,
 								uint32 width, uint32 height, uint32 bytesPerRow,
 								int32 xOffset, int32 yOffset) const;
+			status_t		_CopyRegionBits(const BRegion& region,
+								ServerBitmap* bitmap, int32 left, int32 top,
+								bool toBitmap);
 
 			ObjectDeleter<Painter>
 							fPainter;
@@ -25,9 +25,11 @@
 #include "GlobalSubpixelSettings.h"
 #include "GlyphLayoutEngine.h"
 #include "IntRect.h"
+#include "TextRunCache.h"
 
 
-AGGTextRenderer::AGGTextRenderer(renderer_subpix_type& subpixRenderer,
+AGGTextRenderer::AGGTextRenderer(renderer_base& baseRenderer,
+		renderer_subpix_type& subpixRenderer,
 		renderer_type& solidRenderer, renderer_bin_type& binRenderer,
 		scanline_unpacked_type& scanline,
 		scanline_unpacked_subpix_type& subpixScanline,
@@ -44,6 +46,7 @@ AGGTextRenderer::AGGTextRenderer(renderer_subpix_type& subpixRenderer,
 	fCurves(fPathAdaptor),
 	fContour(fCurves),
 
+	fBaseRenderer(baseRenderer),
 	fSolidRenderer(solidRenderer),
 	fBinRenderer(binRenderer),
 	fSubpixRenderer(subpixRenderer),
@@ -53,6 +56,7 @@ AGGTextRenderer::AGGTextRenderer(renderer_subpix_type& subpixRenderer,
 	fMaskedScanline(maskedScanline),
 
 	fRasterizer(),
+	fRunGlyphs(),
 
 	fHinted(true),
 	fAntialias(true),
@@ -368,6 +372,143 @@ private:
 };
 
 
+/*!	Lays out a text run from the glyphs in the GlyphAtlas of the font, and
+	composes their coverage into a TextRun. This only works as long as all
+	visible glyphs are in the atlas.
+*/
+class AGGTextRenderer::RunBuilder {
+public:
+	RunBuilder(const TextRunKey& key, GlyphAtlas* atlas, size_t maxRunSize,
+			AGGTextRenderer& renderer)
+		:
+		fKey(key),
+		fDataType(atlas->IsSubpixel() ? glyph_data_subpix : glyph_data_gray8),
+		fBytesPerPixel(atlas->BytesPerPixel()),
+		fMaxRunSize(maxRunSize),
+		fFailed(false),
+		fBounds(INT32_MAX, INT32_MAX, INT32_MIN, INT32_MIN),
+		fRun(NULL),
+		fGlyphs(renderer.fRunGlyphs)
+	{
+	}
+
+	bool NeedsVector()
+	{
+		return false;
+	}
+
+	void Start()
+	{
+		fGlyphs.remove_all();
+	}
+
+	void Finish(double x, double y)
+	{
+		// The glyphs of fallback fonts are only valid as long as the layout
+		// is in progress, so the run has to be composed right now.
+		if (!fFailed)
+			_Compose(BPoint(x, y));
+	}
+
+	void ConsumeEmptyGlyph(int32 index, uint32 charCode, double x, double y)
+	{
+	}
+
+	bool ConsumeGlyph(int32 index, uint32 charCode, const GlyphCache* glyph,
+		FontCacheEntry* entry, double x, double y, double advanceX,
+			double advanceY)
+	{
+		const agg::rect_i& r = glyph->bounds;
+		if (!r.is_valid())
+			return true;
+
+		if (glyph->data_type != fDataType || glyph->atlas_bits == NULL) {
+			fFailed = true;
+			return false;
+		}
+
+		// the same bounds and position as the StringRenderer uses
+		fBounds = fBounds | IntRect(int32(r.x1 + x), int32(r.y1 + y - 1),
+			int32(r.x2 + x + 1), int32(r.y2 + y + 1));
+
+		RunGlyph runGlyph;
+		runGlyph.glyph = glyph;
+		runGlyph.x = agg::iround(x + fKey.offset_x) + glyph->atlas_left;
+		runGlyph.y = agg::iround(y + fKey.offset_y) + glyph->atlas_top;
+		fGlyphs.add(runGlyph);
+		return true;
+	}
+
+	TextRun* Run() const
+	{
+		return fRun;
+	}
+
+private:
+	void _Compose(const BPoint& end)
+	{
+		int32 left = 0;
+		int32 top = 0;
+		int32 right = -1;
+		int32 bottom = -1;
+		if (fGlyphs.size() > 0) {
+			left = top = INT32_MAX;
+			right = bottom = INT32_MIN;
+		}
+		for (unsigned i = 0; i < fGlyphs.size(); i++) {
+			const RunGlyph& runGlyph = fGlyphs[i];
+			left = min_c(left, runGlyph.x);
+			top = min_c(top, runGlyph.y);
+			right = max_c(right, runGlyph.x + runGlyph.glyph->atlas_width - 1);
+			bottom = max_c(bottom,
+				runGlyph.y + runGlyph.glyph->atlas_height - 1);
+		}
+
+		int32 width = right - left + 1;
+		int32 height = bottom - top + 1;
+		if ((size_t)width * fBytesPerPixel * height > fMaxRunSize)
+			return;
+
+		fRun = TextRun::Create(fKey, fBytesPerPixel, left, top, width,
+			height);
+		if (fRun == NULL)
+			return;
+
+		// Glyphs may overlap, their coverage is added up.
+		for (unsigned i = 0; i < fGlyphs.size(); i++) {
+			const RunGlyph& runGlyph = fGlyphs[i];
+			const GlyphCache* glyph = runGlyph.glyph;
+			int32 rowBytes = glyph->atlas_width * fBytesPerPixel;
+			uint8* target = fRun->Bits() + (runGlyph.y - top)
+				* fRun->BytesPerRow() + (runGlyph.x - left) * fBytesPerPixel;
+			const uint8* source = glyph->atlas_bits;
+
+			for (int32 y = 0; y < glyph->atlas_height; y++) {
+				for (int32 x = 0; x < rowBytes; x++) {
+					uint32 cover = target[x] + source[x];
+					target[x] = cover > 255 ? 255 : cover;
+				}
+				target += fRun->BytesPerRow();
+				source += glyph->atlas_bytes_per_row;
+			}
+		}
+
+		fRun->SetLayout(fBounds, end);
+	}
+
+private:
+	const TextRunKey&	fKey;
+	glyph_data_type		fDataType;
+	uint32				fBytesPerPixel;
+	size_t				fMaxRunSize;
+	bool				fFailed;
+	IntRect				fBounds;
+	TextRun*			fRun;
+
+	agg::pod_bvector<RunGlyph>& fGlyphs;
+};
+
+
 BRect
 AGGTextRenderer::RenderString(const char* string, uint32 length,
 	const BPoint& baseLine, const BRect& clippingFrame, bool dryRun,
@@ -395,6 +536,12 @@ AGGTextRenderer::RenderString(const char* string, uint32 length,
 	transform.Transform(&transformOffset);
 	IntRect clippingIntFrame(clippingFrame);
 
+	BRect bounds;
+	if (!dryRun && _RenderCachedRun(string, length, transform, transformOffset,
+			clippingIntFrame, nextCharPos, delta, cacheReference, bounds)) {
+		return bounds;
+	}
+
 	StringRenderer renderer(clippingIntFrame, dryRun, transformedOutline, transformedContourOutline,
 		transform, transformOffset, nextCharPos, *this);
 
@@ -438,3 +585,135 @@ AGGTextRenderer::RenderString(const char* string, uint32 length,
 
 	return transform.TransformBounds(renderer.Bounds());
 }
+
+
+/*!	Draws the string from the TextRunCache, composing the run from the
+	GlyphAtlas of the font first if it is not cached yet. Returns \c false
+	if the string has to be drawn glyph by glyph instead.
+*/
+bool
+AGGTextRenderer::_RenderCachedRun(const char* string, uint32 length,
+	const Transformable& transform, const BPoint& transformOffset,
+	const IntRect& clippingFrame, BPoint* nextCharPos,
+	const escapement_delta* delta, FontCacheReference* cacheReference,
+	BRect& bounds)
+{
+	// only plain, unmasked text can be blended from a run
+	if (fMaskedScanline != NULL || !transform.IsTranslationOnly()
+		|| fContour.width() != 0.0
+		|| (fFont.Face() & (B_UNDERSCORE_FACE | B_STRIKEOUT_FACE)) != 0) {
+		return false;
+	}
+
+	TextRunCache* runCache = TextRunCache::Default();
+	if (runCache == NULL)
+		return false;
+
+	FontCacheReference localReference;
+	if (cacheReference == NULL)
+		cacheReference = &localReference;
+
+	FontCacheEntry* entry = cacheReference->Entry();
+	if (entry == NULL) {
+		entry = GlyphLayoutEngine::FontCacheEntryFor(fFont, false);
+		if (entry == NULL)
+			return false;
+
+		cacheReference->SetTo(entry);
+		if (!cacheReference->ReadLock())
+			return false;
+	}
+
+	GlyphAtlas* atlas = entry->Atlas();
+	if (atlas == NULL)
+		return false;
+
+	// The run is positioned relative to the pixel it starts in, the fraction
+	// is part of the key as it changes how the glyphs are rounded.
+	double originX = floor(transformOffset.x);
+	double originY = floor(transformOffset.y);
+
+	TextRunKey key(entry, string, strnlen(string, length),
+		delta != NULL ? delta->nonspace : 0.0f,
+		delta != NULL ? delta->space : 0.0f, fFont.Spacing(),
+		transformOffset.x - originX, transformOffset.y - originY);
+
+	BReference<TextRun> run(runCache->Lookup(key), true);
+	if (!run.IsSet()) {
+		RunBuilder builder(key, atlas, runCache->MaxRunSize(), *this);
+		GlyphLayoutEngine::LayoutGlyphs(builder, fFont, string, length,
+			INT32_MAX, delta, fFont.Spacing(), NULL, cacheReference);
+
+		run.SetTo(builder.Run(), true);
+		if (!run.IsSet())
+			return false;
+
+		runCache->Insert(run);
+	}
+
+	_BlendRun(run, (int32)originX, (int32)originY, clippingFrame);
+
+	if (nextCharPos != NULL) {
+		*nextCharPos = run->End();
+		transform.Transform(nextCharPos);
+	}
+
+	bounds = transform.TransformBounds(run->Bounds());
+	return true;
+}
+
+
+static inline bool
+is_covered(const uint8* covers, int32 x, uint32 bytesPerPixel)
+{
+	if (bytesPerPixel == 1)
+		return covers[x] != 0;
+
+	covers += x * 3;
+	return (covers[0] | covers[1] | covers[2]) != 0;
+}
+
+
+/*!	Blends the coverage of \a run with the current color and drawing mode,
+	in spans that leave out the gaps between the glyphs.
+*/
+void
+AGGTextRenderer::_BlendRun(const TextRun* run, int32 originX, int32 originY,
+	const IntRect& clippingFrame)
+{
+	int32 left = originX + run->Left();
+	int32 top = originY + run->Top();
+
+	int32 firstColumn = max_c(0, clippingFrame.left - left);
+	int32 lastColumn = min_c(run->Width() - 1, clippingFrame.right - left);
+	int32 firstRow = max_c(0, clippingFrame.top - top);
+	int32 lastRow = min_c(run->Height() - 1, clippingFrame.bottom - top);
+
+	uint32 bytesPerPixel = run->BytesPerPixel();
+
+	for (int32 row = firstRow; row <= lastRow; row++) {
+		const uint8* covers = run->Bits() + row * run->BytesPerRow();
+		int32 x = firstColumn;
+
+		while (x <= lastColumn) {
+			while (x <= lastColumn && !is_covered(covers, x, bytesPerPixel))
+				x++;
+
+			int32 start = x;
+			while (x <= lastColumn && is_covered(covers, x, bytesPerPixel))
+				x++;
+
+			if (x == start)
+				continue;
+
+			if (bytesPerPixel == 3) {
+				fBaseRenderer.blend_solid_hspan_subpix(left + start,
+					top + row, (x - start) * 3, fSubpixRenderer.color(),
+					covers + start * 3);
+			} else {
+				fBaseRenderer.blend_solid_hspan(left + start, top + row,
+					x - start, fSolidRenderer.color(), covers + start);
+			}
+		}
+	}
+}
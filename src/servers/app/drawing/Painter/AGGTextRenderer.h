@@ -13,16 +13,20 @@
 #include "ServerFont.h"
 #include "Transformable.h"
 
+#include <agg_array.h>
 #include <agg_conv_curve.h>
 #include <agg_conv_contour.h>
 #include <agg_scanline_u.h>
 
 
 class FontCacheReference;
+class IntRect;
+class TextRun;
 
 class AGGTextRenderer {
 public:
 								AGGTextRenderer(
+									renderer_base& baseRenderer,
 									renderer_subpix_type& subpixRenderer,
 									renderer_type& solidRenderer,
 									renderer_bin_type& binRenderer,
@@ -61,9 +65,30 @@ public:
 									FontCacheReference* cacheReference);
 
 private:
+			bool				_RenderCachedRun(const char* utf8String,
+									uint32 length,
+									const Transformable& transform,
+									const BPoint& transformOffset,
+									const IntRect& clippingFrame,
+									BPoint* nextCharPos,
+									const escapement_delta* delta,
+									FontCacheReference* cacheReference,
+									BRect& bounds);
+			void				_BlendRun(const TextRun* run, int32 originX,
+									int32 originY,
+									const IntRect& clippingFrame);
+
+private:
+	struct RunGlyph {
+		const GlyphCache*	glyph;
+		int32				x;
+		int32				y;
+	};
 
 	class StringRenderer;
 	friend class StringRenderer;
+	class RunBuilder;
+	friend class RunBuilder;
 
 	// Pipeline to process the vectors glyph paths (curves + contour)
 	FontCacheEntry::GlyphPathAdapter	fPathAdaptor;
@@ -75,6 +100,7 @@ private:
 	FontCacheEntry::CurveConverter		fCurves;
 	FontCacheEntry::ContourConverter	fContour;
 
+	renderer_base&				fBaseRenderer;
 	renderer_type&				fSolidRenderer;
 	renderer_bin_type&			fBinRenderer;
 	renderer_subpix_type&		fSubpixRenderer;
@@ -88,6 +114,9 @@ private:
 		// since it might be using a different gamma setting
 		// to support non-anti-aliased text rendering
 
+	agg::pod_bvector<RunGlyph>	fRunGlyphs;
+		// the glyphs of the text run being composed
+
 	ServerFont					fFont;
 	bool						fHinted;
 									// is glyph hinting active?
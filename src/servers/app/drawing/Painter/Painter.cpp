@@ -107,6 +107,9 @@ using std::nothrow;
 
 
 static uint32 detect_simd();
+#if defined(__i386__) || defined(__x86_64__)
+static bool os_supports_avx();
+#endif
 
 uint32 gSIMDFlags = detect_simd();
 
@@ -114,10 +117,25 @@ uint32 gSIMDFlags = detect_simd();
 /*!	Detect SIMD flags for use in AppServer. Checks all CPUs in the system
 	and chooses the minimum supported set of instructions.
 */
+#if defined(__i386__) || defined(__x86_64__)
+/*!	Returns whether the OS saves the AVX register state on context switches,
+	which is required before any AVX instruction may be used.
+*/
+static bool
+os_supports_avx()
+{
+	uint32 eax;
+	uint32 edx;
+	asm volatile("xgetbv" : "=a" (eax), "=d" (edx) : "c" (0));
+	return (eax & 0x6) == 0x6;
+}
+#endif
+
+
 static uint32
 detect_simd()
 {
-#if __i386__
+#if defined(__i386__) || defined(__x86_64__)
 	// Only scan CPUs for which we are certain the SIMD flags are properly
 	// defined.
 	const char* vendorNames[] = {
@@ -158,10 +176,21 @@ detect_simd()
 		if (vendorFound && maxStdFunc >= 1) {
 			get_cpuid(&cpuInfo, 1, 0);
 			uint32 edx = cpuInfo.regs.edx;
+			uint32 ecx = cpuInfo.regs.ecx;
 			if (edx & (1 << 23))
 				cpuSIMD |= APPSERVER_SIMD_MMX;
 			if (edx & (1 << 25))
 				cpuSIMD |= APPSERVER_SIMD_SSE;
+			if (edx & (1 << 26))
+				cpuSIMD |= APPSERVER_SIMD_SSE2;
+
+			// AVX2 needs both the CPU and the OS (OSXSAVE + AVX) to agree
+			if (maxStdFunc >= 7 && (ecx & (1 << 27)) != 0
+				&& (ecx & (1 << 28)) != 0 && os_supports_avx()) {
+				get_cpuid(&cpuInfo, 7, 0);
+				if (cpuInfo.regs.ebx & (1 << 5))
+					cpuSIMD |= APPSERVER_SIMD_AVX2;
+			}
 		} else {
 			// no flags can be identified
 			cpuSIMD = 0;
@@ -169,7 +198,7 @@ detect_simd()
 		systemSIMD &= cpuSIMD;
 	}
 	return systemSIMD;
-#else	// !__i386__
+#else	// !__i386__ && !__x86_64__
 	return 0;
 #endif
 }
@@ -218,9 +247,9 @@ Painter::Painter()
 	fMiterLimit(B_DEFAULT_MITER_LIMIT),
 
 	fPatternHandler(),
-	fTextRenderer(fSubpixRenderer, fRenderer, fRendererBin, fUnpackedScanline,
-		fSubpixUnpackedScanline, fSubpixRasterizer, fMaskedUnpackedScanline,
-		fTransform),
+	fTextRenderer(fBaseRenderer, fSubpixRenderer, fRenderer, fRendererBin,
+		fUnpackedScanline, fSubpixUnpackedScanline, fSubpixRasterizer,
+		fMaskedUnpackedScanline, fTransform),
 	fInternal(fPatternHandler)
 {
 	fPixelFormat.SetDrawingMode(fDrawingMode, fAlphaSrcMode, fAlphaFncMode);
@@ -349,6 +378,44 @@ Painter::SetDrawState(const DrawState* state, int32 xOffset, int32 yOffset)
 }
 
 
+/*!	Adopts the drawing state of \a other, so that this painter draws the
+	same pixels into its own buffer. This is used to spread a drawing
+	operation over several threads, which each get their own painter.
+	The clipping region, the font and the fill rule are not copied, and the
+	alpha mask is not shared, since its scanline cannot be used by more
+	than one thread at a time.
+*/
+void
+Painter::SetStateFrom(const Painter& other)
+{
+	fSubpixelPrecise = other.fSubpixelPrecise;
+	fIdentityTransform = other.fIdentityTransform;
+	fTransform = other.fTransform;
+
+	fPenSize = other.fPenSize;
+	fLineCapMode = other.fLineCapMode;
+	fLineJoinMode = other.fLineJoinMode;
+	fMiterLimit = other.fMiterLimit;
+
+	fMaskedUnpackedScanline = NULL;
+	fClippedAlphaMask = NULL;
+
+	fBaseRenderer.set_offset(other.fBaseRenderer.offset_x(),
+		other.fBaseRenderer.offset_y());
+
+	fPatternHandler = other.fPatternHandler;
+	fDrawingMode = other.fDrawingMode;
+	fAlphaSrcMode = other.fAlphaSrcMode;
+	fAlphaFncMode = other.fAlphaFncMode;
+	_UpdateDrawingMode();
+
+	if (fPatternHandler.IsSolidLow())
+		_SetRendererColor(fPatternHandler.LowColor());
+	else
+		_SetRendererColor(fPatternHandler.HighColor());
+}
+
+
 // #pragma mark - state
 
 
@@ -17,6 +17,7 @@
 #include "PainterAggInterface.h"
 #include "PatternHandler.h"
 #include "ServerFont.h"
+#include "SIMDFlags.h"
 #include "Transformable.h"
 
 #include "defines.h"
@@ -43,11 +44,6 @@ class ServerBitmap;
 class ServerFont;
 
 
-// Defines for SIMD support.
-#define APPSERVER_SIMD_MMX	(1 << 0)
-#define APPSERVER_SIMD_SSE	(1 << 1)
-
-
 class Painter {
 public:
 								Painter();
@@ -61,10 +57,14 @@ public:
 			void				SetDrawState(const DrawState* data,
 									int32 xOffset = 0,
 									int32 yOffset = 0);
+			void				SetStateFrom(const Painter& other);
 
 			void				ConstrainClipping(const BRegion* region);
 			const BRegion*		ClippingRegion() const
 									{ return fClippingRegion; }
+	inline	bool				HasAlphaMask() const
+									{ return fInternal.fClippedAlphaMask
+										!= NULL; }
 
 								// object settings
 			void				SetTransform(BAffineTransform transform,
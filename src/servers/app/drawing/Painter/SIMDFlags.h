@@ -0,0 +1,24 @@
+/*
+ * Copyright 2026, Haiku, Inc. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+#ifndef SIMD_FLAGS_H
+#define SIMD_FLAGS_H
+
+
+#include <SupportDefs.h>
+
+
+// Defines for SIMD support.
+#define APPSERVER_SIMD_MMX	(1 << 0)
+#define APPSERVER_SIMD_SSE	(1 << 1)
+#define APPSERVER_SIMD_SSE2	(1 << 2)
+#define APPSERVER_SIMD_AVX2	(1 << 3)
+
+
+// The instruction set extensions supported by all CPUs, detected by the
+// Painter on startup.
+extern uint32 gSIMDFlags;
+
+
+#endif // SIMD_FLAGS_H
@@ -14,6 +14,7 @@
 #include <agg_span_image_filter_rgba.h>
 
 #include "DrawBitmapBilinear.h"
+#include "DrawBitmapBoxFilter.h"
 #include "DrawBitmapGeneric.h"
 #include "DrawBitmapNearestNeighbor.h"
 #include "DrawBitmapNoScale.h"
@@ -137,10 +138,14 @@ Painter::BitmapPainter::Draw(const BRect& sourceRect,
 			}
 		}
 
-		// bilinear and nearest-neighbor scaled, OP_COPY only
+		// box filtered, bilinear and nearest-neighbor scaled, OP_COPY only
 		if (fPainter->fDrawingMode == B_OP_COPY
 			&& !_HasAffineTransform() && !_HasAlphaMask()) {
-			if ((fOptions & B_FILTER_BITMAP_BILINEAR) != 0) {
+			if ((fOptions & B_FILTER_BITMAP_BILINEAR) != 0
+				&& _ScalesDownByHalf()) {
+				DrawBitmapBoxFilter::Draw(fPainter, fPainter->fInternal,
+					fBitmap, fOffset, fScaleX, fScaleY, fDestinationRect);
+			} else if ((fOptions & B_FILTER_BITMAP_BILINEAR) != 0) {
 				DrawBitmapBilinear<ColorTypeRgb, DrawModeCopy> drawBilinear;
 				drawBilinear.Draw(fPainter, fPainter->fInternal,
 					fBitmap, fOffset, fScaleX, fScaleY, fDestinationRect);
@@ -241,6 +246,17 @@ Painter::BitmapPainter::_HasScale()
 }
 
 
+/*!	Below half the size, the bilinear filter starts to skip source pixels,
+	so a box filter is used instead. It can only scale down, though.
+*/
+bool
+Painter::BitmapPainter::_ScalesDownByHalf()
+{
+	return fScaleX <= 1.0 && fScaleY <= 1.0
+		&& (fScaleX <= 0.5 || fScaleY <= 0.5);
+}
+
+
 bool
 Painter::BitmapPainter::_HasAffineTransform()
 {
@@ -29,6 +29,7 @@ private:
 									const BRect& destinationRect);
 
 			bool				_HasScale();
+			bool				_ScalesDownByHalf();
 			bool				_HasAffineTransform();
 			bool				_HasAlphaMask();
 
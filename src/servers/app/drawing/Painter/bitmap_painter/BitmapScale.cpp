@@ -0,0 +1,82 @@
+/*
+ * Copyright 2026, Haiku, Inc. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ *
+ * Scalar versions of the scaling row functions, and their selection.
+ *
+ */
+
+#include "BitmapScale.h"
+
+#include "SIMDFlags.h"
+
+
+using namespace BitmapPainterPrivate;
+
+
+static void
+bilinear_copy(uint8* dst, const uint8* top, uint32 bytesPerRow,
+	const FilterInfo* weightsX, int32 count, uint16 wTop)
+{
+	for (; count > 0; count--) {
+		bilinear_copy_pixel(dst, top + weightsX->index, bytesPerRow,
+			weightsX->weight, wTop);
+		weightsX++;
+		dst += 4;
+	}
+}
+
+
+static void
+bilinear_alpha_overlay(uint8* dst, const uint8* top, uint32 bytesPerRow,
+	const FilterInfo* weightsX, int32 count, uint16 wTop)
+{
+	for (; count > 0; count--) {
+		bilinear_alpha_overlay_pixel(dst, top + weightsX->index, bytesPerRow,
+			weightsX->weight, wTop);
+		weightsX++;
+		dst += 4;
+	}
+}
+
+
+static void
+box_accumulate(uint32* sums, const uint8* source, int32 count)
+{
+	for (count *= 4; count > 0; count--)
+		*sums++ += *source++;
+}
+
+
+static void
+box_resolve(uint8* dst, const uint32* sums, const BoxSpan* spans,
+	int32 count, uint32 rows)
+{
+	for (; count > 0; count--) {
+		box_resolve_pixel(dst, sums, *spans, rows);
+		spans++;
+		dst += 4;
+	}
+}
+
+
+const scale_functions gScaleFunctionsScalar = {
+	bilinear_copy,
+	bilinear_alpha_overlay,
+
+	box_accumulate,
+	box_resolve
+};
+
+
+const scale_functions*
+scale_functions_for(uint32 simdFlags)
+{
+#ifdef PAINTER_SIMD_SCALING
+	if ((simdFlags & APPSERVER_SIMD_AVX2) != 0)
+		return &gScaleFunctionsAVX2;
+	if ((simdFlags & APPSERVER_SIMD_SSE2) != 0)
+		return &gScaleFunctionsSSE2;
+#endif
+	return &gScaleFunctionsScalar;
+}
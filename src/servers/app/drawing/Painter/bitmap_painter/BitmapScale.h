@@ -0,0 +1,157 @@
+/*
+ * Copyright 2026, Haiku, Inc. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ *
+ * Row functions for the scaled drawing of B_RGBA32 bitmaps, with vectorized
+ * versions for the instruction sets detected by the Painter.
+ *
+ */
+
+#ifndef BITMAP_SCALE_H
+#define BITMAP_SCALE_H
+
+#include <SupportDefs.h>
+
+
+#if (defined(__i386__) || defined(__x86_64__)) && __GNUC__ >= 4
+#	define PAINTER_SIMD_SCALING 1
+#endif
+
+
+namespace BitmapPainterPrivate {
+
+
+struct FilterInfo {
+	uint16 index;	// index into source bitmap row/column
+	uint16 weight;	// weight of the pixel at index [0..255]
+};
+
+
+// The source pixels a destination pixel is the average of, when the bitmap
+// is scaled down with a box filter.
+struct BoxSpan {
+	uint32 index;	// first pixel in the source bitmap row/column
+	uint32 count;	// number of pixels, at least 1
+};
+
+
+// The row functions for a single pixel, also used by the vectorized versions
+// for the pixels that do not fill a vector.
+
+
+// ColorTypeRgb::Interpolate() followed by DrawModeCopy::Blend()
+static inline void
+bilinear_copy_pixel(uint8* d, const uint8* s, uint32 bytesPerRow,
+	uint16 wLeft, uint16 wTop)
+{
+	const uint16 wRight = 255 - wLeft;
+	const uint16 wBottom = 255 - wTop;
+	const uint8* b = s + bytesPerRow;
+
+	for (int32 i = 0; i < 3; i++) {
+		d[i] = ((s[i] * wLeft + s[i + 4] * wRight) * wTop
+			+ (b[i] * wLeft + b[i + 4] * wRight) * wBottom) >> 16;
+	}
+}
+
+
+// ColorTypeRgba::Interpolate() followed by DrawModeAlphaOverlay::Blend()
+static inline void
+bilinear_alpha_overlay_pixel(uint8* d, const uint8* s, uint32 bytesPerRow,
+	uint16 wLeft, uint16 wTop)
+{
+	const uint16 wRight = 255 - wLeft;
+	const uint16 wBottom = 255 - wTop;
+	const uint8* b = s + bytesPerRow;
+
+	int32 t[4];
+	for (int32 i = 0; i < 4; i++) {
+		t[i] = ((s[i] * wLeft + s[i + 4] * wRight) * wTop
+			+ (b[i] * wLeft + b[i + 4] * wRight) * wBottom) >> 16;
+	}
+
+	if (t[3] == 255) {
+		d[0] = t[0];
+		d[1] = t[1];
+		d[2] = t[2];
+	} else {
+		for (int32 i = 0; i < 3; i++)
+			d[i] = ((t[i] - d[i]) * t[3] + (d[i] << 8)) >> 8;
+	}
+}
+
+
+// Dividing by the number of pixels is done as a multiplication with this,
+// and a shift by 32 bits; the sums never exceed 255 times the number.
+static inline uint32
+box_multiplier(uint32 pixels)
+{
+	return pixels > 1 ? (uint32)(((uint64)1 << 32) / pixels) : 0xffffffff;
+}
+
+
+static inline void
+box_resolve_pixel(uint8* d, const uint32* sums, const BoxSpan& span,
+	uint32 rows)
+{
+	const uint64 multiplier = box_multiplier(span.count * rows);
+	const uint32* s = sums + span.index * 4;
+
+	for (int32 i = 0; i < 3; i++) {
+		uint32 sum = 0;
+		for (uint32 x = 0; x < span.count; x++)
+			sum += s[x * 4 + i];
+
+		d[i] = (sum * multiplier + 0x80000000) >> 32;
+	}
+}
+
+
+} // namespace BitmapPainterPrivate
+
+
+// The bilinear functions interpolate \a count destination pixels from the
+// source row at \a top and the one below it, using \a weightsX for the
+// columns and \a wTop (0..255) for the rows. The pixel right of every
+// indexed one is read as well, so the pixels of the last source column, which
+// have a weight of 255, must be left out. They produce
+// exactly the same pixels as BilinearDefault in DrawBitmapBilinear.h with
+// ColorTypeRgb and DrawModeCopy, or ColorTypeRgba and DrawModeAlphaOverlay.
+//
+// The box functions scale down: box_accumulate adds \a count source pixels
+// to the per channel \a sums, box_resolve writes \a count destination
+// pixels, each the rounded average of the sums of the pixels the respective
+// span refers to (with indices relative to \a sums), and the number of
+// source \a rows that were accumulated into them.
+// Like DrawModeCopy, they leave the alpha channel of the destination alone.
+struct scale_functions {
+	typedef BitmapPainterPrivate::FilterInfo FilterInfo;
+	typedef BitmapPainterPrivate::BoxSpan BoxSpan;
+
+	void	(*bilinear_copy)(uint8* dst, const uint8* top,
+				uint32 bytesPerRow, const FilterInfo* weightsX, int32 count,
+				uint16 wTop);
+	void	(*bilinear_alpha_overlay)(uint8* dst, const uint8* top,
+				uint32 bytesPerRow, const FilterInfo* weightsX, int32 count,
+				uint16 wTop);
+
+	void	(*box_accumulate)(uint32* sums, const uint8* source,
+				int32 count);
+	void	(*box_resolve)(uint8* dst, const uint32* sums,
+				const BoxSpan* spans, int32 count, uint32 rows);
+};
+
+
+extern const scale_functions gScaleFunctionsScalar;
+#ifdef PAINTER_SIMD_SCALING
+extern const scale_functions gScaleFunctionsSSE2;
+extern const scale_functions gScaleFunctionsAVX2;
+#endif
+
+
+// Never returns NULL, the scalar versions are used when no instruction set
+// with a vectorized version is available.
+const scale_functions* scale_functions_for(uint32 simdFlags);
+
+
+#endif // BITMAP_SCALE_H
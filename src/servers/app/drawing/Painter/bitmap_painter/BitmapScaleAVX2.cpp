@@ -0,0 +1,147 @@
+/*
+ * Copyright 2026, Haiku, Inc. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ *
+ * AVX2 versions of the scaling row functions in BitmapScaleKernels.h.
+ *
+ */
+
+#include "BitmapScale.h"
+
+
+#ifdef PAINTER_SIMD_SCALING
+
+// Only what follows may use AVX2; the rest of the app_server must still run
+// on CPUs without it.
+#pragma GCC push_options
+#pragma GCC target("avx2")
+
+#include <immintrin.h>
+
+#include "BitmapScaleKernels.h"
+
+
+using namespace BitmapPainterPrivate;
+
+
+struct AVX2 {
+	typedef __m256i vector;
+
+	enum {
+		kPixels = 4
+	};
+
+	// The unpack and pack instructions work on the two 128 bit lanes
+	// separately, so the first two pixels go into the low, and the other
+	// two into the high lane.
+	static inline vector Combine(__m128i low, __m128i high)
+		{ return _mm256_inserti128_si256(_mm256_castsi128_si256(low), high, 1); }
+
+	static inline __m128i LoadPair(const uint8* p)
+		{ return _mm_loadl_epi64((const __m128i*)p); }
+
+	static inline vector Gather(const uint8* row, const FilterInfo* weights)
+	{
+		return Combine(
+			_mm_unpacklo_epi32(LoadPair(row + weights[0].index),
+				LoadPair(row + weights[1].index)),
+			_mm_unpacklo_epi32(LoadPair(row + weights[2].index),
+				LoadPair(row + weights[3].index)));
+	}
+
+	static inline vector LoadWeights(const FilterInfo* weights)
+	{
+		return Combine(
+			_mm_unpacklo_epi64(_mm_set1_epi16(weights[0].weight),
+				_mm_set1_epi16(weights[1].weight)),
+			_mm_unpacklo_epi64(_mm_set1_epi16(weights[2].weight),
+				_mm_set1_epi16(weights[3].weight)));
+	}
+
+	static inline vector LoadPixels16(const uint8* p)
+		{ return _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i*)p)); }
+	static inline void StorePixels16(uint8* p, vector v)
+	{
+		vector packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(v, v),
+			_MM_SHUFFLE(3, 1, 2, 0));
+		_mm_storeu_si128((__m128i*)p, _mm256_castsi256_si128(packed));
+	}
+
+	// Unpacking within the lanes puts the n-th pixel of both into one
+	// vector, so the even pixels are moved into the low lane, the odd ones
+	// into the high lane first.
+	static inline void Accumulate(uint32* sums, const uint8* source)
+	{
+		vector zero = Zero();
+		vector pixels = _mm256_permutevar8x32_epi32(
+			_mm256_loadu_si256((const __m256i*)source),
+			_mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7));
+		vector low = _mm256_unpacklo_epi8(pixels, zero);
+		vector high = _mm256_unpackhi_epi8(pixels, zero);
+
+		vector* s = (vector*)sums;
+		_mm256_storeu_si256(s, _mm256_add_epi32(_mm256_loadu_si256(s),
+			_mm256_unpacklo_epi16(low, zero)));
+		_mm256_storeu_si256(s + 1, _mm256_add_epi32(_mm256_loadu_si256(s + 1),
+			_mm256_unpackhi_epi16(low, zero)));
+		_mm256_storeu_si256(s + 2, _mm256_add_epi32(_mm256_loadu_si256(s + 2),
+			_mm256_unpacklo_epi16(high, zero)));
+		_mm256_storeu_si256(s + 3, _mm256_add_epi32(_mm256_loadu_si256(s + 3),
+			_mm256_unpackhi_epi16(high, zero)));
+	}
+
+	static inline vector BroadcastAlpha16(vector v)
+	{
+		return _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(v,
+			_MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+	}
+
+	static inline vector Zero()
+		{ return _mm256_setzero_si256(); }
+	static inline vector Set16(uint16 value)
+		{ return _mm256_set1_epi16(value); }
+	static inline vector Set64(uint64 value)
+		{ return _mm256_set1_epi64x(value); }
+
+	static inline vector And(vector a, vector b)
+		{ return _mm256_and_si256(a, b); }
+	static inline vector AndNot(vector a, vector b)
+		{ return _mm256_andnot_si256(a, b); }
+	static inline vector Or(vector a, vector b)
+		{ return _mm256_or_si256(a, b); }
+	static inline vector CmpEq16(vector a, vector b)
+		{ return _mm256_cmpeq_epi16(a, b); }
+
+	static inline vector Add16(vector a, vector b)
+		{ return _mm256_add_epi16(a, b); }
+	static inline vector Sub16(vector a, vector b)
+		{ return _mm256_sub_epi16(a, b); }
+	static inline vector MulLow16(vector a, vector b)
+		{ return _mm256_mullo_epi16(a, b); }
+	static inline vector MulHigh16(vector a, vector b)
+		{ return _mm256_mulhi_epu16(a, b); }
+	static inline vector ShiftRight16(vector v, int bits)
+		{ return _mm256_srli_epi16(v, bits); }
+	static inline vector Add32(vector a, vector b)
+		{ return _mm256_add_epi32(a, b); }
+	static inline vector ShiftRight32(vector v, int bits)
+		{ return _mm256_srli_epi32(v, bits); }
+
+	static inline vector UnpackLow8(vector a, vector b)
+		{ return _mm256_unpacklo_epi8(a, b); }
+	static inline vector UnpackHigh8(vector a, vector b)
+		{ return _mm256_unpackhi_epi8(a, b); }
+	static inline vector UnpackLow16(vector a, vector b)
+		{ return _mm256_unpacklo_epi16(a, b); }
+	static inline vector UnpackHigh16(vector a, vector b)
+		{ return _mm256_unpackhi_epi16(a, b); }
+	static inline vector Pack32(vector a, vector b)
+		{ return _mm256_packs_epi32(a, b); }
+};
+
+
+const scale_functions gScaleFunctionsAVX2 = SIMD_SCALE_FUNCTIONS(AVX2);
+
+#pragma GCC pop_options
+
+#endif	// PAINTER_SIMD_SCALING
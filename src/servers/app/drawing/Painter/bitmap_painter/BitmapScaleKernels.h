@@ -0,0 +1,229 @@
+/*
+ * Copyright 2026, Haiku, Inc. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ *
+ * Row functions for bilinear and box filtered scaling of B_RGBA32 bitmaps,
+ * written against a small set of vector operations, so that they can be
+ * instantiated for every instruction set we care about.
+ *
+ */
+
+#ifndef BITMAP_SCALE_KERNELS_H
+#define BITMAP_SCALE_KERNELS_H
+
+#include "BitmapScale.h"
+
+
+#ifdef PAINTER_SIMD_SCALING
+
+
+namespace BitmapPainterPrivate {
+
+
+// The vector type V has to provide the following operations, working on
+// 32 bit B_RGBA32 pixels, or on their 8 bit channels unpacked to 16 or
+// 32 bit:
+//
+//	vector		the vector type
+//	kPixels		the number of pixels whose channels fit into a vector when
+//				unpacked to 16 bit
+//	Gather()	loads the pixels the first kPixels weights refer to, and
+//				their right neighbours, such that UnpackLow8() returns the
+//				former and UnpackHigh8() the latter
+//	LoadWeights() returns the weights of kPixels pixels for every channel
+//	LoadPixels16(), StorePixels16() which load or store kPixels pixels,
+//	with the channels unpacked to 16 bit
+//	Accumulate() which adds kPixels * 2 pixels to their 32 bit sums
+//	BroadcastAlpha16() which copies the alpha channel of every pixel to its
+//	other channels
+//	Zero(), Set16(), Set64(), And(), AndNot(), Or(), CmpEq16(), Add16(),
+//	Sub16(), MulLow16(), MulHigh16() (unsigned), ShiftRight16(), Add32(),
+//	ShiftRight32(), UnpackLow8(), UnpackHigh8(), UnpackLow16(),
+//	UnpackHigh16() and Pack32() (with signed saturation).
+//
+// Unpacking and packing may work on lanes within the vector, as long as
+// Pack32() reverses what UnpackLow16() and UnpackHigh16() did.
+template<typename V>
+struct SIMDScaling {
+	typedef typename V::vector vector;
+
+	static inline vector Select(vector mask, vector a, vector b)
+	{
+		return V::Or(V::And(mask, a), V::AndNot(mask, b));
+	}
+
+	static inline vector AlphaMask()
+	{
+		return V::Set64(0xffff000000000000ULL);
+	}
+
+	// The weighted sum of the left and right pixels
+	static inline vector InterpolateRow(vector pixels, vector wLeft,
+		vector wRight)
+	{
+		vector zero = V::Zero();
+		return V::Add16(V::MulLow16(V::UnpackLow8(pixels, zero), wLeft),
+			V::MulLow16(V::UnpackHigh8(pixels, zero), wRight));
+	}
+
+	// Does what ColorType::Interpolate() does for kPixels pixels. The
+	// rows are interpolated in 16 bit, which can hold up to 255 * 255,
+	// but weighting them again needs the full 32 bit products.
+	static inline vector Interpolate(const uint8* top, uint32 bytesPerRow,
+		const FilterInfo* weights, vector wTop, vector wBottom)
+	{
+		vector wLeft = V::LoadWeights(weights);
+		vector wRight = V::Sub16(V::Set16(255), wLeft);
+
+		vector rowTop = InterpolateRow(V::Gather(top, weights), wLeft,
+			wRight);
+		vector rowBottom = InterpolateRow(
+			V::Gather(top + bytesPerRow, weights), wLeft, wRight);
+
+		vector topLow = V::MulLow16(rowTop, wTop);
+		vector topHigh = V::MulHigh16(rowTop, wTop);
+		vector bottomLow = V::MulLow16(rowBottom, wBottom);
+		vector bottomHigh = V::MulHigh16(rowBottom, wBottom);
+
+		vector first = V::Add32(V::UnpackLow16(topLow, topHigh),
+			V::UnpackLow16(bottomLow, bottomHigh));
+		vector second = V::Add32(V::UnpackHigh16(topLow, topHigh),
+			V::UnpackHigh16(bottomLow, bottomHigh));
+
+		return V::Pack32(V::ShiftRight32(first, 16),
+			V::ShiftRight32(second, 16));
+	}
+
+	static void BilinearCopy(uint8* dst, const uint8* top,
+		uint32 bytesPerRow, const FilterInfo* weightsX, int32 count,
+		uint16 wTop)
+	{
+		vector topWeight = V::Set16(wTop);
+		vector bottomWeight = V::Set16(255 - wTop);
+		vector alpha = AlphaMask();
+
+		for (; count >= V::kPixels; count -= V::kPixels) {
+			vector pixels = Interpolate(top, bytesPerRow, weightsX, topWeight,
+				bottomWeight);
+			V::StorePixels16(dst,
+				Select(alpha, V::LoadPixels16(dst), pixels));
+
+			weightsX += V::kPixels;
+			dst += V::kPixels * 4;
+		}
+
+		for (; count > 0; count--) {
+			bilinear_copy_pixel(dst, top + weightsX->index, bytesPerRow,
+				weightsX->weight, wTop);
+			weightsX++;
+			dst += 4;
+		}
+	}
+
+	// Since ((t - d) * a + (d << 8)) >> 8 == (t * a + d * (256 - a)) >> 8,
+	// and the latter never leaves the range of an unsigned 16 bit value,
+	// this produces exactly the same result as DrawModeAlphaOverlay.
+	static void BilinearAlphaOverlay(uint8* dst, const uint8* top,
+		uint32 bytesPerRow, const FilterInfo* weightsX, int32 count,
+		uint16 wTop)
+	{
+		vector topWeight = V::Set16(wTop);
+		vector bottomWeight = V::Set16(255 - wTop);
+		vector alphaMask = AlphaMask();
+
+		for (; count >= V::kPixels; count -= V::kPixels) {
+			vector pixels = Interpolate(top, bytesPerRow, weightsX, topWeight,
+				bottomWeight);
+			vector dstPixels = V::LoadPixels16(dst);
+
+			vector alpha = V::BroadcastAlpha16(pixels);
+			vector blended = V::ShiftRight16(
+				V::Add16(V::MulLow16(pixels, alpha),
+					V::MulLow16(dstPixels, V::Sub16(V::Set16(256), alpha))),
+				8);
+			pixels = Select(V::CmpEq16(alpha, V::Set16(255)), pixels,
+				blended);
+
+			V::StorePixels16(dst, Select(alphaMask, dstPixels, pixels));
+
+			weightsX += V::kPixels;
+			dst += V::kPixels * 4;
+		}
+
+		for (; count > 0; count--) {
+			bilinear_alpha_overlay_pixel(dst, top + weightsX->index,
+				bytesPerRow, weightsX->weight, wTop);
+			weightsX++;
+			dst += 4;
+		}
+	}
+
+	static void BoxAccumulate(uint32* sums, const uint8* source, int32 count)
+	{
+		for (; count >= V::kPixels * 2; count -= V::kPixels * 2) {
+			V::Accumulate(sums, source);
+			sums += V::kPixels * 8;
+			source += V::kPixels * 8;
+		}
+
+		for (count *= 4; count > 0; count--)
+			*sums++ += *source++;
+	}
+
+	// The sums of a pixel fit into 128 bits on every instruction set, and
+	// there is no point in using wider vectors for a single pixel.
+	static void BoxResolve(uint8* dst, const uint32* sums,
+		const BoxSpan* spans, int32 count, uint32 rows)
+	{
+		const __m128i round = _mm_set1_epi64x(0x80000000);
+		const __m128i oddMask = _mm_set1_epi64x(0xffffffff00000000ULL);
+
+		for (; count > 0; count--) {
+			const uint32* s = sums + spans->index * 4;
+			__m128i sum = _mm_loadu_si128((const __m128i*)s);
+			for (uint32 x = 1; x < spans->count; x++) {
+				sum = _mm_add_epi32(sum,
+					_mm_loadu_si128((const __m128i*)(s + x * 4)));
+			}
+
+			// channels 0 and 2 end up in the low, 1 and 3 in the high
+			// 32 bits of the 64 bit lanes
+			__m128i multiplier = _mm_set1_epi32(
+				box_multiplier(spans->count * rows));
+			__m128i even = _mm_srli_epi64(_mm_add_epi64(
+				_mm_mul_epu32(sum, multiplier), round), 32);
+			__m128i odd = _mm_and_si128(_mm_add_epi64(
+				_mm_mul_epu32(_mm_srli_epi64(sum, 32), multiplier), round),
+				oddMask);
+			__m128i pixel = _mm_or_si128(even, odd);
+			pixel = _mm_packs_epi32(pixel, pixel);
+			pixel = _mm_packus_epi16(pixel, pixel);
+
+			uint32 value = _mm_cvtsi128_si32(pixel);
+			*(uint32*)dst = (value & 0x00ffffff)
+				| (*(uint32*)dst & 0xff000000);
+
+			spans++;
+			dst += 4;
+		}
+	}
+};
+
+
+#define SIMD_SCALE_FUNCTIONS(V) \
+{ \
+	SIMDScaling<V>::BilinearCopy, \
+	SIMDScaling<V>::BilinearAlphaOverlay, \
+\
+	SIMDScaling<V>::BoxAccumulate, \
+	SIMDScaling<V>::BoxResolve \
+}
+
+
+} // namespace BitmapPainterPrivate
+
+
+#endif	// PAINTER_SIMD_SCALING
+
+
+#endif // BITMAP_SCALE_KERNELS_H
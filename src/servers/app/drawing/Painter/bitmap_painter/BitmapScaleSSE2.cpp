@@ -0,0 +1,126 @@
+/*
+ * Copyright 2026, Haiku, Inc. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ *
+ * SSE2 versions of the scaling row functions in BitmapScaleKernels.h.
+ *
+ */
+
+#include "BitmapScale.h"
+
+
+#ifdef PAINTER_SIMD_SCALING
+
+// Only what follows may use SSE2; on x86 the rest of the app_server must
+// still run on CPUs without it.
+#pragma GCC push_options
+#pragma GCC target("sse2")
+
+#include <emmintrin.h>
+
+#include "BitmapScaleKernels.h"
+
+
+using namespace BitmapPainterPrivate;
+
+
+struct SSE2 {
+	typedef __m128i vector;
+
+	enum {
+		kPixels = 2
+	};
+
+	static inline __m128i LoadPair(const uint8* p)
+		{ return _mm_loadl_epi64((const __m128i*)p); }
+
+	static inline vector Gather(const uint8* row, const FilterInfo* weights)
+	{
+		return _mm_unpacklo_epi32(LoadPair(row + weights[0].index),
+			LoadPair(row + weights[1].index));
+	}
+
+	static inline vector LoadWeights(const FilterInfo* weights)
+	{
+		return _mm_unpacklo_epi64(_mm_set1_epi16(weights[0].weight),
+			_mm_set1_epi16(weights[1].weight));
+	}
+
+	static inline vector LoadPixels16(const uint8* p)
+		{ return _mm_unpacklo_epi8(LoadPair(p), Zero()); }
+	static inline void StorePixels16(uint8* p, vector v)
+		{ _mm_storel_epi64((__m128i*)p, _mm_packus_epi16(v, v)); }
+
+	static inline void Accumulate(uint32* sums, const uint8* source)
+	{
+		vector zero = Zero();
+		vector pixels = _mm_loadu_si128((const __m128i*)source);
+		vector low = _mm_unpacklo_epi8(pixels, zero);
+		vector high = _mm_unpackhi_epi8(pixels, zero);
+
+		vector* s = (vector*)sums;
+		_mm_storeu_si128(s, _mm_add_epi32(_mm_loadu_si128(s),
+			_mm_unpacklo_epi16(low, zero)));
+		_mm_storeu_si128(s + 1, _mm_add_epi32(_mm_loadu_si128(s + 1),
+			_mm_unpackhi_epi16(low, zero)));
+		_mm_storeu_si128(s + 2, _mm_add_epi32(_mm_loadu_si128(s + 2),
+			_mm_unpacklo_epi16(high, zero)));
+		_mm_storeu_si128(s + 3, _mm_add_epi32(_mm_loadu_si128(s + 3),
+			_mm_unpackhi_epi16(high, zero)));
+	}
+
+	static inline vector BroadcastAlpha16(vector v)
+	{
+		return _mm_shufflehi_epi16(_mm_shufflelo_epi16(v,
+			_MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+	}
+
+	static inline vector Zero()
+		{ return _mm_setzero_si128(); }
+	static inline vector Set16(uint16 value)
+		{ return _mm_set1_epi16(value); }
+	static inline vector Set64(uint64 value)
+		{ return _mm_set1_epi64x(value); }
+
+	static inline vector And(vector a, vector b)
+		{ return _mm_and_si128(a, b); }
+	static inline vector AndNot(vector a, vector b)
+		{ return _mm_andnot_si128(a, b); }
+	static inline vector Or(vector a, vector b)
+		{ return _mm_or_si128(a, b); }
+	static inline vector CmpEq16(vector a, vector b)
+		{ return _mm_cmpeq_epi16(a, b); }
+
+	static inline vector Add16(vector a, vector b)
+		{ return _mm_add_epi16(a, b); }
+	static inline vector Sub16(vector a, vector b)
+		{ return _mm_sub_epi16(a, b); }
+	static inline vector MulLow16(vector a, vector b)
+		{ return _mm_mullo_epi16(a, b); }
+	static inline vector MulHigh16(vector a, vector b)
+		{ return _mm_mulhi_epu16(a, b); }
+	static inline vector ShiftRight16(vector v, int bits)
+		{ return _mm_srli_epi16(v, bits); }
+	static inline vector Add32(vector a, vector b)
+		{ return _mm_add_epi32(a, b); }
+	static inline vector ShiftRight32(vector v, int bits)
+		{ return _mm_srli_epi32(v, bits); }
+
+	static inline vector UnpackLow8(vector a, vector b)
+		{ return _mm_unpacklo_epi8(a, b); }
+	static inline vector UnpackHigh8(vector a, vector b)
+		{ return _mm_unpackhi_epi8(a, b); }
+	static inline vector UnpackLow16(vector a, vector b)
+		{ return _mm_unpacklo_epi16(a, b); }
+	static inline vector UnpackHigh16(vector a, vector b)
+		{ return _mm_unpackhi_epi16(a, b); }
+	static inline vector Pack32(vector a, vector b)
+		{ return _mm_packs_epi32(a, b); }
+};
+
+
+const scale_functions gScaleFunctionsSSE2 = SIMD_SCALE_FUNCTIONS(SSE2);
+
+#pragma GCC pop_options
+
+#endif	// PAINTER_SIMD_SCALING
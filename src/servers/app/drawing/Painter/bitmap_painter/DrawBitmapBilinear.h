@@ -12,6 +12,8 @@
 
 #include <typeinfo>
 
+#include "BitmapScale.h"
+
 
 // Prototypes for assembler routines
 extern "C" {
@@ -26,12 +28,6 @@ extern uint32 gSIMDFlags;
 namespace BitmapPainterPrivate {
 
 
-struct FilterInfo {
-	uint16 index;	// index into source bitmap row/column
-	uint16 weight;	// weight of the pixel at index [0..255]
-};
-
-
 struct FilterData {
 	FilterInfo* fWeightsX;
 	FilterInfo* fWeightsY;
@@ -229,6 +225,18 @@ template<class ColorType, class DrawMode>
 struct BilinearDefault :
 	DrawBitmapBilinearOptimized<BilinearDefault<ColorType, DrawMode> > {
 
+	typedef void (*RowFunction)(uint8* dst, const uint8* top,
+		uint32 bytesPerRow, const FilterInfo* weightsX, int32 count,
+		uint16 wTop);
+
+	// If given, \a rowFunction is used for all pixels that are
+	// interpolated from four source pixels (see BitmapScale.h).
+	BilinearDefault(RowFunction rowFunction = NULL)
+		:
+		fRowFunction(rowFunction)
+	{
+	}
+
 	void DrawToClipRect(int32 xIndexL, int32 xIndexR, int32 y1, int32 y2)
 	{
 		// In this mode we anticipate many pixels wich need filtering,
@@ -257,23 +265,32 @@ struct BilinearDefault :
 			// pixel
 			uint8* d = this->fDestination;
 
-			for (int32 x = xIndexL; x <= xIndexMax; x++) {
-				const uint8* s = src + this->fWeightsX[x].index;
+			if (fRowFunction != NULL && this->fSource->height() > 1
+				&& xIndexL <= xIndexMax) {
+				fRowFunction(d, src, this->fSourceBytesPerRow,
+					this->fWeightsX + xIndexL, xIndexMax - xIndexL + 1, wTop);
+				d += (xIndexMax - xIndexL + 1) * 4;
+			} else {
+				for (int32 x = xIndexL; x <= xIndexMax; x++) {
+					const uint8* s = src + this->fWeightsX[x].index;
 
-				// calculate the weighted sum of all four
-				// interpolated pixels
-				const uint16 wLeft = this->fWeightsX[x].weight;
-				const uint16 wRight = 255 - wLeft;
+					// calculate the weighted sum of all four
+					// interpolated pixels
+					const uint16 wLeft = this->fWeightsX[x].weight;
+					const uint16 wRight = 255 - wLeft;
 
-				uint32 t[4];
+					uint32 t[4];
 
-				if (this->fSource->height() > 1) {
-					ColorType::Interpolate(&t[0], s, this->fSourceBytesPerRow,
-						wLeft, wTop, wRight, wBottom);
-				} else {
-					ColorType::InterpolateLastRow(&t[0], s,  wLeft, wRight);
+					if (this->fSource->height() > 1) {
+						ColorType::Interpolate(&t[0], s,
+							this->fSourceBytesPerRow, wLeft, wTop, wRight,
+							wBottom);
+					} else {
+						ColorType::InterpolateLastRow(&t[0], s, wLeft,
+							wRight);
+					}
+					DrawMode::Blend(d, &t[0]);
 				}
-				DrawMode::Blend(d, &t[0]);
 			}
 			// last column of pixels if necessary
 			if (xIndexMax < xIndexR && this->fSource->height() > 1) {
@@ -313,6 +330,9 @@ struct BilinearDefault :
 			*(uint32*)d = *(uint32*)s;
 		}
 	}
+
+private:
+	RowFunction	fRowFunction;
 };
 
 
@@ -591,17 +611,26 @@ struct DrawBitmapBilinear {
 		enum {
 			kOptimizeForLowFilterRatio = 0,
 			kUseDefaultVersion,
-			kUseSIMDVersion
+			kUseSIMDVersion,
+			kUseSIMDRows
 		};
 
 		int codeSelect = kUseDefaultVersion;
+		const scale_functions* scaleFunctions
+			= scale_functions_for(gSIMDFlags);
 
-		if (typeid(ColorType) == typeid(ColorTypeRgb)
+		if (scaleFunctions != &gScaleFunctionsScalar) {
+			// the vectorized rows are available for both variants
+			codeSelect = kUseSIMDRows;
+		} else if (typeid(ColorType) == typeid(ColorTypeRgb)
 			&& typeid(DrawMode) == typeid(DrawModeCopy)) {
+#ifdef __i386__
 			uint32 neededSIMDFlags = APPSERVER_SIMD_MMX | APPSERVER_SIMD_SSE;
 			if ((gSIMDFlags & neededSIMDFlags) == neededSIMDFlags)
 				codeSelect = kUseSIMDVersion;
-			else {
+			else
+#endif
+			{
 				if (scaleX == scaleY && (scaleX == 1.5 || scaleX == 2.0
 					|| scaleX == 2.5 || scaleX == 3.0)) {
 					codeSelect = kOptimizeForLowFilterRatio;
@@ -626,6 +655,17 @@ struct DrawBitmapBilinear {
 				break;
 			}
 
+			case kUseSIMDRows:
+			{
+				BilinearDefault<ColorType, DrawMode> bilinearPainter(
+					typeid(DrawMode) == typeid(DrawModeCopy)
+						? scaleFunctions->bilinear_copy
+						: scaleFunctions->bilinear_alpha_overlay);
+				bilinearPainter.Draw(aggInterface, destinationRect, &bitmap,
+					filterData);
+				break;
+			}
+
 #ifdef __i386__
 			case kUseSIMDVersion:
 			{
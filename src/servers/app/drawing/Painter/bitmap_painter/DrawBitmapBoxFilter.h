@@ -0,0 +1,169 @@
+/*
+ * Copyright 2026, Haiku, Inc. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+#ifndef DRAW_BITMAP_BOX_FILTER_H
+#define DRAW_BITMAP_BOX_FILTER_H
+
+#include "Painter.h"
+
+#include <string.h>
+
+#include <StackOrHeapArray.h>
+
+#include "BitmapScale.h"
+
+
+namespace BitmapPainterPrivate {
+
+
+/*!	Scales a bitmap down by averaging all source pixels that fall into a
+	destination pixel. Unlike the bilinear filter, which only looks at the
+	four source pixels around the center of a destination pixel, this does
+	not skip any source pixels, and thus does not alias when the bitmap is
+	scaled down to less than half its size.
+
+	The source pixels are assigned to the destination pixel their left or
+	top edge falls into, so with fractional scales, the boxes differ in size
+	by one pixel at most. OP_COPY only.
+*/
+struct DrawBitmapBoxFilter {
+	static void
+	Draw(const Painter* painter, PainterAggInterface& aggInterface,
+		agg::rendering_buffer& bitmap, BPoint offset,
+		double scaleX, double scaleY, BRect destinationRect)
+	{
+		uint32 dstWidth = destinationRect.IntegerWidth() + 1;
+		uint32 dstHeight = destinationRect.IntegerHeight() + 1;
+
+		// Do not calculate more spans than necessary
+		const BRegion& clippingRegion = *painter->ClippingRegion();
+		if (clippingRegion.Frame().IntegerWidth() + 1 < (int32)dstWidth)
+			dstWidth = clippingRegion.Frame().IntegerWidth() + 1;
+		if (clippingRegion.Frame().IntegerHeight() + 1 < (int32)dstHeight)
+			dstHeight = clippingRegion.Frame().IntegerHeight() + 1;
+
+		// When calculating less spans than specified by destinationRect,
+		// we need to compensate the offset.
+		uint32 indexOffsetX = 0;
+		uint32 indexOffsetY = 0;
+		if (clippingRegion.Frame().left > destinationRect.left) {
+			indexOffsetX = (int32)(clippingRegion.Frame().left
+				- destinationRect.left);
+		}
+		if (clippingRegion.Frame().top > destinationRect.top) {
+			indexOffsetY = (int32)(clippingRegion.Frame().top
+				- destinationRect.top);
+		}
+
+		BStackOrHeapArray<BoxSpan, 256> xSpans(dstWidth);
+		BStackOrHeapArray<BoxSpan, 256> ySpans(dstHeight);
+		if (!xSpans.IsValid() || !ySpans.IsValid())
+			return;
+
+		// Extract the cropping information for the source bitmap,
+		// If only a part of the source bitmap is to be drawn with scale,
+		// the offset will be different from the destinationRect left top
+		// corner.
+		const int32 xBitmapShift = (int32)(destinationRect.left - offset.x);
+		const int32 yBitmapShift = (int32)(destinationRect.top - offset.y);
+
+		_CalculateSpans(xSpans, dstWidth, indexOffsetX, scaleX, xBitmapShift,
+			bitmap.width());
+		_CalculateSpans(ySpans, dstHeight, indexOffsetY, scaleY,
+			yBitmapShift, bitmap.height());
+
+		const scale_functions* functions = scale_functions_for(gSIMDFlags);
+
+		const int32 left = (int32)destinationRect.left;
+		const int32 top = (int32)destinationRect.top;
+		const int32 right = (int32)destinationRect.right;
+		const int32 bottom = (int32)destinationRect.bottom;
+
+		const uint32 dstBPR = aggInterface.fBuffer.stride();
+
+		renderer_base& baseRenderer = aggInterface.fBaseRenderer;
+
+		// iterate over clipping boxes
+		baseRenderer.first_clip_box();
+		do {
+			const int32 x1 = max_c(baseRenderer.xmin(), left);
+			const int32 x2 = min_c(baseRenderer.xmax(), right);
+			if (x1 > x2)
+				continue;
+
+			int32 y1 = max_c(baseRenderer.ymin(), top);
+			int32 y2 = min_c(baseRenderer.ymax(), bottom);
+			if (y1 > y2)
+				continue;
+
+			// buffer offset into destination
+			uint8* dst = aggInterface.fBuffer.row_ptr(y1) + x1 * 4;
+
+			// x and y are needed as indices into the span arrays, so the
+			// offset into the target buffer needs to be compensated
+			const int32 xIndexL = x1 - left - indexOffsetX;
+			const int32 xIndexR = x2 - left - indexOffsetX;
+			y1 -= top + indexOffsetY;
+			y2 -= top + indexOffsetY;
+
+			// the sums cover the source columns of this clipping box only
+			const uint32 firstColumn = xSpans[xIndexL].index;
+			const uint32 columns = xSpans[xIndexR].index
+				+ xSpans[xIndexR].count - firstColumn;
+			const int32 count = xIndexR - xIndexL + 1;
+
+			BStackOrHeapArray<uint32, 1024> sums(columns * 4);
+			BStackOrHeapArray<BoxSpan, 256> spans(count);
+			if (!sums.IsValid() || !spans.IsValid())
+				return;
+
+			for (int32 i = 0; i < count; i++) {
+				spans[i].index = xSpans[xIndexL + i].index - firstColumn;
+				spans[i].count = xSpans[xIndexL + i].count;
+			}
+
+			for (; y1 <= y2; y1++) {
+				const BoxSpan& rows = ySpans[y1];
+
+				memset(sums, 0, columns * 4 * sizeof(uint32));
+				for (uint32 y = 0; y < rows.count; y++) {
+					functions->box_accumulate(sums,
+						bitmap.row_ptr(rows.index + y) + firstColumn * 4,
+						columns);
+				}
+
+				functions->box_resolve(dst, sums, spans, count, rows.count);
+				dst += dstBPR;
+			}
+		} while (baseRenderer.next_clip_box());
+	}
+
+private:
+	static void
+	_CalculateSpans(BoxSpan* spans, uint32 count, uint32 indexOffset,
+		double scale, int32 bitmapShift, uint32 bitmapSize)
+	{
+		// the end of the box is the start of the next one, which might be
+		// beyond the bitmap for the last box
+		uint32 start = (uint32)(indexOffset / scale) + bitmapShift;
+		for (uint32 i = 0; i < count; i++) {
+			uint32 end = (uint32)((i + indexOffset + 1) / scale)
+				+ bitmapShift;
+			if (end > bitmapSize)
+				end = bitmapSize;
+			if (start >= end)
+				start = end - 1;
+
+			spans[i].index = start;
+			spans[i].count = end - start;
+			start = end;
+		}
+	}
+};
+
+
+} // namespace BitmapPainterPrivate
+
+
+#endif // DRAW_BITMAP_BOX_FILTER_H
@@ -0,0 +1,94 @@
+/*
+ * Copyright 2026, Haiku, Inc. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ *
+ * AVX2 versions of the span functions in DrawingModeSIMDKernels.h.
+ *
+ */
+
+#include "DrawingModeSIMD.h"
+
+#include "DrawingMode.h"
+
+
+#ifdef PAINTER_SIMD_SPANS
+
+// Only what follows may use AVX2; the rest of the app_server must still run
+// on CPUs without it.
+#pragma GCC push_options
+#pragma GCC target("avx2")
+
+#include <immintrin.h>
+
+#include "DrawingModeSIMDKernels.h"
+
+
+struct AVX2 {
+	typedef __m256i vector;
+
+	enum {
+		kPixels = 8
+	};
+
+	static const uint32 kAllLanes = 0xffffffff;
+
+	static inline vector Load(const void* p)
+		{ return _mm256_loadu_si256((const __m256i*)p); }
+	static inline void Store(void* p, vector v)
+		{ _mm256_storeu_si256((__m256i*)p, v); }
+
+	static inline vector LoadCovers(const uint8* covers)
+	{
+		return _mm256_cvtepu8_epi32(
+			_mm_loadl_epi64((const __m128i*)covers));
+	}
+
+	static inline vector Zero()
+		{ return _mm256_setzero_si256(); }
+	static inline vector Set16(uint16 value)
+		{ return _mm256_set1_epi16(value); }
+	static inline vector Set32(uint32 value)
+		{ return _mm256_set1_epi32(value); }
+
+	static inline vector And(vector a, vector b)
+		{ return _mm256_and_si256(a, b); }
+	static inline vector AndNot(vector a, vector b)
+		{ return _mm256_andnot_si256(a, b); }
+	static inline vector Or(vector a, vector b)
+		{ return _mm256_or_si256(a, b); }
+	static inline vector CmpEq32(vector a, vector b)
+		{ return _mm256_cmpeq_epi32(a, b); }
+
+	static inline vector ShiftLeft32(vector v, int bits)
+		{ return _mm256_slli_epi32(v, bits); }
+	static inline vector ShiftRight32(vector v, int bits)
+		{ return _mm256_srli_epi32(v, bits); }
+	static inline vector ShiftRight16(vector v, int bits)
+		{ return _mm256_srli_epi16(v, bits); }
+
+	static inline vector UnpackLow8(vector a, vector b)
+		{ return _mm256_unpacklo_epi8(a, b); }
+	static inline vector UnpackHigh8(vector a, vector b)
+		{ return _mm256_unpackhi_epi8(a, b); }
+	static inline vector Pack16(vector a, vector b)
+		{ return _mm256_packus_epi16(a, b); }
+
+	static inline vector Add16(vector a, vector b)
+		{ return _mm256_add_epi16(a, b); }
+	static inline vector Sub16(vector a, vector b)
+		{ return _mm256_sub_epi16(a, b); }
+	static inline vector MulLow16(vector a, vector b)
+		{ return _mm256_mullo_epi16(a, b); }
+	static inline vector MulHigh16(vector a, vector b)
+		{ return _mm256_mulhi_epu16(a, b); }
+
+	static inline uint32 MoveMask(vector v)
+		{ return _mm256_movemask_epi8(v); }
+};
+
+
+const simd_span_functions gSpanFunctionsAVX2 = SIMD_SPAN_FUNCTIONS(AVX2);
+
+#pragma GCC pop_options
+
+#endif	// PAINTER_SIMD_SPANS
@@ -0,0 +1,50 @@
+/*
+ * Copyright 2026, Haiku, Inc. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ *
+ * Vectorized span functions for the most used drawing modes on B_RGBA32.
+ *
+ */
+
+#ifndef DRAWING_MODE_SIMD_H
+#define DRAWING_MODE_SIMD_H
+
+#include "PixelFormat.h"
+
+
+#if (defined(__i386__) || defined(__x86_64__)) && __GNUC__ >= 4
+#	define PAINTER_SIMD_SPANS 1
+#endif
+
+
+// The SIMD versions only replace the span functions of the solid pattern
+// variants of B_OP_OVER, B_OP_COPY and B_OP_ALPHA (B_PIXEL_ALPHA,
+// B_ALPHA_COMPOSITE), since those are hit for nearly everything the
+// interface kit draws. They produce exactly the same pixels as the scalar
+// versions in DrawingModeOverSolid.h, DrawingModeCopySolid.h and
+// DrawingModeAlphaPCSolid.h.
+struct simd_span_functions {
+	PixelFormat::blend_line			hline_over_solid;
+	PixelFormat::blend_solid_span	solid_hspan_over_solid;
+	PixelFormat::blend_color_span	color_hspan_over;
+
+	PixelFormat::blend_line			hline_copy_solid;
+	PixelFormat::blend_solid_span	solid_hspan_copy_solid;
+	PixelFormat::blend_color_span	color_hspan_copy_solid;
+
+	PixelFormat::blend_line			hline_alpha_pc_solid;
+	PixelFormat::blend_solid_span	solid_hspan_alpha_pc_solid;
+	PixelFormat::blend_color_span	color_hspan_alpha_pc;
+};
+
+
+#ifdef PAINTER_SIMD_SPANS
+extern const simd_span_functions gSpanFunctionsSSE2;
+extern const simd_span_functions gSpanFunctionsAVX2;
+#endif
+
+
+const simd_span_functions* simd_span_functions_for(uint32 simdFlags);
+
+
+#endif // DRAWING_MODE_SIMD_H
@@ -0,0 +1,401 @@
+/*
+ * Copyright 2026, Haiku, Inc. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ *
+ * Span functions for B_OP_OVER, B_OP_COPY and B_OP_ALPHA on B_RGBA32,
+ * written against a small set of vector operations, so that they can be
+ * instantiated for every instruction set we care about.
+ *
+ */
+
+#ifndef DRAWING_MODE_SIMD_KERNELS_H
+#define DRAWING_MODE_SIMD_KERNELS_H
+
+#include "DrawingMode.h"
+
+
+// The vector type V has to provide the following operations, working on
+// 32 bit B_RGBA32 pixels, or on their 8 bit channels unpacked to 16 bit:
+//
+//	vector		the vector type
+//	kPixels		the number of pixels that fit into a vector
+//	kAllLanes	the result of MoveMask() if all bytes were set
+//	Load(), Store(), LoadCovers() (which zero extends kPixels covers to
+//	32 bit), Zero(), Set16(), Set32(), And(), AndNot(), Or(), CmpEq32(),
+//	ShiftLeft32(), ShiftRight32(), ShiftRight16(), UnpackLow8(),
+//	UnpackHigh8(), Pack16() (with unsigned saturation), Add16(), Sub16(),
+//	MulLow16(), MulHigh16() (unsigned), and MoveMask().
+//
+// Unpacking and packing may work on lanes within the vector, as long as
+// Pack16() reverses what UnpackLow8() and UnpackHigh8() did.
+template<typename V>
+struct SIMDSpans {
+	typedef typename V::vector vector;
+
+	static inline uint32 PixelFor(uint8 r, uint8 g, uint8 b)
+	{
+		return b | (g << 8) | (r << 16) | 0xff000000;
+	}
+
+	static inline vector Select(vector mask, vector a, vector b)
+	{
+		return V::Or(V::And(mask, a), V::AndNot(mask, b));
+	}
+
+	// Turns agg::rgba8 colors into opaque B_RGBA32 pixels.
+	static inline vector PixelsFor(vector rgba)
+	{
+		vector rb = V::And(rgba, V::Set32(0x00ff00ff));
+		vector ga = V::And(rgba, V::Set32(0x0000ff00));
+		return V::Or(V::Or(ga, V::Set32(0xff000000)),
+			V::Or(V::ShiftLeft32(rb, 16), V::ShiftRight32(rb, 16)));
+	}
+
+	// Does what BLEND() does for every pixel. The alpha values (0..255) are
+	// expected in the lowest byte of each 32 bit lane.
+	// Since ((s - d) * a + (d << 8)) >> 8 == (d * (256 - a) + s * a) >> 8,
+	// and the latter never leaves the range of an unsigned 16 bit value,
+	// this produces exactly the same result.
+	static inline vector Blend(vector dst, vector src, vector alpha)
+	{
+		vector zero = V::Zero();
+		vector full = V::Set16(256);
+
+		alpha = V::Or(alpha, V::ShiftLeft32(alpha, 8));
+		alpha = V::Or(alpha, V::ShiftLeft32(alpha, 16));
+
+		vector a = V::UnpackLow8(alpha, zero);
+		vector low = V::Add16(
+			V::MulLow16(V::UnpackLow8(dst, zero), V::Sub16(full, a)),
+			V::MulLow16(V::UnpackLow8(src, zero), a));
+
+		a = V::UnpackHigh8(alpha, zero);
+		vector high = V::Add16(
+			V::MulLow16(V::UnpackHigh8(dst, zero), V::Sub16(full, a)),
+			V::MulLow16(V::UnpackHigh8(src, zero), a));
+
+		return V::Or(V::Pack16(V::ShiftRight16(low, 8),
+			V::ShiftRight16(high, 8)), V::Set32(0xff000000));
+	}
+
+	// Blends the opaque pixels in src over dst like BLEND_OVER() and
+	// ASSIGN_OVER(): pixels with a cover of 255 are replaced, pixels without
+	// cover, or those set in skip, are left alone.
+	static inline vector BlendOver(vector dst, vector src, vector cover,
+		vector skip)
+	{
+		skip = V::Or(skip, V::CmpEq32(cover, V::Zero()));
+		vector opaque = V::CmpEq32(cover, V::Set32(255));
+
+		vector result = Select(opaque, src, Blend(dst, src, cover));
+		return Select(skip, dst, result);
+	}
+
+	// Does what BLEND_ALPHA_PC() and ASSIGN_ALPHA_PC() do, but only if the
+	// fast path of BLEND_COMPOSITE() applies to all pixels that need to be
+	// blended. Returns false otherwise, and leaves dst untouched.
+	static inline bool BlendComposite(vector& dst, vector src,
+		vector colorAlpha, vector cover)
+	{
+		vector alpha = V::MulLow16(colorAlpha, cover);
+		vector skip = V::CmpEq32(alpha, V::Zero());
+		vector opaque = V::CmpEq32(alpha, V::Set32(255 * 255));
+		vector opaqueDst = V::CmpEq32(V::ShiftRight32(dst, 24),
+			V::Set32(255));
+		if (V::MoveMask(V::Or(V::Or(skip, opaque), opaqueDst))
+				!= V::kAllLanes) {
+			return false;
+		}
+
+		// alpha / 255, exact for all 16 bit values
+		alpha = V::ShiftRight16(V::MulHigh16(alpha, V::Set32(0x8081)), 7);
+
+		vector result = Select(opaque, src, Blend(dst, src, alpha));
+		dst = Select(skip, dst, result);
+		return true;
+	}
+
+	static inline void BlendOverPixel(uint8* p, uint8 r, uint8 g, uint8 b,
+		uint8 cover)
+	{
+		if (cover == 255)
+			*(uint32*)p = PixelFor(r, g, b);
+		else
+			BLEND(p, r, g, b, cover);
+	}
+
+	static inline void BlendCompositePixel(uint8* p, uint8 r, uint8 g,
+		uint8 b, uint16 alpha)
+	{
+		if (alpha == 0)
+			return;
+
+		if (alpha == 255 * 255)
+			*(uint32*)p = PixelFor(r, g, b);
+		else
+			BLEND_COMPOSITE16(p, r, g, b, alpha);
+	}
+
+	// #pragma mark - B_OP_OVER, B_OP_COPY
+
+	static void HLineSolid(int x, int y, unsigned len, const color_type& c,
+		uint8 cover, agg_buffer* buffer)
+	{
+		uint8* p = buffer->row_ptr(y) + (x << 2);
+		vector src = V::Set32(PixelFor(c.r, c.g, c.b));
+
+		if (cover == 255) {
+			for (; len >= V::kPixels; len -= V::kPixels) {
+				V::Store(p, src);
+				p += V::kPixels * 4;
+			}
+		} else {
+			vector alpha = V::Set32(cover);
+			for (; len >= V::kPixels; len -= V::kPixels) {
+				V::Store(p, Blend(V::Load(p), src, alpha));
+				p += V::kPixels * 4;
+			}
+		}
+
+		for (; len > 0; len--) {
+			BlendOverPixel(p, c.r, c.g, c.b, cover);
+			p += 4;
+		}
+	}
+
+	static void SolidHSpan(int x, int y, unsigned len, const color_type& c,
+		const uint8* covers, agg_buffer* buffer)
+	{
+		uint8* p = buffer->row_ptr(y) + (x << 2);
+		vector src = V::Set32(PixelFor(c.r, c.g, c.b));
+
+		for (; len >= V::kPixels; len -= V::kPixels) {
+			vector cover = V::LoadCovers(covers);
+			V::Store(p, BlendOver(V::Load(p), src, cover, V::Zero()));
+			covers += V::kPixels;
+			p += V::kPixels * 4;
+		}
+
+		for (; len > 0; len--) {
+			if (*covers)
+				BlendOverPixel(p, c.r, c.g, c.b, *covers);
+			covers++;
+			p += 4;
+		}
+	}
+
+	template<bool kSkipTransparent>
+	static void ColorHSpan(int x, int y, unsigned len,
+		const color_type* colors, const uint8* covers, uint8 cover,
+		agg_buffer* buffer)
+	{
+		if (covers == NULL && cover == 0)
+			return;
+
+		uint8* p = buffer->row_ptr(y) + (x << 2);
+		vector solidCover = V::Set32(cover);
+
+		for (; len >= V::kPixels; len -= V::kPixels) {
+			vector rgba = V::Load(colors);
+			vector skip = V::Zero();
+			if (kSkipTransparent)
+				skip = V::CmpEq32(V::ShiftRight32(rgba, 24), V::Zero());
+
+			vector c = solidCover;
+			if (covers != NULL) {
+				c = V::LoadCovers(covers);
+				covers += V::kPixels;
+			}
+
+			V::Store(p, BlendOver(V::Load(p), PixelsFor(rgba), c, skip));
+			colors += V::kPixels;
+			p += V::kPixels * 4;
+		}
+
+		for (; len > 0; len--) {
+			uint8 pixelCover = covers != NULL ? *covers++ : cover;
+			if (pixelCover != 0 && (!kSkipTransparent || colors->a > 0))
+				BlendOverPixel(p, colors->r, colors->g, colors->b, pixelCover);
+			colors++;
+			p += 4;
+		}
+	}
+
+	static void blend_hline_over_solid(int x, int y, unsigned len,
+		const color_type& c, uint8 cover, agg_buffer* buffer,
+		const PatternHandler* pattern)
+	{
+		if (pattern->IsSolidLow())
+			return;
+
+		HLineSolid(x, y, len, c, cover, buffer);
+	}
+
+	static void blend_solid_hspan_over_solid(int x, int y, unsigned len,
+		const color_type& c, const uint8* covers, agg_buffer* buffer,
+		const PatternHandler* pattern)
+	{
+		if (pattern->IsSolidLow())
+			return;
+
+		SolidHSpan(x, y, len, c, covers, buffer);
+	}
+
+	static void blend_color_hspan_over(int x, int y, unsigned len,
+		const color_type* colors, const uint8* covers, uint8 cover,
+		agg_buffer* buffer, const PatternHandler* pattern)
+	{
+		ColorHSpan<true>(x, y, len, colors, covers, cover, buffer);
+	}
+
+	static void blend_hline_copy_solid(int x, int y, unsigned len,
+		const color_type& c, uint8 cover, agg_buffer* buffer,
+		const PatternHandler* pattern)
+	{
+		HLineSolid(x, y, len, c, cover, buffer);
+	}
+
+	static void blend_solid_hspan_copy_solid(int x, int y, unsigned len,
+		const color_type& c, const uint8* covers, agg_buffer* buffer,
+		const PatternHandler* pattern)
+	{
+		SolidHSpan(x, y, len, c, covers, buffer);
+	}
+
+	static void blend_color_hspan_copy_solid(int x, int y, unsigned len,
+		const color_type* colors, const uint8* covers, uint8 cover,
+		agg_buffer* buffer, const PatternHandler* pattern)
+	{
+		ColorHSpan<false>(x, y, len, colors, covers, cover, buffer);
+	}
+
+	// #pragma mark - B_OP_ALPHA, B_PIXEL_ALPHA, B_ALPHA_COMPOSITE
+
+	static void blend_hline_alpha_pc_solid(int x, int y, unsigned len,
+		const color_type& c, uint8 cover, agg_buffer* buffer,
+		const PatternHandler* pattern)
+	{
+		uint16 alpha = c.a * cover;
+		if (alpha == 0)
+			return;
+
+		uint8* p = buffer->row_ptr(y) + (x << 2);
+		vector src = V::Set32(PixelFor(c.r, c.g, c.b));
+		vector colorAlpha = V::Set32(c.a);
+		vector solidCover = V::Set32(cover);
+
+		for (; len >= V::kPixels; len -= V::kPixels) {
+			vector dst = V::Load(p);
+			if (BlendComposite(dst, src, colorAlpha, solidCover))
+				V::Store(p, dst);
+			else {
+				for (int32 i = 0; i < V::kPixels; i++)
+					BlendCompositePixel(p + i * 4, c.r, c.g, c.b, alpha);
+			}
+			p += V::kPixels * 4;
+		}
+
+		for (; len > 0; len--) {
+			BlendCompositePixel(p, c.r, c.g, c.b, alpha);
+			p += 4;
+		}
+	}
+
+	static void blend_solid_hspan_alpha_pc_solid(int x, int y, unsigned len,
+		const color_type& c, const uint8* covers, agg_buffer* buffer,
+		const PatternHandler* pattern)
+	{
+		uint8* p = buffer->row_ptr(y) + (x << 2);
+		vector src = V::Set32(PixelFor(c.r, c.g, c.b));
+		vector colorAlpha = V::Set32(c.a);
+
+		for (; len >= V::kPixels; len -= V::kPixels) {
+			vector dst = V::Load(p);
+			if (BlendComposite(dst, src, colorAlpha, V::LoadCovers(covers)))
+				V::Store(p, dst);
+			else {
+				for (int32 i = 0; i < V::kPixels; i++) {
+					BlendCompositePixel(p + i * 4, c.r, c.g, c.b,
+						c.a * covers[i]);
+				}
+			}
+			covers += V::kPixels;
+			p += V::kPixels * 4;
+		}
+
+		for (; len > 0; len--) {
+			BlendCompositePixel(p, c.r, c.g, c.b, c.a * *covers);
+			covers++;
+			p += 4;
+		}
+	}
+
+	static void blend_color_hspan_alpha_pc(int x, int y, unsigned len,
+		const color_type* colors, const uint8* covers, uint8 cover,
+		agg_buffer* buffer, const PatternHandler* pattern)
+	{
+		uint8* p = buffer->row_ptr(y) + (x << 2);
+
+		// Without covers, the scalar version uses the alpha of the first
+		// color for the whole span; we need to do the same.
+		uint16 solidAlpha = colors->a * cover;
+		if (covers == NULL && solidAlpha == 0)
+			return;
+
+		vector solidColorAlpha = V::Set32(colors->a);
+		vector solidCover = V::Set32(cover);
+
+		for (; len >= V::kPixels; len -= V::kPixels) {
+			vector rgba = V::Load(colors);
+			vector colorAlpha = solidColorAlpha;
+			vector c = solidCover;
+			if (covers != NULL) {
+				colorAlpha = V::ShiftRight32(rgba, 24);
+				c = V::LoadCovers(covers);
+			}
+
+			vector dst = V::Load(p);
+			if (BlendComposite(dst, PixelsFor(rgba), colorAlpha, c))
+				V::Store(p, dst);
+			else {
+				for (int32 i = 0; i < V::kPixels; i++) {
+					uint16 alpha = covers != NULL
+						? colors[i].a * covers[i] : solidAlpha;
+					BlendCompositePixel(p + i * 4, colors[i].r, colors[i].g,
+						colors[i].b, alpha);
+				}
+			}
+
+			if (covers != NULL)
+				covers += V::kPixels;
+			colors += V::kPixels;
+			p += V::kPixels * 4;
+		}
+
+		for (; len > 0; len--) {
+			uint16 alpha = covers != NULL ? colors->a * *covers++ : solidAlpha;
+			BlendCompositePixel(p, colors->r, colors->g, colors->b, alpha);
+			colors++;
+			p += 4;
+		}
+	}
+};
+
+
+#define SIMD_SPAN_FUNCTIONS(V) \
+{ \
+	SIMDSpans<V>::blend_hline_over_solid, \
+	SIMDSpans<V>::blend_solid_hspan_over_solid, \
+	SIMDSpans<V>::blend_color_hspan_over, \
+\
+	SIMDSpans<V>::blend_hline_copy_solid, \
+	SIMDSpans<V>::blend_solid_hspan_copy_solid, \
+	SIMDSpans<V>::blend_color_hspan_copy_solid, \
+\
+	SIMDSpans<V>::blend_hline_alpha_pc_solid, \
+	SIMDSpans<V>::blend_solid_hspan_alpha_pc_solid, \
+	SIMDSpans<V>::blend_color_hspan_alpha_pc \
+}
+
+
+#endif // DRAWING_MODE_SIMD_KERNELS_H
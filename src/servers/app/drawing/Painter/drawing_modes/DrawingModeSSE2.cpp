@@ -0,0 +1,100 @@
+/*
+ * Copyright 2026, Haiku, Inc. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ *
+ * SSE2 versions of the span functions in DrawingModeSIMDKernels.h.
+ *
+ */
+
+#include "DrawingModeSIMD.h"
+
+#include <string.h>
+
+#include "DrawingMode.h"
+
+
+#ifdef PAINTER_SIMD_SPANS
+
+// Only what follows may use SSE2; on x86 the rest of the app_server must
+// still run on CPUs without it.
+#pragma GCC push_options
+#pragma GCC target("sse2")
+
+#include <emmintrin.h>
+
+#include "DrawingModeSIMDKernels.h"
+
+
+struct SSE2 {
+	typedef __m128i vector;
+
+	enum {
+		kPixels = 4
+	};
+
+	static const uint32 kAllLanes = 0xffff;
+
+	static inline vector Load(const void* p)
+		{ return _mm_loadu_si128((const __m128i*)p); }
+	static inline void Store(void* p, vector v)
+		{ _mm_storeu_si128((__m128i*)p, v); }
+
+	static inline vector LoadCovers(const uint8* covers)
+	{
+		uint32 value;
+		memcpy(&value, covers, sizeof(value));
+
+		vector zero = Zero();
+		return _mm_unpacklo_epi16(
+			_mm_unpacklo_epi8(_mm_cvtsi32_si128(value), zero), zero);
+	}
+
+	static inline vector Zero()
+		{ return _mm_setzero_si128(); }
+	static inline vector Set16(uint16 value)
+		{ return _mm_set1_epi16(value); }
+	static inline vector Set32(uint32 value)
+		{ return _mm_set1_epi32(value); }
+
+	static inline vector And(vector a, vector b)
+		{ return _mm_and_si128(a, b); }
+	static inline vector AndNot(vector a, vector b)
+		{ return _mm_andnot_si128(a, b); }
+	static inline vector Or(vector a, vector b)
+		{ return _mm_or_si128(a, b); }
+	static inline vector CmpEq32(vector a, vector b)
+		{ return _mm_cmpeq_epi32(a, b); }
+
+	static inline vector ShiftLeft32(vector v, int bits)
+		{ return _mm_slli_epi32(v, bits); }
+	static inline vector ShiftRight32(vector v, int bits)
+		{ return _mm_srli_epi32(v, bits); }
+	static inline vector ShiftRight16(vector v, int bits)
+		{ return _mm_srli_epi16(v, bits); }
+
+	static inline vector UnpackLow8(vector a, vector b)
+		{ return _mm_unpacklo_epi8(a, b); }
+	static inline vector UnpackHigh8(vector a, vector b)
+		{ return _mm_unpackhi_epi8(a, b); }
+	static inline vector Pack16(vector a, vector b)
+		{ return _mm_packus_epi16(a, b); }
+
+	static inline vector Add16(vector a, vector b)
+		{ return _mm_add_epi16(a, b); }
+	static inline vector Sub16(vector a, vector b)
+		{ return _mm_sub_epi16(a, b); }
+	static inline vector MulLow16(vector a, vector b)
+		{ return _mm_mullo_epi16(a, b); }
+	static inline vector MulHigh16(vector a, vector b)
+		{ return _mm_mulhi_epu16(a, b); }
+
+	static inline uint32 MoveMask(vector v)
+		{ return _mm_movemask_epi8(v); }
+};
+
+
+const simd_span_functions gSpanFunctionsSSE2 = SIMD_SPAN_FUNCTIONS(SSE2);
+
+#pragma GCC pop_options
+
+#endif	// PAINTER_SIMD_SPANS
@@ -54,7 +54,9 @@
 #include "DrawingModeSelectSUBPIX.h"
 #include "DrawingModeSubtractSUBPIX.h"
 
+#include "DrawingModeSIMD.h"
 #include "PatternHandler.h"
+#include "SIMDFlags.h"
 
 // blend_pixel_empty
 void
@@ -130,6 +132,19 @@ blend_color_vspan_empty(int x, int y, unsigned len,
 	printf("blend_color_vspan_empty()\n");
 }
 
+// simd_span_functions_for
+const simd_span_functions*
+simd_span_functions_for(uint32 simdFlags)
+{
+#ifdef PAINTER_SIMD_SPANS
+	if ((simdFlags & APPSERVER_SIMD_AVX2) != 0)
+		return &gSpanFunctionsAVX2;
+	if ((simdFlags & APPSERVER_SIMD_SSE2) != 0)
+		return &gSpanFunctionsSSE2;
+#endif
+	return NULL;
+}
+
 // #pragma mark -
 
 // constructor
@@ -159,6 +174,8 @@ void
 PixelFormat::SetDrawingMode(drawing_mode mode, source_alpha alphaSrcMode,
 							alpha_function alphaFncMode)
 {
+	const simd_span_functions* simd = simd_span_functions_for(gSIMDFlags);
+
 	switch (mode) {
 		// These drawing modes discard source pixels
 		// which have the current low color.
@@ -169,6 +186,10 @@ PixelFormat::SetDrawingMode(drawing_mode mode, source_alpha alphaSrcMode,
 				fBlendSolidHSpan = blend_solid_hspan_over_solid;
 				fBlendSolidVSpan = blend_solid_vspan_over_solid;
 				fBlendSolidHSpanSubpix = blend_solid_hspan_over_solid_subpix;
+				if (simd != NULL) {
+					fBlendHLine = simd->hline_over_solid;
+					fBlendSolidHSpan = simd->solid_hspan_over_solid;
+				}
 			} else {
 				fBlendPixel = blend_pixel_over;
 				fBlendHLine = blend_hline_over;
@@ -177,6 +198,8 @@ PixelFormat::SetDrawingMode(drawing_mode mode, source_alpha alphaSrcMode,
 				fBlendSolidVSpan = blend_solid_vspan_over;
 			}
 			fBlendColorHSpan = blend_color_hspan_over;
+			if (simd != NULL)
+				fBlendColorHSpan = simd->color_hspan_over;
 			break;
 		case B_OP_ERASE:
 			fBlendPixel = blend_pixel_erase;
@@ -213,6 +236,11 @@ PixelFormat::SetDrawingMode(drawing_mode mode, source_alpha alphaSrcMode,
 				fBlendSolidHSpan = blend_solid_hspan_copy_solid;
 				fBlendSolidVSpan = blend_solid_vspan_copy_solid;
 				fBlendColorHSpan = blend_color_hspan_copy_solid;
+				if (simd != NULL) {
+					fBlendHLine = simd->hline_copy_solid;
+					fBlendSolidHSpan = simd->solid_hspan_copy_solid;
+					fBlendColorHSpan = simd->color_hspan_copy_solid;
+				}
 			} else {
 				fBlendPixel = blend_pixel_copy;
 				fBlendHLine = blend_hline_copy;
@@ -320,6 +348,10 @@ PixelFormat::SetDrawingMode(drawing_mode mode, source_alpha alphaSrcMode,
 						fBlendSolidHSpan = blend_solid_hspan_alpha_pc_solid;
 						fBlendSolidVSpan = blend_solid_vspan_alpha_pc_solid;
 						fBlendColorHSpan = blend_color_hspan_alpha_pc_solid;
+						if (simd != NULL) {
+							fBlendHLine = simd->hline_alpha_pc_solid;
+							fBlendSolidHSpan = simd->solid_hspan_alpha_pc_solid;
+						}
 					} else {
 						fBlendPixel = blend_pixel_alpha_pc;
 						fBlendHLine = blend_hline_alpha_pc;
@@ -328,6 +360,8 @@ PixelFormat::SetDrawingMode(drawing_mode mode, source_alpha alphaSrcMode,
 						fBlendSolidVSpan = blend_solid_vspan_alpha_pc;
 						fBlendColorHSpan = blend_color_hspan_alpha_pc;
 					}
+					if (simd != NULL)
+						fBlendColorHSpan = simd->color_hspan_alpha_pc;
 				} else if (alphaFncMode == B_ALPHA_COMPOSITE_SOURCE_IN) {
 					SetAggCompOpAdapter<alpha_src_in>();
 				} else if (alphaFncMode == B_ALPHA_COMPOSITE_SOURCE_OUT) {
@@ -0,0 +1,246 @@
+/*
+ * Copyright 2026, Haiku, Inc.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+#include "TileWorkerPool.h"
+
+#include <new>
+
+#include <pthread.h>
+#include <stdio.h>
+
+#include <algorithm>
+
+#include "Painter.h"
+#include "RenderingBuffer.h"
+
+
+static const int32 kMaxWorkers = 15;
+static const int32 kTilesPerThread = 4;
+	// more tiles than threads, so that threads that finish early can help
+	// out with the rest
+static const int32 kMinTileHeight = 16;
+
+static TileWorkerPool* sDefaultPool = NULL;
+static pthread_once_t sDefaultPoolInitOnce = PTHREAD_ONCE_INIT;
+
+
+static void
+init_default_pool()
+{
+	system_info info;
+	if (get_system_info(&info) != B_OK || info.cpu_count < 2)
+		return;
+
+	// the thread calling Run() draws tiles as well
+	int32 count = std::min((int32)info.cpu_count - 1, kMaxWorkers);
+
+	TileWorkerPool* pool = new(std::nothrow) TileWorkerPool(count);
+	if (pool != NULL && pool->InitCheck() != B_OK) {
+		delete pool;
+		return;
+	}
+
+	sDefaultPool = pool;
+}
+
+
+// #pragma mark -
+
+
+TileWorkerPool::Job::~Job()
+{
+}
+
+
+// #pragma mark -
+
+
+TileWorkerPool::TileWorkerPool(int32 workerCount)
+	:
+	fWorkers(NULL),
+	fWorkerCount(0),
+	fDoneSem(-1),
+	fBusy(0),
+	fQuitting(false),
+	fJob(NULL),
+	fClipping(NULL),
+	fTileHeight(0),
+	fTileCount(0),
+	fNextTile(0)
+{
+	fDoneSem = create_sem(0, "tile workers done");
+	if (fDoneSem < 0)
+		return;
+
+	fWorkers = new(std::nothrow) Worker[workerCount];
+	if (fWorkers == NULL)
+		return;
+
+	for (int32 i = 0; i < workerCount; i++) {
+		Worker& worker = fWorkers[i];
+		worker.pool = this;
+		worker.painter = new(std::nothrow) Painter();
+		if (worker.painter == NULL)
+			break;
+
+		// Each worker has its own semaphore, so that Run() only wakes up
+		// the workers it prepared the painter of
+		worker.startSem = create_sem(0, "tile worker start");
+		if (worker.startSem < 0) {
+			delete worker.painter;
+			break;
+		}
+
+		char name[B_OS_NAME_LENGTH];
+		snprintf(name, sizeof(name), "tile worker %" B_PRId32, i);
+		worker.thread = spawn_thread(&_WorkerThread, name, B_DISPLAY_PRIORITY,
+			&worker);
+		if (worker.thread < 0) {
+			delete_sem(worker.startSem);
+			delete worker.painter;
+			break;
+		}
+
+		resume_thread(worker.thread);
+		fWorkerCount++;
+	}
+}
+
+
+TileWorkerPool::~TileWorkerPool()
+{
+	fQuitting = true;
+	for (int32 i = 0; i < fWorkerCount; i++)
+		delete_sem(fWorkers[i].startSem);
+	delete_sem(fDoneSem);
+
+	for (int32 i = 0; i < fWorkerCount; i++) {
+		status_t result;
+		wait_for_thread(fWorkers[i].thread, &result);
+		delete fWorkers[i].painter;
+	}
+
+	delete[] fWorkers;
+}
+
+
+status_t
+TileWorkerPool::InitCheck() const
+{
+	if (fDoneSem < 0)
+		return fDoneSem;
+
+	return fWorkerCount > 0 ? B_OK : B_NO_MEMORY;
+}
+
+
+/*static*/ TileWorkerPool*
+TileWorkerPool::Default()
+{
+	pthread_once(&sDefaultPoolInitOnce, &init_default_pool);
+	return sDefaultPool;
+}
+
+
+/*!	Draws \a job into \a buffer, which \a painter needs to be attached to.
+	The state and clipping of \a painter are used for all tiles; only
+	the part of the clipping within \a area is drawn.
+*/
+status_t
+TileWorkerPool::Run(Painter* painter, RenderingBuffer* buffer,
+	const clipping_rect& area, Job& job)
+{
+	if (atomic_test_and_set(&fBusy, 1, 0) != 0)
+		return B_BUSY;
+
+	int32 height = area.bottom - area.top + 1;
+	int32 tileCount = std::min((fWorkerCount + 1) * kTilesPerThread,
+		(height + kMinTileHeight - 1) / kMinTileHeight);
+	if (tileCount < 2) {
+		atomic_set(&fBusy, 0);
+		return B_BAD_VALUE;
+	}
+
+	fJob = &job;
+	fClipping = painter->ClippingRegion();
+	fArea = area;
+	fTileHeight = (height + tileCount - 1) / tileCount;
+	fTileCount = tileCount;
+	fNextTile = 0;
+
+	// the workers only need to be woken up for tiles the caller won't get,
+	// and only those whose painter is prepared may be
+	int32 workerCount = std::min(fWorkerCount, tileCount - 1);
+	for (int32 i = 0; i < workerCount; i++) {
+		fWorkers[i].painter->AttachToBuffer(buffer);
+		fWorkers[i].painter->SetStateFrom(*painter);
+	}
+
+	for (int32 i = 0; i < workerCount; i++)
+		release_sem_etc(fWorkers[i].startSem, 1, B_DO_NOT_RESCHEDULE);
+
+	BRegion clipping;
+	_DrawTiles(painter, clipping);
+	painter->ConstrainClipping(fClipping);
+
+	while (acquire_sem_etc(fDoneSem, workerCount, 0, 0) == B_INTERRUPTED)
+		;
+
+	fJob = NULL;
+	fClipping = NULL;
+
+	atomic_set(&fBusy, 0);
+	return B_OK;
+}
+
+
+/*static*/ status_t
+TileWorkerPool::_WorkerThread(void* data)
+{
+	Worker* worker = (Worker*)data;
+	TileWorkerPool* pool = worker->pool;
+
+	while (true) {
+		status_t status = acquire_sem(worker->startSem);
+		if (status == B_INTERRUPTED)
+			continue;
+		if (status != B_OK || pool->fQuitting)
+			break;
+
+		pool->_DrawTiles(worker->painter, worker->clipping);
+		release_sem_etc(pool->fDoneSem, 1, B_DO_NOT_RESCHEDULE);
+	}
+
+	return B_OK;
+}
+
+
+/*!	Draws tiles until there are none left. \a clipping must stay valid as
+	long as \a painter uses it.
+*/
+void
+TileWorkerPool::_DrawTiles(Painter* painter, BRegion& clipping)
+{
+	while (true) {
+		int32 index = atomic_add(&fNextTile, 1);
+		if (index >= fTileCount)
+			break;
+
+		clipping_rect tile = fArea;
+		tile.top += index * fTileHeight;
+		tile.bottom = std::min(tile.top + fTileHeight - 1, fArea.bottom);
+		if (tile.top > tile.bottom)
+			continue;
+
+		clipping.Set(tile);
+		clipping.IntersectWith(fClipping);
+		if (clipping.CountRects() == 0)
+			continue;
+
+		painter->ConstrainClipping(&clipping);
+		fJob->DrawTile(painter, tile);
+	}
+}
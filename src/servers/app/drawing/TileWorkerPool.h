@@ -0,0 +1,85 @@
+/*
+ * Copyright 2026, Haiku, Inc.
+ * Distributed under the terms of the MIT License.
+ */
+#ifndef TILE_WORKER_POOL_H
+#define TILE_WORKER_POOL_H
+
+
+#include <OS.h>
+#include <Region.h>
+
+
+class Painter;
+class RenderingBuffer;
+
+
+/*!	A pool of threads that draws large operations in parallel.
+
+	The area of an operation is cut into horizontal bands ("tiles"), and
+	each thread draws the tiles it picks up with its own Painter, clipped to
+	the intersection of the tile and the clipping of the calling painter.
+	Since BRegion rects are banded horizontally, the clipping of a tile
+	contains exactly the same spans as the full clipping, so the result is
+	the same as if the operation had been drawn by a single thread. Run()
+	only returns when all tiles are done, so the order of operations is
+	kept as well.
+
+	There is only one pool for all drawing engines; when it is already
+	in use, Run() returns \c B_BUSY, and the caller should draw the
+	operation itself.
+*/
+class TileWorkerPool {
+public:
+	class Job {
+	public:
+		virtual					~Job();
+
+		virtual	void			DrawTile(Painter* painter,
+									const clipping_rect& tile) = 0;
+	};
+
+								TileWorkerPool(int32 workerCount);
+								~TileWorkerPool();
+
+			status_t			InitCheck() const;
+
+	static	TileWorkerPool*		Default();
+
+			int32				CountWorkers() const
+									{ return fWorkerCount; }
+
+			status_t			Run(Painter* painter, RenderingBuffer* buffer,
+									const clipping_rect& area, Job& job);
+
+private:
+			struct Worker {
+				TileWorkerPool*	pool;
+				Painter*		painter;
+				BRegion			clipping;
+				sem_id			startSem;
+				thread_id		thread;
+			};
+
+	static	status_t			_WorkerThread(void* data);
+			void				_DrawTiles(Painter* painter,
+									BRegion& clipping);
+
+private:
+			Worker*				fWorkers;
+			int32				fWorkerCount;
+			sem_id				fDoneSem;
+			int32				fBusy;
+			bool				fQuitting;
+
+			// the job currently being drawn
+			Job*				fJob;
+			const BRegion*		fClipping;
+			clipping_rect		fArea;
+			int32				fTileHeight;
+			int32				fTileCount;
+			int32				fNextTile;
+};
+
+
+#endif // TILE_WORKER_POOL_H
@@ -0,0 +1,216 @@
+/*
+ * Copyright 2026, Haiku, Inc.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+/*!	Lossless compression of frame buffer tiles, using the operations of the
+	"Quite OK Image" format: runs of the previous pixel, references into a
+	table of 64 recently seen pixels, and small differences to the previous
+	pixel. This compresses screen content well, and is simple and fast
+	enough to be decoded in a browser.
+
+	The screen is opaque, so the alpha channel is not transferred. Pixels
+	are B_RGB32, the tile dimensions are not part of the encoded data.
+*/
+
+
+#include "FrameTileCodec.h"
+
+
+enum {
+	OP_INDEX	= 0x00,
+	OP_DIFF		= 0x40,
+	OP_LUMA		= 0x80,
+	OP_RUN		= 0xc0,
+	OP_RGB		= 0xfe,
+
+	OP_MASK		= 0xc0
+};
+
+static const int32 kMaxRun = 62;
+	// run lengths of 63 and 64 would collide with OP_RGB
+
+
+static inline uint32
+index_of(uint32 pixel)
+{
+	uint32 red = (pixel >> 16) & 0xff;
+	uint32 green = (pixel >> 8) & 0xff;
+	uint32 blue = pixel & 0xff;
+	return (red * 3 + green * 5 + blue * 7 + 255 * 11) % 64;
+}
+
+
+size_t
+frame_tile_max_encoded_size(int32 width, int32 height)
+{
+	// every pixel as an OP_RGB
+	return (size_t)width * height * 4;
+}
+
+
+/*!	Encodes the \a width x \a height pixels at \a bits into \a output, which
+	must have room for frame_tile_max_encoded_size() bytes. Returns the
+	number of bytes written.
+*/
+size_t
+encode_frame_tile(const uint8* bits, uint32 bytesPerRow, int32 width,
+	int32 height, uint8* output)
+{
+	uint32 index[64] = { 0 };
+	uint32 previous = 0xff000000;
+	int32 run = 0;
+	uint8* out = output;
+
+	for (int32 y = 0; y < height; y++) {
+		const uint32* row = (const uint32*)(bits + y * bytesPerRow);
+
+		for (int32 x = 0; x < width; x++) {
+			uint32 pixel = row[x] | 0xff000000;
+
+			if (pixel == previous) {
+				if (++run == kMaxRun) {
+					*out++ = OP_RUN | (run - 1);
+					run = 0;
+				}
+				continue;
+			}
+
+			if (run > 0) {
+				*out++ = OP_RUN | (run - 1);
+				run = 0;
+			}
+
+			uint32 hash = index_of(pixel);
+			if (index[hash] == pixel) {
+				*out++ = OP_INDEX | hash;
+				previous = pixel;
+				continue;
+			}
+			index[hash] = pixel;
+
+			int8 red = (int8)(((pixel >> 16) & 0xff)
+				- ((previous >> 16) & 0xff));
+			int8 green = (int8)(((pixel >> 8) & 0xff)
+				- ((previous >> 8) & 0xff));
+			int8 blue = (int8)((pixel & 0xff) - (previous & 0xff));
+			previous = pixel;
+
+			if (red >= -2 && red <= 1 && green >= -2 && green <= 1
+				&& blue >= -2 && blue <= 1) {
+				*out++ = OP_DIFF | (red + 2) << 4 | (green + 2) << 2
+					| (blue + 2);
+				continue;
+			}
+
+			int32 redGreen = red - green;
+			int32 blueGreen = blue - green;
+			if (green >= -32 && green <= 31 && redGreen >= -8 && redGreen <= 7
+				&& blueGreen >= -8 && blueGreen <= 7) {
+				*out++ = OP_LUMA | (green + 32);
+				*out++ = (redGreen + 8) << 4 | (blueGreen + 8);
+				continue;
+			}
+
+			*out++ = OP_RGB;
+			*out++ = (pixel >> 16) & 0xff;
+			*out++ = (pixel >> 8) & 0xff;
+			*out++ = pixel & 0xff;
+		}
+	}
+
+	if (run > 0)
+		*out++ = OP_RUN | (run - 1);
+
+	return out - output;
+}
+
+
+/*!	Decodes a tile encoded by encode_frame_tile() into the \a width x
+	\a height pixels at \a bits. Returns \c B_BAD_DATA if \a data does not
+	exactly describe a tile of that size.
+*/
+status_t
+decode_frame_tile(const uint8* data, size_t size, uint8* bits,
+	uint32 bytesPerRow, int32 width, int32 height)
+{
+	uint32 index[64] = { 0 };
+	uint32 pixel = 0xff000000;
+	int32 run = 0;
+	const uint8* end = data + size;
+
+	for (int32 y = 0; y < height; y++) {
+		uint32* row = (uint32*)(bits + y * bytesPerRow);
+
+		for (int32 x = 0; x < width; x++) {
+			if (run > 0) {
+				run--;
+				row[x] = pixel;
+				continue;
+			}
+
+			if (data >= end)
+				return B_BAD_DATA;
+
+			uint8 op = *data++;
+			if (op == OP_RGB) {
+				if (end - data < 3)
+					return B_BAD_DATA;
+
+				pixel = 0xff000000 | (uint32)data[0] << 16
+					| (uint32)data[1] << 8 | data[2];
+				data += 3;
+				index[index_of(pixel)] = pixel;
+			} else if ((op & OP_MASK) == OP_INDEX) {
+				pixel = index[op & 0x3f];
+			} else if ((op & OP_MASK) == OP_DIFF) {
+				uint32 red = ((pixel >> 16) + ((op >> 4) & 0x03) - 2) & 0xff;
+				uint32 green = ((pixel >> 8) + ((op >> 2) & 0x03) - 2) & 0xff;
+				uint32 blue = (pixel + (op & 0x03) - 2) & 0xff;
+				pixel = 0xff000000 | red << 16 | green << 8 | blue;
+				index[index_of(pixel)] = pixel;
+			} else if ((op & OP_MASK) == OP_LUMA) {
+				if (data >= end)
+					return B_BAD_DATA;
+
+				int32 green = (op & 0x3f) - 32;
+				int32 redGreen = (*data >> 4) - 8;
+				int32 blueGreen = (*data & 0x0f) - 8;
+				data++;
+
+				uint32 red = ((pixel >> 16) + green + redGreen) & 0xff;
+				uint32 blue = (pixel + green + blueGreen) & 0xff;
+				uint32 newGreen = ((pixel >> 8) + green) & 0xff;
+				pixel = 0xff000000 | red << 16 | newGreen << 8 | blue;
+				index[index_of(pixel)] = pixel;
+			} else {
+				// OP_RUN, this pixel is the first of the run
+				run = op & 0x3f;
+			}
+
+			row[x] = pixel;
+		}
+	}
+
+	return run == 0 && data == end ? B_OK : B_BAD_DATA;
+}
+
+
+/*!	Returns a hash of the visible contents of the tile, used to find tiles
+	that did not change, or that the client already has in its cache.
+*/
+uint64
+hash_frame_tile(const uint8* bits, uint32 bytesPerRow, int32 width,
+	int32 height)
+{
+	uint64 hash = 0xcbf29ce484222325ULL ^ ((uint64)width << 32 | height);
+
+	for (int32 y = 0; y < height; y++) {
+		const uint32* row = (const uint32*)(bits + y * bytesPerRow);
+		for (int32 x = 0; x < width; x++)
+			hash = (hash ^ (row[x] & 0x00ffffff)) * 0x100000001b3ULL;
+	}
+
+	return hash;
+}
@@ -0,0 +1,30 @@
+/*
+ * Copyright 2026, Haiku, Inc.
+ * Distributed under the terms of the MIT License.
+ */
+#ifndef FRAME_TILE_CODEC_H
+#define FRAME_TILE_CODEC_H
+
+
+#include <SupportDefs.h>
+
+
+// Tiles of the frame buffer as sent in frame streaming mode. Both sides keep
+// a cache of the last tiles, the slot of a tile is its hash modulo the cache
+// size, so that the server can tell which tiles the client already has.
+static const int32 kFrameTileSize = 64;
+static const uint32 kFrameTileCacheSize = 256;
+
+
+size_t		frame_tile_max_encoded_size(int32 width, int32 height);
+
+size_t		encode_frame_tile(const uint8* bits, uint32 bytesPerRow,
+				int32 width, int32 height, uint8* output);
+status_t	decode_frame_tile(const uint8* data, size_t size, uint8* bits,
+				uint32 bytesPerRow, int32 width, int32 height);
+
+uint64		hash_frame_tile(const uint8* bits, uint32 bytesPerRow,
+				int32 width, int32 height);
+
+
+#endif // FRAME_TILE_CODEC_H
@@ -981,6 +981,23 @@ RemoteDrawingEngine::ReadBitmap(ServerBitmap* bitmap, bool drawCursor,
 }
 
 
+status_t
+RemoteDrawingEngine::CopyRegionToBitmap(const BRegion& region,
+	ServerBitmap* bitmap, int32 left, int32 top)
+{
+	// the screen contents are on the other side
+	return B_UNSUPPORTED;
+}
+
+
+status_t
+RemoteDrawingEngine::CopyRegionFromBitmap(const BRegion& region,
+	ServerBitmap* bitmap, int32 left, int32 top)
+{
+	return B_UNSUPPORTED;
+}
+
+
 // #pragma mark -
 
 
@@ -37,6 +37,13 @@ public:
 	virtual	status_t			ReadBitmap(ServerBitmap* bitmap,
 									bool drawCursor, BRect bounds);
 
+	virtual	status_t			CopyRegionToBitmap(const BRegion& region,
+									ServerBitmap* bitmap, int32 left,
+									int32 top);
+	virtual	status_t			CopyRegionFromBitmap(const BRegion& region,
+									ServerBitmap* bitmap, int32 left,
+									int32 top);
+
 	// clipping for all drawing functions, passing a NULL region
 	// will remove any clipping (drawing allowed everywhere)
 	virtual	void				ConstrainClippingRegion(const BRegion* region);
@@ -0,0 +1,223 @@
+/*
+ * Copyright 2026, Haiku, Inc.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+#include "RemoteFrameStreamer.h"
+
+#include <Autolock.h>
+
+#include <new>
+#include <stdlib.h>
+#include <string.h>
+
+#include "RemoteMessage.h"
+#include "RenderingBuffer.h"
+#include "StreamingRingBuffer.h"
+
+
+RemoteFrameStreamer::RemoteFrameStreamer(StreamingRingBuffer* target)
+	:
+	fTarget(target),
+	fDamageLock("frame damage"),
+	fResetPending(true),
+	fWidth(0),
+	fHeight(0),
+	fTilesX(0),
+	fTilesY(0),
+	fTileHashes(NULL),
+	fDirtyTiles(NULL),
+	fEncodeBuffer(NULL)
+{
+	memset(fCacheHashes, 0, sizeof(fCacheHashes));
+	memset(&fStatistics, 0, sizeof(fStatistics));
+}
+
+
+RemoteFrameStreamer::~RemoteFrameStreamer()
+{
+	free(fTileHashes);
+	free(fDirtyTiles);
+	free(fEncodeBuffer);
+}
+
+
+void
+RemoteFrameStreamer::AddDamage(const BRegion& region)
+{
+	BAutolock _(fDamageLock);
+	fDamage.Include(&region);
+}
+
+
+void
+RemoteFrameStreamer::AddDamage(const BRect& rect)
+{
+	BAutolock _(fDamageLock);
+	fDamage.Include(rect);
+}
+
+
+/*!	Forgets what the client has, for example because it just connected. The
+	next Stream() sends the whole frame buffer again.
+*/
+void
+RemoteFrameStreamer::Reset()
+{
+	BAutolock _(fDamageLock);
+	fResetPending = true;
+}
+
+
+/*!	Sends all tiles of \a buffer touched by the damage collected since the
+	last call. \a buffer must stay locked while this is running.
+*/
+status_t
+RemoteFrameStreamer::Stream(const RenderingBuffer* buffer)
+{
+	int32 width = buffer->Width();
+	int32 height = buffer->Height();
+
+	BRegion damage;
+	{
+		BAutolock _(fDamageLock);
+
+		if (fResetPending || width != fWidth || height != fHeight) {
+			status_t status = _SetSize(width, height);
+			if (status != B_OK)
+				return status;
+
+			fDamage.Set(BRect(0, 0, width - 1, height - 1));
+			fResetPending = false;
+		}
+
+		damage = fDamage;
+		fDamage.MakeEmpty();
+	}
+
+	BRegion bounds(BRect(0, 0, width - 1, height - 1));
+	damage.IntersectWith(&bounds);
+	if (damage.CountRects() == 0)
+		return B_OK;
+
+	memset(fDirtyTiles, 0, fTilesX * fTilesY);
+
+	for (int32 i = 0; i < damage.CountRects(); i++) {
+		clipping_rect rect = damage.RectAtInt(i);
+		for (int32 y = rect.top / kFrameTileSize;
+				y <= rect.bottom / kFrameTileSize; y++) {
+			memset(fDirtyTiles + y * fTilesX + rect.left / kFrameTileSize, 1,
+				rect.right / kFrameTileSize - rect.left / kFrameTileSize + 1);
+		}
+	}
+
+	RemoteMessage message(NULL, fTarget);
+	for (int32 y = 0; y < fTilesY; y++) {
+		for (int32 x = 0; x < fTilesX; x++) {
+			if (fDirtyTiles[y * fTilesX + x] != 0)
+				_StreamTile(message, buffer, x, y);
+		}
+	}
+
+	return B_OK;
+}
+
+
+void
+RemoteFrameStreamer::GetStatistics(frame_stream_statistics& statistics) const
+{
+	statistics = fStatistics;
+}
+
+
+status_t
+RemoteFrameStreamer::_SetSize(int32 width, int32 height)
+{
+	int32 tilesX = (width + kFrameTileSize - 1) / kFrameTileSize;
+	int32 tilesY = (height + kFrameTileSize - 1) / kFrameTileSize;
+
+	if (tilesX * tilesY != fTilesX * fTilesY) {
+		uint64* tileHashes = (uint64*)realloc(fTileHashes,
+			tilesX * tilesY * sizeof(uint64));
+		if (tileHashes == NULL)
+			return B_NO_MEMORY;
+		fTileHashes = tileHashes;
+
+		uint8* dirtyTiles = (uint8*)realloc(fDirtyTiles, tilesX * tilesY);
+		if (dirtyTiles == NULL)
+			return B_NO_MEMORY;
+		fDirtyTiles = dirtyTiles;
+	}
+
+	if (fEncodeBuffer == NULL) {
+		fEncodeBuffer = (uint8*)malloc(
+			frame_tile_max_encoded_size(kFrameTileSize, kFrameTileSize));
+		if (fEncodeBuffer == NULL)
+			return B_NO_MEMORY;
+	}
+
+	fWidth = width;
+	fHeight = height;
+	fTilesX = tilesX;
+	fTilesY = tilesY;
+
+	// a hash of 0 stands for "unknown", the client has nothing yet
+	memset(fTileHashes, 0, tilesX * tilesY * sizeof(uint64));
+	memset(fCacheHashes, 0, sizeof(fCacheHashes));
+	return B_OK;
+}
+
+
+void
+RemoteFrameStreamer::_StreamTile(RemoteMessage& message,
+	const RenderingBuffer* buffer, int32 tileX, int32 tileY)
+{
+	int32 left = tileX * kFrameTileSize;
+	int32 top = tileY * kFrameTileSize;
+	int32 width = min_c(kFrameTileSize, fWidth - left);
+	int32 height = min_c(kFrameTileSize, fHeight - top);
+
+	uint32 bytesPerRow = buffer->BytesPerRow();
+	const uint8* bits = (const uint8*)buffer->Bits() + top * bytesPerRow
+		+ left * 4;
+
+	fStatistics.damaged_bytes += width * height * 4;
+
+	uint64 hash = hash_frame_tile(bits, bytesPerRow, width, height);
+	uint64& shownHash = fTileHashes[tileY * fTilesX + tileX];
+	if (hash == shownHash) {
+		fStatistics.tiles_unchanged++;
+		return;
+	}
+	shownHash = hash;
+
+	uint32 slot = hash % kFrameTileCacheSize;
+	if (fCacheHashes[slot] == hash) {
+		message.Start(RP_FRAME_TILE_CACHED);
+		message.Add(left);
+		message.Add(top);
+		message.Add(width);
+		message.Add(height);
+		message.Add(slot);
+
+		fStatistics.tiles_cached++;
+		return;
+	}
+
+	fCacheHashes[slot] = hash;
+
+	size_t size = encode_frame_tile(bits, bytesPerRow, width, height,
+		fEncodeBuffer);
+
+	message.Start(RP_FRAME_TILE);
+	message.Add(left);
+	message.Add(top);
+	message.Add(width);
+	message.Add(height);
+	message.Add(slot);
+	message.AddString((const char*)fEncodeBuffer, size);
+
+	fStatistics.tiles_sent++;
+	fStatistics.encoded_bytes += size;
+}
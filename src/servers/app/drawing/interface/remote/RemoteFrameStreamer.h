@@ -0,0 +1,84 @@
+/*
+ * Copyright 2026, Haiku, Inc.
+ * Distributed under the terms of the MIT License.
+ */
+#ifndef REMOTE_FRAME_STREAMER_H
+#define REMOTE_FRAME_STREAMER_H
+
+
+#include <Locker.h>
+#include <Region.h>
+
+#include "FrameTileCodec.h"
+
+
+class RemoteMessage;
+class RenderingBuffer;
+class StreamingRingBuffer;
+
+
+struct frame_stream_statistics {
+	uint64		damaged_bytes;
+		// size of the pixel data of all damaged tiles
+	uint64		encoded_bytes;
+		// size of the encoded tiles that were sent
+	uint32		tiles_sent;
+	uint32		tiles_cached;
+	uint32		tiles_unchanged;
+};
+
+
+/*!	Sends the damaged parts of a locally rendered frame buffer to the client
+	as compressed tiles.
+
+	Damage is collected from any thread with AddDamage(); Stream() then
+	sends all tiles that the damage touches. Tiles whose contents did not
+	change since they were last sent are skipped, and tiles that are still
+	in the cache of the client (like the contents of a window that is moved
+	around) are only referenced by their cache slot.
+*/
+class RemoteFrameStreamer {
+public:
+								RemoteFrameStreamer(
+									StreamingRingBuffer* target);
+								~RemoteFrameStreamer();
+
+			void				AddDamage(const BRegion& region);
+			void				AddDamage(const BRect& rect);
+			void				Reset();
+
+			status_t			Stream(const RenderingBuffer* buffer);
+
+			void				GetStatistics(
+									frame_stream_statistics& statistics)
+										const;
+
+private:
+			status_t			_SetSize(int32 width, int32 height);
+			void				_StreamTile(RemoteMessage& message,
+									const RenderingBuffer* buffer,
+									int32 tileX, int32 tileY);
+
+private:
+			StreamingRingBuffer* fTarget;
+
+			BLocker				fDamageLock;
+			BRegion				fDamage;
+			bool				fResetPending;
+
+			// only used by Stream()
+			int32				fWidth;
+			int32				fHeight;
+			int32				fTilesX;
+			int32				fTilesY;
+			uint64*				fTileHashes;
+				// the contents the client shows at each tile position
+			uint8*				fDirtyTiles;
+			uint64				fCacheHashes[kFrameTileCacheSize];
+			uint8*				fEncodeBuffer;
+
+			frame_stream_statistics fStatistics;
+};
+
+
+#endif // REMOTE_FRAME_STREAMER_H
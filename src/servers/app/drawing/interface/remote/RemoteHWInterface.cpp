@@ -9,8 +9,11 @@
 #include "RemoteHWInterface.h"
 #include "RemoteDrawingEngine.h"
 #include "RemoteEventStream.h"
+#include "RemoteFrameStreamer.h"
 #include "RemoteMessage.h"
 
+#include "MallocBuffer.h"
+
 #include "NetReceiver.h"
 #include "NetSender.h"
 #include "StreamingRingBuffer.h"
@@ -24,6 +27,9 @@
 #include <string.h>
 
 
+static const bigtime_t kFrameInterval = 1000000 / 60;
+
+
 #define TRACE(x...)				/*debug_printf("RemoteHWInterface: " x)*/
 #define TRACE_ALWAYS(x...)		debug_printf("RemoteHWInterface: " x)
 #define TRACE_ERROR(x...)		debug_printf("RemoteHWInterface: " x)
@@ -51,7 +57,13 @@ RemoteHWInterface::RemoteHWInterface(const char* target)
 	fReceiver(NULL),
 	fEventThread(-1),
 	fEventStream(NULL),
-	fCallbackLocker("callback locker")
+	fCallbackLocker("callback locker"),
+	fFrameMode(false),
+	fFrameBuffer(NULL),
+	fFrameStreamer(NULL),
+	fFrameThread(-1),
+	fFrameSem(-1),
+	fFramePending(0)
 {
 	memset(&fFallbackMode, 0, sizeof(fFallbackMode));
 	fFallbackMode.virtual_width = 640;
@@ -66,6 +78,10 @@ RemoteHWInterface::RemoteHWInterface(const char* target)
 		return;
 	}
 
+	// "<port>:frames" selects frame streaming instead of sending the drawing
+	// commands
+	fFrameMode = strstr(fTarget, ":frames") != NULL;
+
 	fListenEndpoint.SetTo(new(std::nothrow) BNetEndpoint());
 	if (!fListenEndpoint.IsSet()) {
 		fInitStatus = B_NO_MEMORY;
@@ -117,11 +133,44 @@ RemoteHWInterface::RemoteHWInterface(const char* target)
 	}
 
 	resume_thread(fEventThread);
+
+	if (!fFrameMode)
+		return;
+
+	fFrameStreamer.SetTo(new(std::nothrow) RemoteFrameStreamer(
+		fSendBuffer.Get()));
+	if (!fFrameStreamer.IsSet()) {
+		fInitStatus = B_NO_MEMORY;
+		return;
+	}
+
+	fFrameSem = create_sem(0, "remote frame pending");
+	if (fFrameSem < 0) {
+		fInitStatus = fFrameSem;
+		return;
+	}
+
+	fFrameThread = spawn_thread(_FrameThreadEntry, "remote frame thread",
+		B_DISPLAY_PRIORITY, this);
+	if (fFrameThread < 0) {
+		fInitStatus = fFrameThread;
+		return;
+	}
+
+	resume_thread(fFrameThread);
 }
 
 
 RemoteHWInterface::~RemoteHWInterface()
 {
+	if (fFrameSem >= 0) {
+		delete_sem(fFrameSem);
+		if (fFrameThread >= 0) {
+			status_t result;
+			wait_for_thread(fFrameThread, &result);
+		}
+	}
+
 	//TODO: check order
 	fReceiver.Unset();
 	fReceiveBuffer.Unset();
@@ -153,6 +202,9 @@ RemoteHWInterface::Shutdown()
 DrawingEngine*
 RemoteHWInterface::CreateDrawingEngine()
 {
+	if (fFrameMode)
+		return new(std::nothrow) DrawingEngine(this);
+
 	return new(std::nothrow) RemoteDrawingEngine(this);
 }
 
@@ -290,6 +342,9 @@ RemoteHWInterface::_EventThread()
 				fClientMode.virtual_height = height;
 				_FillDisplayModeTiming(fClientMode);
 				_NotifyScreenChanged();
+
+				if (fFrameMode)
+					_QueueFrame();
 				break;
 			}
 
@@ -354,6 +409,12 @@ RemoteHWInterface::_NewConnection(BNetEndpoint &endpoint)
 		return B_NO_MEMORY;
 	}
 
+	if (fFrameMode) {
+		// the new client has none of the frame yet
+		fFrameStreamer->Reset();
+		_QueueFrame();
+	}
+
 	return B_OK;
 }
 
@@ -378,7 +439,27 @@ RemoteHWInterface::SetMode(const display_mode& mode)
 {
 	TRACE("set mode: %" B_PRIu16 " %" B_PRIu16 "\n", mode.virtual_width,
 		mode.virtual_height);
+	if (!fFrameMode) {
+		fCurrentMode = mode;
+		return B_OK;
+	}
+
+	AutoWriteLocker _(this);
+
+	ObjectDeleter<MallocBuffer> frameBuffer(new(std::nothrow) MallocBuffer(
+		mode.virtual_width, mode.virtual_height));
+	if (!frameBuffer.IsSet())
+		return B_NO_MEMORY;
+
+	status_t status = frameBuffer->InitCheck();
+	if (status != B_OK)
+		return status;
+
 	fCurrentMode = mode;
+	fFrameBuffer.SetTo(frameBuffer.Detach());
+
+	// the streamer sends the whole frame buffer when its size changes
+	_NotifyFrameBufferChanged();
 	return B_OK;
 }
 
@@ -577,20 +658,27 @@ RemoteHWInterface::FrontBuffer() const
 RenderingBuffer*
 RemoteHWInterface::BackBuffer() const
 {
-	return NULL;
+	// in frame mode, everything is drawn into the back buffer, and the
+	// client is the front buffer
+	return fFrameBuffer.Get();
 }
 
 
 bool
 RemoteHWInterface::IsDoubleBuffered() const
 {
-	return false;
+	return fFrameMode;
 }
 
 
 status_t
 RemoteHWInterface::InvalidateRegion(const BRegion& region)
 {
+	if (fFrameMode) {
+		_AddFrameDamage(region);
+		return B_OK;
+	}
+
 	RemoteMessage message(NULL, fSendBuffer.Get());
 	message.Start(RP_INVALIDATE_REGION);
 	message.AddRegion(region);
@@ -601,6 +689,11 @@ RemoteHWInterface::InvalidateRegion(const BRegion& region)
 status_t
 RemoteHWInterface::Invalidate(const BRect& frame)
 {
+	if (fFrameMode) {
+		_AddFrameDamage(frame);
+		return B_OK;
+	}
+
 	RemoteMessage message(NULL, fSendBuffer.Get());
 	message.Start(RP_INVALIDATE_RECT);
 	message.Add(frame);
@@ -611,10 +704,76 @@ RemoteHWInterface::Invalidate(const BRect& frame)
 status_t
 RemoteHWInterface::CopyBackToFront(const BRect& frame)
 {
+	if (fFrameMode)
+		_AddFrameDamage(frame);
+
 	return B_OK;
 }
 
 
+int32
+RemoteHWInterface::_FrameThreadEntry(void* data)
+{
+	return ((RemoteHWInterface*)data)->_FrameThread();
+}
+
+
+/*!	Streams the damaged parts of the frame buffer. The frame rate is limited,
+	so that the damage of many small drawing operations is sent at once.
+*/
+status_t
+RemoteHWInterface::_FrameThread()
+{
+	bigtime_t lastFrame = 0;
+
+	while (true) {
+		status_t status = acquire_sem(fFrameSem);
+		if (status == B_INTERRUPTED)
+			continue;
+		if (status != B_OK)
+			return B_OK;
+
+		snooze_until(lastFrame + kFrameInterval, B_SYSTEM_TIMEBASE);
+		lastFrame = system_time();
+
+		atomic_set(&fFramePending, 0);
+
+		// without a client, the damage is kept until it is connected
+		if (!fIsConnected || !ReadLock())
+			continue;
+
+		if (fFrameBuffer.IsSet())
+			fFrameStreamer->Stream(fFrameBuffer.Get());
+
+		ReadUnlock();
+	}
+}
+
+
+void
+RemoteHWInterface::_AddFrameDamage(const BRegion& region)
+{
+	fFrameStreamer->AddDamage(region);
+	_QueueFrame();
+}
+
+
+void
+RemoteHWInterface::_AddFrameDamage(const BRect& frame)
+{
+	fFrameStreamer->AddDamage(frame);
+	_QueueFrame();
+}
+
+
+void
+RemoteHWInterface::_QueueFrame()
+{
+	if (atomic_test_and_set(&fFramePending, 1, 0) == 0)
+		release_sem_etc(fFrameSem, 1, B_DO_NOT_RESCHEDULE);
+}
+
+
 void
 RemoteHWInterface::_FillDisplayModeTiming(display_mode &mode)
 {
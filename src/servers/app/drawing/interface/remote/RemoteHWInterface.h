@@ -15,6 +15,8 @@
 #include <ObjectList.h>
 
 class BNetEndpoint;
+class MallocBuffer;
+class RemoteFrameStreamer;
 class StreamingRingBuffer;
 class NetSender;
 class NetReceiver;
@@ -80,6 +82,11 @@ virtual	status_t					InvalidateRegion(const BRegion& region);
 virtual	status_t					Invalidate(const BRect& frame);
 virtual	status_t					CopyBackToFront(const BRect& frame);
 
+		// frame streaming mode, the server draws itself and sends the
+		// changed parts of the frame buffer
+		bool						IsFrameMode() const
+										{ return fFrameMode; }
+
 		// drawing engine interface
 		StreamingRingBuffer*		ReceiveBuffer()
 										{ return fReceiveBuffer.Get(); }
@@ -106,6 +113,12 @@ static	status_t					_NewConnectionCallback(void *cookie,
 
 		void						_Disconnect();
 
+static	int32						_FrameThreadEntry(void* data);
+		status_t					_FrameThread();
+		void						_AddFrameDamage(const BRegion& region);
+		void						_AddFrameDamage(const BRect& frame);
+		void						_QueueFrame();
+
 		void						_FillDisplayModeTiming(display_mode &mode);
 
 		const char*					fTarget;
@@ -133,6 +146,14 @@ static	status_t					_NewConnectionCallback(void *cookie,
 
 		BLocker						fCallbackLocker;
 		BObjectList<callback_info>	fCallbacks;
+
+		bool						fFrameMode;
+		ObjectDeleter<MallocBuffer>	fFrameBuffer;
+		ObjectDeleter<RemoteFrameStreamer>
+									fFrameStreamer;
+		thread_id					fFrameThread;
+		sem_id						fFrameSem;
+		int32						fFramePending;
 };
 
 #endif // REMOTE_HW_INTERFACE_H
@@ -125,7 +125,10 @@ enum {
 	RP_KEY_UP,
 	RP_UNMAPPED_KEY_DOWN,
 	RP_UNMAPPED_KEY_UP,
-	RP_MODIFIERS_CHANGED
+	RP_MODIFIERS_CHANGED,
+
+	RP_FRAME_TILE = 260,
+	RP_FRAME_TILE_CACHED
 };
 
 
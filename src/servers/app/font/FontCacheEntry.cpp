@@ -37,6 +37,7 @@
 #include <util/OpenHashTable.h>
 
 #include "GlobalSubpixelSettings.h"
+#include "TextRunCache.h"
 
 
 BLocker FontCacheEntry::sUsageUpdateLock("FontCacheEntry usage lock");
@@ -143,6 +144,9 @@ FontCacheEntry::FontCacheEntry()
 FontCacheEntry::~FontCacheEntry()
 {
 //printf("~FontCacheEntry()\n");
+	TextRunCache* runCache = TextRunCache::Default();
+	if (runCache != NULL)
+		runCache->RemoveRuns(this);
 }
 
 
@@ -178,6 +182,14 @@ FontCacheEntry::Init(const ServerFont& font, bool forceVector)
 		return false;
 	}
 
+	// Glyphs that are drawn from their coverage anyway are also kept in an
+	// atlas, so that whole text runs can be composed from it.
+	if (renderingType == glyph_ren_native_gray8
+		|| renderingType == glyph_ren_subpix) {
+		fAtlas.SetTo(new(std::nothrow) GlyphAtlas(
+			renderingType == glyph_ren_subpix));
+	}
+
 	return true;
 }
 
@@ -334,14 +346,18 @@ FontCacheEntry::CreateGlyph(uint32 glyphCode, FontCacheEntry* fallbackEntry)
 	}
 
 	if (engine->PrepareGlyph(glyphIndex)) {
-		glyph = fGlyphCache->CacheGlyph(glyphCode,
+		GlyphCache* newGlyph = fGlyphCache->CacheGlyph(glyphCode,
 			engine->DataSize(), engine->DataType(), engine->Bounds(),
 			engine->AdvanceX(), engine->AdvanceY(),
 			engine->PreciseAdvanceX(), engine->PreciseAdvanceY(),
 			engine->InsetLeft(), engine->InsetRight());
 
-		if (glyph != NULL)
-			engine->WriteGlyphTo(glyph->data);
+		if (newGlyph != NULL) {
+			engine->WriteGlyphTo(newGlyph->data);
+			if (fAtlas.IsSet())
+				fAtlas->AddGlyph(newGlyph);
+		}
+		glyph = newGlyph;
 	}
 
 	return glyph;
@@ -36,6 +36,7 @@
 
 #include "ServerFont.h"
 #include "FontEngine.h"
+#include "GlyphAtlas.h"
 #include "MultiLocker.h"
 #include "Referenceable.h"
 #include "Transformable.h"
@@ -58,6 +59,12 @@ struct GlyphCache {
 		precise_advance_y(preciseAdvanceY),
 		inset_left(insetLeft),
 		inset_right(insetRight),
+		atlas_bits(NULL),
+		atlas_bytes_per_row(0),
+		atlas_left(0),
+		atlas_top(0),
+		atlas_width(0),
+		atlas_height(0),
 		hash_link(NULL)
 	{
 	}
@@ -79,6 +86,14 @@ struct GlyphCache {
 	float			inset_left;
 	float			inset_right;
 
+	// coverage in the GlyphAtlas of the entry, if any
+	const uint8*	atlas_bits;
+	uint32			atlas_bytes_per_row;
+	int32			atlas_left;
+	int32			atlas_top;
+	int32			atlas_width;
+	int32			atlas_height;
+
 	GlyphCache*		hash_link;
 };
 
@@ -115,6 +130,9 @@ class FontCacheEntry : public MultiLocker, public BReferenceable {
 									FontCacheEntry* fallbackEntry = NULL);
 			bool				CanCreateGlyph(uint32 glyphCode);
 
+			GlyphAtlas*			Atlas() const
+									{ return fAtlas.Get(); }
+
 			void				InitAdaptors(const GlyphCache* glyph,
 									double x, double y,
 									GlyphMonoAdapter& monoAdapter,
@@ -147,6 +165,8 @@ class FontCacheEntry : public MultiLocker, public BReferenceable {
 
 			ObjectDeleter<GlyphCachePool>
 								fGlyphCache;
+			ObjectDeleter<GlyphAtlas>
+								fAtlas;
 			FontEngine			fEngine;
 
 	static	BLocker				sUsageUpdateLock;
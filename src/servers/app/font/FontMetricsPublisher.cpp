@@ -0,0 +1,178 @@
+/*
+ * Copyright 2026, Haiku, Inc.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+#include "FontMetricsPublisher.h"
+
+#include <string.h>
+
+#include <Autolock.h>
+#include <SharedFontMetrics.h>
+
+#include "GlyphLayoutEngine.h"
+#include "ServerFont.h"
+
+
+class SharedMetricsConsumer {
+public:
+	SharedMetricsConsumer(shared_font_metrics& metrics)
+		:
+		fMetrics(metrics)
+	{
+	}
+
+	bool NeedsVector() { return false; }
+	void Start() {}
+	void Finish(double x, double y) {}
+
+	void ConsumeEmptyGlyph(int32 index, uint32 charCode, double x, double y)
+	{
+		if (charCode < kSharedFontMetricsCharCount)
+			fMetrics.missing[charCode / 32] |= 1UL << (charCode % 32);
+	}
+
+	bool ConsumeGlyph(int32 index, uint32 charCode, const GlyphCache* glyph,
+		FontCacheEntry* entry, double x, double y, double advanceX,
+			double advanceY)
+	{
+		if (charCode < kSharedFontMetricsCharCount) {
+			fMetrics.glyphs[charCode].advance = glyph->advance_x;
+			fMetrics.glyphs[charCode].precise_advance
+				= glyph->precise_advance_x;
+		}
+		return true;
+	}
+
+private:
+	shared_font_metrics& fMetrics;
+};
+
+
+// #pragma mark -
+
+
+FontMetricsPublisher::FontMetricsPublisher()
+	:
+	fLock("font metrics publisher"),
+	fArea(-1),
+	fMetrics(NULL)
+{
+}
+
+
+FontMetricsPublisher::~FontMetricsPublisher()
+{
+	delete_area(fArea);
+}
+
+
+status_t
+FontMetricsPublisher::Init(const char* name)
+{
+	size_t size = (sizeof(shared_font_metrics_area) + B_PAGE_SIZE - 1)
+		& ~(B_PAGE_SIZE - 1);
+	fArea = create_area(name, (void**)&fMetrics, B_ANY_ADDRESS, size,
+		B_NO_LOCK, B_READ_AREA | B_WRITE_AREA | B_CLONEABLE_AREA);
+	if (fArea < 0)
+		return fArea;
+
+	fMetrics->version = kSharedFontMetricsVersion;
+	fMetrics->generation = 0;
+	fMetrics->count = 0;
+	return B_OK;
+}
+
+
+/*!	Makes the metrics of the given font available to the clients, unless
+	they already are. Only fonts of the global font manager are published,
+	as the IDs of fonts that applications loaded themselves are not unique.
+*/
+void
+FontMetricsPublisher::Publish(uint16 familyID, uint16 styleID, float size)
+{
+	if (fMetrics == NULL || size <= 0)
+		return;
+
+	BAutolock _(fLock);
+
+	if (find_shared_font_metrics(fMetrics, familyID, styleID, size) != NULL)
+		return;
+
+	ServerFont font;
+	if (font.SetFamilyAndStyle(familyID, styleID, NULL) != B_OK)
+		return;
+	font.SetSize(size);
+
+	if (fMetrics->count == (int32)kSharedFontMetricsMaxFonts)
+		_Reset();
+
+	uint32 slot = shared_font_metrics_hash(familyID, styleID, size);
+	while (fMetrics->slots[slot] != 0)
+		slot = (slot + 1) % kSharedFontMetricsSlotCount;
+
+	// the metrics are complete before they can be found
+	int32 index = fMetrics->count;
+	if (!_Measure(font, index))
+		return;
+
+	atomic_set(&fMetrics->slots[slot], index + 1);
+	fMetrics->count = index + 1;
+}
+
+
+/*!	Removes all fonts, as the glyph metrics may have changed. */
+void
+FontMetricsPublisher::Reset()
+{
+	if (fMetrics == NULL)
+		return;
+
+	BAutolock _(fLock);
+	_Reset();
+}
+
+
+void
+FontMetricsPublisher::_Reset()
+{
+	atomic_add(&fMetrics->generation, 1);
+
+	for (uint32 i = 0; i < kSharedFontMetricsSlotCount; i++)
+		atomic_set(&fMetrics->slots[i], 0);
+	fMetrics->count = 0;
+
+	atomic_add(&fMetrics->generation, 1);
+}
+
+
+bool
+FontMetricsPublisher::_Measure(const ServerFont& font, int32 index)
+{
+	shared_font_metrics& metrics = fMetrics->fonts[index];
+	memset(&metrics, 0, sizeof(metrics));
+	metrics.family_id = font.FamilyID();
+	metrics.style_id = font.StyleID();
+	metrics.size = font.Size();
+	metrics.flags = font.Flags();
+
+	// lay out all characters in one go, using the same fallback fonts as
+	// for other text
+	char string[kSharedFontMetricsCharCount * 2];
+	int32 length = 0;
+	for (uint32 charCode = 1; charCode < kSharedFontMetricsCharCount;
+			charCode++) {
+		if (charCode < 0x80)
+			string[length++] = charCode;
+		else {
+			string[length++] = 0xc0 | (charCode >> 6);
+			string[length++] = 0x80 | (charCode & 0x3f);
+		}
+	}
+	string[length] = '\0';
+
+	SharedMetricsConsumer consumer(metrics);
+	return GlyphLayoutEngine::LayoutGlyphs(consumer, font, string, length,
+		INT32_MAX, NULL, B_BITMAP_SPACING);
+}
@@ -0,0 +1,45 @@
+/*
+ * Copyright 2026, Haiku, Inc.
+ * Distributed under the terms of the MIT License.
+ */
+#ifndef FONT_METRICS_PUBLISHER_H
+#define FONT_METRICS_PUBLISHER_H
+
+
+#include <Locker.h>
+#include <OS.h>
+
+
+class ServerFont;
+struct shared_font_metrics_area;
+
+
+/*!	Maintains the area with the shared font metrics, see
+	SharedFontMetrics.h.
+*/
+class FontMetricsPublisher {
+public:
+								FontMetricsPublisher();
+								~FontMetricsPublisher();
+
+			status_t			Init(const char* name);
+			area_id				Area() const
+									{ return fArea; }
+
+			void				Publish(uint16 familyID, uint16 styleID,
+									float size);
+			void				Reset();
+
+private:
+			void				_Reset();
+			bool				_Measure(const ServerFont& font,
+									int32 index);
+
+private:
+			BLocker				fLock;
+			area_id				fArea;
+			shared_font_metrics_area* fMetrics;
+};
+
+
+#endif	// FONT_METRICS_PUBLISHER_H
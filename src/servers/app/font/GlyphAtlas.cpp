@@ -0,0 +1,157 @@
+/*
+ * Copyright 2026, Haiku, Inc.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+#include "GlyphAtlas.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <new>
+
+#include "FontCacheEntry.h"
+
+
+static const int32 kPageBytesPerRow = 512;
+static const int32 kPageHeight = 256;
+
+
+struct GlyphAtlas::Page {
+	Page*	next;
+	int32	shelfTop;
+	int32	shelfHeight;
+	int32	shelfUsed;
+		// in bytes
+	uint8	bits[kPageBytesPerRow * kPageHeight];
+};
+
+
+GlyphAtlas::GlyphAtlas(bool subpixel)
+	:
+	fBytesPerPixel(subpixel ? 3 : 1),
+	fPages(NULL),
+	fMemoryUsage(0)
+{
+}
+
+
+GlyphAtlas::~GlyphAtlas()
+{
+	while (fPages != NULL) {
+		Page* next = fPages->next;
+		free(fPages);
+		fPages = next;
+	}
+}
+
+
+/*!	Rasterizes the coverage of \a glyph into the atlas, and stores where it
+	ended up in the glyph. Returns \c false if the glyph cannot be put into
+	the atlas, it then has to be drawn from its scanlines.
+*/
+bool
+GlyphAtlas::AddGlyph(GlyphCache* glyph)
+{
+	glyph_data_type expectedType = IsSubpixel()
+		? glyph_data_subpix : glyph_data_gray8;
+	if (glyph->data_type != expectedType)
+		return false;
+
+	FontCacheEntry::GlyphGray8Adapter adapter;
+	FontCacheEntry::GlyphGray8Scanline scanline;
+	adapter.init(glyph->data, glyph->data_size, 0, 0);
+	if (!adapter.rewind_scanlines())
+		return false;
+
+	int32 left = adapter.min_x();
+	int32 top = adapter.min_y();
+	int32 width = adapter.max_x() - left + 1;
+	int32 height = adapter.max_y() - top + 1;
+	if (width <= 0 || height <= 0)
+		return false;
+
+	uint8* bits = _Allocate(width, height);
+	if (bits == NULL)
+		return false;
+
+	int32 rowBytes = width * fBytesPerPixel;
+	for (int32 y = 0; y < height; y++)
+		memset(bits + y * kPageBytesPerRow, 0, rowBytes);
+
+	while (adapter.sweep_scanline(scanline)) {
+		int32 y = scanline.y() - top;
+		if (y < 0 || y >= height)
+			continue;
+
+		uint8* row = bits + y * kPageBytesPerRow;
+		int32 spanCount = scanline.num_spans();
+		FontCacheEntry::GlyphGray8Scanline::const_iterator span
+			= scanline.begin();
+		for (; spanCount > 0; spanCount--, ++span) {
+			// the length of subpixel spans is in subpixels
+			int32 start = (span->x - left) * fBytesPerPixel;
+			int32 length = abs(span->len);
+			if (start < 0 || start + length > rowBytes)
+				continue;
+
+			if (span->len < 0)
+				memset(row + start, *span->covers, length);
+			else
+				memcpy(row + start, span->covers, length);
+		}
+	}
+
+	glyph->atlas_bits = bits;
+	glyph->atlas_bytes_per_row = kPageBytesPerRow;
+	glyph->atlas_left = left;
+	glyph->atlas_top = top;
+	glyph->atlas_width = width;
+	glyph->atlas_height = height;
+	return true;
+}
+
+
+/*!	Finds room for a \a width x \a height glyph. Glyphs are placed next to
+	each other on shelves as high as the first glyph on them, which wastes
+	little space as the glyphs of one font are of similar height.
+*/
+uint8*
+GlyphAtlas::_Allocate(int32 width, int32 height)
+{
+	int32 widthBytes = width * fBytesPerPixel;
+	if (widthBytes > kPageBytesPerRow || height > kPageHeight)
+		return NULL;
+
+	Page* page = fPages;
+	if (page != NULL && (page->shelfUsed + widthBytes > kPageBytesPerRow
+			|| height > page->shelfHeight)) {
+		// start a new shelf below the current one
+		int32 shelfTop = page->shelfTop + page->shelfHeight;
+		if (shelfTop + height <= kPageHeight) {
+			page->shelfTop = shelfTop;
+			page->shelfHeight = height;
+			page->shelfUsed = 0;
+		} else
+			page = NULL;
+	}
+
+	if (page == NULL) {
+		page = (Page*)malloc(sizeof(Page));
+		if (page == NULL)
+			return NULL;
+
+		page->next = fPages;
+		page->shelfTop = 0;
+		page->shelfHeight = height;
+		page->shelfUsed = 0;
+		fPages = page;
+		fMemoryUsage += sizeof(Page);
+	}
+
+	uint8* bits = page->bits + page->shelfTop * kPageBytesPerRow
+		+ page->shelfUsed;
+	page->shelfUsed += widthBytes;
+	return bits;
+}
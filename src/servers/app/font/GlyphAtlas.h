@@ -0,0 +1,50 @@
+/*
+ * Copyright 2026, Haiku, Inc.
+ * Distributed under the terms of the MIT License.
+ */
+#ifndef GLYPH_ATLAS_H
+#define GLYPH_ATLAS_H
+
+
+#include <SupportDefs.h>
+
+
+struct GlyphCache;
+
+
+/*!	Keeps the coverage of the glyphs of one FontCacheEntry as plain alpha
+	bitmaps, packed into a few larger pages. Subpixel glyphs have three
+	coverage values per pixel.
+
+	A glyph is rasterized into the atlas once, when it is cached; text runs
+	are then composed from the atlas without going through the serialized
+	scanlines of each glyph again.
+*/
+class GlyphAtlas {
+public:
+								GlyphAtlas(bool subpixel);
+								~GlyphAtlas();
+
+			bool				IsSubpixel() const
+									{ return fBytesPerPixel == 3; }
+			uint32				BytesPerPixel() const
+									{ return fBytesPerPixel; }
+
+			bool				AddGlyph(GlyphCache* glyph);
+
+			size_t				MemoryUsage() const
+									{ return fMemoryUsage; }
+
+private:
+			struct Page;
+
+			uint8*				_Allocate(int32 width, int32 height);
+
+private:
+			uint32				fBytesPerPixel;
+			Page*				fPages;
+			size_t				fMemoryUsage;
+};
+
+
+#endif // GLYPH_ATLAS_H
@@ -0,0 +1,265 @@
+/*
+ * Copyright 2026, Haiku, Inc.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+#include "TextRunCache.h"
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <new>
+
+#include <Autolock.h>
+
+
+static const size_t kDefaultMaxMemoryUsage = 4 * 1024 * 1024;
+
+static TextRunCache* sDefaultCache = NULL;
+static pthread_once_t sDefaultCacheInitOnce = PTHREAD_ONCE_INIT;
+
+
+static void
+init_default_cache()
+{
+	sDefaultCache = new(std::nothrow) TextRunCache(kDefaultMaxMemoryUsage);
+}
+
+
+static inline uint32
+hash_bytes(uint32 hash, const void* data, size_t size)
+{
+	const uint8* bytes = (const uint8*)data;
+	for (size_t i = 0; i < size; i++)
+		hash = (hash ^ bytes[i]) * 16777619;
+	return hash;
+}
+
+
+// #pragma mark - TextRunKey
+
+
+TextRunKey::TextRunKey(const FontCacheEntry* entry, const char* string,
+		uint32 length, float deltaNonSpace, float deltaSpace, uint8 spacing,
+		float offsetX, float offsetY)
+	:
+	entry(entry),
+	string(string),
+	length(length),
+	delta_nonspace(deltaNonSpace),
+	delta_space(deltaSpace),
+	spacing(spacing),
+	offset_x(offsetX),
+	offset_y(offsetY)
+{
+	hash = hash_bytes(2166136261U, &entry, sizeof(entry));
+	hash = hash_bytes(hash, string, length);
+	hash = hash_bytes(hash, &delta_nonspace, sizeof(delta_nonspace));
+	hash = hash_bytes(hash, &delta_space, sizeof(delta_space));
+	hash = hash_bytes(hash, &spacing, sizeof(spacing));
+	hash = hash_bytes(hash, &offset_x, sizeof(offset_x));
+	hash = hash_bytes(hash, &offset_y, sizeof(offset_y));
+}
+
+
+bool
+TextRunKey::operator==(const TextRunKey& other) const
+{
+	return hash == other.hash && entry == other.entry
+		&& length == other.length && spacing == other.spacing
+		&& delta_nonspace == other.delta_nonspace
+		&& delta_space == other.delta_space
+		&& offset_x == other.offset_x && offset_y == other.offset_y
+		&& memcmp(string, other.string, length) == 0;
+}
+
+
+// #pragma mark - TextRun
+
+
+TextRun::TextRun(const TextRunKey& key, uint32 bytesPerPixel, int32 left,
+		int32 top, int32 width, int32 height)
+	:
+	fKey(key),
+	fBits(NULL),
+	fBytesPerRow(width * bytesPerPixel),
+	fBytesPerPixel(bytesPerPixel),
+	fLeft(left),
+	fTop(top),
+	fWidth(width),
+	fHeight(height),
+	fBounds(),
+	fEnd(),
+	fMemoryUsage(0),
+	fHashLink(NULL)
+{
+}
+
+
+TextRun::~TextRun()
+{
+	// the string and the bits were allocated along with the object
+}
+
+
+/*!	Creates a run for \a key with room for \a width x \a height pixels of
+	cleared coverage. The string of \a key is copied.
+*/
+/*static*/ TextRun*
+TextRun::Create(const TextRunKey& key, uint32 bytesPerPixel, int32 left,
+	int32 top, int32 width, int32 height)
+{
+	size_t bitsSize = (size_t)width * bytesPerPixel * height;
+	size_t size = sizeof(TextRun) + key.length + bitsSize;
+
+	void* memory = malloc(size);
+	if (memory == NULL)
+		return NULL;
+
+	TextRun* run = new(memory) TextRun(key, bytesPerPixel, left, top, width,
+		height);
+
+	char* string = (char*)(run + 1);
+	memcpy(string, key.string, key.length);
+	run->fKey.string = string;
+
+	run->fBits = (uint8*)string + key.length;
+	memset(run->fBits, 0, bitsSize);
+
+	run->fMemoryUsage = size;
+	return run;
+}
+
+
+void
+TextRun::SetLayout(const IntRect& bounds, const BPoint& end)
+{
+	fBounds = bounds;
+	fEnd = end;
+}
+
+
+void
+TextRun::LastReferenceReleased()
+{
+	this->~TextRun();
+	free(this);
+}
+
+
+// #pragma mark - TextRunCache
+
+
+TextRunCache::TextRunCache(size_t maxMemoryUsage)
+	:
+	fLock("text run cache"),
+	fMemoryUsage(0),
+	fMaxMemoryUsage(maxMemoryUsage)
+{
+	fTable.Init();
+}
+
+
+TextRunCache::~TextRunCache()
+{
+	while (TextRun* run = fRuns.Head())
+		_Remove(run);
+}
+
+
+/*static*/ TextRunCache*
+TextRunCache::Default()
+{
+	pthread_once(&sDefaultCacheInitOnce, &init_default_cache);
+	return sDefaultCache;
+}
+
+
+/*!	Runs larger than this are not worth caching, they would push out too
+	many others.
+*/
+size_t
+TextRunCache::MaxRunSize() const
+{
+	return fMaxMemoryUsage / 16;
+}
+
+
+/*!	Returns the run for \a key with a reference acquired for the caller, or
+	\c NULL if it is not cached.
+*/
+TextRun*
+TextRunCache::Lookup(const TextRunKey& key)
+{
+	BAutolock _(fLock);
+
+	TextRun* run = fTable.Lookup(key);
+	if (run == NULL)
+		return NULL;
+
+	if (fRuns.Head() != run) {
+		fRuns.Remove(run);
+		fRuns.Add(run, false);
+	}
+
+	run->AcquireReference();
+	return run;
+}
+
+
+/*!	Adds \a run to the cache, which acquires its own reference to it. The
+	least recently used runs are dropped to make room for it.
+*/
+void
+TextRunCache::Insert(TextRun* run)
+{
+	BAutolock _(fLock);
+
+	if (run->MemoryUsage() > MaxRunSize()
+		|| fTable.Lookup(run->Key()) != NULL) {
+		// another thread drew the same run in the meantime
+		return;
+	}
+
+	while (fMemoryUsage + run->MemoryUsage() > fMaxMemoryUsage
+		&& fRuns.Tail() != NULL) {
+		_Remove(fRuns.Tail());
+	}
+
+	if (fTable.Insert(run) != B_OK)
+		return;
+
+	run->AcquireReference();
+	fRuns.Add(run, false);
+	fMemoryUsage += run->MemoryUsage();
+}
+
+
+/*!	Removes all runs of \a entry; it is about to go away, and its address
+	could be reused for another one.
+*/
+void
+TextRunCache::RemoveRuns(const FontCacheEntry* entry)
+{
+	BAutolock _(fLock);
+
+	TextRun* run = fRuns.Head();
+	while (run != NULL) {
+		TextRun* next = fRuns.GetNext(run);
+		if (run->Key().entry == entry)
+			_Remove(run);
+		run = next;
+	}
+}
+
+
+void
+TextRunCache::_Remove(TextRun* run)
+{
+	fTable.RemoveUnchecked(run);
+	fRuns.Remove(run);
+	fMemoryUsage -= run->MemoryUsage();
+	run->ReleaseReference();
+}
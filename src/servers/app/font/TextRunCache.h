@@ -0,0 +1,175 @@
+/*
+ * Copyright 2026, Haiku, Inc.
+ * Distributed under the terms of the MIT License.
+ */
+#ifndef TEXT_RUN_CACHE_H
+#define TEXT_RUN_CACHE_H
+
+
+#include <Debug.h>
+#include <Locker.h>
+#include <Point.h>
+#include <Referenceable.h>
+#include <util/DoublyLinkedList.h>
+#include <util/OpenHashTable.h>
+
+#include "IntRect.h"
+
+
+class FontCacheEntry;
+
+
+/*!	Identifies a text run: the string, the font it is drawn with, and
+	everything else that changes where its glyphs end up on the pixel grid.
+*/
+struct TextRunKey {
+								TextRunKey(const FontCacheEntry* entry,
+									const char* string, uint32 length,
+									float deltaNonSpace, float deltaSpace,
+									uint8 spacing, float offsetX,
+									float offsetY);
+
+			bool				operator==(const TextRunKey& other) const;
+
+			const FontCacheEntry* entry;
+			const char*			string;
+			uint32				length;
+			float				delta_nonspace;
+			float				delta_space;
+			uint8				spacing;
+			float				offset_x;
+			float				offset_y;
+				// the fraction of the pixel the run starts at
+			uint32				hash;
+};
+
+
+/*!	The combined coverage of the glyphs of a text run, as it was composed
+	from the GlyphAtlas of its FontCacheEntry. The coverage is positioned
+	relative to the pixel the run starts at; subpixel runs have three
+	values per pixel.
+*/
+class TextRun : public BReferenceable,
+	public DoublyLinkedListLinkImpl<TextRun> {
+public:
+	static	TextRun*			Create(const TextRunKey& key,
+									uint32 bytesPerPixel, int32 left,
+									int32 top, int32 width, int32 height);
+
+			const TextRunKey&	Key() const
+									{ return fKey; }
+
+			uint8*				Bits() const
+									{ return fBits; }
+			uint32				BytesPerRow() const
+									{ return fBytesPerRow; }
+			uint32				BytesPerPixel() const
+									{ return fBytesPerPixel; }
+
+			int32				Left() const
+									{ return fLeft; }
+			int32				Top() const
+									{ return fTop; }
+			int32				Width() const
+									{ return fWidth; }
+			int32				Height() const
+									{ return fHeight; }
+
+			// the results of the layout, relative to the base line
+			void				SetLayout(const IntRect& bounds,
+									const BPoint& end);
+			const IntRect&		Bounds() const
+									{ return fBounds; }
+			const BPoint&		End() const
+									{ return fEnd; }
+
+			size_t				MemoryUsage() const
+									{ return fMemoryUsage; }
+
+			TextRun*&			HashLink()
+									{ return fHashLink; }
+
+protected:
+	virtual	void				LastReferenceReleased();
+
+private:
+								TextRun(const TextRunKey& key,
+									uint32 bytesPerPixel, int32 left,
+									int32 top, int32 width, int32 height);
+	virtual						~TextRun();
+
+private:
+			TextRunKey			fKey;
+			uint8*				fBits;
+			uint32				fBytesPerRow;
+			uint32				fBytesPerPixel;
+			int32				fLeft;
+			int32				fTop;
+			int32				fWidth;
+			int32				fHeight;
+			IntRect				fBounds;
+			BPoint				fEnd;
+			size_t				fMemoryUsage;
+			TextRun*			fHashLink;
+};
+
+
+/*!	Keeps the most recently drawn text runs of all fonts, up to a global
+	memory limit. Redrawing a run that is still cached is then just a matter
+	of blending its coverage.
+*/
+class TextRunCache {
+public:
+								TextRunCache(size_t maxMemoryUsage);
+								~TextRunCache();
+
+	static	TextRunCache*		Default();
+
+			size_t				MaxRunSize() const;
+
+			TextRun*			Lookup(const TextRunKey& key);
+			void				Insert(TextRun* run);
+			void				RemoveRuns(const FontCacheEntry* entry);
+
+private:
+	struct HashDefinition {
+		typedef TextRunKey		KeyType;
+		typedef	TextRun			ValueType;
+
+		size_t HashKey(const TextRunKey& key) const
+		{
+			return key.hash;
+		}
+
+		size_t Hash(TextRun* value) const
+		{
+			return value->Key().hash;
+		}
+
+		bool Compare(const TextRunKey& key, TextRun* value) const
+		{
+			return value->Key() == key;
+		}
+
+		TextRun*& GetLink(TextRun* value) const
+		{
+			return value->HashLink();
+		}
+	};
+
+	typedef BOpenHashTable<HashDefinition> RunTable;
+	typedef DoublyLinkedList<TextRun> RunList;
+
+			void				_Remove(TextRun* run);
+
+private:
+			BLocker				fLock;
+			RunTable			fTable;
+			RunList				fRuns;
+				// the most recently used run first
+			size_t				fMemoryUsage;
+			size_t				fMaxMemoryUsage;
+};
+
+
+#endif // TEXT_RUN_CACHE_H
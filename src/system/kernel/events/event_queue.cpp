@@ -108,7 +108,10 @@ public:
 
 private:
 	void				_Notify(select_event* event, uint16 events);
+	void				_Enqueue(select_event* event);
+	bool				_HasQueuedEvents();
 	status_t			_DeselectEvent(select_event* event);
+	void				_DeselectEvents(select_event** events, int32 count);
 
 	ssize_t				_DequeueEvents(event_wait_info* infos, int numInfos);
 
@@ -137,6 +140,13 @@ private:
 	 */
 	mutex				fQueueLock;
 
+	/*
+	 * Protects fEventList and the B_EVENT_QUEUED flag. Nests inside
+	 * fQueueLock; Notify() only needs this lock to queue an event, so that
+	 * readiness changes don't contend with select, deselect, and waiters.
+	 */
+	spinlock			fReadyLock;
+
 	/*
 	 * Notified when events are available on the queue.
 	 */
@@ -157,6 +167,7 @@ EventQueue::EventQueue(bool kernel)
 	fDequeueing(false)
 {
 	mutex_init(&fQueueLock, "event_queue lock");
+	B_INITIALIZE_SPINLOCK(&fReadyLock);
 	fQueueCondition.Init(this, "evtq wait");
 	fEventCondition.Init(this, "event_queue event change wait");
 }
@@ -177,8 +188,12 @@ EventQueue::~EventQueue()
 		mutex_lock(&fQueueLock);
 
 		iter.Remove();
+
+		InterruptsSpinLocker readyLocker(fReadyLock);
 		if ((event->events & B_EVENT_QUEUED) != 0)
 			fEventList.Remove(event);
+		readyLocker.Unlock();
+
 		delete event;
 	}
 
@@ -308,8 +323,11 @@ EventQueue::Deselect(int32 object, uint16 type)
 
 	if ((event->events & B_EVENT_INVALID) == 0)
 		fEventTree.Remove(event);
+
+	InterruptsSpinLocker readyLocker(fReadyLock);
 	if ((event->events & B_EVENT_QUEUED) != 0)
 		fEventList.Remove(event);
+	readyLocker.Unlock();
 
 	delete event;
 
@@ -326,6 +344,26 @@ EventQueue::_DeselectEvent(select_event* event)
 }
 
 
+/*
+ * Deselects and deletes events that have already been removed from the tree
+ * and the event list. Must be called with the queue lock held, which is
+ * dropped in the meantime.
+ */
+void
+EventQueue::_DeselectEvents(select_event** events, int32 count)
+{
+	mutex_unlock(&fQueueLock);
+	for (int32 i = 0; i < count; i++) {
+		_DeselectEvent(events[i]);
+		delete events[i];
+	}
+	mutex_lock(&fQueueLock);
+
+	// We don't need to notify waiters, as we removed the events
+	// from anywhere they could be found before dropping the lock.
+}
+
+
 status_t
 EventQueue::Notify(select_info* info, uint16 events)
 {
@@ -352,27 +390,52 @@ EventQueue::_Notify(select_event* event, uint16 events)
 	if ((previousEvents & B_EVENT_QUEUED) != 0 && (events & B_EVENT_INVALID) == 0)
 		return;
 
-	{
-		MutexLocker _(&fQueueLock);
+	if ((events & B_EVENT_INVALID) == 0) {
+		_Enqueue(event);
+		return;
+	}
 
-		// We need to recheck B_EVENT_DELETING now we have the lock.
-		if ((event->events & B_EVENT_DELETING) != 0)
-			return;
+	// If we get B_EVENT_INVALID it means the object we were monitoring was
+	// deleted. The object's ID may now be reused, so we must remove it
+	// from the event tree, which needs the queue lock.
+	MutexLocker _(&fQueueLock);
 
-		// If we get B_EVENT_INVALID it means the object we were monitoring was
-		// deleted. The object's ID may now be reused, so we must remove it
-		// from the event tree.
-		if ((events & B_EVENT_INVALID) != 0) {
-			atomic_or(&event->events, B_EVENT_INVALID);
-			fEventTree.Remove(event);
-		}
+	// We need to recheck B_EVENT_DELETING now we have the lock.
+	if ((event->events & B_EVENT_DELETING) != 0)
+		return;
 
-		// If it's not already queued, it's our responsibility to queue it.
-		if ((atomic_or(&event->events, B_EVENT_QUEUED) & B_EVENT_QUEUED) == 0) {
-			fEventList.Add(event);
-			fQueueCondition.NotifyAll();
-		}
-	}
+	atomic_or(&event->events, B_EVENT_INVALID);
+	fEventTree.Remove(event);
+
+	_Enqueue(event);
+}
+
+
+void
+EventQueue::_Enqueue(select_event* event)
+{
+	InterruptsSpinLocker locker(fReadyLock);
+
+	// We need to recheck B_EVENT_DELETING now we have the lock.
+	if ((event->events & B_EVENT_DELETING) != 0)
+		return;
+
+	// If it's not already queued, it's our responsibility to queue it.
+	if ((atomic_or(&event->events, B_EVENT_QUEUED) & B_EVENT_QUEUED) != 0)
+		return;
+
+	fEventList.Add(event);
+	locker.Unlock();
+
+	fQueueCondition.NotifyAll();
+}
+
+
+bool
+EventQueue::_HasQueuedEvents()
+{
+	InterruptsSpinLocker _(fReadyLock);
+	return !fEventList.IsEmpty();
 }
 
 
@@ -387,9 +450,18 @@ EventQueue::Wait(event_wait_info* infos, int numInfos,
 
 	ssize_t count = 0;
 	while (timeout == 0 || (system_time() < timeout)) {
-		while ((fDequeueing || fEventList.IsEmpty()) && !fClosing) {
-			status_t status = fQueueCondition.Wait(queueLocker.Get(),
-				flags | B_CAN_INTERRUPT, timeout);
+		while (!fClosing) {
+			// Events are queued without holding the queue lock, so we need to
+			// start waiting before checking whether there are any.
+			ConditionVariableEntry entry;
+			fQueueCondition.Add(&entry);
+			if (!fDequeueing && _HasQueuedEvents())
+				break;
+
+			queueLocker.Unlock();
+			status_t status = entry.Wait(flags | B_CAN_INTERRUPT, timeout);
+			queueLocker.Lock();
+
 			if (status != B_OK)
 				return status;
 		}
@@ -420,22 +492,26 @@ EventQueue::_DequeueEvents(event_wait_info* infos, int numInfos)
 {
 	ssize_t count = 0;
 
-	const int32 kMaxToDeselect = 8;
+	const int32 kMaxToDeselect = 32;
 	select_event* deselect[kMaxToDeselect];
 	int32 deselectCount = 0;
 
 	// Add a marker element, so we don't loop forever after unlocking the list.
 	// (There is only one invocation of _DequeueEvents() at a time.)
 	select_event marker = {};
+	InterruptsSpinLocker readyLocker(fReadyLock);
 	fEventList.Add(&marker);
+	readyLocker.Unlock();
 
 	for (select_event* event = NULL; count < numInfos; ) {
+		readyLocker.Lock();
 		if (fEventList.Head() == NULL || fEventList.Head() == &marker)
 			break;
 
 		event = fEventList.RemoveHead();
 		int32 events = atomic_and(&event->events,
 			~(event->selected_events | B_EVENT_QUEUED));
+		readyLocker.Unlock();
 
 		if ((events & B_EVENT_DELETING) != 0)
 			continue;
@@ -479,8 +555,10 @@ EventQueue::_DequeueEvents(event_wait_info* infos, int numInfos)
 			continue;
 
 		// Check if the event was requeued.
+		readyLocker.Lock();
 		if ((atomic_and(&event->events, ~B_EVENT_QUEUED) & B_EVENT_QUEUED) != 0)
 			fEventList.Remove(event);
+		readyLocker.Unlock();
 
 		if ((events & B_EVENT_INVALID) != 0) {
 			// The event will already have been removed from the tree.
@@ -491,26 +569,21 @@ EventQueue::_DequeueEvents(event_wait_info* infos, int numInfos)
 			event->events = B_EVENT_DELETING;
 
 			deselect[deselectCount++] = event;
-			if (deselectCount == kMaxToDeselect)
-				break;
+			if (deselectCount == kMaxToDeselect) {
+				// Keep going, the marker protects our position in the list.
+				_DeselectEvents(deselect, deselectCount);
+				deselectCount = 0;
+			}
 		}
 	}
 
+	if (!readyLocker.IsLocked())
+		readyLocker.Lock();
 	fEventList.Remove(&marker);
+	readyLocker.Unlock();
 
-	if (deselectCount != 0) {
-		mutex_unlock(&fQueueLock);
-		for (int32 i = 0; i < deselectCount; i++) {
-			select_event* event = deselect[i];
-
-			_DeselectEvent(event);
-			delete event;
-		}
-		mutex_lock(&fQueueLock);
-
-		// We don't need to notify waiters, as we removed the events
-		// from anywhere they could be found before dropping the lock.
-	}
+	if (deselectCount != 0)
+		_DeselectEvents(deselect, deselectCount);
 
 	return count;
 }
@@ -711,9 +784,11 @@ _user_event_queue_wait(int queue, event_wait_info* userInfos, int numInfos,
 	if (result < 0)
 		return syscall_restart_handle_timeout_post(result, timeout);
 
+	// Only copy back what we actually dequeued; callers with large arrays
+	// usually get only a few events at a time.
 	status_t status = B_OK;
-	if (numInfos != 0)
-		status = user_memcpy(userInfos, infos, sizeof(event_wait_info) * numInfos);
+	if (result > 0)
+		status = user_memcpy(userInfos, infos, sizeof(event_wait_info) * result);
 
 	return status == B_OK ? result : status;
 }
@@ -1014,8 +1014,12 @@ _user_recvfrom(int socket, void *data, size_t length, int flags,
 }
 
 
-ssize_t
-_user_recvmsg(int socket, struct msghdr *userMessage, int flags)
+/*!	Receives a single message into the userland \a userMessage header from
+	an already resolved socket \a descriptor.
+*/
+static ssize_t
+receive_userland_msghdr(file_descriptor* descriptor, msghdr* userMessage,
+	int flags)
 {
 	// copy message from userland
 	msghdr message;
@@ -1049,9 +1053,8 @@ _user_recvmsg(int socket, struct msghdr *userMessage, int flags)
 	}
 
 	// recvmsg()
-	SyscallRestartWrapper<ssize_t> result;
-
-	result = common_recvmsg(socket, &message, flags, false);
+	ssize_t result = sStackInterface->recvmsg(FD_SOCKET(descriptor), &message,
+		flags);
 	if (result < 0)
 		return result;
 
@@ -1072,6 +1075,76 @@ _user_recvmsg(int socket, struct msghdr *userMessage, int flags)
 }
 
 
+ssize_t
+_user_recvmsg(int socket, struct msghdr *userMessage, int flags)
+{
+	file_descriptor* descriptor;
+	GET_SOCKET_FD_OR_RETURN(socket, false, descriptor);
+	FileDescriptorPutter _(descriptor);
+
+	SyscallRestartWrapper<ssize_t> result;
+	return result = receive_userland_msghdr(descriptor, userMessage, flags);
+}
+
+
+/*!	Receives up to \a count messages with a single socket lookup. If an error
+	occurs after at least one message has been received, the number of
+	messages received so far is returned, and the error is discarded; only
+	an error that persists, like that of a reset connection, is reported
+	again by the next call. The \a timeout is only checked after each
+	message.
+*/
+ssize_t
+_user_recvmmsg(int socket, struct mmsghdr *userMessages, unsigned int count,
+	int flags, bigtime_t timeout)
+{
+	if (count > IOV_MAX)
+		count = IOV_MAX;
+	if (userMessages == NULL
+		|| !is_user_address_range(userMessages, sizeof(mmsghdr) * count)) {
+		return B_BAD_ADDRESS;
+	}
+
+	file_descriptor* descriptor;
+	GET_SOCKET_FD_OR_RETURN(socket, false, descriptor);
+	FileDescriptorPutter _(descriptor);
+
+	const bool waitForOne = (flags & MSG_WAITFORONE) != 0;
+	flags &= ~MSG_WAITFORONE;
+
+	bigtime_t deadline = B_INFINITE_TIMEOUT;
+	if (timeout >= 0 && timeout != B_INFINITE_TIMEOUT)
+		deadline = system_time() + timeout;
+
+	SyscallRestartWrapper<ssize_t> result;
+
+	unsigned int received = 0;
+	while (received < count) {
+		ssize_t bytesReceived = receive_userland_msghdr(descriptor,
+			&userMessages[received].msg_hdr, flags);
+		if (bytesReceived < 0) {
+			if (received > 0)
+				break;
+			return result = bytesReceived;
+		}
+
+		unsigned int length = bytesReceived;
+		if (user_memcpy(&userMessages[received].msg_len, &length,
+				sizeof(length)) != B_OK) {
+			return B_BAD_ADDRESS;
+		}
+		received++;
+
+		if (waitForOne)
+			flags |= MSG_DONTWAIT;
+		if (deadline != B_INFINITE_TIMEOUT && system_time() >= deadline)
+			break;
+	}
+
+	return result = received;
+}
+
+
 ssize_t
 _user_send(int socket, const void *data, size_t length, int flags)
 {
@@ -1114,8 +1187,12 @@ _user_sendto(int socket, const void *data, size_t length, int flags,
 }
 
 
-ssize_t
-_user_sendmsg(int socket, const struct msghdr *userMessage, int flags)
+/*!	Sends a single message described by the userland \a userMessage header
+	through an already resolved socket \a descriptor.
+*/
+static ssize_t
+send_userland_msghdr(file_descriptor* descriptor, const msghdr* userMessage,
+	int flags)
 {
 	// copy message from userland
 	msghdr message;
@@ -1158,9 +1235,62 @@ _user_sendmsg(int socket, const struct msghdr *userMessage, int flags)
 	}
 
 	// sendmsg()
+	return sStackInterface->sendmsg(FD_SOCKET(descriptor), &message, flags);
+}
+
+
+ssize_t
+_user_sendmsg(int socket, const struct msghdr *userMessage, int flags)
+{
+	file_descriptor* descriptor;
+	GET_SOCKET_FD_OR_RETURN(socket, false, descriptor);
+	FileDescriptorPutter _(descriptor);
+
 	SyscallRestartWrapper<ssize_t> result;
+	return result = send_userland_msghdr(descriptor, userMessage, flags);
+}
+
+
+/*!	Sends up to \a count messages with a single socket lookup. If an error
+	occurs after at least one message has been sent, the number of messages
+	sent so far is returned.
+*/
+ssize_t
+_user_sendmmsg(int socket, struct mmsghdr *userMessages, unsigned int count,
+	int flags)
+{
+	if (count > IOV_MAX)
+		count = IOV_MAX;
+	if (userMessages == NULL
+		|| !is_user_address_range(userMessages, sizeof(mmsghdr) * count)) {
+		return B_BAD_ADDRESS;
+	}
+
+	file_descriptor* descriptor;
+	GET_SOCKET_FD_OR_RETURN(socket, false, descriptor);
+	FileDescriptorPutter _(descriptor);
+
+	SyscallRestartWrapper<ssize_t> result;
+
+	unsigned int sent = 0;
+	while (sent < count) {
+		ssize_t bytesSent = send_userland_msghdr(descriptor,
+			&userMessages[sent].msg_hdr, flags);
+		if (bytesSent < 0) {
+			if (sent > 0)
+				break;
+			return result = bytesSent;
+		}
+
+		unsigned int length = bytesSent;
+		if (user_memcpy(&userMessages[sent].msg_len, &length,
+				sizeof(length)) != B_OK) {
+			return B_BAD_ADDRESS;
+		}
+		sent++;
+	}
 
-	return result = common_sendmsg(socket, &message, flags, false);
+	return result = sent;
 }
 
 
@@ -21,6 +21,7 @@
 #include <syscall_utils.h>
 
 #include <syscalls.h>
+#include <time_private.h>
 
 
 static void
@@ -286,6 +287,19 @@ recvmsg(int socket, struct msghdr *message, int flags)
 }
 
 
+extern "C" int
+recvmmsg(int socket, struct mmsghdr *messages, unsigned int count, int flags,
+	struct timespec *timeout)
+{
+	bigtime_t timeoutMicros = -1;
+	if (timeout != NULL && !timespec_to_bigtime(*timeout, timeoutMicros))
+		RETURN_AND_SET_ERRNO_TEST_CANCEL(B_BAD_VALUE);
+
+	RETURN_AND_SET_ERRNO_TEST_CANCEL(_kern_recvmmsg(socket, messages, count,
+		flags, timeoutMicros));
+}
+
+
 extern "C" ssize_t
 send(int socket, const void *data, size_t length, int flags)
 {
@@ -317,6 +331,14 @@ sendmsg(int socket, const struct msghdr *message, int flags)
 }
 
 
+extern "C" int
+sendmmsg(int socket, struct mmsghdr *messages, unsigned int count, int flags)
+{
+	RETURN_AND_SET_ERRNO_TEST_CANCEL(_kern_sendmmsg(socket, messages, count,
+		flags));
+}
+
+
 extern "C" int
 getsockopt(int socket, int level, int option, void *value, socklen_t *_length)
 {
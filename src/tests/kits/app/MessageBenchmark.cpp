@@ -0,0 +1,163 @@
+/*
+ * Copyright 2026, Haiku, Inc. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+/*!	Measures how long it takes to build, copy, flatten, unflatten, and send
+	a BMessage through a port, for messages the size of input events, of
+	typical requests, and of messages too large to be kept in one buffer.
+*/
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <Message.h>
+#include <Messenger.h>
+#include <OS.h>
+#include <Point.h>
+#include <Rect.h>
+
+#include <AppMisc.h>
+#include <MessengerPrivate.h>
+
+
+typedef void (*build_function)(BMessage& message);
+
+
+static void
+build_event(BMessage& message)
+{
+	message.AddInt64("when", system_time());
+	message.AddPoint("where", BPoint(100, 200));
+	message.AddPoint("be:view_where", BPoint(20, 30));
+	message.AddInt32("modifiers", 0);
+	message.AddInt32("buttons", 1);
+	message.AddInt32("be:transit", 1);
+}
+
+
+static void
+build_request(BMessage& message)
+{
+	message.AddString("name", "Tracker status window");
+	message.AddRect("frame", BRect(10, 10, 400, 300));
+	for (int32 i = 0; i < 32; i++)
+		message.AddInt32("item", i);
+	for (int32 i = 0; i < 16; i++)
+		message.AddString("path", "/boot/home/Desktop/some file.txt");
+	message.AddBool("replace", true);
+}
+
+
+static void
+build_large(BMessage& message)
+{
+	char buffer[1024];
+	memset(buffer, 'x', sizeof(buffer));
+
+	for (int32 i = 0; i < 16; i++)
+		message.AddData("data", B_RAW_TYPE, buffer, sizeof(buffer), false);
+	message.AddString("name", "large");
+}
+
+
+struct message_case {
+	const char*		name;
+	build_function	build;
+};
+
+static const message_case kCases[] = {
+	{ "event", build_event },
+	{ "request", build_request },
+	{ "large", build_large },
+};
+
+
+static double
+nanoseconds_per_iteration(bigtime_t start, int32 iterations)
+{
+	return (system_time() - start) * 1000.0 / iterations;
+}
+
+
+static void
+benchmark(const message_case& messageCase, int32 iterations, port_id port,
+	char* buffer, size_t bufferSize)
+{
+	BMessage message('bnch');
+	messageCase.build(message);
+	ssize_t size = message.FlattenedSize();
+
+	printf("%-8s %6" B_PRIdSSIZE " bytes", messageCase.name, size);
+
+	bigtime_t start = system_time();
+	for (int32 i = 0; i < iterations; i++) {
+		BMessage built('bnch');
+		messageCase.build(built);
+	}
+	printf("  build %7.0f", nanoseconds_per_iteration(start, iterations));
+
+	start = system_time();
+	for (int32 i = 0; i < iterations; i++)
+		BMessage copy(message);
+	printf("  copy %7.0f", nanoseconds_per_iteration(start, iterations));
+
+	start = system_time();
+	for (int32 i = 0; i < iterations; i++)
+		message.Flatten(buffer, size);
+	printf("  flatten %7.0f", nanoseconds_per_iteration(start, iterations));
+
+	start = system_time();
+	for (int32 i = 0; i < iterations; i++) {
+		BMessage unflattened;
+		unflattened.Unflatten(buffer);
+	}
+	printf("  unflatten %7.0f", nanoseconds_per_iteration(start, iterations));
+
+	BMessenger messenger;
+	BMessenger::Private(messenger).SetTo(BPrivate::current_team(), port,
+		B_PREFERRED_TOKEN);
+
+	start = system_time();
+	for (int32 i = 0; i < iterations; i++) {
+		messenger.SendMessage(&message);
+
+		int32 code;
+		read_port(port, &code, buffer, bufferSize);
+	}
+	printf("  send %7.0f ns\n", nanoseconds_per_iteration(start, iterations));
+}
+
+
+int
+main(int argc, char** argv)
+{
+	int32 iterations = 100000;
+	if (argc > 1)
+		iterations = atoi(argv[1]);
+	if (iterations <= 0) {
+		fprintf(stderr, "usage: %s [iterations]\n", argv[0]);
+		return 1;
+	}
+
+	port_id port = create_port(1, "message benchmark");
+	if (port < 0) {
+		fprintf(stderr, "Could not create port: %s\n", strerror(port));
+		return 1;
+	}
+
+	const size_t bufferSize = 64 * 1024;
+	char* buffer = (char*)malloc(bufferSize);
+	if (buffer == NULL)
+		return 1;
+
+	for (size_t i = 0; i < sizeof(kCases) / sizeof(kCases[0]); i++)
+		benchmark(kCases[i], iterations, port, buffer, bufferSize);
+
+	free(buffer);
+	delete_port(port);
+	return 0;
+}
@@ -0,0 +1,209 @@
+/*
+ * Copyright 2026, Haiku, Inc. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+/*!	Measures how many messages per second a number of threads can pass to a
+	single consumer, once through a BMessageQueue directly, and once by
+	sending them to a BLooper in the same team with a BMessenger, which
+	puts them into the looper's queue without going through its port.
+*/
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <Looper.h>
+#include <Message.h>
+#include <MessageQueue.h>
+#include <Messenger.h>
+#include <OS.h>
+
+
+static const uint32 kBenchmarkMessage = 'bnch';
+static const int32 kProducers[] = { 1, 2, 4, 8 };
+static const int32 kMaxProducers = 8;
+
+
+struct queue_benchmark {
+	BMessageQueue	queue;
+	int32			iterations;
+	int32			remaining;
+};
+
+
+class CountingLooper : public BLooper {
+public:
+	CountingLooper(int32 count)
+		:
+		BLooper("counting looper"),
+		fRemaining(count),
+		fDone(create_sem(0, "all received"))
+	{
+	}
+
+	virtual ~CountingLooper()
+	{
+		delete_sem(fDone);
+	}
+
+	virtual void MessageReceived(BMessage* message)
+	{
+		if (message->what != kBenchmarkMessage) {
+			BLooper::MessageReceived(message);
+			return;
+		}
+
+		if (--fRemaining == 0)
+			release_sem(fDone);
+	}
+
+	void WaitForAll()
+	{
+		while (acquire_sem(fDone) == B_INTERRUPTED)
+			;
+	}
+
+private:
+	int32			fRemaining;
+	sem_id			fDone;
+};
+
+
+struct looper_benchmark {
+	BMessenger		messenger;
+	int32			iterations;
+};
+
+
+static status_t
+queue_producer(void* data)
+{
+	queue_benchmark* benchmark = (queue_benchmark*)data;
+
+	for (int32 i = 0; i < benchmark->iterations; i++)
+		benchmark->queue.AddMessage(new BMessage(kBenchmarkMessage));
+
+	return B_OK;
+}
+
+
+static status_t
+looper_producer(void* data)
+{
+	looper_benchmark* benchmark = (looper_benchmark*)data;
+
+	BMessage message(kBenchmarkMessage);
+	for (int32 i = 0; i < benchmark->iterations; i++)
+		benchmark->messenger.SendMessage(&message);
+
+	return B_OK;
+}
+
+
+static void
+start_producers(thread_id* threads, int32 count, thread_func function,
+	void* data)
+{
+	for (int32 i = 0; i < count; i++) {
+		threads[i] = spawn_thread(function, "producer", B_NORMAL_PRIORITY,
+			data);
+	}
+	for (int32 i = 0; i < count; i++)
+		resume_thread(threads[i]);
+}
+
+
+static void
+wait_for_producers(thread_id* threads, int32 count)
+{
+	for (int32 i = 0; i < count; i++) {
+		status_t status;
+		wait_for_thread(threads[i], &status);
+	}
+}
+
+
+static void
+print_result(const char* name, int32 producers, int32 messages,
+	bigtime_t time)
+{
+	printf("%-8s %2" B_PRId32 " producers  %10.0f messages/s\n", name,
+		producers, messages * 1000000.0 / time);
+}
+
+
+static void
+benchmark_queue(int32 producers, int32 iterations)
+{
+	queue_benchmark benchmark;
+	benchmark.iterations = iterations;
+
+	thread_id threads[kMaxProducers];
+	int32 remaining = producers * iterations;
+
+	bigtime_t start = system_time();
+	start_producers(threads, producers, queue_producer, &benchmark);
+
+	while (remaining > 0) {
+		BMessage* message = benchmark.queue.NextMessage();
+		if (message == NULL)
+			continue;
+
+		delete message;
+		remaining--;
+	}
+
+	print_result("queue", producers, producers * iterations,
+		system_time() - start);
+	wait_for_producers(threads, producers);
+}
+
+
+static void
+benchmark_looper(int32 producers, int32 iterations)
+{
+	CountingLooper* looper = new CountingLooper(producers * iterations);
+	looper->Run();
+
+	looper_benchmark benchmark;
+	benchmark.messenger = BMessenger(NULL, looper);
+	benchmark.iterations = iterations;
+
+	thread_id threads[kMaxProducers];
+
+	bigtime_t start = system_time();
+	start_producers(threads, producers, looper_producer, &benchmark);
+	looper->WaitForAll();
+
+	print_result("looper", producers, producers * iterations,
+		system_time() - start);
+	wait_for_producers(threads, producers);
+
+	looper->Lock();
+	looper->Quit();
+}
+
+
+int
+main(int argc, char** argv)
+{
+	int32 iterations = 100000;
+	if (argc > 1)
+		iterations = atoi(argv[1]);
+	if (iterations <= 0) {
+		fprintf(stderr, "usage: %s [iterations per producer]\n", argv[0]);
+		return 1;
+	}
+
+	const int32 count = sizeof(kProducers) / sizeof(kProducers[0]);
+
+	for (int32 i = 0; i < count; i++)
+		benchmark_queue(kProducers[i], iterations);
+	for (int32 i = 0; i < count; i++)
+		benchmark_looper(kProducers[i], iterations);
+
+	return 0;
+}
@@ -0,0 +1,103 @@
+/*
+ * Copyright 2026, Haiku, Inc. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+/*!	Checks that text measured from the font metrics the app_server shares
+	with its clients gives the same results as asking the app_server, and
+	measures how many StringWidth() calls per second can be done.
+
+	The first measurement of a font size is always done by the app_server,
+	which then publishes the metrics of that font; later measurements are
+	done locally.
+*/
+
+
+#include <Application.h>
+#include <Font.h>
+#include <String.h>
+
+#include <stdio.h>
+#include <string.h>
+
+
+static const char* kStrings[] = {
+	"Hello, world!",
+	"The quick brown fox jumps over the lazy dog.",
+	"  tabs\tand\tspaces  ",
+	"Grüße aus Köln, ça va? ¿Qué tal? £5 ±1°",
+	"1234567890 ()[]{}<>/\\|!?@#$%^&*",
+};
+static const int32 kStringCount = sizeof(kStrings) / sizeof(kStrings[0]);
+
+static const uint8 kSpacings[] = {
+	B_BITMAP_SPACING, B_CHAR_SPACING, B_FIXED_SPACING
+};
+
+
+static int32
+check_font(const BFont& baseFont, const char* name)
+{
+	int32 failures = 0;
+
+	for (int32 i = 0; i < 60; i++) {
+		BFont font(baseFont);
+		font.SetSize(8.0f + i * 0.5f);
+		font.SetSpacing(kSpacings[i % 3]);
+
+		const char* string = kStrings[i % kStringCount];
+		int32 numChars = BString(string).CountChars();
+
+		// the first call goes to the app_server
+		float serverWidth = font.StringWidth(string);
+		float localWidth = font.StringWidth(string);
+
+		float serverEscapements[64];
+		float localEscapements[64];
+		escapement_delta delta = { 0.5f, 1.5f };
+		font.SetSize(font.Size() + 0.125f);
+		font.GetEscapements(string, numChars, &delta, serverEscapements);
+		font.GetEscapements(string, numChars, &delta, localEscapements);
+
+		if (serverWidth != localWidth) {
+			printf("%s %.3f: width of \"%s\" is %.6f, locally %.6f\n", name,
+				font.Size(), string, serverWidth, localWidth);
+			failures++;
+		}
+		if (memcmp(serverEscapements, localEscapements,
+				numChars * sizeof(float)) != 0) {
+			printf("%s %.3f: escapements of \"%s\" differ\n", name,
+				font.Size(), string);
+			failures++;
+		}
+	}
+
+	return failures;
+}
+
+
+int
+main()
+{
+	BApplication app("application/x-vnd.Haiku-StringWidthTest");
+
+	int32 failures = check_font(*be_plain_font, "plain");
+	failures += check_font(*be_bold_font, "bold");
+	failures += check_font(*be_fixed_font, "fixed");
+	printf("%" B_PRId32 " differences\n", failures);
+
+	BFont font(be_plain_font);
+	const int32 kIterations = 100000;
+	float total = 0;
+
+	bigtime_t start = system_time();
+	for (int32 i = 0; i < kIterations; i++)
+		total += font.StringWidth(kStrings[i % kStringCount]);
+	bigtime_t time = system_time() - start;
+
+	printf("%" B_PRId32 " StringWidth() calls: %.3f µs per call (%.1f)\n",
+		kIterations, (double)time / kIterations, total);
+
+	return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,116 @@
+/*
+ * Copyright 2026, Haiku, Inc. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+/*!	Times the BRegion operations the app_server uses most, on regions like
+	the ones found on a desktop: the screen minus a number of windows, and
+	the visible parts of a window.
+*/
+
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <OS.h>
+#include <Region.h>
+
+
+static const BRect kScreen(0, 0, 3839, 2159);
+
+
+static BRect
+random_window()
+{
+	float left = rand() % 3400;
+	float top = rand() % 1800;
+	return BRect(left, top, left + 200 + rand() % 800, top + 150 + rand() % 600);
+}
+
+
+static void
+create_desktop(BRegion& background, BRect* windows, int32 windowCount)
+{
+	background.Set(kScreen);
+	for (int32 i = 0; i < windowCount; i++) {
+		windows[i] = random_window();
+		background.Exclude(windows[i]);
+	}
+}
+
+
+static void
+benchmark(int32 windowCount, int32 iterations)
+{
+	srand(windowCount);
+
+	BRect* windows = new BRect[windowCount];
+	BRegion background;
+	create_desktop(background, windows, windowCount);
+
+	// excluding a window from the screen, as done for each window when the
+	// clipping is rebuilt
+	bigtime_t start = system_time();
+	for (int32 i = 0; i < iterations; i++) {
+		BRegion region(background);
+		region.Exclude(windows[i % windowCount]);
+	}
+	bigtime_t exclude = system_time() - start;
+
+	// adding a moved window's old frame to the dirty region
+	start = system_time();
+	for (int32 i = 0; i < iterations; i++) {
+		BRegion region(background);
+		region.Include(windows[i % windowCount]);
+	}
+	bigtime_t include = system_time() - start;
+
+	// clipping a drawing operation against the visible region
+	BRegion operand;
+	operand.Set(windows[0]);
+	start = system_time();
+	for (int32 i = 0; i < iterations; i++) {
+		BRegion region(background);
+		operand.Set(windows[i % windowCount]);
+		region.IntersectWith(&operand);
+	}
+	bigtime_t intersect = system_time() - start;
+
+	// hit testing
+	int32 hits = 0;
+	start = system_time();
+	for (int32 i = 0; i < iterations * 16; i++) {
+		if (background.Contains(rand() % 3840, rand() % 2160))
+			hits++;
+		if (background.Intersects(random_window()))
+			hits++;
+	}
+	bigtime_t contains = system_time() - start;
+
+	printf("%4" B_PRId32 " windows, %5" B_PRId32 " rects: exclude %6.2f us, "
+		"include %6.2f us, intersect %6.2f us, hit test %6.3f us (%" B_PRId32
+		")\n", windowCount, background.CountRects(),
+		(double)exclude / iterations, (double)include / iterations,
+		(double)intersect / iterations, (double)contains / iterations / 32,
+		hits);
+
+	delete[] windows;
+}
+
+
+int
+main(int argc, char** argv)
+{
+	int32 iterations = 10000;
+	if (argc > 1)
+		iterations = atoi(argv[1]);
+
+	static const int32 kWindowCounts[] = { 1, 10, 50, 100, 200 };
+	for (size_t i = 0; i < sizeof(kWindowCounts) / sizeof(kWindowCounts[0]);
+			i++) {
+		benchmark(kWindowCounts[i], iterations);
+	}
+
+	return 0;
+}
@@ -0,0 +1,284 @@
+/*
+ * Copyright 2026, Haiku, Inc. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+/*!	Applies random sequences of operations to regions, and compares the
+	results against a plain bitmap of the same area. Also verifies that the
+	rectangles stay sorted and banded, as the region code relies on that.
+*/
+
+
+#include "RegionFuzz.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <OS.h>
+#include <Region.h>
+
+
+static const int32 kOffset = 8;
+static const int32 kGridSize = 80;
+	// covers the coordinates from -8 to 71
+static const int32 kIterations = 5000;
+
+
+struct Grid {
+	bool	pixels[kGridSize][kGridSize];
+
+	Grid()
+	{
+		memset(pixels, 0, sizeof(pixels));
+	}
+
+	void Set(BRect rect, bool value)
+	{
+		if (!rect.IsValid())
+			return;
+
+		for (int32 y = (int32)rect.top; y <= (int32)rect.bottom; y++) {
+			for (int32 x = (int32)rect.left; x <= (int32)rect.right; x++)
+				pixels[y + kOffset][x + kOffset] = value;
+		}
+	}
+
+	bool Contains(int32 x, int32 y) const
+	{
+		x += kOffset;
+		y += kOffset;
+		return x >= 0 && y >= 0 && x < kGridSize && y < kGridSize
+			&& pixels[y][x];
+	}
+};
+
+
+static BRect
+random_rect(unsigned int& seed)
+{
+	int32 left = rand_r(&seed) % 48 - 4;
+	int32 top = rand_r(&seed) % 48 - 4;
+	if (rand_r(&seed) % 20 == 0)
+		return BRect(left, top, left - 1, top);
+
+	return BRect(left, top, left + rand_r(&seed) % 20,
+		top + rand_r(&seed) % 20);
+}
+
+
+static bool
+matches(const BRegion& region, const Grid& grid, unsigned int& seed)
+{
+	for (int32 y = -kOffset; y < kGridSize - kOffset; y++) {
+		for (int32 x = -kOffset; x < kGridSize - kOffset; x++) {
+			if (region.Contains(x, y) != grid.Contains(x, y))
+				return false;
+		}
+	}
+
+	// the rectangles must be sorted by band, and must neither overlap nor
+	// touch within a band
+	BRect frame;
+	for (int32 i = 0; i < region.CountRects(); i++) {
+		clipping_rect rect = region.RectAtInt(i);
+		if (rect.left > rect.right || rect.top > rect.bottom)
+			return false;
+
+		if (i > 0) {
+			clipping_rect previous = region.RectAtInt(i - 1);
+			if (previous.top == rect.top) {
+				if (previous.bottom != rect.bottom
+					|| previous.right + 1 >= rect.left) {
+					return false;
+				}
+			} else if (previous.bottom >= rect.top)
+				return false;
+		}
+
+		frame = i == 0 ? region.RectAt(i) : frame | region.RectAt(i);
+	}
+	if (region.CountRects() > 0 && frame != region.Frame())
+		return false;
+
+	for (int32 i = 0; i < 4; i++) {
+		BRect rect = random_rect(seed);
+		if (!rect.IsValid())
+			continue;
+
+		bool intersects = false;
+		for (int32 y = (int32)rect.top; y <= (int32)rect.bottom; y++) {
+			for (int32 x = (int32)rect.left; x <= (int32)rect.right; x++)
+				intersects |= grid.Contains(x, y);
+		}
+		if (region.Intersects(rect) != intersects)
+			return false;
+	}
+
+	return true;
+}
+
+
+static bool
+run_random_operations(unsigned int seed)
+{
+	for (int32 iteration = 0; iteration < kIterations; iteration++) {
+		BRegion a;
+		BRegion b;
+		Grid gridA;
+		Grid gridB;
+
+		int32 count = rand_r(&seed) % 8;
+		for (int32 i = 0; i < count; i++) {
+			BRect rect = random_rect(seed);
+			bool exclude = rand_r(&seed) % 4 == 0;
+			if (exclude)
+				a.Exclude(rect);
+			else
+				a.Include(rect);
+			gridA.Set(rect, !exclude);
+
+			if (!matches(a, gridA, seed))
+				return false;
+		}
+
+		count = rand_r(&seed) % 8;
+		for (int32 i = 0; i < count; i++) {
+			BRect rect = random_rect(seed);
+			b.Include(rect);
+			gridB.Set(rect, true);
+		}
+		if (!matches(b, gridB, seed))
+			return false;
+
+		BRegion result(a);
+		Grid expected;
+		int32 operation = rand_r(&seed) % 5;
+		switch (operation) {
+			case 0:
+				result.Include(&b);
+				break;
+			case 1:
+				result.Exclude(&b);
+				break;
+			case 2:
+				result.IntersectWith(&b);
+				break;
+			case 3:
+				result.ExclusiveInclude(&b);
+				break;
+			case 4:
+				result = b;
+				break;
+		}
+
+		for (int32 y = 0; y < kGridSize; y++) {
+			for (int32 x = 0; x < kGridSize; x++) {
+				bool inA = gridA.pixels[y][x];
+				bool inB = gridB.pixels[y][x];
+				bool& pixel = expected.pixels[y][x];
+				switch (operation) {
+					case 0:
+						pixel = inA || inB;
+						break;
+					case 1:
+						pixel = inA && !inB;
+						break;
+					case 2:
+						pixel = inA && inB;
+						break;
+					case 3:
+						pixel = inA != inB;
+						break;
+					case 4:
+						pixel = inB;
+						break;
+				}
+			}
+		}
+		if (!matches(result, expected, seed))
+			return false;
+
+		// operations of a region with itself
+		BRegion copy(result);
+		copy.IntersectWith(&copy);
+		copy.Include(&copy);
+		if (!matches(copy, expected, seed))
+			return false;
+
+		copy.Exclude(&copy);
+		if (copy.CountRects() != 0)
+			return false;
+	}
+
+	return true;
+}
+
+
+static status_t
+random_operations_thread(void* data)
+{
+	return run_random_operations((unsigned int)(addr_t)data) ? B_OK : B_ERROR;
+}
+
+
+// #pragma mark -
+
+
+RegionFuzz::RegionFuzz(std::string name)
+	:
+	TestCase(name)
+{
+}
+
+
+RegionFuzz::~RegionFuzz()
+{
+}
+
+
+void
+RegionFuzz::RandomOperationsTest()
+{
+	CPPUNIT_ASSERT(run_random_operations(1234));
+}
+
+
+/*!	The regions cache their rectangle arrays per thread, make sure that
+	threads don't get in each other's way.
+*/
+void
+RegionFuzz::ConcurrentOperationsTest()
+{
+	static const int32 kThreadCount = 4;
+	thread_id threads[kThreadCount];
+
+	for (int32 i = 0; i < kThreadCount; i++) {
+		threads[i] = spawn_thread(&random_operations_thread, "region fuzz",
+			B_NORMAL_PRIORITY, (void*)(addr_t)(i + 1));
+		CPPUNIT_ASSERT(threads[i] >= 0);
+		resume_thread(threads[i]);
+	}
+
+	for (int32 i = 0; i < kThreadCount; i++) {
+		status_t result;
+		CPPUNIT_ASSERT(wait_for_thread(threads[i], &result) == B_OK);
+		CPPUNIT_ASSERT(result == B_OK);
+	}
+}
+
+
+/*static*/ Test*
+RegionFuzz::suite()
+{
+	TestSuite* suite = new TestSuite("RegionFuzz");
+
+	suite->addTest(new CppUnit::TestCaller<RegionFuzz>(
+		"BRegion::Random operations test",
+		&RegionFuzz::RandomOperationsTest));
+	suite->addTest(new CppUnit::TestCaller<RegionFuzz>(
+		"BRegion::Concurrent operations test",
+		&RegionFuzz::ConcurrentOperationsTest));
+
+	return suite;
+}
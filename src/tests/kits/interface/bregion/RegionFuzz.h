@@ -0,0 +1,27 @@
+/*
+ * Copyright 2026, Haiku, Inc. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+#ifndef REGION_FUZZ_H
+#define REGION_FUZZ_H
+
+
+#include "../common.h"
+
+
+class BRegion;
+
+
+class RegionFuzz : public TestCase {
+public:
+								RegionFuzz(std::string name = "");
+	virtual						~RegionFuzz();
+
+			void				RandomOperationsTest();
+			void				ConcurrentOperationsTest();
+
+	static	Test*				suite();
+};
+
+
+#endif	// REGION_FUZZ_H
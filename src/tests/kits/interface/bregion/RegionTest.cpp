@@ -1,6 +1,7 @@
 #include "../common.h"
 #include "RegionConstruction.h"
 #include "RegionExclude.h"
+#include "RegionFuzz.h"
 #include "RegionInclude.h"
 #include "RegionIntersect.h"
 #include "RegionOffsetBy.h"
@@ -11,6 +12,7 @@ Test *RegionTestSuite()
 	
 	testSuite->addTest(RegionConstruction::suite());
 	testSuite->addTest(RegionExclude::suite());
+	testSuite->addTest(RegionFuzz::suite());
 	testSuite->addTest(RegionInclude::suite());
 	testSuite->addTest(RegionIntersect::suite());
 	testSuite->addTest(RegionOffsetBy::suite());
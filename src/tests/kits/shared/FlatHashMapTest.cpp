@@ -0,0 +1,194 @@
+/*
+ * Copyright 2026, Haiku, Inc. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+#include "FlatHashMapTest.h"
+
+#include <stdlib.h>
+
+#include <FlatHashMap.h>
+#include <FlatHashSet.h>
+#include <HashMap.h>
+#include <HashString.h>
+#include <String.h>
+
+#include <cppunit/TestCaller.h>
+#include <cppunit/TestSuite.h>
+
+
+typedef FlatHashMap<HashKey32<int32>, int32> IntMap;
+
+
+FlatHashMapTest::FlatHashMapTest()
+{
+}
+
+
+FlatHashMapTest::~FlatHashMapTest()
+{
+}
+
+
+void
+FlatHashMapTest::TestPutGet()
+{
+	FlatHashMap<HashString, BString> map;
+
+	CPPUNIT_ASSERT_EQUAL(B_OK, map.InitCheck());
+	CPPUNIT_ASSERT_EQUAL(0, map.Size());
+	CPPUNIT_ASSERT_EQUAL(BString(""), map.Get(HashString("Red")));
+
+// ----------------------
+	map.Put(HashString("Red"), "Rot");
+	map.Put(HashString("Yellow"), "Gelb");
+	map.Put(HashString("Red"), "Rouge");
+// ----------------------
+
+	CPPUNIT_ASSERT_EQUAL(2, map.Size());
+	CPPUNIT_ASSERT_EQUAL(BString("Rouge"), map.Get(HashString("Red")));
+	CPPUNIT_ASSERT_EQUAL(BString("Gelb"), map.Get(HashString("Yellow")));
+	CPPUNIT_ASSERT(!map.ContainsKey(HashString("Green")));
+
+	BString* value;
+	CPPUNIT_ASSERT(map.Get(HashString("Yellow"), value));
+	value->SetTo("Jaune");
+	CPPUNIT_ASSERT_EQUAL(BString("Jaune"), map.Get(HashString("Yellow")));
+}
+
+
+void
+FlatHashMapTest::TestRemove()
+{
+	FlatHashMap<HashString, BString> map;
+	map.Put(HashString("Town"), "Tirau");
+	map.Put(HashString("Lake"), "Taupo");
+
+// ----------------------
+	BString resultOcean = map.Remove(HashString("Ocean"));
+	BString resultLake = map.Remove(HashString("Lake"));
+// ----------------------
+
+	CPPUNIT_ASSERT_EQUAL(1, map.Size());
+	CPPUNIT_ASSERT_EQUAL(BString(""), resultOcean);
+	CPPUNIT_ASSERT_EQUAL(BString("Taupo"), resultLake);
+	CPPUNIT_ASSERT_EQUAL(BString("Tirau"), map.Get(HashString("Town")));
+	CPPUNIT_ASSERT(!map.ContainsKey(HashString("Lake")));
+
+	map.Clear();
+	CPPUNIT_ASSERT_EQUAL(0, map.Size());
+	CPPUNIT_ASSERT(!map.ContainsKey(HashString("Town")));
+}
+
+
+/*!	Adds and removes random keys, so that the table is grown, and has to
+	reuse deleted slots, and compares it with a HashMap.
+*/
+void
+FlatHashMapTest::TestManyElements()
+{
+	IntMap map;
+	HashMap<HashKey32<int32>, int32> reference;
+	srand(42);
+
+	for (int32 i = 0; i < 200000; i++) {
+		int32 key = rand() % 5000;
+		if (rand() % 3 != 0) {
+			CPPUNIT_ASSERT_EQUAL(B_OK, map.Put(key, i));
+			reference.Put(key, i);
+		} else
+			CPPUNIT_ASSERT_EQUAL(reference.Remove(key), map.Remove(key));
+
+		CPPUNIT_ASSERT_EQUAL(reference.Size(), map.Size());
+	}
+
+	for (int32 key = 0; key < 5000; key++) {
+		CPPUNIT_ASSERT_EQUAL(reference.ContainsKey(key), map.ContainsKey(key));
+		CPPUNIT_ASSERT_EQUAL(reference.Get(key), map.Get(key));
+	}
+}
+
+
+void
+FlatHashMapTest::TestRemoveWhileIterating()
+{
+	IntMap map;
+	CPPUNIT_ASSERT_EQUAL(B_OK, map.Reserve(1000));
+	for (int32 i = 0; i < 1000; i++)
+		map.Put(i, i * 2);
+
+// ----------------------
+	int32 count = 0;
+	IntMap::Iterator iterator = map.GetIterator();
+	while (iterator.HasNext()) {
+		IntMap::Entry entry = iterator.Next();
+		CPPUNIT_ASSERT_EQUAL(entry.key.value * 2, entry.value);
+		if (entry.key.value % 2 == 0)
+			CPPUNIT_ASSERT_EQUAL(entry.value, map.Remove(iterator));
+		count++;
+	}
+// ----------------------
+
+	CPPUNIT_ASSERT_EQUAL(1000, count);
+	CPPUNIT_ASSERT_EQUAL(500, map.Size());
+	for (int32 i = 0; i < 1000; i++)
+		CPPUNIT_ASSERT_EQUAL(i % 2 != 0, map.ContainsKey(i));
+}
+
+
+void
+FlatHashMapTest::TestSet()
+{
+	FlatHashSet<HashString> set;
+
+// ----------------------
+	set.Add(HashString("Red"));
+	set.Add(HashString("Green"));
+	set.Add(HashString("Red"));
+	bool removedGreen = set.Remove(HashString("Green"));
+	bool removedBlue = set.Remove(HashString("Blue"));
+// ----------------------
+
+	CPPUNIT_ASSERT(removedGreen);
+	CPPUNIT_ASSERT(!removedBlue);
+	CPPUNIT_ASSERT_EQUAL(1, set.Size());
+	CPPUNIT_ASSERT(set.Contains(HashString("Red")));
+	CPPUNIT_ASSERT(!set.Contains(HashString("Green")));
+
+	FlatHashSet<HashString>::Iterator iterator = set.GetIterator();
+	CPPUNIT_ASSERT(iterator.HasNext());
+	CPPUNIT_ASSERT(iterator.Next() == HashString("Red"));
+	CPPUNIT_ASSERT(!iterator.HasNext());
+}
+
+
+/*static*/ void
+FlatHashMapTest::AddTests(BTestSuite& parent)
+{
+	CppUnit::TestSuite& suite = *new CppUnit::TestSuite(
+		"FlatHashMapTest");
+
+	suite.addTest(
+		new CppUnit::TestCaller<FlatHashMapTest>(
+			"FlatHashMapTest::TestPutGet",
+			&FlatHashMapTest::TestPutGet));
+	suite.addTest(
+		new CppUnit::TestCaller<FlatHashMapTest>(
+			"FlatHashMapTest::TestRemove",
+			&FlatHashMapTest::TestRemove));
+	suite.addTest(
+		new CppUnit::TestCaller<FlatHashMapTest>(
+			"FlatHashMapTest::TestManyElements",
+			&FlatHashMapTest::TestManyElements));
+	suite.addTest(
+		new CppUnit::TestCaller<FlatHashMapTest>(
+			"FlatHashMapTest::TestRemoveWhileIterating",
+			&FlatHashMapTest::TestRemoveWhileIterating));
+	suite.addTest(
+		new CppUnit::TestCaller<FlatHashMapTest>(
+			"FlatHashMapTest::TestSet",
+			&FlatHashMapTest::TestSet));
+
+	parent.addTest("FlatHashMapTest", &suite);
+}
@@ -0,0 +1,28 @@
+/*
+ * Copyright 2026, Haiku, Inc. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+#ifndef FLAT_HASH_MAP_TEST_H
+#define FLAT_HASH_MAP_TEST_H
+
+
+#include <TestCase.h>
+#include <TestSuite.h>
+
+
+class FlatHashMapTest : public CppUnit::TestCase {
+public:
+								FlatHashMapTest();
+	virtual						~FlatHashMapTest();
+
+			void				TestPutGet();
+			void				TestRemove();
+			void				TestManyElements();
+			void				TestRemoveWhileIterating();
+			void				TestSet();
+
+	static	void				AddTests(BTestSuite& suite);
+};
+
+
+#endif	// FLAT_HASH_MAP_TEST_H
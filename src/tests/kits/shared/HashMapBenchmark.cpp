@@ -0,0 +1,146 @@
+/*
+ * Copyright 2026, Haiku, Inc. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+/*!	Compares HashMap and FlatHashMap with integer and string keys: inserting
+	random keys into an empty map, looking up keys that are, and that are
+	not in the map, and removing all keys again, for maps from a few up to a
+	million elements.
+*/
+
+
+#include <stdio.h>
+
+#include <OS.h>
+
+#include <FlatHashMap.h>
+#include <HashMap.h>
+#include <HashString.h>
+
+
+static const int32 kSizes[] = { 16, 256, 4096, 65536, 1048576 };
+static const int32 kOperationsPerSize = 4 * 1024 * 1024;
+static const uint32 kStride = 40503;
+	// odd, so that it visits all keys of a power of two sized range
+
+
+struct Times {
+	bigtime_t	insert;
+	bigtime_t	lookup;
+	bigtime_t	miss;
+	bigtime_t	remove;
+};
+
+
+static int32 sSink;
+
+
+//!	A bijection, so that distinct values stay distinct.
+static uint32
+scramble(uint32 value)
+{
+	value ^= value >> 16;
+	value *= 0x85ebca6b;
+	value ^= value >> 13;
+	value *= 0xc2b2ae35;
+	value ^= value >> 16;
+	return value;
+}
+
+
+template<typename Map, typename Key>
+static void
+benchmark(const Key* keys, const Key* missingKeys, int32 count, Times& times)
+{
+	int32 rounds = kOperationsPerSize / count;
+	times.insert = times.lookup = times.miss = times.remove = 0;
+
+	for (int32 round = 0; round < rounds; round++) {
+		Map map;
+
+		bigtime_t start = system_time();
+		for (int32 i = 0; i < count; i++)
+			map.Put(keys[i], i);
+		bigtime_t inserted = system_time();
+
+		// look up and remove in another order than inserted, as the elements
+		// of HashMap would otherwise be read sequentially
+		for (int32 i = 0; i < count; i++)
+			sSink += map.Get(keys[((uint32)i * kStride) & (count - 1)]);
+		bigtime_t looked = system_time();
+
+		for (int32 i = 0; i < count; i++)
+			sSink += map.ContainsKey(missingKeys[i]);
+		bigtime_t missed = system_time();
+
+		for (int32 i = 0; i < count; i++)
+			sSink += map.Remove(keys[((uint32)i * kStride) & (count - 1)]);
+		bigtime_t removed = system_time();
+
+		times.insert += inserted - start;
+		times.lookup += looked - inserted;
+		times.miss += missed - looked;
+		times.remove += removed - missed;
+	}
+}
+
+
+static void
+print_times(const char* name, int32 count, const Times& times)
+{
+	double operations = (double)(kOperationsPerSize / count) * count / 1000;
+	printf("  %-12s %8.1f %8.1f %8.1f %8.1f\n", name,
+		times.insert / operations, times.lookup / operations,
+		times.miss / operations, times.remove / operations);
+}
+
+
+int
+main(int argc, char** argv)
+{
+	int32 maxCount = kSizes[B_COUNT_OF(kSizes) - 1];
+
+	// the keys are distinct and random, without a pattern the prefetcher
+	// could pick up; the second half of them are the missing ones
+	HashKey32<int32>* intKeys = new HashKey32<int32>[maxCount * 2];
+	HashString* stringKeys = new HashString[maxCount * 2];
+	for (int32 i = 0; i < maxCount * 2; i++) {
+		int32 value = (int32)scramble(i);
+		intKeys[i] = value;
+
+		char buffer[32];
+		snprintf(buffer, sizeof(buffer), "package-%" B_PRId32, value);
+		stringKeys[i].SetTo(buffer);
+	}
+
+	printf("nanoseconds per operation\n");
+	printf("  %-12s %8s %8s %8s %8s\n", "", "insert", "lookup", "miss",
+		"remove");
+
+	for (size_t i = 0; i < B_COUNT_OF(kSizes); i++) {
+		int32 count = kSizes[i];
+		Times times;
+
+		printf("%" B_PRId32 " integer keys\n", count);
+		benchmark<HashMap<HashKey32<int32>, int32> >(intKeys,
+			intKeys + maxCount, count, times);
+		print_times("HashMap", count, times);
+		benchmark<FlatHashMap<HashKey32<int32>, int32> >(intKeys,
+			intKeys + maxCount, count, times);
+		print_times("FlatHashMap", count, times);
+
+		printf("%" B_PRId32 " string keys\n", count);
+		benchmark<HashMap<HashString, int32> >(stringKeys,
+			stringKeys + maxCount, count, times);
+		print_times("HashMap", count, times);
+		benchmark<FlatHashMap<HashString, int32> >(stringKeys,
+			stringKeys + maxCount, count, times);
+		print_times("FlatHashMap", count, times);
+	}
+
+	delete[] intKeys;
+	delete[] stringKeys;
+	return 0;
+}
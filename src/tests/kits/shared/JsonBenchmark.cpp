@@ -0,0 +1,214 @@
+/*
+ * Copyright 2026, Haiku, Inc. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+/*!	Measures parsing JSON data the size of what HaikuDepot downloads for a
+	repository, and writing it out again. Without arguments, a document that
+	is shaped like HaikuDepot's package data is generated; otherwise the
+	given files are used, for example those in HaikuDepot's cache directory.
+*/
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+
+#include <File.h>
+#include <OS.h>
+#include <String.h>
+
+#include <Json.h>
+#include <JsonEventListener.h>
+#include <JsonTextWriter.h>
+
+
+using namespace BPrivate;
+
+
+static const int32 kGeneratedPackageCount = 20000;
+static const int32 kIterations = 5;
+
+
+class CountingListener : public BJsonEventListener {
+public:
+	CountingListener()
+		:
+		fEventCount(0),
+		fError(B_OK)
+	{
+	}
+
+	virtual bool Handle(const BJsonEvent& event)
+	{
+		fEventCount++;
+		return true;
+	}
+
+	virtual void HandleError(status_t status, int32 line, const char* message)
+	{
+		fprintf(stderr, "Parse error at line %" B_PRId32 ": %s\n", line,
+			message);
+		fError = status;
+	}
+
+	virtual void Complete()
+	{
+	}
+
+	int64		fEventCount;
+	status_t	fError;
+};
+
+
+static const char* kWords[] = {
+	"the", "package", "provides", "a", "library", "for", "handling",
+	"image", "files", "and", "tools", "to", "convert", "them", "with",
+	"support", "of", "many", "formats", "Haiku", "application", "written",
+	"in", "C++", "which", "uses", "native", "interface", "kit",
+	"\\u00fcbersetzt", "\\\"quoted\\\"", "path/to/file", "\\n"
+};
+
+
+static void
+append_text(BString& json, int32 wordCount)
+{
+	for (int32 i = 0; i < wordCount; i++) {
+		if (i > 0)
+			json << ' ';
+		json << kWords[rand() % B_COUNT_OF(kWords)];
+	}
+}
+
+
+static void
+generate_packages(BString& json)
+{
+	json << "{\n  \"info\": {\n    \"createTimestamp\": 1700000000000,\n"
+		"    \"dataModifiedTimestamp\": 1700000000000,\n"
+		"    \"agent\": \"hds\",\n    \"agentVersion\": \"1.0.150\"\n  },\n"
+		"  \"items\": [\n";
+
+	for (int32 i = 0; i < kGeneratedPackageCount; i++) {
+		BString item;
+		item.SetToFormat("    {\n      \"name\": \"package_%" B_PRId32 "\",\n"
+			"      \"active\": true,\n"
+			"      \"derivedRating\": %" B_PRId32 ".%" B_PRId32 ",\n"
+			"      \"prominenceOrdering\": %" B_PRId32 ",\n"
+			"      \"modifyTimestamp\": 17%011" B_PRId32 ",\n"
+			"      \"pkgCategories\": [{\"code\": \"graphics\"},"
+			" {\"code\": \"development\"}],\n"
+			"      \"pkgScreenshots\": [{\"code\": \"%08" B_PRIx32 "\","
+			" \"width\": 640, \"height\": 480, \"length\": %" B_PRId32 ","
+			" \"ordering\": 1}],\n"
+			"      \"pkgVersions\": [{\n"
+			"        \"major\": \"%" B_PRId32 "\", \"minor\": \"%" B_PRId32
+			"\", \"micro\": \"0\", \"revision\": 1,\n",
+			i, i % 5, i % 10, i % 1000, i, (uint32)rand(), rand() % 100000,
+			i % 4, i % 20);
+		json << item;
+
+		json << "        \"title\": \"";
+		append_text(json, 3);
+		json << "\",\n        \"summary\": \"";
+		append_text(json, 12);
+		json << "\",\n        \"description\": \"";
+		append_text(json, 40 + rand() % 200);
+		json << "\",\n        \"payloadLength\": " << rand() << "\n"
+			"      }]\n    }";
+		json << (i + 1 < kGeneratedPackageCount ? ",\n" : "\n");
+	}
+
+	json << "  ]\n}\n";
+}
+
+
+static bool
+read_file(const char* path, BString& json)
+{
+	BFile file(path, B_READ_ONLY);
+	off_t size;
+	if (file.InitCheck() != B_OK || file.GetSize(&size) != B_OK)
+		return false;
+
+	char* buffer = json.LockBuffer(size + 1);
+	if (buffer == NULL)
+		return false;
+	ssize_t bytesRead = file.ReadAt(0, buffer, size);
+	json.UnlockBuffer(bytesRead > 0 ? bytesRead : 0);
+	return bytesRead == size;
+}
+
+
+static void
+benchmark(const char* name, const BString& json)
+{
+	double megabytes = json.Length() / 1024.0 / 1024.0;
+	printf("%s, %.1f MB\n", name, megabytes);
+
+	bigtime_t parseTime = B_INFINITE_TIMEOUT;
+	bigtime_t writeTime = B_INFINITE_TIMEOUT;
+	bigtime_t messageTime = B_INFINITE_TIMEOUT;
+	int64 eventCount = 0;
+
+	for (int32 i = 0; i < kIterations; i++) {
+		// parsing into events, the way HaikuDepot processes its data
+		BMemoryIO input(json.String(), json.Length());
+		CountingListener listener;
+		bigtime_t start = system_time();
+		BJson::Parse(&input, &listener);
+		parseTime = std::min(parseTime, system_time() - start);
+		eventCount = listener.fEventCount;
+		if (listener.fError != B_OK)
+			return;
+
+		// parsing, and writing the events out again
+		BMemoryIO writerInput(json.String(), json.Length());
+		BMallocIO output;
+		output.SetBlockSize(1024 * 1024);
+		BJsonTextWriter writer(&output);
+		start = system_time();
+		BJson::Parse(&writerInput, &writer);
+		writeTime = std::min(writeTime, system_time() - start);
+
+		// parsing into a BMessage, in place
+		BMessage message;
+		start = system_time();
+		BJson::Parse(json.String(), json.Length(), message);
+		messageTime = std::min(messageTime, system_time() - start);
+	}
+
+	printf("  %" B_PRId64 " events\n", eventCount);
+	printf("  parse:             %8.1f ms, %6.1f MB/s\n", parseTime / 1000.0,
+		megabytes / (parseTime / 1000000.0));
+	printf("  parse and write:   %8.1f ms, %6.1f MB/s\n", writeTime / 1000.0,
+		megabytes / (writeTime / 1000000.0));
+	printf("  parse to BMessage: %8.1f ms, %6.1f MB/s\n", messageTime / 1000.0,
+		megabytes / (messageTime / 1000000.0));
+}
+
+
+int
+main(int argc, char** argv)
+{
+	if (argc < 2) {
+		BString json;
+		generate_packages(json);
+		benchmark("generated package data", json);
+		return 0;
+	}
+
+	for (int i = 1; i < argc; i++) {
+		BString json;
+		if (!read_file(argv[i], json)) {
+			fprintf(stderr, "Could not read \"%s\"\n", argv[i]);
+			continue;
+		}
+		benchmark(argv[i], json);
+	}
+
+	return 0;
+}
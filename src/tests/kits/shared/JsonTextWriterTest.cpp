@@ -216,6 +216,15 @@ JsonTextWriterTest::TestString()
 		// contains an illegal character which should be ignored.
 	TestStringGeneric("X", "\"X\"");
 		// a simple string with a single character
+	TestStringGeneric("\xf0\x9f\x98\x80", "\"\\ud83d\\ude00\"");
+		// a character beyond the basic multilingual plane is written as a
+		// surrogate pair.
+	TestStringGeneric("Some longer text, where the \"quotes\" and a/slash come"
+		" after the first 16 characters.",
+		"\"Some longer text, where the \\\"quotes\\\" and a\\/slash come"
+		" after the first 16 characters.\"");
+		// escapes after a run of simple characters that is longer than the
+		// block that is checked at once.
 }
 
 
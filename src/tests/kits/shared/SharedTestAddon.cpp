@@ -10,6 +10,7 @@
 
 #include "CalendarViewTest.h"
 #include "DriverSettingsMessageAdapterTest.h"
+#include "FlatHashMapTest.h"
 #include "NaturalCompareTest.h"
 #include "JsonEndToEndTest.h"
 #include "JsonErrorHandlingTest.h"
@@ -27,6 +28,7 @@ getTestSuite()
 
 	CalendarViewTest::AddTests(*suite);
 	DriverSettingsMessageAdapterTest::AddTests(*suite);
+	FlatHashMapTest::AddTests(*suite);
 	NaturalCompareTest::AddTests(*suite);
 	JsonEndToEndTest::AddTests(*suite);
 	JsonErrorHandlingTest::AddTests(*suite);
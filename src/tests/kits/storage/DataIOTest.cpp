@@ -1,7 +1,10 @@
 // DataIOTest.cpp
 
+#include <stdlib.h>
 #include <string.h>
 #include <BufferedDataIO.h>
+#include <Entry.h>
+#include <File.h>
 
 #include <TestShell.h>
 
@@ -43,4 +46,61 @@ DataIOTest::BufferedDataIOTest()
 		CPPUNIT_ASSERT(mallocIO.Position() == 27);
 		CPPUNIT_ASSERT(memcmp(mallocIO.Buffer(), "test test test longer-test", 27) == 0);
 	}
+
+	// mixed small and large reads, the buffer grows and the file is read ahead
+	NextSubTest();
+	{
+		const char* path = "/tmp/buffered_data_io_test";
+		const size_t size = 3 * 1024 * 1024 + 1234;
+		uint8* data = new uint8[size];
+		for (size_t i = 0; i < size; i++)
+			data[i] = (uint8)rand();
+
+		BFile file(path, B_READ_WRITE | B_CREATE_FILE | B_ERASE_FILE);
+		CPPUNIT_ASSERT(file.InitCheck() == B_OK);
+		CPPUNIT_ASSERT(file.Write(data, size) == (ssize_t)size);
+		CPPUNIT_ASSERT(file.Seek(0, SEEK_SET) == 0);
+
+		uint8* buffer = new uint8[200000];
+		{
+			BBufferedDataIO bufferedDataIO(file, 4096, false);
+			size_t position = 0;
+			for (int32 i = 0; position < size; i++) {
+				size_t toRead = i % 5 == 0 ? 100000 + i : i % 100;
+				ssize_t bytesRead = bufferedDataIO.Read(buffer, toRead);
+				CPPUNIT_ASSERT(bytesRead >= 0);
+				CPPUNIT_ASSERT((size_t)bytesRead <= size - position);
+				CPPUNIT_ASSERT(memcmp(buffer, data + position, bytesRead)
+					== 0);
+				if (bytesRead == 0 && toRead > 0)
+					break;
+				position += bytesRead;
+			}
+			CPPUNIT_ASSERT(position == size);
+			CPPUNIT_ASSERT(bufferedDataIO.BufferSize() > 4096);
+		}
+
+		// small and large writes end up in order
+		CPPUNIT_ASSERT(file.SetSize(0) == B_OK);
+		CPPUNIT_ASSERT(file.Seek(0, SEEK_SET) == 0);
+		{
+			BBufferedDataIO bufferedDataIO(file, 4096, false);
+			size_t position = 0;
+			for (int32 i = 0; position < size; i++) {
+				size_t toWrite = min_c(i % 5 == 0 ? 100000 + i : i % 100,
+					size - position);
+				CPPUNIT_ASSERT(bufferedDataIO.Write(data + position, toWrite)
+					== (ssize_t)toWrite);
+				position += toWrite;
+			}
+		}
+		CPPUNIT_ASSERT(file.ReadAt(0, buffer, 200000) == 200000);
+		CPPUNIT_ASSERT(memcmp(buffer, data, 200000) == 0);
+		CPPUNIT_ASSERT(file.ReadAt(size - 200000, buffer, 200000) == 200000);
+		CPPUNIT_ASSERT(memcmp(buffer, data + size - 200000, 200000) == 0);
+
+		delete[] buffer;
+		delete[] data;
+		BEntry(path).Remove();
+	}
 }
@@ -0,0 +1,255 @@
+/*
+ * Copyright 2026, Haiku, Inc. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+/*!	Compares BFile and BMappedFile for the reads of a parser: walking the
+	resources of an executable, or of a .rsrc file, entry by entry the way
+	ResourceFile does, and parsing a package, and reading its heap.
+*/
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+
+#include <elf.h>
+#include <File.h>
+#include <OS.h>
+#include <package/hpkg/PackageContentHandler.h>
+#include <package/hpkg/StandardErrorOutput.h>
+
+#include <MappedFile.h>
+#include <package/hpkg/PackageFileHeapReader.h>
+#include <package/hpkg/PackageReaderImpl.h>
+#include <ResourcesDefs.h>
+
+
+using namespace BPackageKit::BHPKG;
+using BPackageKit::BHPKG::BPrivate::PackageReaderImpl;
+
+
+static const int32 kIterations = 100;
+
+
+class NullContentHandler : public BLowLevelPackageContentHandler {
+public:
+	virtual status_t HandleSectionStart(BHPKGPackageSectionID sectionID,
+		bool& _handleSection)
+	{
+		_handleSection = true;
+		return B_OK;
+	}
+
+	virtual status_t HandleSectionEnd(BHPKGPackageSectionID sectionID)
+	{
+		return B_OK;
+	}
+
+	virtual status_t HandleAttribute(BHPKGAttributeID attributeID,
+		const BPackageAttributeValue& value, void* parentToken, void*& _token)
+	{
+		_token = NULL;
+		return B_OK;
+	}
+
+	virtual status_t HandleAttributeDone(BHPKGAttributeID attributeID,
+		const BPackageAttributeValue& value, void* parentToken, void* token)
+	{
+		return B_OK;
+	}
+
+	virtual void HandleErrorOccurred()
+	{
+	}
+};
+
+
+static bool
+has_resources_header(BPositionIO& file, off_t offset)
+{
+	uint32 magic;
+	return file.ReadAt(offset, &magic, sizeof(magic)) == sizeof(magic)
+		&& magic == kResourcesHeaderMagic;
+}
+
+
+/*!	Finds the resources of a .rsrc file, or of an ELF file, which follow the
+	section header table, aligned to one of the alignments ResourceFile uses.
+*/
+static status_t
+find_resources(BPositionIO& file, off_t& _offset)
+{
+	uint8 ident[EI_NIDENT];
+	if (file.ReadAt(0, ident, sizeof(ident)) != sizeof(ident))
+		return B_BAD_DATA;
+
+	if (memcmp(ident, kX86ResourceFileMagic, 4) == 0) {
+		_offset = kX86ResourcesOffset;
+		return has_resources_header(file, _offset) ? B_OK : B_BAD_DATA;
+	}
+
+	if (memcmp(ident, ELFMAG, SELFMAG) != 0)
+		return B_BAD_TYPE;
+
+	off_t end;
+	if (ident[EI_CLASS] == ELFCLASS64) {
+		Elf64_Ehdr header;
+		if (file.ReadAt(0, &header, sizeof(header)) != sizeof(header))
+			return B_BAD_DATA;
+		end = header.e_shoff + (off_t)header.e_shnum * header.e_shentsize;
+	} else {
+		Elf32_Ehdr header;
+		if (file.ReadAt(0, &header, sizeof(header)) != sizeof(header))
+			return B_BAD_DATA;
+		end = header.e_shoff + (off_t)header.e_shnum * header.e_shentsize;
+	}
+
+	static const off_t kAlignments[] = { 8, 32, B_PAGE_SIZE };
+	for (size_t i = 0; i < B_COUNT_OF(kAlignments); i++) {
+		off_t offset = (end + kAlignments[i] - 1) / kAlignments[i]
+			* kAlignments[i];
+		if (has_resources_header(file, offset)) {
+			_offset = offset;
+			return B_OK;
+		}
+	}
+
+	return B_ENTRY_NOT_FOUND;
+}
+
+
+static status_t
+read_resources(BPositionIO& file, off_t offset, uint8* buffer,
+	size_t bufferSize)
+{
+	resources_header header;
+	if (file.ReadAt(offset, &header, kResourcesHeaderSize)
+			!= kResourcesHeaderSize) {
+		return B_BAD_DATA;
+	}
+
+	off_t indexOffset = offset + header.rh_index_section_offset;
+	resource_index_section_header indexHeader;
+	if (file.ReadAt(indexOffset, &indexHeader,
+			kResourceIndexSectionHeaderSize)
+			!= kResourceIndexSectionHeaderSize) {
+		return B_BAD_DATA;
+	}
+
+	// one read per index entry, and one per resource
+	for (uint32 i = 0; i < header.rh_resource_count; i++) {
+		resource_index_entry entry;
+		if (file.ReadAt(indexOffset + kResourceIndexSectionHeaderSize
+					+ i * kResourceIndexEntrySize, &entry,
+				kResourceIndexEntrySize) != kResourceIndexEntrySize) {
+			return B_BAD_DATA;
+		}
+
+		size_t size = std::min((size_t)entry.rie_size, bufferSize);
+		if (file.ReadAt(offset + entry.rie_offset, buffer, size)
+				!= (ssize_t)size) {
+			return B_BAD_DATA;
+		}
+	}
+
+	return B_OK;
+}
+
+
+static status_t
+read_package(BPositionIO& file, uint8* buffer, size_t bufferSize)
+{
+	BStandardErrorOutput errorOutput;
+	PackageReaderImpl reader(&errorOutput);
+	status_t error = reader.Init(&file, false, 0);
+	if (error != B_OK)
+		return error;
+
+	NullContentHandler handler;
+	error = reader.ParseContent(&handler);
+	if (error != B_OK)
+		return error;
+
+	// read the file data in pieces, like packagefs does
+	uint64 heapSize = reader.RawHeapReader()->UncompressedHeapSize();
+	for (uint64 offset = 0; offset < heapSize; offset += bufferSize) {
+		error = reader.HeapReader()->ReadData(offset, buffer,
+			std::min((uint64)bufferSize, heapSize - offset));
+		if (error != B_OK)
+			return error;
+	}
+
+	return B_OK;
+}
+
+
+static bigtime_t
+benchmark(BPositionIO& file, bool isPackage, off_t resourcesOffset)
+{
+	uint8 buffer[4096];
+
+	bigtime_t start = system_time();
+	for (int32 i = 0; i < kIterations; i++) {
+		status_t error = isPackage
+			? read_package(file, buffer, sizeof(buffer))
+			: read_resources(file, resourcesOffset, buffer, sizeof(buffer));
+		if (error != B_OK) {
+			fprintf(stderr, "Failed to read the file: %s\n", strerror(error));
+			return 0;
+		}
+	}
+
+	return (system_time() - start) / kIterations;
+}
+
+
+int
+main(int argc, char** argv)
+{
+	if (argc < 2) {
+		fprintf(stderr, "usage: %s <package or executable> ...\n", argv[0]);
+		return 1;
+	}
+
+	printf("%-40s %10s %10s\n", "file", "BFile", "BMappedFile");
+
+	for (int i = 1; i < argc; i++) {
+		BFile file(argv[i], B_READ_ONLY);
+		BMappedFile mappedFile(argv[i]);
+		status_t error = file.InitCheck();
+		if (error == B_OK)
+			error = mappedFile.InitCheck();
+		if (error != B_OK) {
+			fprintf(stderr, "Failed to open \"%s\": %s\n", argv[i],
+				strerror(error));
+			continue;
+		}
+
+		const char* extension = strrchr(argv[i], '.');
+		bool isPackage = extension != NULL && strcmp(extension, ".hpkg") == 0;
+
+		off_t resourcesOffset = 0;
+		if (!isPackage && find_resources(file, resourcesOffset) != B_OK) {
+			fprintf(stderr, "\"%s\" has no resources\n", argv[i]);
+			continue;
+		}
+
+		if (isPackage)
+			mappedFile.SetAccess(B_MAPPED_FILE_ACCESS_SEQUENTIAL);
+		else
+			mappedFile.SetAccess(B_MAPPED_FILE_ACCESS_RANDOM);
+
+		bigtime_t fileTime = benchmark(file, isPackage, resourcesOffset);
+		bigtime_t mappedTime = benchmark(mappedFile, isPackage,
+			resourcesOffset);
+
+		printf("%-40s %8" B_PRIdBIGTIME "us %8" B_PRIdBIGTIME "us\n",
+			argv[i], fileTime, mappedTime);
+	}
+
+	return 0;
+}
@@ -0,0 +1,207 @@
+/*
+ * Copyright 2026, Haiku, Inc. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+/*!	Measures the throughput of BBufferedDataIO for a mix of small and large
+	reads, as they happen when parsing mail or JSON streams, from a file and
+	from a pipe, and for small writes to a file, compared to using the stream
+	directly.
+*/
+
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <algorithm>
+
+#include <BufferedDataIO.h>
+#include <Entry.h>
+#include <File.h>
+#include <OS.h>
+
+
+static const char* kPath = "/tmp/buffered_data_io_benchmark";
+static const size_t kDataSize = 64 * 1024 * 1024;
+static const size_t kMaxReadSize = 256 * 1024;
+
+
+class PipeIO : public BDataIO {
+public:
+	PipeIO(int fd)
+		:
+		fFD(fd)
+	{
+	}
+
+	virtual ssize_t Read(void* buffer, size_t size)
+	{
+		ssize_t bytesRead = read(fFD, buffer, size);
+		return bytesRead < 0 ? errno : bytesRead;
+	}
+
+	virtual ssize_t Write(const void* buffer, size_t size)
+	{
+		ssize_t bytesWritten = write(fFD, buffer, size);
+		return bytesWritten < 0 ? errno : bytesWritten;
+	}
+
+private:
+	int		fFD;
+};
+
+
+static uint8* sData;
+
+
+static size_t
+next_read_size(uint32& seed)
+{
+	seed = seed * 1103515245 + 12345;
+	uint32 random = seed >> 8;
+
+	// mostly header lines and tokens, sometimes a large body
+	if (random % 16 == 0)
+		return random % kMaxReadSize;
+	return random % 128;
+}
+
+
+static size_t
+read_all(BDataIO& stream, uint8* buffer)
+{
+	uint32 seed = 0;
+	size_t total = 0;
+	while (true) {
+		size_t size = next_read_size(seed);
+		ssize_t bytesRead = stream.Read(buffer, size);
+		if (bytesRead < 0) {
+			fprintf(stderr, "Failed to read: %s\n", strerror(bytesRead));
+			break;
+		}
+		if (bytesRead == 0 && size > 0)
+			break;
+		total += bytesRead;
+	}
+	return total;
+}
+
+
+static status_t
+pipe_writer(void* data)
+{
+	int fd = (int)(addr_t)data;
+	for (size_t offset = 0; offset < kDataSize; ) {
+		ssize_t bytesWritten = write(fd, sData + offset,
+			std::min(kDataSize - offset, (size_t)65536));
+		if (bytesWritten <= 0)
+			break;
+		offset += bytesWritten;
+	}
+	close(fd);
+	return B_OK;
+}
+
+
+static void
+print_result(const char* name, bigtime_t time)
+{
+	printf("%-32s %8.1f MB/s\n", name,
+		kDataSize / 1024.0 / 1024.0 / (time / 1000000.0));
+}
+
+
+static void
+benchmark_file(bool buffered)
+{
+	BFile file(kPath, B_READ_ONLY);
+	uint8* buffer = new uint8[kMaxReadSize];
+
+	bigtime_t start = system_time();
+	if (buffered) {
+		BBufferedDataIO bufferedIO(file, 65536, false);
+		read_all(bufferedIO, buffer);
+	} else
+		read_all(file, buffer);
+	bigtime_t time = system_time() - start;
+
+	print_result(buffered ? "file, buffered" : "file, direct", time);
+	delete[] buffer;
+}
+
+
+static void
+benchmark_pipe(bool buffered)
+{
+	int fds[2];
+	if (pipe(fds) != 0)
+		return;
+
+	thread_id writer = spawn_thread(&pipe_writer, "pipe writer",
+		B_NORMAL_PRIORITY, (void*)(addr_t)fds[1]);
+	uint8* buffer = new uint8[kMaxReadSize];
+
+	bigtime_t start = system_time();
+	resume_thread(writer);
+	PipeIO pipe(fds[0]);
+	if (buffered) {
+		BBufferedDataIO bufferedIO(pipe, 65536, false);
+		read_all(bufferedIO, buffer);
+	} else
+		read_all(pipe, buffer);
+	bigtime_t time = system_time() - start;
+
+	status_t result;
+	wait_for_thread(writer, &result);
+	close(fds[0]);
+
+	print_result(buffered ? "pipe, buffered" : "pipe, direct", time);
+	delete[] buffer;
+}
+
+
+static void
+benchmark_writes(bool buffered)
+{
+	BFile file(kPath, B_WRITE_ONLY | B_CREATE_FILE | B_ERASE_FILE);
+	BBufferedDataIO bufferedIO(file, 65536, false);
+	BDataIO& stream = buffered ? (BDataIO&)bufferedIO : (BDataIO&)file;
+
+	bigtime_t start = system_time();
+	uint32 seed = 0;
+	for (size_t offset = 0; offset < kDataSize; ) {
+		size_t size = std::min(next_read_size(seed), kDataSize - offset);
+		stream.Write(sData + offset, size);
+		offset += size;
+	}
+	bufferedIO.Flush();
+	bigtime_t time = system_time() - start;
+
+	print_result(buffered ? "writes, buffered" : "writes, direct", time);
+}
+
+
+int
+main(int argc, char** argv)
+{
+	sData = new uint8[kDataSize];
+	for (size_t i = 0; i < kDataSize; i++)
+		sData[i] = (uint8)rand();
+
+	benchmark_writes(false);
+	benchmark_writes(true);
+		// also leaves the file for the read benchmarks
+
+	benchmark_file(false);
+	benchmark_file(true);
+	benchmark_pipe(false);
+	benchmark_pipe(true);
+
+	BEntry(kPath).Remove();
+	delete[] sData;
+	return 0;
+}
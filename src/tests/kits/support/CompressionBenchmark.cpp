@@ -0,0 +1,204 @@
+/*
+ * Copyright 2026, Haiku, Inc. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+/*!	Compresses the heap of a package file the way the package writer does, in
+	independent 64 KiB chunks, and as a single stream with a growing number
+	of threads, with zlib and zstd, and prints the throughput and the
+	resulting ratio for each.
+*/
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+
+#include <DataIO.h>
+#include <OS.h>
+#include <package/hpkg/StandardErrorOutput.h>
+
+#include <package/hpkg/PackageFileHeapReader.h>
+#include <package/hpkg/PackageReaderImpl.h>
+#include <ZlibCompressionAlgorithm.h>
+#include <ZstdCompressionAlgorithm.h>
+
+
+using BPackageKit::BHPKG::BStandardErrorOutput;
+using BPackageKit::BHPKG::BPrivate::PackageFileHeapReader;
+using BPackageKit::BHPKG::BPrivate::PackageReaderImpl;
+
+
+static const size_t kChunkSize = 64 * 1024;
+
+
+//!	Throws away everything written to it, and only counts it.
+class CountingOutput : public BDataIO {
+public:
+	CountingOutput()
+		:
+		fSize(0)
+	{
+	}
+
+	virtual ssize_t Write(const void* buffer, size_t size)
+	{
+		fSize += size;
+		return size;
+	}
+
+	size_t Size() const
+	{
+		return fSize;
+	}
+
+private:
+	size_t	fSize;
+};
+
+
+static void
+print_result(const char* name, bigtime_t start, size_t inputSize,
+	size_t outputSize)
+{
+	bigtime_t time = system_time() - start;
+	printf("  %-24s %8.1f MB/s  %6.2f%%\n", name,
+		time > 0 ? inputSize / (double)time : 0.0,
+		inputSize > 0 ? outputSize * 100.0 / inputSize : 0.0);
+}
+
+
+static void
+benchmark_chunks(BCompressionAlgorithm& algorithm,
+	BCompressionParameters& parameters, const uint8* data, size_t size)
+{
+	uint8* output = (uint8*)malloc(kChunkSize);
+	if (output == NULL)
+		return;
+
+	size_t outputSize = 0;
+	bigtime_t start = system_time();
+	for (size_t offset = 0; offset < size; offset += kChunkSize) {
+		size_t chunkSize = std::min(size - offset, kChunkSize);
+		iovec input = { (void*)(data + offset), chunkSize };
+		iovec compressed = { output, kChunkSize };
+
+		// like the package writer, keep the chunks that don't compress as is
+		if (algorithm.CompressBuffer(input, compressed, &parameters) == B_OK
+			&& compressed.iov_len < chunkSize) {
+			outputSize += compressed.iov_len;
+		} else
+			outputSize += chunkSize;
+	}
+	print_result("64 KiB chunks", start, size, outputSize);
+
+	free(output);
+}
+
+
+static void
+benchmark_stream(BCompressionAlgorithm& algorithm,
+	BCompressionParameters& parameters, int32 workerCount, const uint8* data,
+	size_t size)
+{
+	CountingOutput output;
+	bigtime_t start = system_time();
+
+	BDataIO* stream;
+	status_t error = algorithm.CreateCompressingOutputStream(&output,
+		&parameters, stream);
+	if (error != B_OK) {
+		fprintf(stderr, "Failed to create stream: %s\n", strerror(error));
+		return;
+	}
+
+	for (size_t offset = 0; offset < size && error == B_OK;
+			offset += kChunkSize) {
+		error = stream->WriteExactly(data + offset,
+			std::min(size - offset, kChunkSize));
+	}
+	if (error == B_OK)
+		error = stream->Flush();
+	delete stream;
+
+	if (error != B_OK) {
+		fprintf(stderr, "Failed to compress: %s\n", strerror(error));
+		return;
+	}
+
+	char name[32];
+	snprintf(name, sizeof(name), "stream, %" B_PRId32 " worker%s", workerCount,
+		workerCount == 1 ? "" : "s");
+	print_result(name, start, size, output.Size());
+}
+
+
+int
+main(int argc, char** argv)
+{
+	if (argc < 2 || argc > 3) {
+		fprintf(stderr, "usage: %s <package file> [max workers]\n", argv[0]);
+		return 1;
+	}
+
+	system_info info;
+	get_system_info(&info);
+	int32 maxWorkerCount = argc > 2 ? atoi(argv[2]) : info.cpu_count;
+
+	BStandardErrorOutput errorOutput;
+	PackageReaderImpl reader(&errorOutput);
+	status_t error = reader.Init(argv[1], 0);
+	if (error != B_OK) {
+		fprintf(stderr, "Failed to open package \"%s\": %s\n", argv[1],
+			strerror(error));
+		return 1;
+	}
+
+	PackageFileHeapReader* heapReader = reader.RawHeapReader();
+	size_t size = heapReader->UncompressedHeapSize();
+	uint8* data = (uint8*)malloc(size);
+	if (data == NULL) {
+		fprintf(stderr, "Failed to allocate %" B_PRIuSIZE " bytes\n", size);
+		return 1;
+	}
+
+	error = heapReader->ReadData(0, data, size);
+	if (error != B_OK) {
+		fprintf(stderr, "Failed to read the heap: %s\n", strerror(error));
+		return 1;
+	}
+
+	printf("%" B_PRIuSIZE " bytes of heap\n", size);
+
+	BZlibCompressionAlgorithm zlib;
+	BZlibCompressionParameters zlibParameters(B_ZLIB_COMPRESSION_BEST);
+	printf("zlib, level %" B_PRId32 ":\n", zlibParameters.CompressionLevel());
+	benchmark_chunks(zlib, zlibParameters, data, size);
+	for (int32 workers = 0; workers <= maxWorkerCount;
+			workers = workers < 2 ? 2 : workers * 2) {
+		// one worker is the same as none for zlib
+		zlibParameters.SetWorkerCount(workers);
+		benchmark_stream(zlib, zlibParameters, workers, data, size);
+	}
+
+	BZstdCompressionAlgorithm zstd;
+	BZstdCompressionParameters zstdParameters;
+	printf("zstd, level %" B_PRId32 ":\n", zstdParameters.CompressionLevel());
+	benchmark_chunks(zstd, zstdParameters, data, size);
+	for (int32 workers = 0; workers <= maxWorkerCount;
+			workers = workers == 0 ? 1 : workers * 2) {
+		zstdParameters.SetWorkerCount(workers);
+		benchmark_stream(zstd, zstdParameters, workers, data, size);
+	}
+
+	zstdParameters.SetWorkerCount(maxWorkerCount);
+	zstdParameters.SetLongDistanceMatching(true);
+	printf("zstd, long distance matching:\n");
+	benchmark_stream(zstd, zstdParameters, maxWorkerCount, data, size);
+
+	free(data);
+	return 0;
+}
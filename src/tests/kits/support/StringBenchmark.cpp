@@ -0,0 +1,173 @@
+/*
+ * Copyright 2026, Haiku, Inc. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+/*!	Measures BString operations the way Tracker and Mail use them: short
+	MIME types and attribute names that are built, copied and compared, paths
+	that are put together, and searching and replacing in mail headers and
+	bodies. The short strings are measured with BSmallString as well.
+*/
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <OS.h>
+#include <String.h>
+
+#include <SmallString.h>
+
+
+static const char* kShortStrings[] = {
+	"text/plain",
+	"application/x-vnd.Be-directory",
+	"BEOS:TYPE",
+	"META:email",
+	"MAIL:subject",
+	"image/png",
+	"be:volume_id",
+	"Tracker:Icon",
+};
+static const int32 kShortStringCount
+	= sizeof(kShortStrings) / sizeof(kShortStrings[0]);
+
+
+static volatile int32 sSink;
+
+
+static void
+print_result(const char* name, bigtime_t start, int32 iterations)
+{
+	printf("  %-28s %8.1f ns\n", name,
+		(system_time() - start) * 1000.0 / iterations);
+}
+
+
+template<typename String>
+static void
+benchmark_short_strings(const char* name, int32 iterations)
+{
+	printf("%s:\n", name);
+
+	bigtime_t start = system_time();
+	for (int32 i = 0; i < iterations; i++) {
+		String string(kShortStrings[i % kShortStringCount]);
+		sSink += string.Length();
+	}
+	print_result("construct", start, iterations);
+
+	String strings[kShortStringCount];
+	for (int32 i = 0; i < kShortStringCount; i++)
+		strings[i] = kShortStrings[i];
+
+	start = system_time();
+	for (int32 i = 0; i < iterations; i++) {
+		String copy(strings[i % kShortStringCount]);
+		sSink += copy.Length();
+	}
+	print_result("copy", start, iterations);
+
+	start = system_time();
+	for (int32 i = 0; i < iterations; i++) {
+		String string("BEOS:");
+		string += "TYPE";
+		sSink += string == kShortStrings[2];
+	}
+	print_result("append and compare", start, iterations);
+}
+
+
+static void
+benchmark_paths(int32 iterations)
+{
+	printf("paths:\n");
+
+	bigtime_t start = system_time();
+	for (int32 i = 0; i < iterations; i++) {
+		BString path("/boot/home/Desktop");
+		path << "/" << "Some document.txt";
+		sSink += path.FindLast('/');
+		sSink += path.IFindLast(".TXT");
+	}
+	print_result("build and split", start, iterations);
+}
+
+
+static void
+benchmark_mail(int32 iterations)
+{
+	printf("mail:\n");
+
+	BString header;
+	for (int32 i = 0; i < 40; i++) {
+		header << "Received: from relay" << i << ".example.com (relay" << i
+			<< ".example.com [192.0.2." << i << "]) by mx.example.org "
+			"with ESMTPS id 4Zx3kq; Mon, 19 Oct 2026 10:00:00 +0200\r\n";
+	}
+	header << "content-type: text/plain; charset=UTF-8\r\n\r\n";
+
+	BString body;
+	for (int32 i = 0; i < 1000; i++) {
+		body << "This is line " << i << " of a longer mail body, which "
+			"goes on for a while =3D with some quoted printable.\r\n";
+	}
+
+	bigtime_t start = system_time();
+	for (int32 i = 0; i < iterations; i++)
+		sSink += header.FindFirst("\r\n\r\n");
+	print_result("FindFirst() in header", start, iterations);
+
+	start = system_time();
+	for (int32 i = 0; i < iterations; i++)
+		sSink += header.IFindFirst("Content-Type:");
+	print_result("IFindFirst() in header", start, iterations);
+
+	int32 bodyIterations = iterations / 100 + 1;
+
+	start = system_time();
+	for (int32 i = 0; i < bodyIterations; i++) {
+		BString copy(body);
+		copy.ReplaceAll("\r\n", "\n");
+		sSink += copy.Length();
+	}
+	print_result("ReplaceAll() line breaks", start, bodyIterations);
+
+	start = system_time();
+	for (int32 i = 0; i < bodyIterations; i++) {
+		BString copy(body);
+		copy.ReplaceAll("=3D", "=");
+		sSink += copy.Length();
+	}
+	print_result("ReplaceAll() escapes", start, bodyIterations);
+
+	start = system_time();
+	for (int32 i = 0; i < bodyIterations; i++) {
+		BString copy(body);
+		copy.ReplaceAll("line", "LINE");
+		sSink += copy.Length();
+	}
+	print_result("ReplaceAll() same length", start, bodyIterations);
+}
+
+
+int
+main(int argc, char** argv)
+{
+	int32 iterations = 1000000;
+	if (argc > 1)
+		iterations = atoi(argv[1]);
+	if (iterations <= 0) {
+		fprintf(stderr, "usage: %s [iterations]\n", argv[0]);
+		return 1;
+	}
+
+	benchmark_short_strings<BString>("BString", iterations);
+	benchmark_short_strings<BSmallString<> >("BSmallString", iterations);
+	benchmark_paths(iterations);
+	benchmark_mail(iterations / 10);
+
+	return 0;
+}
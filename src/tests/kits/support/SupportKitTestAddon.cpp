@@ -11,6 +11,8 @@
 #include "bblockcache/BlockCacheTest.h"
 #include "ByteOrderTest.h"
 #include "DateTimeTest.h"
+#include "ThreadPoolTest.h"
+#include "ZlibCompressionTest.h"
 
 
 BTestSuite *
@@ -28,6 +30,8 @@ getTestSuite()
 	suite->addTest("BString", StringTestSuite());
 	suite->addTest("BBlockCache", BlockCacheTestSuite());
 	suite->addTest("ByteOrder", ByteOrderTestSuite());
+	suite->addTest("BZlibCompressionAlgorithm", ZlibCompressionTestSuite());
+	suite->addTest("ThreadPool", ThreadPoolTestSuite());
 
 	return suite;
 }
@@ -0,0 +1,252 @@
+/*
+ * Copyright 2026, Haiku, Inc. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+/*!	Runs the same number of small jobs with a JobQueue and worker threads
+	popping from it, the way the launch_daemon does, with ThreadPool::RunJobs()
+	and as plain tasks, and compares a recursive fork/join computation, each
+	with one up to as many workers as there are CPUs.
+*/
+
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <Job.h>
+#include <OS.h>
+
+#include <JobQueue.h>
+#include <ThreadPool.h>
+
+
+using BSupportKit::BJob;
+using BSupportKit::BPrivate::JobQueue;
+using BSupportKit::BPrivate::Task;
+using BSupportKit::BPrivate::TaskGroup;
+using BSupportKit::BPrivate::ThreadPool;
+
+
+static const int32 kJobCount = 20000;
+static const int32 kWorkPerJob = 2000;
+static const int32 kSumCount = 16 * 1024 * 1024;
+static const int32 kSumGrainSize = 16 * 1024;
+
+
+static volatile int32 sSink;
+
+
+static int32
+do_work(int32 seed)
+{
+	uint32 value = seed;
+	for (int32 i = 0; i < kWorkPerJob; i++)
+		value = value * 1103515245 + 12345;
+	return value;
+}
+
+
+class WorkJob : public BJob {
+public:
+	WorkJob(int32 seed)
+		:
+		BJob("work"),
+		fSeed(seed)
+	{
+	}
+
+protected:
+	virtual status_t Execute()
+	{
+		sSink += do_work(fSeed);
+		return B_OK;
+	}
+
+private:
+	int32	fSeed;
+};
+
+
+class WorkTask : public Task {
+public:
+	WorkTask(int32 seed)
+		:
+		fSeed(seed)
+	{
+	}
+
+	virtual void Run()
+	{
+		sSink += do_work(fSeed);
+	}
+
+private:
+	int32	fSeed;
+};
+
+
+class SumTask : public Task {
+public:
+	SumTask(ThreadPool& pool, const int32* values, int32 count, int64& _sum)
+		:
+		fPool(pool),
+		fValues(values),
+		fCount(count),
+		fSum(_sum)
+	{
+	}
+
+	virtual void Run()
+	{
+		if (fCount <= kSumGrainSize) {
+			int64 sum = 0;
+			for (int32 i = 0; i < fCount; i++)
+				sum += fValues[i];
+			fSum = sum;
+			return;
+		}
+
+		int32 half = fCount / 2;
+		int64 left;
+		int64 right;
+
+		TaskGroup group(fPool);
+		group.Spawn(new SumTask(fPool, fValues, half, left));
+		SumTask(fPool, fValues + half, fCount - half, right).Run();
+		group.Wait();
+
+		fSum = left + right;
+	}
+
+private:
+	ThreadPool&		fPool;
+	const int32*	fValues;
+	int32			fCount;
+	int64&			fSum;
+};
+
+
+static void
+fill_queue(JobQueue& queue)
+{
+	for (int32 i = 0; i < kJobCount; i++)
+		queue.AddJob(new WorkJob(i));
+}
+
+
+static status_t
+job_queue_worker(void* data)
+{
+	JobQueue* queue = (JobQueue*)data;
+	while (BJob* job = queue->Pop()) {
+		job->Run();
+		delete job;
+	}
+	return B_OK;
+}
+
+
+static bigtime_t
+benchmark_job_queue(int32 workerCount)
+{
+	JobQueue queue;
+	fill_queue(queue);
+
+	bigtime_t start = system_time();
+
+	thread_id* threads = new thread_id[workerCount];
+	for (int32 i = 0; i < workerCount; i++) {
+		threads[i] = spawn_thread(&job_queue_worker, "job queue worker",
+			B_NORMAL_PRIORITY, &queue);
+		resume_thread(threads[i]);
+	}
+	for (int32 i = 0; i < workerCount; i++) {
+		status_t result;
+		wait_for_thread(threads[i], &result);
+	}
+	delete[] threads;
+
+	return system_time() - start;
+}
+
+
+static bigtime_t
+benchmark_run_jobs(ThreadPool& pool)
+{
+	JobQueue queue;
+	fill_queue(queue);
+
+	bigtime_t start = system_time();
+	pool.RunJobs(queue);
+	return system_time() - start;
+}
+
+
+static bigtime_t
+benchmark_tasks(ThreadPool& pool)
+{
+	bigtime_t start = system_time();
+
+	TaskGroup group(pool);
+	for (int32 i = 0; i < kJobCount; i++)
+		group.Spawn(new WorkTask(i));
+	group.Wait();
+
+	return system_time() - start;
+}
+
+
+static bigtime_t
+benchmark_fork_join(ThreadPool& pool, const int32* values)
+{
+	bigtime_t start = system_time();
+
+	int64 sum;
+	TaskGroup group(pool);
+	group.Spawn(new SumTask(pool, values, kSumCount, sum));
+	group.Wait();
+	sSink += sum;
+
+	return system_time() - start;
+}
+
+
+int
+main(int argc, char** argv)
+{
+	system_info info;
+	get_system_info(&info);
+	int32 maxWorkerCount = argc > 1 ? atoi(argv[1]) : info.cpu_count;
+	if (maxWorkerCount <= 0) {
+		fprintf(stderr, "usage: %s [max workers]\n", argv[0]);
+		return 1;
+	}
+
+	int32* values = (int32*)malloc(kSumCount * sizeof(int32));
+	if (values == NULL)
+		return 1;
+	for (int32 i = 0; i < kSumCount; i++)
+		values[i] = i;
+
+	printf("%" B_PRId32 " jobs, times in ms\n", kJobCount);
+	printf("workers  JobQueue  RunJobs()  tasks  fork/join sum\n");
+
+	for (int32 workers = 1; workers <= maxWorkerCount; workers++) {
+		ThreadPool pool("benchmark worker", workers);
+		if (pool.InitCheck() != B_OK)
+			return 1;
+
+		bigtime_t jobQueue = benchmark_job_queue(workers);
+		bigtime_t runJobs = benchmark_run_jobs(pool);
+		bigtime_t tasks = benchmark_tasks(pool);
+		bigtime_t forkJoin = benchmark_fork_join(pool, values);
+
+		printf("%7" B_PRId32 "  %8.1f  %9.1f  %5.1f  %13.1f\n", workers,
+			jobQueue / 1000.0, runJobs / 1000.0, tasks / 1000.0,
+			forkJoin / 1000.0);
+	}
+
+	free(values);
+	return 0;
+}
@@ -0,0 +1,458 @@
+/*
+ * Copyright 2026, Haiku, Inc.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+#include "ThreadPoolTest.h"
+
+#include <Job.h>
+#include <OS.h>
+
+#include <JobQueue.h>
+#include <ThreadPool.h>
+
+#include <cppunit/TestCaller.h>
+#include <cppunit/TestSuite.h>
+
+
+using BSupportKit::BJob;
+using namespace BSupportKit::BPrivate;
+
+
+static const int32 kWorkerCount = 4;
+
+
+class ThreadPoolTest : public BTestCase {
+	public:
+		ThreadPoolTest(std::string name = "");
+
+		void ForkJoin();
+		void NestedWait();
+		void Cancel();
+		void Priorities();
+		void DequeOverflow();
+		void RunJobs();
+};
+
+
+// #pragma mark - tasks
+
+
+class CountTask : public Task {
+public:
+	CountTask(int32& count)
+		:
+		fCount(count)
+	{
+	}
+
+	virtual void Run()
+	{
+		atomic_add(&fCount, 1);
+	}
+
+private:
+	int32&	fCount;
+};
+
+
+class SumTask : public Task {
+public:
+	SumTask(ThreadPool& pool, int64 first, int64 last, int64& _sum)
+		:
+		fPool(pool),
+		fFirst(first),
+		fLast(last),
+		fSum(_sum)
+	{
+	}
+
+	virtual void Run()
+	{
+		if (fLast - fFirst < 100) {
+			int64 sum = 0;
+			for (int64 i = fFirst; i <= fLast; i++)
+				sum += i;
+			fSum = sum;
+			return;
+		}
+
+		int64 middle = (fFirst + fLast) / 2;
+		int64 left;
+		int64 right;
+
+		TaskGroup group(fPool);
+		group.Spawn(new SumTask(fPool, fFirst, middle, left));
+		group.Spawn(new SumTask(fPool, middle + 1, fLast, right));
+		group.Wait();
+
+		fSum = left + right;
+	}
+
+private:
+	ThreadPool&		fPool;
+	int64			fFirst;
+	int64			fLast;
+	int64&			fSum;
+};
+
+
+//!	Spawns \a count tasks, and waits for them, from within a task.
+class SpawningTask : public Task {
+public:
+	SpawningTask(ThreadPool& pool, int32 count, int32& done)
+		:
+		fPool(pool),
+		fSpawnCount(count),
+		fDone(done)
+	{
+	}
+
+	virtual void Run()
+	{
+		int32 count = 0;
+		TaskGroup group(fPool);
+		for (int32 i = 0; i < fSpawnCount; i++)
+			group.Spawn(new CountTask(count));
+		group.Wait();
+
+		if (count == fSpawnCount)
+			atomic_add(&fDone, 1);
+	}
+
+private:
+	ThreadPool&		fPool;
+	int32			fSpawnCount;
+	int32&			fDone;
+};
+
+
+//!	Blocks its worker until the gate semaphore is released.
+class GateTask : public Task {
+public:
+	GateTask(sem_id started, sem_id gate, bool& _wasCanceled)
+		:
+		fStarted(started),
+		fGate(gate),
+		fWasCanceled(_wasCanceled)
+	{
+	}
+
+	virtual void Run()
+	{
+		release_sem(fStarted);
+		acquire_sem(fGate);
+		fWasCanceled = IsCanceled();
+	}
+
+private:
+	sem_id			fStarted;
+	sem_id			fGate;
+	bool&			fWasCanceled;
+};
+
+
+//!	Records the order in which the tasks run.
+class OrderTask : public Task {
+public:
+	OrderTask(int32 id, int32* order, int32& index, sem_id done)
+		:
+		fID(id),
+		fOrder(order),
+		fIndex(index),
+		fDone(done)
+	{
+	}
+
+	virtual void Run()
+	{
+		fOrder[atomic_add(&fIndex, 1)] = fID;
+		release_sem(fDone);
+	}
+
+private:
+	int32			fID;
+	int32*			fOrder;
+	int32&			fIndex;
+	sem_id			fDone;
+};
+
+
+// #pragma mark - jobs
+
+
+struct JobLog {
+	int32		order[16];
+	int32		count;
+	int32		deleted;
+
+	JobLog()
+		:
+		count(0),
+		deleted(0)
+	{
+	}
+
+	int32 IndexOf(int32 id) const
+	{
+		for (int32 i = 0; i < count; i++) {
+			if (order[i] == id)
+				return i;
+		}
+		return -1;
+	}
+};
+
+
+class LogJob : public BJob {
+public:
+	LogJob(int32 id, JobLog& log, status_t result = B_OK)
+		:
+		BJob("log"),
+		fID(id),
+		fLog(log),
+		fResult(result)
+	{
+	}
+
+	virtual ~LogJob()
+	{
+		atomic_add(&fLog.deleted, 1);
+	}
+
+protected:
+	virtual status_t Execute()
+	{
+		// give the dependant jobs a chance to run too early
+		snooze(1000);
+		fLog.order[atomic_add(&fLog.count, 1)] = fID;
+		return fResult;
+	}
+
+private:
+	int32		fID;
+	JobLog&		fLog;
+	status_t	fResult;
+};
+
+
+// #pragma mark - ThreadPoolTest
+
+
+ThreadPoolTest::ThreadPoolTest(std::string name)
+	:
+	BTestCase(name)
+{
+}
+
+
+void
+ThreadPoolTest::ForkJoin()
+{
+	ThreadPool pool("test worker", kWorkerCount);
+	CPPUNIT_ASSERT_EQUAL(B_OK, pool.InitCheck());
+	CPPUNIT_ASSERT_EQUAL(kWorkerCount, pool.CountWorkers());
+	CPPUNIT_ASSERT(!pool.IsWorkerThread());
+
+	for (int64 count = 1; count <= 100000; count *= 10) {
+		NextSubTest();
+		int64 sum = -1;
+		TaskGroup group(pool);
+		CPPUNIT_ASSERT_EQUAL(B_OK,
+			group.Spawn(new SumTask(pool, 1, count, sum)));
+		group.Wait();
+		CPPUNIT_ASSERT_EQUAL(count * (count + 1) / 2, sum);
+	}
+}
+
+
+void
+ThreadPoolTest::NestedWait()
+{
+	// with a single worker, the waiting tasks have to run the others
+	for (int32 workerCount = 1; workerCount <= kWorkerCount;
+			workerCount += kWorkerCount - 1) {
+		NextSubTest();
+		ThreadPool pool("test worker", workerCount);
+		CPPUNIT_ASSERT_EQUAL(B_OK, pool.InitCheck());
+
+		int32 done = 0;
+		TaskGroup group(pool);
+		for (int32 i = 0; i < 20; i++)
+			group.Spawn(new SpawningTask(pool, 50, done));
+		group.Wait();
+
+		CPPUNIT_ASSERT_EQUAL(20, done);
+	}
+}
+
+
+void
+ThreadPoolTest::Cancel()
+{
+	ThreadPool pool("test worker", 1);
+	CPPUNIT_ASSERT_EQUAL(B_OK, pool.InitCheck());
+
+	sem_id started = create_sem(0, "started");
+	sem_id gate = create_sem(0, "gate");
+	bool wasCanceled = false;
+	int32 count = 0;
+
+	{
+		TaskGroup group(pool);
+		group.Spawn(new GateTask(started, gate, wasCanceled));
+		acquire_sem(started);
+
+		// the worker is blocked, so none of these can have started yet
+		for (int32 i = 0; i < 10; i++)
+			group.Spawn(new CountTask(count));
+		group.Cancel();
+		CPPUNIT_ASSERT(group.IsCanceled());
+		group.Spawn(new CountTask(count));
+
+		release_sem(gate);
+		group.Wait();
+	}
+
+	CPPUNIT_ASSERT_EQUAL(0, count);
+	CPPUNIT_ASSERT(wasCanceled);
+
+	// other groups are not affected
+	TaskGroup group(pool);
+	group.Spawn(new CountTask(count));
+	group.Wait();
+	CPPUNIT_ASSERT_EQUAL(1, count);
+
+	delete_sem(started);
+	delete_sem(gate);
+}
+
+
+void
+ThreadPoolTest::Priorities()
+{
+	ThreadPool pool("test worker", 1);
+	CPPUNIT_ASSERT_EQUAL(B_OK, pool.InitCheck());
+
+	sem_id started = create_sem(0, "started");
+	sem_id gate = create_sem(0, "gate");
+	sem_id done = create_sem(0, "done");
+	bool wasCanceled;
+
+	pool.Submit(new GateTask(started, gate, wasCanceled),
+		TASK_PRIORITY_HIGH);
+	acquire_sem(started);
+
+	// Only the blocked worker runs the tasks, as nobody waits for them, so
+	// they run in the order of their priority, and in the order they were
+	// submitted
+	int32 order[9];
+	int32 index = 0;
+	static const task_priority kPriorities[] = {
+		TASK_PRIORITY_LOW, TASK_PRIORITY_NORMAL, TASK_PRIORITY_HIGH
+	};
+	for (int32 i = 0; i < 9; i++) {
+		pool.Submit(new OrderTask(i, order, index, done),
+			kPriorities[i % 3]);
+	}
+
+	release_sem(gate);
+	CPPUNIT_ASSERT_EQUAL(B_OK, acquire_sem_etc(done, 9, B_RELATIVE_TIMEOUT,
+		10000000));
+
+	static const int32 kExpectedOrder[] = { 2, 5, 8, 1, 4, 7, 0, 3, 6 };
+	for (int32 i = 0; i < 9; i++)
+		CPPUNIT_ASSERT_EQUAL(kExpectedOrder[i], order[i]);
+
+	delete_sem(started);
+	delete_sem(gate);
+	delete_sem(done);
+}
+
+
+void
+ThreadPoolTest::DequeOverflow()
+{
+	// more tasks than the deque of a worker holds, spawned from a worker
+	for (int32 workerCount = 1; workerCount <= kWorkerCount;
+			workerCount += kWorkerCount - 1) {
+		NextSubTest();
+		ThreadPool pool("test worker", workerCount);
+		CPPUNIT_ASSERT_EQUAL(B_OK, pool.InitCheck());
+
+		int32 done = 0;
+		TaskGroup group(pool);
+		group.Spawn(new SpawningTask(pool, 5000, done));
+		group.Spawn(new SpawningTask(pool, 5000, done));
+		group.Wait();
+
+		CPPUNIT_ASSERT_EQUAL(2, done);
+	}
+}
+
+
+void
+ThreadPoolTest::RunJobs()
+{
+	ThreadPool pool("test worker", kWorkerCount);
+	CPPUNIT_ASSERT_EQUAL(B_OK, pool.InitCheck());
+
+	JobLog log;
+	JobQueue queue;
+	CPPUNIT_ASSERT_EQUAL(B_OK, queue.InitCheck());
+
+	// 1 <- 2 <- 3, 4 fails <- 5 <- 6, 7 and 8 <- 9
+	LogJob* jobs[10];
+	for (int32 i = 1; i < 10; i++)
+		jobs[i] = new LogJob(i, log, i == 4 ? B_ERROR : B_OK);
+	jobs[2]->AddDependency(jobs[1]);
+	jobs[3]->AddDependency(jobs[2]);
+	jobs[5]->AddDependency(jobs[4]);
+	jobs[6]->AddDependency(jobs[5]);
+	jobs[9]->AddDependency(jobs[7]);
+	jobs[9]->AddDependency(jobs[8]);
+	for (int32 i = 9; i >= 1; i--)
+		CPPUNIT_ASSERT_EQUAL(B_OK, queue.AddJob(jobs[i]));
+
+	CPPUNIT_ASSERT_EQUAL(B_OK, pool.RunJobs(queue));
+
+	CPPUNIT_ASSERT_EQUAL((size_t)0, queue.CountJobs());
+	CPPUNIT_ASSERT_EQUAL(7, log.count);
+	CPPUNIT_ASSERT_EQUAL(9, log.deleted);
+
+	// the dependants of the failed job were not run
+	CPPUNIT_ASSERT(log.IndexOf(4) >= 0);
+	CPPUNIT_ASSERT_EQUAL(-1, log.IndexOf(5));
+	CPPUNIT_ASSERT_EQUAL(-1, log.IndexOf(6));
+
+	// the others only after what they depend on
+	CPPUNIT_ASSERT(log.IndexOf(1) >= 0);
+	CPPUNIT_ASSERT(log.IndexOf(1) < log.IndexOf(2));
+	CPPUNIT_ASSERT(log.IndexOf(2) < log.IndexOf(3));
+	CPPUNIT_ASSERT(log.IndexOf(7) >= 0 && log.IndexOf(8) >= 0);
+	CPPUNIT_ASSERT(log.IndexOf(7) < log.IndexOf(9));
+	CPPUNIT_ASSERT(log.IndexOf(8) < log.IndexOf(9));
+}
+
+
+CppUnit::Test*
+ThreadPoolTestSuite()
+{
+	CppUnit::TestSuite* testSuite = new CppUnit::TestSuite();
+
+	testSuite->addTest(new CppUnit::TestCaller<ThreadPoolTest>(
+		"ThreadPool::ForkJoin", &ThreadPoolTest::ForkJoin));
+	testSuite->addTest(new CppUnit::TestCaller<ThreadPoolTest>(
+		"ThreadPool::NestedWait", &ThreadPoolTest::NestedWait));
+	testSuite->addTest(new CppUnit::TestCaller<ThreadPoolTest>(
+		"ThreadPool::Cancel", &ThreadPoolTest::Cancel));
+	testSuite->addTest(new CppUnit::TestCaller<ThreadPoolTest>(
+		"ThreadPool::Priorities", &ThreadPoolTest::Priorities));
+	testSuite->addTest(new CppUnit::TestCaller<ThreadPoolTest>(
+		"ThreadPool::DequeOverflow", &ThreadPoolTest::DequeOverflow));
+	testSuite->addTest(new CppUnit::TestCaller<ThreadPoolTest>(
+		"ThreadPool::RunJobs", &ThreadPoolTest::RunJobs));
+
+	return testSuite;
+}
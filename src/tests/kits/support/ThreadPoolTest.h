@@ -0,0 +1,15 @@
+/*
+ * Copyright 2026, Haiku, Inc.
+ * Distributed under the terms of the MIT License.
+ */
+#ifndef _THREAD_POOL_TEST_H_
+#define _THREAD_POOL_TEST_H_
+
+
+#include "TestCase.h"
+
+
+CppUnit::Test *ThreadPoolTestSuite();
+
+
+#endif	// _THREAD_POOL_TEST_H_
@@ -0,0 +1,157 @@
+/*
+ * Copyright 2026, Haiku, Inc.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+#include "ZlibCompressionTest.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+
+#include <DataIO.h>
+
+#include <ZlibCompressionAlgorithm.h>
+
+#include <cppunit/TestCaller.h>
+#include <cppunit/TestSuite.h>
+
+
+// the size of the blocks the parallel compressing stream compresses
+static const size_t kBlockSize = 128 * 1024;
+static const int32 kWorkerCount = 3;
+
+
+class ZlibCompressionTest : public BTestCase {
+	public:
+		ZlibCompressionTest(std::string name = "");
+
+		void ZlibRoundTrip();
+		void GzipRoundTrip();
+
+	private:
+		void _RoundTrip(bool gzipFormat, int32 workerCount, size_t size,
+			size_t writeSize);
+		void _RoundTrips(bool gzipFormat);
+};
+
+
+ZlibCompressionTest::ZlibCompressionTest(std::string name)
+	:
+	BTestCase(name)
+{
+}
+
+
+void
+ZlibCompressionTest::ZlibRoundTrip()
+{
+	_RoundTrips(false);
+}
+
+
+void
+ZlibCompressionTest::GzipRoundTrip()
+{
+	_RoundTrips(true);
+}
+
+
+void
+ZlibCompressionTest::_RoundTrips(bool gzipFormat)
+{
+	static const size_t kSizes[] = {
+		0,
+		1,
+		kBlockSize,
+		kBlockSize + 1,
+		kBlockSize * kWorkerCount,
+			// all blocks filled, nothing left for the end
+		kBlockSize * 7 + 123
+			// more blocks than workers
+	};
+
+	for (size_t i = 0; i < sizeof(kSizes) / sizeof(kSizes[0]); i++) {
+		// in one piece, and in small pieces that don't fit the blocks
+		for (int32 workerCount = 0; workerCount <= kWorkerCount;
+				workerCount += kWorkerCount) {
+			NextSubTest();
+			_RoundTrip(gzipFormat, workerCount, kSizes[i], kSizes[i]);
+			NextSubTest();
+			_RoundTrip(gzipFormat, workerCount, kSizes[i], 1000);
+		}
+	}
+}
+
+
+void
+ZlibCompressionTest::_RoundTrip(bool gzipFormat, int32 workerCount,
+	size_t size, size_t writeSize)
+{
+	// compressible, but not too much
+	uint8* data = (uint8*)malloc(size + 1);
+	CPPUNIT_ASSERT(data != NULL);
+	srand(size);
+	for (size_t i = 0; i < size; i++)
+		data[i] = 'a' + rand() % 8;
+
+	BZlibCompressionAlgorithm algorithm;
+	BZlibCompressionParameters compressionParameters;
+	compressionParameters.SetGzipFormat(gzipFormat);
+	compressionParameters.SetWorkerCount(workerCount);
+
+	BMallocIO compressed;
+	BDataIO* stream;
+	CPPUNIT_ASSERT_EQUAL(B_OK, algorithm.CreateCompressingOutputStream(
+		&compressed, &compressionParameters, stream));
+
+	for (size_t offset = 0; offset < size; offset += writeSize) {
+		size_t toWrite = std::min(writeSize, size - offset);
+		CPPUNIT_ASSERT_EQUAL(B_OK, stream->WriteExactly(data + offset,
+			toWrite));
+	}
+	CPPUNIT_ASSERT_EQUAL(B_OK, stream->Flush());
+	delete stream;
+
+	const uint8* header = (const uint8*)compressed.Buffer();
+	CPPUNIT_ASSERT(compressed.BufferLength() >= 2);
+	if (gzipFormat) {
+		CPPUNIT_ASSERT(header[0] == 0x1f && header[1] == 0x8b);
+	} else
+		CPPUNIT_ASSERT((header[0] * 256 + header[1]) % 31 == 0);
+
+	compressed.Seek(0, SEEK_SET);
+	BZlibDecompressionParameters decompressionParameters;
+	CPPUNIT_ASSERT_EQUAL(B_OK, algorithm.CreateDecompressingInputStream(
+		&compressed, &decompressionParameters, stream));
+
+	uint8* decompressed = (uint8*)malloc(size + 1);
+	CPPUNIT_ASSERT(decompressed != NULL);
+	size_t bytesRead;
+	stream->ReadExactly(decompressed, size + 1, &bytesRead);
+	delete stream;
+
+	CPPUNIT_ASSERT_EQUAL(size, bytesRead);
+	CPPUNIT_ASSERT(memcmp(data, decompressed, size) == 0);
+
+	free(data);
+	free(decompressed);
+}
+
+
+CppUnit::Test*
+ZlibCompressionTestSuite()
+{
+	CppUnit::TestSuite* testSuite = new CppUnit::TestSuite();
+
+	testSuite->addTest(new CppUnit::TestCaller<ZlibCompressionTest>(
+		"BZlibCompressionAlgorithm::ZlibRoundTrip",
+		&ZlibCompressionTest::ZlibRoundTrip));
+	testSuite->addTest(new CppUnit::TestCaller<ZlibCompressionTest>(
+		"BZlibCompressionAlgorithm::GzipRoundTrip",
+		&ZlibCompressionTest::GzipRoundTrip));
+
+	return testSuite;
+}
@@ -0,0 +1,15 @@
+/*
+ * Copyright 2026, Haiku, Inc.
+ * Distributed under the terms of the MIT License.
+ */
+#ifndef _ZLIB_COMPRESSION_TEST_H_
+#define _ZLIB_COMPRESSION_TEST_H_
+
+
+#include "TestCase.h"
+
+
+CppUnit::Test *ZlibCompressionTestSuite();
+
+
+#endif	// _ZLIB_COMPRESSION_TEST_H_
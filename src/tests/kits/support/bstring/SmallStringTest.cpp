@@ -0,0 +1,168 @@
+#include "SmallStringTest.h"
+#include "cppunit/TestCaller.h"
+#include <SmallString.h>
+
+
+typedef BSmallString<8> SmallString;
+
+
+SmallStringTest::SmallStringTest(std::string name)
+		: BTestCase(name)
+{
+}
+
+
+SmallStringTest::~SmallStringTest()
+{
+}
+
+
+void
+SmallStringTest::PerformTest(void)
+{
+	// inline up to the capacity, on the heap from there
+	NextSubTest();
+	SmallString str1("1234567");
+	CPPUNIT_ASSERT(str1.IsInline());
+	CPPUNIT_ASSERT(str1.Length() == 7);
+	str1 += '8';
+	CPPUNIT_ASSERT(!str1.IsInline());
+	CPPUNIT_ASSERT(strcmp(str1.String(), "12345678") == 0);
+	CPPUNIT_ASSERT(str1.Length() == 8);
+	str1.Append("9abcdefghijklmnop");
+	CPPUNIT_ASSERT(strcmp(str1.String(), "123456789abcdefghijklmnop") == 0);
+	CPPUNIT_ASSERT(str1.Length() == 25);
+
+	NextSubTest();
+	SmallString str2("12345678");
+	CPPUNIT_ASSERT(!str2.IsInline());
+	CPPUNIT_ASSERT(strcmp(str2.String(), "12345678") == 0);
+	str2.Truncate(3);
+	CPPUNIT_ASSERT(strcmp(str2.String(), "123") == 0);
+	CPPUNIT_ASSERT(str2.Length() == 3);
+	str2.MakeEmpty();
+	CPPUNIT_ASSERT(str2.IsEmpty());
+	CPPUNIT_ASSERT(strcmp(str2.String(), "") == 0);
+
+	// Append() of itself, inline, and when that moves it to the heap
+	NextSubTest();
+	SmallString str3("abc");
+	str3.Append(str3.String());
+	CPPUNIT_ASSERT(str3.IsInline());
+	CPPUNIT_ASSERT(strcmp(str3.String(), "abcabc") == 0);
+	str3.Append(str3.String());
+	CPPUNIT_ASSERT(!str3.IsInline());
+	CPPUNIT_ASSERT(strcmp(str3.String(), "abcabcabcabc") == 0);
+	str3.Append(str3.String() + 9, 2);
+	CPPUNIT_ASSERT(strcmp(str3.String(), "abcabcabcabcab") == 0);
+	CPPUNIT_ASSERT(str3.Length() == 14);
+
+	// Append(NULL) and Append(const char*, int32)
+	NextSubTest();
+	SmallString str4("Base");
+	str4.Append(NULL);
+	CPPUNIT_ASSERT(strcmp(str4.String(), "Base") == 0);
+	str4.Append("APPENDED", 2);
+	CPPUNIT_ASSERT(strcmp(str4.String(), "BaseAP") == 0);
+	str4.Append("APPENDED", 0);
+	CPPUNIT_ASSERT(strcmp(str4.String(), "BaseAP") == 0);
+
+	// SetTo(const char*, int32)
+	NextSubTest();
+	SmallString str5;
+	CPPUNIT_ASSERT(str5.SetTo("some text", 4) == B_OK);
+	CPPUNIT_ASSERT(strcmp(str5.String(), "some") == 0);
+	CPPUNIT_ASSERT(str5.Length() == 4);
+	str5.SetTo("some text", 40);
+	CPPUNIT_ASSERT(strcmp(str5.String(), "some text") == 0);
+	CPPUNIT_ASSERT(str5.Length() == 9);
+	str5.SetTo("some text", 0);
+	CPPUNIT_ASSERT(str5.IsEmpty());
+	str5.SetTo("some text", -1);
+	CPPUNIT_ASSERT(str5.IsEmpty());
+	str5.SetTo(NULL);
+	CPPUNIT_ASSERT(str5.IsEmpty());
+	CPPUNIT_ASSERT(strcmp(str5.String(), "") == 0);
+
+	// SetTo() with a part of itself
+	NextSubTest();
+	SmallString str6("0123456789");
+	str6.SetTo(str6.String() + 2, 5);
+	CPPUNIT_ASSERT(strcmp(str6.String(), "23456") == 0);
+
+	// copy construction and assignment
+	NextSubTest();
+	SmallString inlineString("short");
+	SmallString heapString("a longer string");
+	SmallString str7(inlineString);
+	SmallString str8(heapString);
+	CPPUNIT_ASSERT(str7.IsInline());
+	CPPUNIT_ASSERT(strcmp(str7.String(), "short") == 0);
+	CPPUNIT_ASSERT(str8.String() != heapString.String());
+	CPPUNIT_ASSERT(strcmp(str8.String(), "a longer string") == 0);
+	str8.Truncate(1);
+	CPPUNIT_ASSERT(strcmp(heapString.String(), "a longer string") == 0);
+
+	NextSubTest();
+	str7 = heapString;
+	CPPUNIT_ASSERT(strcmp(str7.String(), "a longer string") == 0);
+	str7 = inlineString;
+	CPPUNIT_ASSERT(strcmp(str7.String(), "short") == 0);
+	str7 = str7;
+	CPPUNIT_ASSERT(strcmp(str7.String(), "short") == 0);
+	str7 = "assigned";
+	CPPUNIT_ASSERT(strcmp(str7.String(), "assigned") == 0);
+
+	NextSubTest();
+	BString bstring("from a BString");
+	SmallString str9(bstring);
+	CPPUNIT_ASSERT(strcmp(str9.String(), "from a BString") == 0);
+	CPPUNIT_ASSERT(str9.ToString() == bstring);
+
+	// comparison operators
+	NextSubTest();
+	SmallString a("abc");
+	SmallString b("abd");
+	SmallString c("abc");
+	CPPUNIT_ASSERT(a == c);
+	CPPUNIT_ASSERT(!(a != c));
+	CPPUNIT_ASSERT(a != b);
+	CPPUNIT_ASSERT(a < b);
+	CPPUNIT_ASSERT(!(b < a));
+	CPPUNIT_ASSERT(!(a < c));
+	CPPUNIT_ASSERT(a == "abc");
+	CPPUNIT_ASSERT(a != "ab");
+	CPPUNIT_ASSERT(a < "abcd");
+	CPPUNIT_ASSERT(a.Compare(NULL) > 0);
+	CPPUNIT_ASSERT(SmallString() == "");
+	CPPUNIT_ASSERT(a.ICompare("ABC") == 0);
+	CPPUNIT_ASSERT(a.ICompare("ABD") < 0);
+
+	// an inline and a heap string with the same contents are equal
+	NextSubTest();
+	SmallString longString("abcdefghij");
+	longString.Truncate(3);
+	CPPUNIT_ASSERT(!longString.IsInline());
+	CPPUNIT_ASSERT(longString == a);
+	CPPUNIT_ASSERT(!(longString < a));
+
+	// the default inline size
+	NextSubTest();
+	BSmallString<> str10("a string with thirty one chars.");
+	CPPUNIT_ASSERT(str10.Length() == 31);
+	CPPUNIT_ASSERT(str10.IsInline());
+	str10 += '!';
+	CPPUNIT_ASSERT(!str10.IsInline());
+	CPPUNIT_ASSERT(strcmp(str10.String(),
+		"a string with thirty one chars.!") == 0);
+}
+
+
+CppUnit::Test *SmallStringTest::suite(void)
+{
+	typedef CppUnit::TestCaller<SmallStringTest>
+		SmallStringTestCaller;
+
+	return(new SmallStringTestCaller("BSmallString Test",
+		&SmallStringTest::PerformTest));
+}
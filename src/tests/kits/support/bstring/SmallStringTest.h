@@ -0,0 +1,16 @@
+#ifndef SmallStringTest_H
+#define SmallStringTest_H
+
+#include "TestCase.h"
+
+
+class SmallStringTest : public BTestCase
+{
+public:
+	static Test *suite(void);
+	void PerformTest(void);
+	SmallStringTest(std::string name = "");
+	virtual ~SmallStringTest();
+};
+
+#endif
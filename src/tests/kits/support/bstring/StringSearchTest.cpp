@@ -628,6 +628,24 @@ StringSearchTest::PerformTest(void)
 	i = string1->IFindLast("abc",4);
 	CPPUNIT_ASSERT(i == 0);
 	delete string1;
+
+	// matches beyond, and across, the blocks searched at once
+	NextSubTest();
+	string1 = new BString("Received: from mail.example.com by mx.example.org; "
+		"Content-Type: text/plain; charset=UTF-8");
+	i = string1->FindFirst("Content-Type:");
+	CPPUNIT_ASSERT(i == 51);
+	i = string1->IFindFirst("CONTENT-type:");
+	CPPUNIT_ASSERT(i == 51);
+	i = string1->IFindFirst("charset=utf-8");
+	CPPUNIT_ASSERT(i == 77);
+	i = string1->FindFirst("charset=utf-8");
+	CPPUNIT_ASSERT(i == B_ERROR);
+	i = string1->FindFirst("UTF-8", 86);
+	CPPUNIT_ASSERT(i == B_ERROR);
+	i = string1->FindFirst('8', 30);
+	CPPUNIT_ASSERT(i == 89);
+	delete string1;
 }
 
 
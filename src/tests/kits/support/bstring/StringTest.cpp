@@ -17,6 +17,7 @@
 #include "StringReplaceTest.h"
 #include "StringSearchTest.h"
 #include "StringSplitTest.h"
+#include "SmallStringTest.h"
 
 
 CppUnit::Test *StringTestSuite()
@@ -39,6 +40,7 @@ CppUnit::Test *StringTestSuite()
 	testSuite->addTest(StringReplaceTest::suite());
 	testSuite->addTest(StringSearchTest::suite());
 	testSuite->addTest(StringSplitTest::suite());
+	testSuite->addTest(SmallStringTest::suite());
 	
 	return(testSuite);
 }
@@ -44,6 +44,9 @@ static const char* kUsage =
 	"      Print this usage info.\n"
 	"  -i, --input-stream\n"
 	"      Use the input stream API (default is output stream API).\n"
+	"  -t <threads>\n"
+	"      Compress with the given number of threads (output stream API\n"
+	"      only). Defaults to 0, compressing in the calling thread.\n"
 ;
 
 
@@ -61,6 +64,7 @@ main(int argc, const char* const* argv)
 	int compressionLevel = -1;
 	bool compress = true;
 	bool useInputStream = false;
+	int32 workerCount = 0;
 	CompressionType compressionType = ZlibCompression;
 
 	while (true) {
@@ -72,7 +76,7 @@ main(int argc, const char* const* argv)
 		};
 
 		opterr = 0; // don't print errors
-		int c = getopt_long(argc, (char**)argv, "+0123456789df:hi",
+		int c = getopt_long(argc, (char**)argv, "+0123456789df:hit:",
 			sLongOptions, NULL);
 		if (c == -1)
 			break;
@@ -117,6 +121,10 @@ main(int argc, const char* const* argv)
 				useInputStream = true;
 				break;
 
+			case 't':
+				workerCount = atoi(optarg);
+				break;
+
 			default:
 				print_usage_and_exit(true);
 				break;
@@ -164,6 +172,7 @@ main(int argc, const char* const* argv)
 				= new BZlibCompressionParameters(compressionLevel);
 			zlibCompressionParameters->SetGzipFormat(
 				compressionType == GzipCompression);
+			zlibCompressionParameters->SetWorkerCount(workerCount);
 			compressionParameters = zlibCompressionParameters;
 			decompressionParameters = new BZlibDecompressionParameters;
 			break;
@@ -173,8 +182,10 @@ main(int argc, const char* const* argv)
 			if (compressionLevel < 0)
 				compressionLevel = B_ZSTD_COMPRESSION_DEFAULT;
 			compressionAlgorithm = new BZstdCompressionAlgorithm;
-			compressionParameters
+			BZstdCompressionParameters* zstdCompressionParameters
 				= new BZstdCompressionParameters(compressionLevel);
+			zstdCompressionParameters->SetWorkerCount(workerCount);
+			compressionParameters = zstdCompressionParameters;
 			decompressionParameters = new BZstdDecompressionParameters;
 			break;
 		}
@@ -18,6 +18,7 @@
 #include "HorizontalLineTest.h"
 #include "RandomLineTest.h"
 #include "StringTest.h"
+#include "TerminalTextTest.h"
 #include "VerticalLineTest.h"
 
 
@@ -30,6 +31,7 @@ const test_info kTestInfos[] = {
 	{ "HorizontalLines",	HorizontalLineTest::CreateTest },
 	{ "RandomLines",		RandomLineTest::CreateTest },
 	{ "Strings",			StringTest::CreateTest },
+	{ "TerminalText",		TerminalTextTest::CreateTest },
 	{ "VerticalLines",		VerticalLineTest::CreateTest },
 	{ NULL, NULL }
 };
@@ -0,0 +1,143 @@
+/*
+ * Copyright 2026, Haiku, Inc.
+ * All rights reserved. Distributed under the terms of the MIT license.
+ */
+
+#include "TerminalTextTest.h"
+
+#include <stdio.h>
+
+#include <String.h>
+#include <View.h>
+
+#include "TestSupport.h"
+
+
+static const uint32 kColumns = 80;
+static const uint32 kBufferLines = 500;
+
+static const char* kWords[] = {
+	"status_t", "int32", "return", "B_OK", "if", "(error", "!=", "{", "}",
+	"fView->Invalidate();", "for", "while", "//", "delete", "NULL;",
+	"const", "char*", "BString", "printf(\"%s\\n\",", "=", "+=", "i++)",
+};
+
+
+/*!	Redraws a terminal full of 80 column lines in a fixed width font,
+	scrolled by one line each iteration. Most lines were already drawn in
+	the previous iteration, just one line further up, which is what text
+	views and terminals spend most of their drawing time on.
+*/
+TerminalTextTest::TerminalTextTest()
+	: Test(),
+	  fTestDuration(0),
+	  fTestStart(-1),
+	  fGlyphsRendered(0),
+	  fIterations(0),
+	  fMaxIterations(1500),
+
+	  fLines(NULL),
+	  fLineCount(0),
+	  fFirstLine(0),
+	  fAscent(11.0),
+	  fLineHeight(15.0)
+{
+}
+
+
+TerminalTextTest::~TerminalTextTest()
+{
+	delete[] fLines;
+}
+
+
+void
+TerminalTextTest::Prepare(BView* view)
+{
+	view->SetFont(be_fixed_font);
+
+	font_height fh;
+	view->GetFontHeight(&fh);
+	fAscent = ceilf(fh.ascent);
+	fLineHeight = ceilf(fh.ascent) + ceilf(fh.descent)
+		+ ceilf(fh.leading);
+	fViewBounds = view->Bounds();
+
+	delete[] fLines;
+	fLines = new BString[kBufferLines];
+	fLineCount = kBufferLines;
+
+	uint32 wordCount = sizeof(kWords) / sizeof(kWords[0]);
+	for (uint32 i = 0; i < fLineCount; i++) {
+		BString& line = fLines[i];
+		line.Append(' ', rand() % 4 * 4);
+		while ((uint32)line.Length() < kColumns) {
+			line << kWords[rand() % wordCount] << ' ';
+			if (rand() % 8 == 0)
+				break;
+		}
+		line.Truncate(kColumns);
+		while ((uint32)line.Length() < kColumns)
+			line.Append(' ', 1);
+	}
+
+	fTestDuration = 0;
+	fGlyphsRendered = 0;
+	fIterations = 0;
+	fFirstLine = 0;
+	fTestStart = system_time();
+}
+
+
+bool
+TerminalTextTest::RunIteration(BView* view)
+{
+	bigtime_t now = system_time();
+
+	view->FillRect(fViewBounds, B_SOLID_LOW);
+
+	BPoint textLocation(2, fAscent);
+	uint32 line = fFirstLine;
+	while (textLocation.y - fAscent < fViewBounds.bottom) {
+		view->DrawString(fLines[line].String(), kColumns, textLocation);
+		fGlyphsRendered += kColumns;
+
+		textLocation.y += fLineHeight;
+		line = (line + 1) % fLineCount;
+	}
+
+	view->Sync();
+
+	fTestDuration += system_time() - now;
+	fFirstLine = (fFirstLine + 1) % fLineCount;
+	fIterations++;
+
+	return fIterations < fMaxIterations;
+}
+
+
+void
+TerminalTextTest::PrintResults(BView* view)
+{
+	if (fTestDuration == 0) {
+		printf("Test was not run.\n");
+		return;
+	}
+	bigtime_t timeLeak = system_time() - fTestStart - fTestDuration;
+
+	Test::PrintResults(view);
+
+	printf("Screens per second: %.3f\n",
+		fIterations * 1000000.0 / fTestDuration);
+	printf("Glyphs per second: %.3f\n",
+		fGlyphsRendered * 1000000.0 / fTestDuration);
+	printf("Average time between iterations: %.4f seconds.\n",
+		(float)timeLeak / fIterations / 1000000);
+}
+
+
+Test*
+TerminalTextTest::CreateTest()
+{
+	return new TerminalTextTest();
+}
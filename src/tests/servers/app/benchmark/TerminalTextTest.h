@@ -0,0 +1,40 @@
+/*
+ * Copyright 2026, Haiku, Inc.
+ * All rights reserved. Distributed under the terms of the MIT license.
+ */
+#ifndef TERMINAL_TEXT_TEST_H
+#define TERMINAL_TEXT_TEST_H
+
+#include <Rect.h>
+
+#include "Test.h"
+
+class BString;
+
+class TerminalTextTest : public Test {
+public:
+								TerminalTextTest();
+	virtual						~TerminalTextTest();
+
+	virtual	void				Prepare(BView* view);
+	virtual	bool				RunIteration(BView* view);
+	virtual	void				PrintResults(BView* view);
+
+	static	Test*				CreateTest();
+
+private:
+	bigtime_t					fTestDuration;
+	bigtime_t					fTestStart;
+	uint64						fGlyphsRendered;
+	uint32						fIterations;
+	uint32						fMaxIterations;
+
+	BString*					fLines;
+	uint32						fLineCount;
+	uint32						fFirstLine;
+	float						fAscent;
+	float						fLineHeight;
+	BRect						fViewBounds;
+};
+
+#endif // TERMINAL_TEXT_TEST_H
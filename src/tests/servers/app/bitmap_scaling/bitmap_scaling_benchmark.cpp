@@ -0,0 +1,210 @@
+/*
+ * Copyright 2026, Haiku, Inc. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+/*!	Measures the row functions used to draw scaled bitmaps, for common icon
+	and image sizes, once with the scalar and once with every supported SIMD
+	implementation. Bitmaps scaled to more than half their size use the
+	bilinear filter, smaller ones the box filter, like the Painter does.
+*/
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <OS.h>
+
+#include "BitmapScale.h"
+#include "SIMDFlags.h"
+
+
+using BitmapPainterPrivate::BoxSpan;
+using BitmapPainterPrivate::FilterInfo;
+
+
+struct scale_case {
+	const char*	name;
+	int32		sourceWidth;
+	int32		sourceHeight;
+	int32		width;
+	int32		height;
+	bool		alpha;
+};
+
+static const scale_case kCases[] = {
+	{ "icon 16 -> 32", 16, 16, 32, 32, true },
+	{ "icon 32 -> 64", 32, 32, 64, 64, true },
+	{ "icon 64 -> 48", 64, 64, 48, 48, true },
+	{ "icon 128 -> 32", 128, 128, 32, 32, false },
+	{ "image 640x480 -> 200%", 640, 480, 1280, 960, false },
+	{ "image 1920x1080 -> 75%", 1920, 1080, 1440, 810, false },
+	{ "image 1920x1080 -> 50%", 1920, 1080, 960, 540, false },
+	{ "image 1920x1080 -> 25%", 1920, 1080, 480, 270, false },
+	{ "image 4000x3000 -> 1920x1440", 4000, 3000, 1920, 1440, false },
+};
+
+
+/*!	Calculates the weights like DrawBitmapBilinear does, but leaves out the
+	last pixel that would need special treatment.
+*/
+static void
+calculate_weights(FilterInfo* weights, int32 count, int32 sourceSize,
+	int32 size, int32 factor)
+{
+	for (int32 i = 0; i < count; i++) {
+		float index = (float)i * (sourceSize - 1) / (size - 1);
+		weights[i].index = (uint16)index;
+		weights[i].weight = 255 - (uint16)((index - weights[i].index) * 255);
+		if (weights[i].weight == 255)
+			weights[i].weight = 254;
+		weights[i].index *= factor;
+	}
+}
+
+
+static void
+calculate_spans(BoxSpan* spans, int32 count, int32 sourceSize, int32 size)
+{
+	for (int32 i = 0; i < count; i++) {
+		spans[i].index = (int64)i * sourceSize / size;
+		spans[i].count = (int64)(i + 1) * sourceSize / size - spans[i].index;
+	}
+}
+
+
+static bigtime_t
+run(const scale_functions* functions, const scale_case& scale,
+	const uint8* source, uint8* bits, int32 iterations)
+{
+	const uint32 sourceBPR = scale.sourceWidth * 4;
+	const uint32 bytesPerRow = scale.width * 4;
+
+	bigtime_t start = system_time();
+
+	if (scale.width * 2 > scale.sourceWidth) {
+		FilterInfo* weightsX = new FilterInfo[scale.width];
+		FilterInfo* weightsY = new FilterInfo[scale.height];
+		calculate_weights(weightsX, scale.width - 1, scale.sourceWidth,
+			scale.width, 4);
+		calculate_weights(weightsY, scale.height - 1, scale.sourceHeight,
+			scale.height, 1);
+
+		for (int32 i = 0; i < iterations; i++) {
+			for (int32 y = 0; y < scale.height - 1; y++) {
+				const uint8* top = source + weightsY[y].index * sourceBPR;
+				uint8* dst = bits + y * bytesPerRow;
+				if (scale.alpha) {
+					functions->bilinear_alpha_overlay(dst, top, sourceBPR,
+						weightsX, scale.width - 1, weightsY[y].weight);
+				} else {
+					functions->bilinear_copy(dst, top, sourceBPR, weightsX,
+						scale.width - 1, weightsY[y].weight);
+				}
+			}
+		}
+
+		delete[] weightsX;
+		delete[] weightsY;
+	} else {
+		BoxSpan* spansX = new BoxSpan[scale.width];
+		BoxSpan* spansY = new BoxSpan[scale.height];
+		uint32* sums = new uint32[scale.sourceWidth * 4];
+		calculate_spans(spansX, scale.width, scale.sourceWidth, scale.width);
+		calculate_spans(spansY, scale.height, scale.sourceHeight,
+			scale.height);
+
+		for (int32 i = 0; i < iterations; i++) {
+			for (int32 y = 0; y < scale.height; y++) {
+				memset(sums, 0, scale.sourceWidth * 4 * sizeof(uint32));
+				for (uint32 row = 0; row < spansY[y].count; row++) {
+					functions->box_accumulate(sums,
+						source + (spansY[y].index + row) * sourceBPR,
+						scale.sourceWidth);
+				}
+				functions->box_resolve(bits + y * bytesPerRow, sums, spansX,
+					scale.width, spansY[y].count);
+			}
+		}
+
+		delete[] spansX;
+		delete[] spansY;
+		delete[] sums;
+	}
+
+	return system_time() - start;
+}
+
+
+static void
+benchmark(const scale_case& scale, int32 iterations)
+{
+	size_t sourceSize = (size_t)scale.sourceWidth * scale.sourceHeight * 4;
+	uint8* source = new uint8[sourceSize];
+	for (size_t i = 0; i < sourceSize; i++)
+		source[i] = rand();
+
+	uint8* bits = new uint8[(size_t)scale.width * scale.height * 4];
+	memset(bits, 0x80, (size_t)scale.width * scale.height * 4);
+
+	// keep the number of pixels drawn roughly the same for every case
+	iterations = iterations * 1024 * 768 / (scale.width * scale.height);
+	if (iterations < 1)
+		iterations = 1;
+
+	struct {
+		const char*	name;
+		uint32		flags;
+		bool		supported;
+	} implementations[] = {
+		{ "scalar", 0, true },
+#if defined(__i386__) || defined(__x86_64__)
+		{ "SSE2", APPSERVER_SIMD_SSE2, __builtin_cpu_supports("sse2") != 0 },
+		{ "AVX2", APPSERVER_SIMD_AVX2, __builtin_cpu_supports("avx2") != 0 },
+#endif
+	};
+
+	printf("%-30s %-8s", scale.name,
+		scale.width * 2 > scale.sourceWidth ? "bilinear" : "box");
+
+	double scalarTime = 0;
+	for (size_t i = 0; i < sizeof(implementations)
+			/ sizeof(implementations[0]); i++) {
+		if (!implementations[i].supported)
+			continue;
+
+		double time = run(scale_functions_for(implementations[i].flags),
+			scale, source, bits, iterations);
+		if (i == 0)
+			scalarTime = time;
+
+		printf("  %s %7.1f Mpix/s", implementations[i].name,
+			(double)scale.width * scale.height * iterations / time);
+		if (i != 0)
+			printf(" (%.1fx)", scalarTime / time);
+	}
+	printf("\n");
+
+	delete[] source;
+	delete[] bits;
+}
+
+
+int
+main(int argc, char** argv)
+{
+	int32 iterations = 20;
+	if (argc > 1)
+		iterations = strtol(argv[1], NULL, 0);
+	if (iterations <= 0) {
+		fprintf(stderr, "usage: %s [iterations]\n", argv[0]);
+		return 1;
+	}
+
+	for (size_t i = 0; i < sizeof(kCases) / sizeof(kCases[0]); i++)
+		benchmark(kCases[i], iterations);
+
+	return 0;
+}
@@ -0,0 +1,147 @@
+/*
+ * Copyright 2026, Haiku, Inc. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+/*!	Counts the port messages the app_server receives for a frame of a busy
+	view, drawn once the usual way, and once recorded with
+	BView::BeginDrawingBatch(). The frame mixes a few hundred small drawing
+	calls with a GetMouse() query, which needs a reply from the server.
+
+	The messages are counted on the port of the ServerWindow, which is
+	named after the window title.
+*/
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <Application.h>
+#include <Roster.h>
+#include <View.h>
+#include <Window.h>
+
+
+static const char* kWindowTitle = "Drawing batch benchmark";
+static const int32 kRows = 100;
+
+
+static port_id
+find_server_window_port()
+{
+	team_id serverTeam
+		= be_roster->TeamFor("application/x-vnd.Haiku-app_server");
+	if (serverTeam < 0)
+		return serverTeam;
+
+	port_info info;
+	int32 cookie = 0;
+	while (get_next_port_info(serverTeam, &cookie, &info) == B_OK) {
+		if (strcmp(info.name, kWindowTitle) == 0)
+			return info.port;
+	}
+
+	return B_NAME_NOT_FOUND;
+}
+
+
+static int32
+messages_read(port_id port)
+{
+	port_info info;
+	if (get_port_info(port, &info) != B_OK)
+		return 0;
+
+	return info.total_count;
+}
+
+
+static void
+draw_frame(BView* view)
+{
+	BRect bounds = view->Bounds();
+	float rowHeight = bounds.Height() / kRows;
+
+	for (int32 row = 0; row < kRows; row++) {
+		BRect rect(bounds.left, row * rowHeight, bounds.right,
+			(row + 1) * rowHeight - 1);
+
+		view->SetHighColor(row & 1 ? 240 : 255, 240, 255);
+		view->FillRect(rect);
+		view->SetHighColor(0, 0, 0);
+		view->StrokeLine(rect.LeftBottom(), rect.RightBottom());
+		view->DrawString("Row of a list with some text",
+			BPoint(rect.left + 4, rect.bottom - 2));
+
+		if (row == kRows / 2) {
+			BPoint where;
+			uint32 buttons;
+			view->GetMouse(&where, &buttons, false);
+		}
+	}
+}
+
+
+static void
+measure(BView* view, port_id port, int32 frames, bool batched)
+{
+	view->LockLooper();
+
+	int32 before = messages_read(port);
+	bigtime_t start = system_time();
+
+	for (int32 i = 0; i < frames; i++) {
+		if (batched)
+			view->BeginDrawingBatch();
+
+		draw_frame(view);
+		view->Sync();
+
+		if (batched)
+			view->EndDrawingBatch();
+	}
+
+	bigtime_t time = system_time() - start;
+	int32 messages = messages_read(port) - before;
+
+	view->UnlockLooper();
+
+	printf("  %-10s %8.1f port messages, %8.1f usecs per frame\n",
+		batched ? "batched:" : "direct:", (double)messages / frames,
+		(double)time / frames);
+}
+
+
+int
+main(int argc, char** argv)
+{
+	int32 frames = 200;
+	if (argc > 1)
+		frames = atoi(argv[1]);
+
+	BApplication app("application/x-vnd.Haiku-DrawingBatchBenchmark");
+
+	BWindow* window = new BWindow(BRect(100, 100, 499, 699), kWindowTitle,
+		B_TITLED_WINDOW, B_NOT_ZOOMABLE | B_QUIT_ON_WINDOW_CLOSE);
+	BView* view = new BView(window->Bounds(), "list", B_FOLLOW_ALL,
+		B_WILL_DRAW);
+	window->AddChild(view);
+	window->Show();
+
+	port_id port = find_server_window_port();
+	if (port < 0) {
+		fprintf(stderr, "Could not find the port of the window: %s\n",
+			strerror(port));
+		return 1;
+	}
+
+	printf("%" B_PRId32 " frames of %" B_PRId32 " rows:\n", frames, kRows);
+	measure(view, port, frames, false);
+	measure(view, port, frames, true);
+
+	window->Lock();
+	window->Quit();
+	return 0;
+}
@@ -0,0 +1,182 @@
+/*
+ * Copyright 2026, Haiku, Inc. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+/*!	Measures the span functions of the Painter drawing modes that have SIMD
+	versions, once with the scalar and once with every supported SIMD
+	implementation.
+*/
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <OS.h>
+
+#include "PatternHandler.h"
+#include "PixelFormat.h"
+#include "SIMDFlags.h"
+
+
+// normally detected by the Painter
+uint32 gSIMDFlags = 0;
+
+
+static const int32 kWidth = 1024;
+static const int32 kHeight = 768;
+
+
+enum span_type {
+	SPAN_HLINE_OPAQUE,
+	SPAN_HLINE,
+	SPAN_SOLID,
+	SPAN_COLOR,
+	SPAN_COLOR_SOLID
+};
+
+static const char* kSpanNames[] = {
+	"hline (opaque)",
+	"hline",
+	"solid hspan",
+	"color hspan",
+	"color hspan (solid)"
+};
+
+
+struct mode_info {
+	const char*		name;
+	drawing_mode	mode;
+};
+
+static const mode_info kModes[] = {
+	{ "B_OP_OVER", B_OP_OVER },
+	{ "B_OP_COPY", B_OP_COPY },
+	{ "B_OP_ALPHA", B_OP_ALPHA }
+};
+
+
+static uint8* sCovers;
+static agg::rgba8* sColors;
+
+
+static bigtime_t
+run(PixelFormat& pixelFormat, span_type type, int32 iterations)
+{
+	agg::rgba8 color(255, 203, 0, 200);
+
+	bigtime_t start = system_time();
+	for (int32 i = 0; i < iterations; i++) {
+		for (int32 y = 0; y < kHeight; y++) {
+			switch (type) {
+				case SPAN_HLINE_OPAQUE:
+					pixelFormat.blend_hline(0, y, kWidth, color, 255);
+					break;
+				case SPAN_HLINE:
+					pixelFormat.blend_hline(0, y, kWidth, color, 128);
+					break;
+				case SPAN_SOLID:
+					pixelFormat.blend_solid_hspan(0, y, kWidth, color,
+						sCovers);
+					break;
+				case SPAN_COLOR:
+					pixelFormat.blend_color_hspan(0, y, kWidth, sColors,
+						sCovers, 0);
+					break;
+				case SPAN_COLOR_SOLID:
+					pixelFormat.blend_color_hspan(0, y, kWidth, sColors,
+						NULL, 200);
+					break;
+			}
+		}
+	}
+	return system_time() - start;
+}
+
+
+static void
+benchmark(const mode_info& mode, span_type type, int32 iterations)
+{
+	uint8* bits = new uint8[kWidth * kHeight * 4];
+	memset(bits, 0x80, kWidth * kHeight * 4);
+	for (int32 i = 3; i < kWidth * kHeight * 4; i += 4)
+		bits[i] = 255;
+
+	agg::rendering_buffer buffer(bits, kWidth, kHeight, kWidth * 4);
+	PatternHandler pattern;
+
+	struct {
+		const char*	name;
+		uint32		flags;
+		bool		supported;
+	} implementations[] = {
+		{ "scalar", 0, true },
+#if defined(__i386__) || defined(__x86_64__)
+		{ "SSE2", APPSERVER_SIMD_SSE2, __builtin_cpu_supports("sse2") != 0 },
+		{ "AVX2", APPSERVER_SIMD_AVX2, __builtin_cpu_supports("avx2") != 0 },
+#endif
+	};
+
+	printf("%-10s %-20s", mode.name, kSpanNames[type]);
+
+	double scalarTime = 0;
+	for (size_t i = 0; i < sizeof(implementations)
+			/ sizeof(implementations[0]); i++) {
+		if (!implementations[i].supported)
+			continue;
+
+		gSIMDFlags = implementations[i].flags;
+		PixelFormat pixelFormat(buffer, &pattern);
+		pixelFormat.SetDrawingMode(mode.mode, B_PIXEL_ALPHA,
+			B_ALPHA_COMPOSITE);
+
+		double time = run(pixelFormat, type, iterations);
+		if (i == 0)
+			scalarTime = time;
+
+		printf("  %s %7.1f Mpix/s", implementations[i].name,
+			(double)kWidth * kHeight * iterations / time);
+		if (i != 0)
+			printf(" (%.1fx)", scalarTime / time);
+	}
+	printf("\n");
+
+	gSIMDFlags = 0;
+	delete[] bits;
+}
+
+
+int
+main(int argc, char** argv)
+{
+	int32 iterations = 20;
+	if (argc > 1)
+		iterations = strtol(argv[1], NULL, 0);
+	if (iterations <= 0) {
+		fprintf(stderr, "usage: %s [iterations]\n", argv[0]);
+		return 1;
+	}
+
+	// anti-aliased edges: mostly transparent or opaque, some partial cover
+	sCovers = new uint8[kWidth];
+	sColors = new agg::rgba8[kWidth];
+	for (int32 i = 0; i < kWidth; i++) {
+		int32 value = rand() % 4;
+		sCovers[i] = value == 0 ? 0 : value == 1 ? 255 : rand();
+		sColors[i] = agg::rgba8(rand() % 256, rand() % 256, rand() % 256,
+			rand() % 2 == 0 ? 255 : rand());
+	}
+
+	for (size_t i = 0; i < sizeof(kModes) / sizeof(kModes[0]); i++) {
+		for (int32 type = SPAN_HLINE_OPAQUE; type <= SPAN_COLOR_SOLID;
+				type++) {
+			benchmark(kModes[i], (span_type)type, iterations);
+		}
+	}
+
+	delete[] sCovers;
+	delete[] sColors;
+	return 0;
+}
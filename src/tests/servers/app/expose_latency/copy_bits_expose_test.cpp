@@ -0,0 +1,187 @@
+/*
+ * Copyright 2026, Haiku, Inc. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+/*!	Checks that a CopyBits() into a partly covered view does not leave the
+	backing store with the old contents of the covered part, which would be
+	put back on screen when it is uncovered.
+
+	The view is green on its right half, until it copies its blue left half
+	over it while another window covers part of the right half. Once that
+	window is moved away, the uncovered part has to be blue, no matter if
+	the client redraws it, or the app_server restores it.
+
+	This only tests something with backing stores enabled: that is, with a
+	message with the bool "backing stores" set to true flattened into
+	~/config/settings/system/app_server/compositing.
+*/
+
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <Application.h>
+#include <Bitmap.h>
+#include <Screen.h>
+#include <View.h>
+#include <Window.h>
+
+
+static const rgb_color kSourceColor = { 40, 60, 200, 255 };
+static const rgb_color kOldColor = { 20, 160, 60, 255 };
+static const rgb_color kCoverColor = { 200, 40, 40, 255 };
+static const bigtime_t kTimeout = 2000000;
+
+
+class CopyView : public BView {
+public:
+	CopyView(BRect frame)
+		:
+		BView(frame, "copy", B_FOLLOW_ALL, B_WILL_DRAW),
+		fCopied(false)
+	{
+		SetViewColor(B_TRANSPARENT_COLOR);
+	}
+
+	virtual void Draw(BRect updateRect)
+	{
+		BRect bounds = Bounds();
+		BRect left = bounds;
+		left.right = floorf(bounds.Width() / 2);
+		BRect right = bounds;
+		right.left = left.right + 1;
+
+		SetHighColor(kSourceColor);
+		FillRect(left);
+		SetHighColor(fCopied ? kSourceColor : kOldColor);
+		FillRect(right);
+	}
+
+	void CopyLeftToRight()
+	{
+		BRect bounds = Bounds();
+		BRect left = bounds;
+		left.right = floorf(bounds.Width() / 2);
+		BRect right = left;
+		right.OffsetBy(left.Width() + 1, 0);
+
+		fCopied = true;
+		CopyBits(left, right);
+		Sync();
+	}
+
+private:
+	bool		fCopied;
+};
+
+
+static bool
+matches(const rgb_color& color, const uint8* pixel)
+{
+	return pixel[0] == color.blue && pixel[1] == color.green
+		&& pixel[2] == color.red;
+}
+
+
+//!	Waits until the pixel at \a where shows \a color.
+static bool
+wait_for_color(BScreen& screen, BBitmap* bitmap, BPoint where,
+	const rgb_color& color)
+{
+	BRect frame(where, where);
+	bigtime_t start = system_time();
+
+	while (system_time() - start < kTimeout) {
+		if (screen.ReadBitmap(bitmap, false, &frame) == B_OK
+			&& matches(color, (const uint8*)bitmap->Bits()))
+			return true;
+		snooze(1000);
+	}
+
+	return false;
+}
+
+
+static void
+move_to(BWindow* window, BPoint where)
+{
+	window->Lock();
+	window->MoveTo(where);
+	window->Unlock();
+}
+
+
+int
+main(int argc, char** argv)
+{
+	int32 iterations = 10;
+	if (argc > 1)
+		iterations = atoi(argv[1]);
+
+	BApplication app("application/x-vnd.Haiku-CopyBitsExposeTest");
+
+	BScreen screen;
+	BBitmap* bitmap = new BBitmap(BRect(0, 0, 0, 0), B_RGB32);
+
+	// the probe is in the right half of the window, which the cover
+	// window covers the upper part of
+	BRect frame(100, 100, 499, 399);
+	BPoint probe(400, 180);
+	BPoint covering(350, 150);
+	BPoint away(560, 150);
+
+	BWindow* cover = new BWindow(BRect(away, away + BPoint(99, 99)),
+		"Cover", B_BORDERED_WINDOW_LOOK, B_FLOATING_APP_WINDOW_FEEL,
+		B_AVOID_FOCUS);
+	BView* coverView = new BView(cover->Bounds(), "cover", B_FOLLOW_ALL,
+		B_WILL_DRAW);
+	coverView->SetViewColor(kCoverColor);
+	cover->AddChild(coverView);
+	cover->Show();
+
+	bool passed = true;
+	for (int32 i = 0; i < iterations && passed; i++) {
+		BWindow* window = new BWindow(frame, "CopyBits expose",
+			B_TITLED_WINDOW, B_NOT_ZOOMABLE);
+		CopyView* view = new CopyView(window->Bounds());
+		window->AddChild(view);
+		window->Show();
+
+		if (!wait_for_color(screen, bitmap, probe, kOldColor)) {
+			fprintf(stderr, "The window did not show up on screen.\n");
+			return 1;
+		}
+
+		// covering the window saves the old contents of the probe
+		move_to(cover, covering);
+		if (!wait_for_color(screen, bitmap, probe, kCoverColor)) {
+			fprintf(stderr, "The cover did not show up on screen.\n");
+			return 1;
+		}
+
+		window->Lock();
+		view->CopyLeftToRight();
+		window->Unlock();
+
+		move_to(cover, away);
+		if (!wait_for_color(screen, bitmap, probe, kSourceColor)) {
+			printf("  iteration %" B_PRId32 ": the old contents were "
+				"exposed\n", i);
+			passed = false;
+		}
+
+		window->Lock();
+		window->Quit();
+	}
+
+	printf("%s\n", passed ? "passed" : "FAILED");
+
+	cover->Lock();
+	cover->Quit();
+	delete bitmap;
+
+	return passed ? 0 : 1;
+}
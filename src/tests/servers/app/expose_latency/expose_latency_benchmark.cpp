@@ -0,0 +1,193 @@
+/*
+ * Copyright 2026, Haiku, Inc. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+/*!	Measures how long it takes until the contents of a window are back on
+	screen after another window that covered them has been moved away. The
+	time is taken by reading back the screen until the uncovered part shows
+	the window's contents again.
+
+	The window takes a while to draw (20 ms by default), like windows with
+	complex contents do. Without backing stores, the app_server has to wait
+	for it; with them, the contents are copied back right away, and the
+	window is not asked to draw at all. To compare, run this with and
+	without a message with the bool "backing stores" set to true flattened
+	into ~/config/settings/system/app_server/compositing; the app_server
+	reads it on start.
+*/
+
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <algorithm>
+
+#include <Application.h>
+#include <Bitmap.h>
+#include <Screen.h>
+#include <View.h>
+#include <Window.h>
+
+
+static const rgb_color kContentColor = { 20, 160, 60, 255 };
+static const rgb_color kCoverColor = { 200, 40, 40, 255 };
+static const bigtime_t kTimeout = 2000000;
+
+
+class SlowView : public BView {
+public:
+	SlowView(BRect frame, bigtime_t drawDelay)
+		:
+		BView(frame, "slow", B_FOLLOW_ALL, B_WILL_DRAW),
+		fDrawDelay(drawDelay),
+		fDrawCount(0)
+	{
+		SetViewColor(B_TRANSPARENT_COLOR);
+	}
+
+	virtual void Draw(BRect updateRect)
+	{
+		atomic_add(&fDrawCount, 1);
+		snooze(fDrawDelay);
+
+		SetHighColor(kContentColor);
+		FillRect(updateRect);
+	}
+
+	int32 DrawCount()
+	{
+		return atomic_get(&fDrawCount);
+	}
+
+private:
+	bigtime_t	fDrawDelay;
+	int32		fDrawCount;
+};
+
+
+static bool
+matches(const rgb_color& color, const uint8* pixel)
+{
+	return pixel[0] == color.blue && pixel[1] == color.green
+		&& pixel[2] == color.red;
+}
+
+
+/*!	Waits until the pixel at \a where shows \a color, and returns the time
+	that took, or -1 on timeout.
+*/
+static bigtime_t
+wait_for_color(BScreen& screen, BBitmap* bitmap, BPoint where,
+	const rgb_color& color)
+{
+	BRect frame(where, where);
+	bigtime_t start = system_time();
+
+	while (system_time() - start < kTimeout) {
+		if (screen.ReadBitmap(bitmap, false, &frame) == B_OK
+			&& matches(color, (const uint8*)bitmap->Bits()))
+			return system_time() - start;
+	}
+
+	return -1;
+}
+
+
+int
+main(int argc, char** argv)
+{
+	int32 iterations = 50;
+	bigtime_t drawDelay = 20000;
+	if (argc > 1)
+		iterations = atoi(argv[1]);
+	if (argc > 2)
+		drawDelay = atoi(argv[2]) * 1000;
+
+	BApplication app("application/x-vnd.Haiku-ExposeLatencyBenchmark");
+
+	BScreen screen;
+	BBitmap* bitmap = new BBitmap(BRect(0, 0, 0, 0), B_RGB32);
+
+	BWindow* window = new BWindow(BRect(100, 100, 499, 399),
+		"Expose latency", B_TITLED_WINDOW, B_NOT_ZOOMABLE);
+	SlowView* view = new SlowView(window->Bounds(), drawDelay);
+	window->AddChild(view);
+	window->Show();
+
+	BRect coverFrame(150, 150, 449, 349);
+	BWindow* cover = new BWindow(coverFrame, "Cover", B_BORDERED_WINDOW_LOOK,
+		B_FLOATING_APP_WINDOW_FEEL, B_AVOID_FOCUS);
+	BView* coverView = new BView(cover->Bounds(), "cover", B_FOLLOW_ALL,
+		B_WILL_DRAW);
+	coverView->SetViewColor(kCoverColor);
+	cover->AddChild(coverView);
+	cover->Show();
+
+	// the middle of the covered part, the cover is moved to the right
+	// of the window to uncover it
+	BPoint probe(300, 250);
+	BPoint away(560, 150);
+
+	if (wait_for_color(screen, bitmap, probe, kCoverColor) < 0) {
+		fprintf(stderr, "The windows did not show up on screen.\n");
+		return 1;
+	}
+	snooze(drawDelay * 4);
+
+	bigtime_t total = 0;
+	bigtime_t minimum = kTimeout;
+	bigtime_t maximum = 0;
+	int32 draws = 0;
+	int32 count = 0;
+
+	for (int32 i = 0; i < iterations; i++) {
+		// cover the window, and let it settle
+		cover->Lock();
+		cover->MoveTo(coverFrame.LeftTop());
+		cover->Unlock();
+		if (wait_for_color(screen, bitmap, probe, kCoverColor) < 0)
+			break;
+		snooze(drawDelay * 2);
+
+		int32 drawCount = view->DrawCount();
+
+		cover->Lock();
+		cover->MoveTo(away);
+		cover->Unlock();
+
+		bigtime_t latency = wait_for_color(screen, bitmap, probe,
+			kContentColor);
+		if (latency < 0) {
+			fprintf(stderr, "The window was not redrawn in time.\n");
+			break;
+		}
+
+		// wait until a pending Draw() would have been called
+		snooze(drawDelay * 2);
+		draws += view->DrawCount() - drawCount;
+
+		total += latency;
+		minimum = std::min(minimum, latency);
+		maximum = std::max(maximum, latency);
+		count++;
+	}
+
+	if (count == 0)
+		return 1;
+
+	printf("%" B_PRId32 " uncovers, window drawing takes %" B_PRIdBIGTIME
+		" usecs\n", count, drawDelay);
+	printf("  expose latency: %8.1f usecs (min %" B_PRIdBIGTIME ", max %"
+		B_PRIdBIGTIME ")\n", (double)total / count, minimum, maximum);
+	printf("  client redraws: %8.2f per uncover\n", (double)draws / count);
+
+	cover->Lock();
+	cover->Quit();
+	window->Lock();
+	window->Quit();
+	delete bitmap;
+
+	return 0;
+}
@@ -0,0 +1,432 @@
+/*
+ * Copyright 2026, Haiku, Inc. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+/*!	Measures the bandwidth the frame streaming mode of the remote
+	HWInterface needs for typical screen updates, and checks that a client
+	decoding the stream ends up with exactly the same frame buffer.
+
+	The "server" draws simple desktop content into a 1920x1080 frame
+	buffer, and streams each frame through a RemoteFrameStreamer; a client
+	thread decodes the tiles the way RemoteDesktop does. The number of
+	bytes on the wire is compared with the size of the damaged pixels.
+*/
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <OS.h>
+#include <Region.h>
+
+#include "FrameTileCodec.h"
+#include "MallocBuffer.h"
+#include "RemoteFrameStreamer.h"
+#include "RemoteMessage.h"
+#include "StreamingRingBuffer.h"
+
+
+static const int32 kWidth = 1920;
+static const int32 kHeight = 1080;
+
+static const uint16 kFrameDone = RP_ENABLE_SYNC_DRAWING;
+	// marks the end of a frame in the stream, not sent by the streamer
+
+
+struct client_state {
+	StreamingRingBuffer*	source;
+	MallocBuffer*			buffer;
+	uint8*					cache;
+	sem_id					frameDone;
+	uint64					wireBytes;
+	int32					errors;
+};
+
+
+static status_t
+client_thread(void* data)
+{
+	client_state& client = *(client_state*)data;
+	RemoteMessage message(client.source, NULL);
+	uint32 tileBytesPerRow = kFrameTileSize * 4;
+
+	while (true) {
+		uint16 code;
+		if (message.NextMessage(code) != B_OK)
+			return B_OK;
+
+		if (code == kFrameDone) {
+			release_sem(client.frameDone);
+			continue;
+		}
+
+		client.wireBytes += sizeof(uint16) + sizeof(uint32)
+			+ message.DataLeft();
+
+		int32 left, top, width, height;
+		uint32 slot;
+		message.Read(left);
+		message.Read(top);
+		message.Read(width);
+		message.Read(height);
+		if (message.Read(slot) != B_OK || slot >= kFrameTileCacheSize) {
+			client.errors++;
+			continue;
+		}
+
+		uint8* tile = client.cache
+			+ slot * kFrameTileSize * kFrameTileSize * 4;
+
+		if (code == RP_FRAME_TILE) {
+			char* data;
+			size_t size;
+			if (message.ReadString(&data, size) != B_OK) {
+				client.errors++;
+				continue;
+			}
+
+			if (decode_frame_tile((const uint8*)data, size, tile,
+					tileBytesPerRow, width, height) != B_OK) {
+				client.errors++;
+			}
+			free(data);
+		} else if (code != RP_FRAME_TILE_CACHED) {
+			client.errors++;
+			continue;
+		}
+
+		uint32 bytesPerRow = client.buffer->BytesPerRow();
+		uint8* bits = (uint8*)client.buffer->Bits() + top * bytesPerRow
+			+ left * 4;
+		for (int32 y = 0; y < height; y++) {
+			memcpy(bits + y * bytesPerRow, tile + y * tileBytesPerRow,
+				width * 4);
+		}
+	}
+}
+
+
+// #pragma mark - drawing
+
+
+static inline uint32*
+pixel_at(MallocBuffer& buffer, int32 x, int32 y)
+{
+	return (uint32*)((uint8*)buffer.Bits() + y * buffer.BytesPerRow()) + x;
+}
+
+
+static void
+fill_rect(MallocBuffer& buffer, BRegion& damage, BRect rect, uint32 color)
+{
+	rect = rect & BRect(0, 0, kWidth - 1, kHeight - 1);
+	if (!rect.IsValid())
+		return;
+
+	for (int32 y = (int32)rect.top; y <= (int32)rect.bottom; y++) {
+		uint32* pixel = pixel_at(buffer, (int32)rect.left, y);
+		for (int32 x = (int32)rect.left; x <= (int32)rect.right; x++)
+			*pixel++ = color;
+	}
+
+	damage.Include(rect);
+}
+
+
+static void
+draw_background(MallocBuffer& buffer, BRegion& damage)
+{
+	for (int32 y = 0; y < kHeight; y++) {
+		uint32* pixel = pixel_at(buffer, 0, y);
+		uint32 blue = 0x80 + y * 0x60 / kHeight;
+		for (int32 x = 0; x < kWidth; x++)
+			*pixel++ = 0xff336600 | blue;
+	}
+
+	damage.Include(BRect(0, 0, kWidth - 1, kHeight - 1));
+}
+
+
+//!	Something that looks roughly like a line of text, to have some detail.
+static void
+draw_text_line(MallocBuffer& buffer, BRegion& damage, int32 x, int32 y,
+	int32 width, uint32 seed)
+{
+	for (int32 offset = 0; offset + 8 <= width; offset += 9) {
+		seed = seed * 1103515245 + 12345;
+		uint32 glyph = seed >> 8;
+		if ((glyph & 7) == 0)
+			continue;
+
+		for (int32 row = 0; row < 12; row++) {
+			uint32* pixel = pixel_at(buffer, x + offset, y + row);
+			for (int32 column = 0; column < 8; column++) {
+				if ((glyph >> ((row * 3 + column) % 24)) & 1)
+					pixel[column] = 0xff202020;
+			}
+		}
+	}
+
+	damage.Include(BRect(x, y, x + width - 1, y + 11));
+}
+
+
+static void
+draw_window(MallocBuffer& buffer, BRegion& damage, BRect frame,
+	int32 firstLine)
+{
+	fill_rect(buffer, damage, BRect(frame.left, frame.top, frame.right,
+		frame.top + 20), 0xffffcb00);
+	fill_rect(buffer, damage, BRect(frame.left, frame.top + 21, frame.right,
+		frame.bottom), 0xffffffff);
+
+	for (int32 y = (int32)frame.top + 28; y + 12 < frame.bottom; y += 16) {
+		draw_text_line(buffer, damage, (int32)frame.left + 6, y,
+			(int32)frame.Width() - 12, firstLine++);
+	}
+}
+
+
+// #pragma mark - scenarios
+
+
+struct scenario {
+	const char*	name;
+	int32		frames;
+	void		(*draw)(MallocBuffer& buffer, BRegion& damage, int32 frame);
+};
+
+
+static const BRect kWindowFrame(200, 150, 999, 749);
+
+
+static void
+typing(MallocBuffer& buffer, BRegion& damage, int32 frame)
+{
+	// one glyph per frame, with a blinking cursor behind it
+	int32 x = 206 + frame * 9;
+	draw_text_line(buffer, damage, x, 178, 9, frame);
+	fill_rect(buffer, damage, BRect(x + 9, 178, x + 9, 189),
+		frame % 2 == 0 ? 0xff000000 : 0xffffffff);
+}
+
+
+static void
+scrolling(MallocBuffer& buffer, BRegion& damage, int32 frame)
+{
+	BRect contents(kWindowFrame.left, kWindowFrame.top + 21,
+		kWindowFrame.right, kWindowFrame.bottom);
+	fill_rect(buffer, damage, contents, 0xffffffff);
+
+	// scroll by a line per frame
+	for (int32 y = (int32)contents.top + 7; y + 12 < contents.bottom;
+			y += 16) {
+		draw_text_line(buffer, damage, (int32)contents.left + 6, y,
+			(int32)contents.Width() - 12, frame + y);
+	}
+}
+
+
+static void
+moving_window(MallocBuffer& buffer, BRegion& damage, int32 frame,
+	int32 stepX, int32 stepY)
+{
+	BRect frameRect = kWindowFrame.OffsetByCopy(frame * stepX, frame * stepY);
+	BRect previous = frameRect.OffsetByCopy(-stepX, -stepY);
+
+	// the exposed desktop is redrawn, then the window at its new position
+	BRegion exposed(previous);
+	exposed.Exclude(frameRect);
+	for (int32 i = 0; i < exposed.CountRects(); i++) {
+		clipping_rect rect = exposed.RectAtInt(i);
+		for (int32 y = rect.top; y <= rect.bottom; y++) {
+			uint32 blue = 0x80 + y * 0x60 / kHeight;
+			for (int32 x = rect.left; x <= rect.right; x++)
+				*pixel_at(buffer, x, y) = 0xff336600 | blue;
+		}
+	}
+	damage.Include(&exposed);
+
+	draw_window(buffer, damage, frameRect, 0);
+}
+
+
+static void
+moving_window_aligned(MallocBuffer& buffer, BRegion& damage, int32 frame)
+{
+	moving_window(buffer, damage, frame, kFrameTileSize, 0);
+}
+
+
+static void
+moving_window_unaligned(MallocBuffer& buffer, BRegion& damage, int32 frame)
+{
+	moving_window(buffer, damage, frame, 13, 7);
+}
+
+
+static void
+video(MallocBuffer& buffer, BRegion& damage, int32 frame)
+{
+	// worst case: a video playing in a 640x360 area
+	uint32 seed = frame;
+	for (int32 y = 0; y < 360; y++) {
+		uint32* pixel = pixel_at(buffer, 1100, 500 + y);
+		for (int32 x = 0; x < 640; x++) {
+			seed = seed * 1103515245 + 12345;
+			*pixel++ = 0xff000000 | (seed >> 8);
+		}
+	}
+
+	damage.Include(BRect(1100, 500, 1739, 859));
+}
+
+
+static void
+redraw_unchanged(MallocBuffer& buffer, BRegion& damage, int32 frame)
+{
+	// the whole screen is redrawn, but nothing actually changes
+	damage.Include(BRect(0, 0, kWidth - 1, kHeight - 1));
+}
+
+
+static const scenario kScenarios[] = {
+	{ "typing", 60, &typing },
+	{ "scrolling", 30, &scrolling },
+	{ "window move (tile steps)", 10, &moving_window_aligned },
+	{ "window move (13,7 steps)", 30, &moving_window_unaligned },
+	{ "video 640x360", 10, &video },
+	{ "unchanged redraw", 10, &redraw_unchanged },
+};
+
+
+// #pragma mark -
+
+
+static void
+stream_frame(RemoteFrameStreamer& streamer, StreamingRingBuffer& target,
+	MallocBuffer& buffer, client_state& client, bigtime_t& streamTime)
+{
+	bigtime_t start = system_time();
+	streamer.Stream(&buffer);
+	streamTime += system_time() - start;
+
+	RemoteMessage marker(NULL, &target);
+	marker.Start(kFrameDone);
+	marker.Flush();
+
+	while (acquire_sem(client.frameDone) == B_INTERRUPTED)
+		;
+}
+
+
+static bool
+compare_buffers(MallocBuffer& server, MallocBuffer& client)
+{
+	for (int32 y = 0; y < kHeight; y++) {
+		uint32* serverRow = pixel_at(server, 0, y);
+		uint32* clientRow = pixel_at(client, 0, y);
+		for (int32 x = 0; x < kWidth; x++) {
+			if (((serverRow[x] ^ clientRow[x]) & 0x00ffffff) != 0) {
+				printf("  mismatch at %" B_PRId32 ",%" B_PRId32 "\n", x, y);
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+
+int
+main()
+{
+	StreamingRingBuffer stream(1024 * 1024);
+	MallocBuffer buffer(kWidth, kHeight);
+	MallocBuffer clientBuffer(kWidth, kHeight);
+	if (stream.InitCheck() != B_OK || buffer.InitCheck() != B_OK
+		|| clientBuffer.InitCheck() != B_OK) {
+		fprintf(stderr, "out of memory\n");
+		return 1;
+	}
+
+	client_state client;
+	client.source = &stream;
+	client.buffer = &clientBuffer;
+	client.cache = (uint8*)malloc(
+		kFrameTileCacheSize * kFrameTileSize * kFrameTileSize * 4);
+	client.frameDone = create_sem(0, "frame done");
+	client.wireBytes = 0;
+	client.errors = 0;
+
+	thread_id clientThread = spawn_thread(&client_thread, "client",
+		B_NORMAL_PRIORITY, &client);
+	resume_thread(clientThread);
+
+	RemoteFrameStreamer streamer(&stream);
+
+	// the initial frame
+	BRegion damage;
+	draw_background(buffer, damage);
+	draw_window(buffer, damage, kWindowFrame, 0);
+	draw_window(buffer, damage, BRect(1100, 300, 1799, 899), 100);
+
+	bigtime_t streamTime = 0;
+	stream_frame(streamer, stream, buffer, client, streamTime);
+
+	printf("%-26s %7s %10s %10s %7s %7s %7s %7s %9s\n", "", "frames",
+		"damaged", "sent", "ratio", "tiles", "cached", "skipped", "ms/frame");
+	printf("%-26s %7d %8.1fMB %8.1fKB %6.1f%% %7s %7s %7s %9.2f\n",
+		"initial frame", 1, (double)kWidth * kHeight * 4 / 1048576,
+		client.wireBytes / 1024.0,
+		100.0 * client.wireBytes / ((double)kWidth * kHeight * 4), "", "", "",
+		streamTime / 1000.0);
+
+	bool identical = compare_buffers(buffer, clientBuffer);
+
+	for (size_t i = 0; i < B_COUNT_OF(kScenarios); i++) {
+		const scenario& test = kScenarios[i];
+
+		frame_stream_statistics before;
+		streamer.GetStatistics(before);
+		uint64 wireBytes = client.wireBytes;
+		streamTime = 0;
+
+		for (int32 frame = 0; frame < test.frames; frame++) {
+			damage.MakeEmpty();
+			test.draw(buffer, damage, frame);
+			streamer.AddDamage(damage);
+			stream_frame(streamer, stream, buffer, client, streamTime);
+		}
+
+		frame_stream_statistics after;
+		streamer.GetStatistics(after);
+		uint64 damaged = after.damaged_bytes - before.damaged_bytes;
+		uint64 sent = client.wireBytes - wireBytes;
+
+		printf("%-26s %7" B_PRId32 " %8.1fMB %8.1fKB %6.1f%% %7" B_PRIu32
+			" %7" B_PRIu32 " %7" B_PRIu32 " %9.2f\n", test.name,
+			test.frames, damaged / 1048576.0, sent / 1024.0,
+			damaged > 0 ? 100.0 * sent / damaged : 0.0,
+			after.tiles_sent - before.tiles_sent,
+			after.tiles_cached - before.tiles_cached,
+			after.tiles_unchanged - before.tiles_unchanged,
+			streamTime / 1000.0 / test.frames);
+
+		if (!compare_buffers(buffer, clientBuffer))
+			identical = false;
+	}
+
+	if (client.errors > 0)
+		printf("%" B_PRId32 " malformed tiles\n", client.errors);
+
+	printf("client frame buffer %s\n", identical ? "identical" : "DIFFERS");
+
+	delete_sem(client.frameDone);
+	free(client.cache);
+	kill_thread(clientThread);
+	return identical && client.errors == 0 ? 0 : 1;
+}
@@ -0,0 +1,155 @@
+/*
+ * Copyright 2026, Haiku, Inc. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+/*!	Measures how long the app_server takes to redraw a 4K (3840x2160) screen
+	full of content: a background fill, a scaled bitmap, a translucent
+	overlay, and a background region like the one left over around a few
+	windows. The drawing goes to an offscreen bitmap, so that the size does
+	not depend on the actual screen.
+
+	The app_server splits operations this large across its tile workers,
+	so the numbers scale with the number of CPUs; disabling all but one CPU
+	in ProcessController gives the times for drawing in a single thread.
+*/
+
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <Application.h>
+#include <Bitmap.h>
+#include <Region.h>
+#include <View.h>
+
+
+static const BRect kFrame(0, 0, 3839, 2159);
+
+
+static BBitmap*
+create_source_bitmap()
+{
+	BBitmap* bitmap = new BBitmap(BRect(0, 0, 1919, 1079), B_RGBA32);
+	uint8* bits = (uint8*)bitmap->Bits();
+	int32 width = bitmap->Bounds().IntegerWidth() + 1;
+	int32 height = bitmap->Bounds().IntegerHeight() + 1;
+
+	for (int32 y = 0; y < height; y++) {
+		uint8* row = bits + y * bitmap->BytesPerRow();
+		for (int32 x = 0; x < width; x++) {
+			row[x * 4 + 0] = x * 255 / width;
+			row[x * 4 + 1] = y * 255 / height;
+			row[x * 4 + 2] = (x ^ y) & 0xff;
+			row[x * 4 + 3] = 255;
+		}
+	}
+	return bitmap;
+}
+
+
+static void
+fill_background(BView* view, BBitmap*)
+{
+	view->SetDrawingMode(B_OP_COPY);
+	view->SetHighColor(51, 102, 152);
+	view->FillRect(kFrame);
+}
+
+
+static void
+draw_scaled_bitmap(BView* view, BBitmap* bitmap)
+{
+	view->SetDrawingMode(B_OP_COPY);
+	view->DrawBitmap(bitmap, bitmap->Bounds(), kFrame,
+		B_FILTER_BITMAP_BILINEAR);
+}
+
+
+static void
+fill_translucent(BView* view, BBitmap*)
+{
+	view->SetDrawingMode(B_OP_ALPHA);
+	view->SetBlendingMode(B_CONSTANT_ALPHA, B_ALPHA_OVERLAY);
+	view->SetHighColor(255, 255, 255, 96);
+	view->FillRect(kFrame);
+}
+
+
+static void
+fill_desktop_region(BView* view, BBitmap*)
+{
+	// the desktop background around a few overlapping windows
+	BRegion region(kFrame);
+	region.Exclude(BRect(200, 150, 1700, 1200));
+	region.Exclude(BRect(1400, 600, 3200, 1900));
+	region.Exclude(BRect(300, 1500, 1000, 2000));
+
+	view->SetDrawingMode(B_OP_COPY);
+	view->SetHighColor(51, 102, 152);
+	view->FillRegion(&region);
+}
+
+
+static double
+measure(BView* view, BBitmap* source, int32 iterations,
+	void (*draw)(BView*, BBitmap*))
+{
+	// warm up once, the first time creates the tile workers
+	view->LockLooper();
+	draw(view, source);
+	view->Sync();
+
+	bigtime_t start = system_time();
+	for (int32 i = 0; i < iterations; i++)
+		draw(view, source);
+	view->Sync();
+	bigtime_t time = system_time() - start;
+	view->UnlockLooper();
+
+	return time / 1000.0 / iterations;
+}
+
+
+static void
+draw_frame(BView* view, BBitmap* bitmap)
+{
+	fill_desktop_region(view, bitmap);
+	draw_scaled_bitmap(view, bitmap);
+	fill_translucent(view, bitmap);
+}
+
+
+int
+main(int argc, char** argv)
+{
+	int32 iterations = 20;
+	if (argc > 1)
+		iterations = atoi(argv[1]);
+
+	BApplication app("application/x-vnd.Haiku-TiledRedrawBenchmark");
+
+	BBitmap* target = new BBitmap(kFrame, B_BITMAP_ACCEPTS_VIEWS, B_RGBA32);
+	BView* view = new BView(kFrame, "target", B_FOLLOW_NONE, B_WILL_DRAW);
+	target->AddChild(view);
+
+	BBitmap* source = create_source_bitmap();
+
+	printf("%" B_PRId32 " iterations at 3840x2160, times per operation:\n",
+		iterations);
+	printf("  background fill:   %8.2f ms\n",
+		measure(view, source, iterations, &fill_background));
+	printf("  bilinear bitmap:   %8.2f ms\n",
+		measure(view, source, iterations, &draw_scaled_bitmap));
+	printf("  translucent fill:  %8.2f ms\n",
+		measure(view, source, iterations, &fill_translucent));
+	printf("  desktop region:    %8.2f ms\n",
+		measure(view, source, iterations, &fill_desktop_region));
+	printf("  full redraw:       %8.2f ms\n",
+		measure(view, source, iterations, &draw_frame));
+
+	delete source;
+	delete target;
+	return 0;
+}
@@ -0,0 +1,121 @@
+/*
+ * Copyright 2026, Haiku, Inc. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+/*!	Checks that the tile workers of the app_server draw operations that are
+	cut into fewer tiles than there are workers correctly.
+
+	A large fill first prepares all workers with the state of one bitmap,
+	which is then deleted. Short fills into another bitmap only use some
+	of the workers; if one of the others took a tile, it would draw with
+	the color, clipping and buffer of the deleted bitmap.
+*/
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <Application.h>
+#include <Bitmap.h>
+#include <Region.h>
+#include <View.h>
+
+
+static const BRect kLargeFrame(0, 0, 3839, 2159);
+static const int32 kWidth = 8192;
+	// with 32 or more lines, the area is large enough to be tiled
+static const rgb_color kStaleColor = { 255, 0, 0, 255 };
+static const rgb_color kColor = { 0, 255, 0, 255 };
+
+
+static bool
+has_color(const uint8* pixel, const rgb_color& color)
+{
+	return pixel[0] == color.blue && pixel[1] == color.green
+		&& pixel[2] == color.red;
+}
+
+
+static void
+fill(BBitmap* bitmap, const rgb_color& color, BRegion* clipping)
+{
+	BView* view = bitmap->ChildAt(0);
+	view->LockLooper();
+	view->ConstrainClippingRegion(clipping);
+	view->SetDrawingMode(B_OP_COPY);
+	view->SetHighColor(color);
+	view->FillRect(bitmap->Bounds());
+	view->Sync();
+	view->UnlockLooper();
+}
+
+
+static BBitmap*
+create_bitmap(BRect frame)
+{
+	BBitmap* bitmap = new BBitmap(frame, B_BITMAP_ACCEPTS_VIEWS, B_RGBA32);
+	bitmap->AddChild(new BView(frame, "target", B_FOLLOW_NONE, B_WILL_DRAW));
+	memset(bitmap->Bits(), 0, bitmap->BitsLength());
+	return bitmap;
+}
+
+
+//!	Fills \a height lines with only the left half visible.
+static bool
+test_fill(int32 height)
+{
+	BBitmap* stale = create_bitmap(kLargeFrame);
+	fill(stale, kStaleColor, NULL);
+	delete stale;
+
+	BRect frame(0, 0, kWidth - 1, height - 1);
+	BBitmap* bitmap = create_bitmap(frame);
+	BRegion clipping(BRect(0, 0, kWidth / 2 - 1, height - 1));
+	fill(bitmap, kColor, &clipping);
+
+	bool passed = true;
+	for (int32 y = 0; y < height && passed; y++) {
+		const uint8* row = (const uint8*)bitmap->Bits()
+			+ y * bitmap->BytesPerRow();
+		for (int32 x = 0; x < kWidth; x++) {
+			const uint8* pixel = row + x * 4;
+			bool visible = x < kWidth / 2;
+			if (visible ? !has_color(pixel, kColor)
+					: pixel[0] != 0 || pixel[1] != 0 || pixel[2] != 0) {
+				printf("  %" B_PRId32 " lines: wrong pixel at %" B_PRId32
+					", %" B_PRId32 ": %u, %u, %u\n", height, x, y, pixel[2],
+					pixel[1], pixel[0]);
+				passed = false;
+				break;
+			}
+		}
+	}
+
+	delete bitmap;
+	return passed;
+}
+
+
+int
+main(int argc, char** argv)
+{
+	int32 iterations = 20;
+	if (argc > 1)
+		iterations = atoi(argv[1]);
+
+	BApplication app("application/x-vnd.Haiku-TiledRedrawTest");
+
+	// 32 lines are cut into two tiles, and every further 16 lines into
+	// another one, so this covers one worker up to a few
+	bool passed = true;
+	for (int32 i = 0; i < iterations; i++) {
+		for (int32 height = 32; height <= 96; height += 16)
+			passed &= test_fill(height);
+	}
+
+	printf("%s\n", passed ? "passed" : "FAILED");
+	return passed ? 0 : 1;
+}
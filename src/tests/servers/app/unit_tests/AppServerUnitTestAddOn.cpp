@@ -6,6 +6,8 @@
 #include <TestSuite.h>
 #include <TestSuiteAddon.h>
 
+#include "BitmapScaleSIMDTest.h"
+#include "DrawingModeSIMDTest.h"
 #include "SimpleTransformTest.h"
 
 
@@ -14,6 +16,8 @@ getTestSuite()
 {
 	BTestSuite* suite = new BTestSuite("AppServerUnitTests");
 
+	BitmapScaleSIMDTest::AddTests(*suite);
+	DrawingModeSIMDTest::AddTests(*suite);
 	SimpleTransformTest::AddTests(*suite);
 
 	return suite;
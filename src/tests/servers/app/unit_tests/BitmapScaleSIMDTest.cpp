@@ -0,0 +1,239 @@
+/*
+ * Copyright 2026, Haiku, Inc. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+
+#include "BitmapScaleSIMDTest.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <cppunit/TestCaller.h>
+#include <cppunit/TestSuite.h>
+
+#include "BitmapScale.h"
+#include "SIMDFlags.h"
+
+
+using BitmapPainterPrivate::BoxSpan;
+using BitmapPainterPrivate::FilterInfo;
+
+
+static const int32 kSourceWidth = 67;
+static const int32 kSourceHeight = 9;
+static const int32 kWidth = 61;
+	// not a multiple of any vector size, so that the scalar tails are used
+static const uint32 kSeeds = 16;
+
+
+static void
+fill_random(uint8* bits, size_t size)
+{
+	for (size_t i = 0; i < size; i++)
+		bits[i] = rand();
+
+	// make sure the special cases of the alpha overlay are hit often
+	for (size_t i = 3; i < size; i += 4) {
+		switch (rand() % 4) {
+			case 0:
+				bits[i] = 0;
+				break;
+			case 1:
+				bits[i] = 255;
+				break;
+		}
+	}
+}
+
+
+static const scale_functions*
+functions_for(const char* feature)
+{
+#if defined(__i386__) || defined(__x86_64__)
+	if (strcmp(feature, "sse2") == 0 && __builtin_cpu_supports("sse2"))
+		return scale_functions_for(APPSERVER_SIMD_SSE2);
+	if (strcmp(feature, "avx2") == 0 && __builtin_cpu_supports("avx2"))
+		return scale_functions_for(APPSERVER_SIMD_AVX2);
+#endif
+	return NULL;
+}
+
+
+void
+BitmapScaleSIMDTest::_CompareBilinear(bool alphaOverlay,
+	const scale_functions* functions)
+{
+	const uint32 bytesPerRow = kSourceWidth * 4;
+	uint8 source[kSourceHeight * bytesPerRow];
+	uint8 reference[kWidth * 4];
+	uint8 bits[kWidth * 4];
+	FilterInfo weights[kWidth];
+
+	for (uint32 seed = 0; seed < kSeeds; seed++) {
+		srand(seed);
+		fill_random(source, sizeof(source));
+		fill_random(reference, sizeof(reference));
+		memcpy(bits, reference, sizeof(bits));
+
+		for (int32 x = 0; x < kWidth; x++) {
+			// the weights must not be 255, since the right neighbour is read
+			weights[x].index = (rand() % (kSourceWidth - 1)) * 4;
+			weights[x].weight = x % 8 == 0 ? 0 : rand() % 255;
+		}
+
+		for (int32 y = 0; y < kSourceHeight - 1; y++) {
+			const uint8* top = source + y * bytesPerRow;
+			uint16 wTop = y == 0 ? 0 : rand() % 255;
+			int32 count = kWidth - y;
+
+			if (alphaOverlay) {
+				gScaleFunctionsScalar.bilinear_alpha_overlay(reference, top,
+					bytesPerRow, weights, count, wTop);
+				functions->bilinear_alpha_overlay(bits, top, bytesPerRow,
+					weights, count, wTop);
+			} else {
+				gScaleFunctionsScalar.bilinear_copy(reference, top,
+					bytesPerRow, weights, count, wTop);
+				functions->bilinear_copy(bits, top, bytesPerRow, weights,
+					count, wTop);
+			}
+
+			CPPUNIT_ASSERT(memcmp(reference, bits, sizeof(bits)) == 0);
+		}
+	}
+}
+
+
+void
+BitmapScaleSIMDTest::_CompareBilinear(bool alphaOverlay)
+{
+	const char* features[] = { "sse2", "avx2" };
+	for (size_t i = 0; i < sizeof(features) / sizeof(features[0]); i++) {
+		const scale_functions* functions = functions_for(features[i]);
+		if (functions != NULL)
+			_CompareBilinear(alphaOverlay, functions);
+	}
+}
+
+
+void
+BitmapScaleSIMDTest::_CompareBox(const scale_functions* functions)
+{
+	uint8 source[kSourceHeight * kSourceWidth * 4];
+	uint32 referenceSums[kSourceWidth * 4];
+	uint32 sums[kSourceWidth * 4];
+	uint8 reference[kWidth * 4];
+	uint8 bits[kWidth * 4];
+	BoxSpan spans[kWidth];
+
+	for (uint32 seed = 0; seed < kSeeds; seed++) {
+		srand(seed);
+		fill_random(source, sizeof(source));
+		fill_random(reference, sizeof(reference));
+		memcpy(bits, reference, sizeof(bits));
+
+		memset(referenceSums, 0, sizeof(referenceSums));
+		memset(sums, 0, sizeof(sums));
+
+		// start at an odd pixel, and leave one out at the end
+		uint32 rows = 1 + seed % kSourceHeight;
+		for (uint32 y = 0; y < rows; y++) {
+			const uint8* row = source + y * kSourceWidth * 4 + 4;
+			gScaleFunctionsScalar.box_accumulate(referenceSums + 4, row,
+				kSourceWidth - 2);
+			functions->box_accumulate(sums + 4, row, kSourceWidth - 2);
+		}
+
+		CPPUNIT_ASSERT(memcmp(referenceSums, sums, sizeof(sums)) == 0);
+
+		for (int32 x = 0; x < kWidth; x++) {
+			spans[x].index = 1 + rand() % (kSourceWidth - 2);
+			spans[x].count = 1 + rand() % (kSourceWidth - 1 - spans[x].index);
+		}
+
+		gScaleFunctionsScalar.box_resolve(reference, referenceSums, spans,
+			kWidth, rows);
+		functions->box_resolve(bits, sums, spans, kWidth, rows);
+
+		CPPUNIT_ASSERT(memcmp(reference, bits, sizeof(bits)) == 0);
+	}
+}
+
+
+void
+BitmapScaleSIMDTest::BilinearCopy()
+{
+	_CompareBilinear(false);
+}
+
+
+void
+BitmapScaleSIMDTest::BilinearAlphaOverlay()
+{
+	_CompareBilinear(true);
+}
+
+
+void
+BitmapScaleSIMDTest::BoxFilter()
+{
+	const char* features[] = { "sse2", "avx2" };
+	for (size_t i = 0; i < sizeof(features) / sizeof(features[0]); i++) {
+		const scale_functions* functions = functions_for(features[i]);
+		if (functions != NULL)
+			_CompareBox(functions);
+	}
+}
+
+
+void
+BitmapScaleSIMDTest::BoxFilterAverage()
+{
+	// a black and a white pixel above each other, and a transparent
+	// destination pixel
+	const uint8 source[] = {
+		0, 0, 0, 255,
+		255, 255, 255, 255
+	};
+	uint32 sums[4] = { 0 };
+	gScaleFunctionsScalar.box_accumulate(sums, source, 1);
+	gScaleFunctionsScalar.box_accumulate(sums, source + 4, 1);
+
+	BoxSpan span = { 0, 1 };
+	uint8 pixel[4] = { 0, 0, 0, 0 };
+	gScaleFunctionsScalar.box_resolve(pixel, sums, &span, 1, 2);
+
+	// the average is rounded, and the alpha channel is left alone
+	CPPUNIT_ASSERT(pixel[0] == 128 && pixel[1] == 128 && pixel[2] == 128);
+	CPPUNIT_ASSERT(pixel[3] == 0);
+
+	// a single pixel is copied unchanged
+	memset(sums, 0, sizeof(sums));
+	const uint8 color[] = { 1, 127, 254, 0 };
+	gScaleFunctionsScalar.box_accumulate(sums, color, 1);
+	gScaleFunctionsScalar.box_resolve(pixel, sums, &span, 1, 1);
+	CPPUNIT_ASSERT(pixel[0] == 1 && pixel[1] == 127 && pixel[2] == 254);
+}
+
+
+/* static */ void
+BitmapScaleSIMDTest::AddTests(BTestSuite& parent)
+{
+	CppUnit::TestSuite* const suite = new CppUnit::TestSuite(
+		"BitmapScaleSIMDTest");
+
+	suite->addTest(new CppUnit::TestCaller<BitmapScaleSIMDTest>(
+		"BitmapScaleSIMDTest::BilinearCopy",
+		&BitmapScaleSIMDTest::BilinearCopy));
+	suite->addTest(new CppUnit::TestCaller<BitmapScaleSIMDTest>(
+		"BitmapScaleSIMDTest::BilinearAlphaOverlay",
+		&BitmapScaleSIMDTest::BilinearAlphaOverlay));
+	suite->addTest(new CppUnit::TestCaller<BitmapScaleSIMDTest>(
+		"BitmapScaleSIMDTest::BoxFilter",
+		&BitmapScaleSIMDTest::BoxFilter));
+	suite->addTest(new CppUnit::TestCaller<BitmapScaleSIMDTest>(
+		"BitmapScaleSIMDTest::BoxFilterAverage",
+		&BitmapScaleSIMDTest::BoxFilterAverage));
+
+	parent.addTest("BitmapScaleSIMDTest", suite);
+}
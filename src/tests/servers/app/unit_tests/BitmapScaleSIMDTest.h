@@ -0,0 +1,32 @@
+/*
+ * Copyright 2026, Haiku, Inc. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+#ifndef BITMAP_SCALE_SIMD_TEST_H
+#define BITMAP_SCALE_SIMD_TEST_H
+
+#include <TestCase.h>
+#include <TestSuite.h>
+
+
+struct scale_functions;
+
+
+class BitmapScaleSIMDTest : public BTestCase {
+public:
+	static	void			AddTests(BTestSuite& parent);
+
+			void			BilinearCopy();
+			void			BilinearAlphaOverlay();
+			void			BoxFilter();
+			void			BoxFilterAverage();
+
+private:
+			void			_CompareBilinear(bool alphaOverlay);
+			void			_CompareBilinear(bool alphaOverlay,
+								const scale_functions* functions);
+			void			_CompareBox(const scale_functions* functions);
+};
+
+
+#endif // BITMAP_SCALE_SIMD_TEST_H
@@ -0,0 +1,210 @@
+/*
+ * Copyright 2026, Haiku, Inc. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+
+#include "DrawingModeSIMDTest.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <cppunit/TestCaller.h>
+#include <cppunit/TestSuite.h>
+
+#include "PatternHandler.h"
+#include "PixelFormat.h"
+#include "SIMDFlags.h"
+
+
+// normally detected by the Painter
+uint32 gSIMDFlags = 0;
+
+
+static const int32 kWidth = 61;
+	// not a multiple of any vector size, so that the scalar tails are used
+static const int32 kHeight = 64;
+static const int32 kSpans = kHeight * 16;
+static const uint32 kSeeds = 16;
+
+
+static uint8
+random_cover()
+{
+	// make sure the special cases of no and full coverage are hit often
+	switch (rand() % 4) {
+		case 0:
+			return 0;
+		case 1:
+			return 255;
+		default:
+			return rand();
+	}
+}
+
+
+static void
+fill_random(uint8* bits, size_t size)
+{
+	for (size_t i = 0; i < size; i++)
+		bits[i] = rand();
+
+	// most of the frame buffer is opaque, but not all of it
+	for (size_t i = 3; i < size; i += 4) {
+		if (rand() % 4 != 0)
+			bits[i] = 255;
+	}
+}
+
+
+static void
+render(PixelFormat& pixelFormat, uint32 seed)
+{
+	srand(seed);
+
+	uint8 covers[kWidth];
+	agg::rgba8 colors[kWidth];
+
+	for (int32 i = 0; i < kSpans; i++) {
+		int32 y = i % kHeight;
+		int32 x = rand() % kWidth;
+		unsigned length = 1 + rand() % (kWidth - x);
+
+		agg::rgba8 color(rand() % 256, rand() % 256, rand() % 256,
+			random_cover());
+		for (unsigned j = 0; j < length; j++) {
+			covers[j] = random_cover();
+			colors[j] = agg::rgba8(rand() % 256, rand() % 256, rand() % 256,
+				random_cover());
+		}
+
+		switch ((i + i / kHeight) % 4) {
+			case 0:
+				pixelFormat.blend_hline(x, y, length, color, random_cover());
+				break;
+			case 1:
+				pixelFormat.blend_solid_hspan(x, y, length, color, covers);
+				break;
+			case 2:
+				pixelFormat.blend_color_hspan(x, y, length, colors, covers, 0);
+				break;
+			case 3:
+				pixelFormat.blend_color_hspan(x, y, length, colors, NULL,
+					random_cover());
+				break;
+		}
+	}
+}
+
+
+void
+DrawingModeSIMDTest::_Compare(drawing_mode mode, const pattern& pattern,
+	uint32 simdFlags)
+{
+	const size_t size = kWidth * kHeight * 4;
+	uint8* reference = new uint8[size];
+	uint8* bits = new uint8[size];
+
+	agg::rendering_buffer referenceBuffer(reference, kWidth, kHeight,
+		kWidth * 4);
+	agg::rendering_buffer buffer(bits, kWidth, kHeight, kWidth * 4);
+
+	PatternHandler patternHandler;
+	patternHandler.SetPattern(pattern);
+	patternHandler.SetColors(make_color(255, 203, 0, 255),
+		make_color(0, 0, 255, 128));
+
+	for (uint32 seed = 0; seed < kSeeds; seed++) {
+		srand(seed);
+		fill_random(reference, size);
+		memcpy(bits, reference, size);
+
+		gSIMDFlags = 0;
+		PixelFormat scalar(referenceBuffer, &patternHandler);
+		scalar.SetDrawingMode(mode, B_PIXEL_ALPHA, B_ALPHA_COMPOSITE);
+		render(scalar, seed);
+
+		gSIMDFlags = simdFlags;
+		PixelFormat simd(buffer, &patternHandler);
+		simd.SetDrawingMode(mode, B_PIXEL_ALPHA, B_ALPHA_COMPOSITE);
+		render(simd, seed);
+		gSIMDFlags = 0;
+
+		CPPUNIT_ASSERT(memcmp(reference, bits, size) == 0);
+	}
+
+	delete[] reference;
+	delete[] bits;
+}
+
+
+void
+DrawingModeSIMDTest::_Compare(drawing_mode mode, const pattern& pattern)
+{
+#if defined(__i386__) || defined(__x86_64__)
+	if (__builtin_cpu_supports("sse2"))
+		_Compare(mode, pattern, APPSERVER_SIMD_SSE2);
+	if (__builtin_cpu_supports("avx2"))
+		_Compare(mode, pattern, APPSERVER_SIMD_AVX2);
+#endif
+}
+
+
+void
+DrawingModeSIMDTest::Over()
+{
+	_Compare(B_OP_OVER, B_SOLID_HIGH);
+}
+
+
+void
+DrawingModeSIMDTest::OverPattern()
+{
+	_Compare(B_OP_OVER, B_MIXED_COLORS);
+}
+
+
+void
+DrawingModeSIMDTest::Copy()
+{
+	_Compare(B_OP_COPY, B_SOLID_HIGH);
+}
+
+
+void
+DrawingModeSIMDTest::AlphaComposite()
+{
+	_Compare(B_OP_ALPHA, B_SOLID_HIGH);
+}
+
+
+void
+DrawingModeSIMDTest::AlphaCompositePattern()
+{
+	_Compare(B_OP_ALPHA, B_MIXED_COLORS);
+}
+
+
+/* static */ void
+DrawingModeSIMDTest::AddTests(BTestSuite& parent)
+{
+	CppUnit::TestSuite* const suite = new CppUnit::TestSuite(
+		"DrawingModeSIMDTest");
+
+	suite->addTest(new CppUnit::TestCaller<DrawingModeSIMDTest>(
+		"DrawingModeSIMDTest::Over",
+		&DrawingModeSIMDTest::Over));
+	suite->addTest(new CppUnit::TestCaller<DrawingModeSIMDTest>(
+		"DrawingModeSIMDTest::OverPattern",
+		&DrawingModeSIMDTest::OverPattern));
+	suite->addTest(new CppUnit::TestCaller<DrawingModeSIMDTest>(
+		"DrawingModeSIMDTest::Copy",
+		&DrawingModeSIMDTest::Copy));
+	suite->addTest(new CppUnit::TestCaller<DrawingModeSIMDTest>(
+		"DrawingModeSIMDTest::AlphaComposite",
+		&DrawingModeSIMDTest::AlphaComposite));
+	suite->addTest(new CppUnit::TestCaller<DrawingModeSIMDTest>(
+		"DrawingModeSIMDTest::AlphaCompositePattern",
+		&DrawingModeSIMDTest::AlphaCompositePattern));
+
+	parent.addTest("DrawingModeSIMDTest", suite);
+}
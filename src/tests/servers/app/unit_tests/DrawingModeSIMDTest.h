@@ -0,0 +1,32 @@
+/*
+ * Copyright 2026, Haiku, Inc. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+#ifndef DRAWING_MODE_SIMD_TEST_H
+#define DRAWING_MODE_SIMD_TEST_H
+
+#include <TestCase.h>
+#include <TestSuite.h>
+
+#include <GraphicsDefs.h>
+
+
+class DrawingModeSIMDTest : public BTestCase {
+public:
+	static	void			AddTests(BTestSuite& parent);
+
+			void			Over();
+			void			OverPattern();
+			void			Copy();
+			void			AlphaComposite();
+			void			AlphaCompositePattern();
+
+private:
+			void			_Compare(drawing_mode mode,
+								const pattern& pattern);
+			void			_Compare(drawing_mode mode,
+								const pattern& pattern, uint32 simdFlags);
+};
+
+
+#endif // DRAWING_MODE_SIMD_TEST_H
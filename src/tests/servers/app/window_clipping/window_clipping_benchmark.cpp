@@ -0,0 +1,121 @@
+/*
+ * Copyright 2026, Haiku, Inc. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+/*!	Measures how long the app_server takes to move and resize a window in
+	front of, and in the middle of, a growing number of overlapping windows.
+	Every move and resize recomputes the clipping of the windows on screen,
+	and waits for the reply of the app_server.
+*/
+
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <Application.h>
+#include <ObjectList.h>
+#include <Screen.h>
+#include <View.h>
+#include <Window.h>
+
+
+static const int32 kWindowCounts[] = { 10, 50, 100, 200 };
+
+
+static BWindow*
+create_window(int32 index, BRect screen)
+{
+	// lay out the windows in overlapping rows across the screen
+	int32 columns = (int32)(screen.Width() / 60) - 4;
+	if (columns < 1)
+		columns = 1;
+
+	BRect frame(0, 0, 239, 179);
+	frame.OffsetTo(20 + (index % columns) * 50,
+		40 + ((index / columns) * 70) % (int32)(screen.Height() - 260));
+
+	BWindow* window = new BWindow(frame, "Clipping benchmark",
+		B_TITLED_WINDOW, B_NOT_ZOOMABLE | B_ASYNCHRONOUS_CONTROLS);
+	BView* view = new BView(window->Bounds(), "content", B_FOLLOW_ALL,
+		B_WILL_DRAW);
+	view->SetViewColor(200 + index % 50, 200, 220);
+	window->AddChild(view);
+	window->Show();
+	return window;
+}
+
+
+static double
+measure_moves(BWindow* window, int32 iterations)
+{
+	window->Lock();
+
+	bigtime_t start = system_time();
+	for (int32 i = 0; i < iterations; i++)
+		window->MoveBy((i & 16) != 0 ? -7 : 7, (i & 8) != 0 ? -5 : 5);
+	bigtime_t time = system_time() - start;
+
+	window->Unlock();
+	return (double)time / iterations;
+}
+
+
+static double
+measure_resizes(BWindow* window, int32 iterations)
+{
+	window->Lock();
+
+	bigtime_t start = system_time();
+	for (int32 i = 0; i < iterations; i++)
+		window->ResizeBy((i & 16) != 0 ? -6 : 6, (i & 16) != 0 ? -4 : 4);
+	bigtime_t time = system_time() - start;
+
+	window->Unlock();
+	return (double)time / iterations;
+}
+
+
+int
+main(int argc, char** argv)
+{
+	int32 iterations = 256;
+	if (argc > 1)
+		iterations = atoi(argv[1]);
+
+	BApplication app("application/x-vnd.Haiku-WindowClippingBenchmark");
+	BRect screen = BScreen().Frame();
+
+	BObjectList<BWindow> windows;
+
+	printf("%" B_PRId32 " iterations, usecs per operation:\n", iterations);
+	printf("  windows    front move  front resize   middle move\n");
+
+	for (size_t i = 0; i < sizeof(kWindowCounts) / sizeof(kWindowCounts[0]);
+			i++) {
+		while (windows.CountItems() < kWindowCounts[i])
+			windows.AddItem(create_window(windows.CountItems(), screen));
+
+		// let the windows draw first
+		snooze(500000);
+
+		BWindow* front = windows.LastItem();
+		BWindow* middle = windows.ItemAt(windows.CountItems() / 2);
+
+		double frontMove = measure_moves(front, iterations);
+		double frontResize = measure_resizes(front, iterations);
+		double middleMove = measure_moves(middle, iterations);
+
+		printf("  %7" B_PRId32 "  %12.1f  %12.1f  %12.1f\n",
+			windows.CountItems(), frontMove, frontResize, middleMove);
+	}
+
+	for (int32 i = 0; i < windows.CountItems(); i++) {
+		BWindow* window = windows.ItemAt(i);
+		window->Lock();
+		window->Quit();
+	}
+
+	return 0;
+}
@@ -0,0 +1,182 @@
+/*
+ * Copyright 2026, Haiku, Inc. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+/*!	Compares the cost of waiting for a few active pipes among many idle ones
+	using poll() and an edge-triggered event queue.
+*/
+
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+#include <OS.h>
+
+#include <event_queue_defs.h>
+#include <syscalls.h>
+
+
+static int* sReadFDs;
+static int* sWriteFDs;
+
+
+static void
+create_pipes(int count)
+{
+	struct rlimit limit;
+	limit.rlim_cur = limit.rlim_max = count * 2 + 32;
+	if (setrlimit(RLIMIT_NOFILE, &limit) != 0) {
+		fprintf(stderr, "setrlimit: %s\n", strerror(errno));
+		exit(1);
+	}
+
+	sReadFDs = new int[count];
+	sWriteFDs = new int[count];
+
+	for (int i = 0; i < count; i++) {
+		int fds[2];
+		if (pipe(fds) != 0) {
+			fprintf(stderr, "pipe %d: %s\n", i, strerror(errno));
+			exit(1);
+		}
+		fcntl(fds[0], F_SETFL, O_NONBLOCK);
+		sReadFDs[i] = fds[0];
+		sWriteFDs[i] = fds[1];
+	}
+}
+
+
+static void
+make_active(int count, int active, int iteration)
+{
+	// spread the active pipes over the whole range, and move them around
+	for (int i = 0; i < active; i++) {
+		int index = (i * (count / active) + iteration) % count;
+		write(sWriteFDs[index], "x", 1);
+	}
+}
+
+
+static void
+drain(int index)
+{
+	char buffer[16];
+	while (read(sReadFDs[index], buffer, sizeof(buffer)) > 0)
+		;
+}
+
+
+static bigtime_t
+run_poll(int count, int active, int iterations)
+{
+	struct pollfd* fds = new pollfd[count];
+	for (int i = 0; i < count; i++) {
+		fds[i].fd = sReadFDs[i];
+		fds[i].events = POLLIN;
+	}
+
+	bigtime_t start = system_time();
+	for (int iteration = 0; iteration < iterations; iteration++) {
+		make_active(count, active, iteration);
+
+		int ready = poll(fds, count, -1);
+		for (int i = 0; i < count && ready > 0; i++) {
+			if ((fds[i].revents & POLLIN) != 0) {
+				drain(i);
+				ready--;
+			}
+		}
+	}
+	bigtime_t time = system_time() - start;
+
+	delete[] fds;
+	return time;
+}
+
+
+static bigtime_t
+run_event_queue(int count, int active, int iterations)
+{
+	int queue = _kern_event_queue_create(0);
+	if (queue < 0) {
+		fprintf(stderr, "event_queue_create: %s\n", strerror(queue));
+		exit(1);
+	}
+
+	event_wait_info* infos = new event_wait_info[count];
+	for (int i = 0; i < count; i++) {
+		infos[i].object = sReadFDs[i];
+		infos[i].type = B_OBJECT_TYPE_FD;
+		infos[i].events = B_EVENT_READ;
+		infos[i].user_data = (void*)(addr_t)i;
+	}
+	if (_kern_event_queue_select(queue, infos, count) != B_OK) {
+		fprintf(stderr, "event_queue_select failed\n");
+		exit(1);
+	}
+
+	bigtime_t start = system_time();
+	for (int iteration = 0; iteration < iterations; iteration++) {
+		make_active(count, active, iteration);
+
+		int left = active;
+		while (left > 0) {
+			ssize_t ready = _kern_event_queue_wait(queue, infos, count, 0, 0);
+			if (ready < 0) {
+				fprintf(stderr, "event_queue_wait: %s\n", strerror(ready));
+				exit(1);
+			}
+			for (ssize_t i = 0; i < ready; i++)
+				drain((addr_t)infos[i].user_data);
+			left -= ready;
+		}
+	}
+	bigtime_t time = system_time() - start;
+
+	close(queue);
+	delete[] infos;
+	return time;
+}
+
+
+int
+main(int argc, char** argv)
+{
+	int count = 10000;
+	int active = 16;
+	int iterations = 1000;
+	if (argc > 1)
+		count = strtol(argv[1], NULL, 0);
+	if (argc > 2)
+		active = strtol(argv[2], NULL, 0);
+	if (argc > 3)
+		iterations = strtol(argv[3], NULL, 0);
+
+	if (count <= 0 || active <= 0 || active > count || iterations <= 0) {
+		fprintf(stderr, "usage: %s [pipes] [active] [iterations]\n",
+			argv[0]);
+		return 1;
+	}
+
+	create_pipes(count);
+
+	bigtime_t pollTime = run_poll(count, active, iterations);
+	bigtime_t queueTime = run_event_queue(count, active, iterations);
+
+	printf("%d pipes, %d active, %d iterations:\n", count, active,
+		iterations);
+	printf("  poll():      %8.1f us per wakeup\n",
+		(double)pollTime / iterations);
+	printf("  event queue: %8.1f us per wakeup\n",
+		(double)queueTime / iterations);
+
+	return 0;
+}
@@ -0,0 +1,179 @@
+/*
+ * Copyright 2026, Haiku, Inc. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+/*!	Measures route lookups in the stack's LPMTable with a large number of
+	routes, and compares them with walking a route list sorted by prefix
+	length, as the stack does without the table.
+*/
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <OS.h>
+
+#include "lpm_table.h"
+
+
+struct route {
+	uint64	key[2];
+	uint32	length;
+};
+
+
+static uint64
+random64()
+{
+	return ((uint64)rand() << 62) ^ ((uint64)rand() << 31) ^ rand();
+}
+
+
+static void
+mask_key(uint64* key, uint32 length)
+{
+	for (int i = 0; i < 2; i++) {
+		if (length >= 64) {
+			length -= 64;
+			continue;
+		}
+		key[i] &= length == 0 ? 0 : ~(uint64)0 << (64 - length);
+		length = 0;
+	}
+}
+
+
+static bool
+matches(const route& route, const uint64* key)
+{
+	uint64 masked[2] = { key[0], key[1] };
+	mask_key(masked, route.length);
+	return masked[0] == route.key[0] && masked[1] == route.key[1];
+}
+
+
+static int
+compare_routes(const void* _a, const void* _b)
+{
+	const route* a = (const route*)_a;
+	const route* b = (const route*)_b;
+	return (int)b->length - (int)a->length;
+}
+
+
+static uint32
+linear_lookup(const route* routes, uint32 count, const uint64* key)
+{
+	for (uint32 i = 0; i < count; i++) {
+		if (matches(routes[i], key))
+			return i + 1;
+	}
+	return 0;
+}
+
+
+static void
+run(uint32 keyBits, uint32 count, uint32 lookups)
+{
+	route* routes = new route[count];
+	for (uint32 i = 0; i < count; i++) {
+		route& route = routes[i];
+		route.key[0] = random64();
+		route.key[1] = keyBits > 64 ? random64() : 0;
+
+		// mostly long prefixes, like an overlay network would use
+		if (keyBits == 32)
+			route.length = rand() % 4 != 0 ? 24 + rand() % 9 : 8 + rand() % 16;
+		else
+			route.length = rand() % 4 != 0 ? 48 + rand() % 81 : 16 + rand() % 32;
+		if (i == 0)
+			route.length = 0;
+
+		mask_key(route.key, route.length);
+	}
+	qsort(routes, count, sizeof(route), &compare_routes);
+
+	uint64 (*keys)[2] = new uint64[lookups][2];
+	for (uint32 i = 0; i < lookups; i++) {
+		// half of the lookups hit a route, the other half the default route
+		const route& route = routes[rand() % count];
+		keys[i][0] = route.key[0];
+		keys[i][1] = route.key[1];
+		if ((i & 1) != 0) {
+			keys[i][0] ^= random64() >> route.length;
+			keys[i][1] ^= keyBits > 64 ? random64() : 0;
+		}
+		if (keyBits == 32)
+			keys[i][0] &= 0xffffffff00000000ULL;
+	}
+
+	bigtime_t start = system_time();
+
+	LPMTable table;
+	status_t status = table.Init(keyBits);
+	for (uint32 i = 0; status == B_OK && i < count; i++)
+		status = table.Add(routes[i].key, routes[i].length, i + 1);
+	if (status == B_OK)
+		status = table.Build();
+	if (status != B_OK) {
+		fprintf(stderr, "building table failed: %s\n", strerror(status));
+		exit(1);
+	}
+
+	bigtime_t buildTime = system_time() - start;
+
+	uint32 sum = 0;
+	start = system_time();
+	for (uint32 i = 0; i < lookups; i++)
+		sum += table.Lookup(keys[i]);
+	bigtime_t tableTime = system_time() - start;
+
+	// the list is a lot slower, only look at a part of the keys
+	uint32 linearLookups = lookups / 100;
+	uint32 errors = 0;
+	start = system_time();
+	for (uint32 i = 0; i < linearLookups; i++) {
+		uint32 expected = linear_lookup(routes, count, keys[i]);
+		if (table.Lookup(keys[i]) != expected)
+			errors++;
+	}
+	bigtime_t linearTime = system_time() - start;
+
+	printf("IPv%d, %" B_PRIu32 " routes: built in %" B_PRIdBIGTIME " ms, "
+		"%" B_PRIu32 " nodes, %zu KB\n", keyBits == 32 ? 4 : 6, count,
+		buildTime / 1000, table.CountNodes(), table.MemoryUsage() / 1024);
+	printf("  table: %8.1f ns per lookup\n",
+		tableTime * 1000.0 / lookups);
+	printf("  list:  %8.1f ns per lookup\n",
+		linearTime * 1000.0 / linearLookups);
+	if (errors != 0)
+		printf("  %" B_PRIu32 " MISMATCHES!\n", errors);
+
+	// make sure the lookups are not optimized away
+	if (sum == 1)
+		printf("\n");
+
+	delete[] keys;
+	delete[] routes;
+}
+
+
+int
+main(int argc, char** argv)
+{
+	uint32 count = 100000;
+	uint32 lookups = 1000000;
+	if (argc > 1)
+		count = strtoul(argv[1], NULL, 0);
+	if (argc > 2)
+		lookups = strtoul(argv[2], NULL, 0);
+
+	srand(system_time());
+
+	run(32, count, lookups);
+	run(128, count, lookups);
+	return 0;
+}
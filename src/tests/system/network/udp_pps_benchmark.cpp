@@ -0,0 +1,220 @@
+/*
+ * Copyright 2026, Haiku, Inc. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+/*!	Measures UDP packets per second over the loopback interface, comparing
+	one datagram per syscall with sendmmsg()/recvmmsg() batching, and with
+	UDP_SEGMENT segmentation offload on the sending side.
+*/
+
+
+#include <errno.h>
+#include <netinet/in.h>
+#include <netinet/udp.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <OS.h>
+
+
+static const int kBatchSize = 64;
+static const int kMaxPacketSize = 1472;
+
+
+enum benchmark_mode {
+	MODE_SINGLE,
+	MODE_BATCH,
+	MODE_SEGMENT
+};
+
+
+struct receiver_args {
+	int				socket;
+	benchmark_mode	mode;
+	int32			expected;
+	int32			received;
+};
+
+
+static void*
+receiver_thread(void* _args)
+{
+	receiver_args& args = *(receiver_args*)_args;
+
+	char buffers[kBatchSize][kMaxPacketSize];
+	iovec vecs[kBatchSize];
+	mmsghdr messages[kBatchSize];
+	for (int i = 0; i < kBatchSize; i++) {
+		vecs[i].iov_base = buffers[i];
+		vecs[i].iov_len = sizeof(buffers[i]);
+		memset(&messages[i], 0, sizeof(mmsghdr));
+		messages[i].msg_hdr.msg_iov = &vecs[i];
+		messages[i].msg_hdr.msg_iovlen = 1;
+	}
+
+	while (atomic_get(&args.received) < args.expected) {
+		if (args.mode == MODE_SINGLE) {
+			ssize_t bytes = recv(args.socket, buffers[0], sizeof(buffers[0]),
+				0);
+			if (bytes < 0)
+				break;
+			atomic_add(&args.received, 1);
+		} else {
+			int count = recvmmsg(args.socket, messages, kBatchSize,
+				MSG_WAITFORONE, NULL);
+			if (count < 0)
+				break;
+			atomic_add(&args.received, count);
+		}
+	}
+
+	return NULL;
+}
+
+
+static int
+create_socket(sockaddr_in& address)
+{
+	int fd = socket(AF_INET, SOCK_DGRAM, 0);
+	if (fd < 0) {
+		perror("socket");
+		exit(1);
+	}
+
+	int size = 4 * 1024 * 1024;
+	setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &size, sizeof(size));
+	setsockopt(fd, SOL_SOCKET, SO_SNDBUF, &size, sizeof(size));
+
+	memset(&address, 0, sizeof(address));
+	address.sin_len = sizeof(address);
+	address.sin_family = AF_INET;
+	address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	if (bind(fd, (sockaddr*)&address, sizeof(address)) != 0) {
+		perror("bind");
+		exit(1);
+	}
+
+	socklen_t length = sizeof(address);
+	getsockname(fd, (sockaddr*)&address, &length);
+	return fd;
+}
+
+
+static void
+run(benchmark_mode mode, int32 packets, size_t packetSize)
+{
+	sockaddr_in receiverAddress;
+	sockaddr_in senderAddress;
+	int receiver = create_socket(receiverAddress);
+	int sender = create_socket(senderAddress);
+
+	if (connect(sender, (sockaddr*)&receiverAddress, sizeof(receiverAddress))
+			!= 0) {
+		perror("connect");
+		exit(1);
+	}
+
+	if (mode == MODE_SEGMENT) {
+		int segmentSize = packetSize;
+		if (setsockopt(sender, IPPROTO_UDP, UDP_SEGMENT, &segmentSize,
+				sizeof(segmentSize)) != 0) {
+			perror("setsockopt(UDP_SEGMENT)");
+			exit(1);
+		}
+	}
+
+	receiver_args args;
+	args.socket = receiver;
+	args.mode = mode == MODE_SINGLE ? MODE_SINGLE : MODE_BATCH;
+	args.expected = packets;
+	args.received = 0;
+
+	pthread_t thread;
+	pthread_create(&thread, NULL, &receiver_thread, &args);
+
+	static char data[kBatchSize * kMaxPacketSize];
+	memset(data, 'x', sizeof(data));
+
+	iovec vecs[kBatchSize];
+	mmsghdr messages[kBatchSize];
+	for (int i = 0; i < kBatchSize; i++) {
+		vecs[i].iov_base = data + i * packetSize;
+		vecs[i].iov_len = packetSize;
+		memset(&messages[i], 0, sizeof(mmsghdr));
+		messages[i].msg_hdr.msg_iov = &vecs[i];
+		messages[i].msg_hdr.msg_iovlen = 1;
+	}
+
+	bigtime_t start = system_time();
+
+	int32 sent = 0;
+	while (sent < packets) {
+		int32 count = min_c(packets - sent, kBatchSize);
+		ssize_t result;
+		switch (mode) {
+			case MODE_SINGLE:
+				result = send(sender, data, packetSize, 0) < 0 ? -1 : 1;
+				break;
+			case MODE_BATCH:
+				result = sendmmsg(sender, messages, count, 0);
+				break;
+			case MODE_SEGMENT:
+				result = send(sender, data, packetSize * count, 0);
+				if (result >= 0)
+					result = count;
+				break;
+		}
+
+		if (result < 0) {
+			if (errno == B_WOULD_BLOCK || errno == ENOBUFS) {
+				snooze(100);
+				continue;
+			}
+			perror("send");
+			break;
+		}
+		sent += result;
+	}
+
+	// give the receiver a chance to catch up on what is left
+	bigtime_t sendTime = system_time() - start;
+	for (int i = 0; i < 100 && atomic_get(&args.received) < sent; i++)
+		snooze(10000);
+
+	bigtime_t totalTime = system_time() - start;
+	shutdown(receiver, SHUT_RDWR);
+	close(receiver);
+	pthread_join(thread, NULL);
+	close(sender);
+
+	static const char* kModeNames[] = { "single", "sendmmsg/recvmmsg",
+		"UDP_SEGMENT" };
+	printf("%-18s %5zu bytes: sent %8.0f pps, received %" B_PRId32 "/%"
+		B_PRId32 " (%8.0f pps)\n", kModeNames[mode], packetSize,
+		sent * 1000000.0 / sendTime, args.received, sent,
+		args.received * 1000000.0 / totalTime);
+}
+
+
+int
+main(int argc, char** argv)
+{
+	int32 packets = 200000;
+	if (argc > 1)
+		packets = strtol(argv[1], NULL, 0);
+
+	static const size_t kSizes[] = { 64, 512, kMaxPacketSize };
+	for (size_t i = 0; i < sizeof(kSizes) / sizeof(kSizes[0]); i++) {
+		run(MODE_SINGLE, packets, kSizes[i]);
+		run(MODE_BATCH, packets, kSizes[i]);
+		run(MODE_SEGMENT, packets, kSizes[i]);
+	}
+
+	return 0;
+}
@@ -91,6 +91,11 @@ const RP_UNMAPPED_KEY_DOWN = 242;
 const RP_UNMAPPED_KEY_UP = 243;
 const RP_MODIFIERS_CHANGED = 244;
 
+const RP_FRAME_TILE = 260;
+const RP_FRAME_TILE_CACHED = 261;
+
+const kFrameTileCacheSize = 256;
+
 
 // drawing_mode
 const B_OP_COPY = 0;
@@ -1762,6 +1767,63 @@ RemoteState.prototype.messageReceived = function(remoteMessage, reply)
 }
 
 
+function decodeFrameTile(data, imageData)
+{
+	// see FrameTileCodec.cpp for the format
+	var pixels = imageData.data;
+	var index = new Uint32Array(64);
+	var red = 0, green = 0, blue = 0;
+	var run = 0;
+	var position = 0;
+
+	for (var offset = 0; offset < pixels.length; offset += 4) {
+		if (run > 0) {
+			run--;
+		} else {
+			if (position >= data.length)
+				return false;
+
+			var op = data[position++];
+			if ((op & 0xc0) == 0x00) {
+				var pixel = index[op];
+				red = pixel >> 16;
+				green = (pixel >> 8) & 0xff;
+				blue = pixel & 0xff;
+			} else if ((op & 0xc0) == 0xc0 && op != 0xfe) {
+				// a run, this pixel is its first one
+				run = op & 0x3f;
+			} else {
+				if (op == 0xfe) {
+					red = data[position++];
+					green = data[position++];
+					blue = data[position++];
+				} else if ((op & 0xc0) == 0x40) {
+					red = (red + ((op >> 4) & 0x03) - 2) & 0xff;
+					green = (green + ((op >> 2) & 0x03) - 2) & 0xff;
+					blue = (blue + (op & 0x03) - 2) & 0xff;
+				} else {
+					var greenDiff = (op & 0x3f) - 32;
+					var next = data[position++];
+					red = (red + greenDiff + (next >> 4) - 8) & 0xff;
+					green = (green + greenDiff) & 0xff;
+					blue = (blue + greenDiff + (next & 0x0f) - 8) & 0xff;
+				}
+
+				index[(red * 3 + green * 5 + blue * 7 + 255 * 11) % 64]
+					= red << 16 | green << 8 | blue;
+			}
+		}
+
+		pixels[offset] = red;
+		pixels[offset + 1] = green;
+		pixels[offset + 2] = blue;
+		pixels[offset + 3] = 255;
+	}
+
+	return run == 0 && position == data.length;
+}
+
+
 function RemoteDesktopSession(targetElement, width, height, targetAddress,
 	disconnectCallback)
 {
@@ -1803,6 +1865,8 @@ function RemoteDesktopSession(targetElement, width, height, targetAddress,
 	this.states = new Object();
 	this.modifiers = 0;
 
+	this.frameTileCache = new Array(kFrameTileCacheSize);
+
 	this.canvas.onmousemove = this.onMouseMove.bind(this);
 	this.canvas.onmousedown = this.onMouseDown.bind(this);
 	this.canvas.onmouseup = this.onMouseUp.bind(this);
@@ -1959,6 +2023,36 @@ RemoteDesktopSession.prototype.messageReceived = function(remoteMessage, reply)
 				rect.top + yOffset);
 			break;
 
+		case RP_FRAME_TILE:
+		case RP_FRAME_TILE_CACHED:
+			var left = remoteMessage.dataView.readInt32();
+			var top = remoteMessage.dataView.readInt32();
+			var width = remoteMessage.dataView.readInt32();
+			var height = remoteMessage.dataView.readInt32();
+			var slot = remoteMessage.dataView.readUint32();
+
+			if (remoteMessage.code() == RP_FRAME_TILE) {
+				var data = new Uint8Array(remoteMessage.dataView.readUint32());
+				remoteMessage.dataView.readInto(data);
+
+				var imageData = this.context.createImageData(width, height);
+				if (!decodeFrameTile(data, imageData)) {
+					console.error('failed to decode frame tile');
+					break;
+				}
+
+				this.frameTileCache[slot % kFrameTileCacheSize] = imageData;
+			}
+
+			var imageData = this.frameTileCache[slot % kFrameTileCacheSize];
+			if (imageData === undefined) {
+				console.error('frame tile not in cache: ' + slot);
+				break;
+			}
+
+			this.context.putImageData(imageData, left, top);
+			break;
+
 		case RP_FILL_REGION_COLOR_NO_CLIPPING:
 			this.removeClipping();
 			this.context.currentToken = -1;